@@ -0,0 +1,15 @@
+# Find the LZ4 includes and library.
+#
+# This module defines
+# LZ4_INCLUDE_DIR, where to locate lz4.h
+# LZ4_LIBRARIES, the libraries to link against to use LZ4
+# LZ4_FOUND.  If false, you cannot build anything that requires LZ4.
+
+find_path(LZ4_INCLUDE_DIR NAMES lz4.h lz4hc.h HINTS ${LZ4_DIR} ENV LZ4_DIR PATH_SUFFIXES include)
+find_library(LZ4_LIBRARY NAMES lz4 HINTS ${LZ4_DIR} ENV LZ4_DIR PATH_SUFFIXES lib)
+
+include(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LZ4 DEFAULT_MSG LZ4_LIBRARY LZ4_INCLUDE_DIR)
+
+set(LZ4_LIBRARIES ${LZ4_LIBRARY})
+mark_as_advanced(LZ4_FOUND LZ4_LIBRARY LZ4_INCLUDE_DIR)
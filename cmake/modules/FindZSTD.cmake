@@ -0,0 +1,15 @@
+# Find the Zstandard includes and library.
+#
+# This module defines
+# ZSTD_INCLUDE_DIR, where to locate zstd.h
+# ZSTD_LIBRARIES, the libraries to link against to use Zstandard
+# ZSTD_FOUND.  If false, you cannot build anything that requires Zstandard.
+
+find_path(ZSTD_INCLUDE_DIR NAMES zstd.h HINTS ${ZSTD_DIR} ENV ZSTD_DIR PATH_SUFFIXES include)
+find_library(ZSTD_LIBRARY NAMES zstd HINTS ${ZSTD_DIR} ENV ZSTD_DIR PATH_SUFFIXES lib)
+
+include(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(ZSTD DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+set(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+mark_as_advanced(ZSTD_FOUND ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
@@ -435,6 +435,16 @@ if(lzma)
 else()
   set(haslzmacompression undef)
 endif()
+if(lz4)
+  set(haslz4 define)
+else()
+  set(haslz4 undef)
+endif()
+if(zstd)
+  set(haszstd define)
+else()
+  set(haszstd undef)
+endif()
 if(cocoa)
   set(hascocoa define)
 else()
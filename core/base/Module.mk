@@ -19,6 +19,7 @@ BASEL3       := $(MODDIRI)/LinkDef3.h
 
 BASEH1       := $(wildcard $(MODDIRI)/T*.h)
 BASEH3       := GuiTypes.h KeySymbols.h Buttons.h TTimeStamp.h TVirtualMutex.h \
+                TVirtualRWMutex.h \
                 TVirtualPerfStats.h TVirtualX.h TParameter.h \
                 TVirtualAuth.h TFileInfo.h TFileCollection.h \
                 TRedirectOutputGuard.h TVirtualMonitoring.h TObjectSpy.h \
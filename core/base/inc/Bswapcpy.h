@@ -32,6 +32,11 @@
 //                                                                      //
 // For arrays of short type (2 bytes in size) use bswapcpy16().         //
 // For arrays of of 4-byte types (int, float) use bswapcpy32().         //
+// For arrays of of 8-byte types (long long, double) use bswapcpy64().  //
+//                                                                      //
+// On x86_64 the arrays are swapped with the SSSE3 or AVX2 byte         //
+// shuffle instructions, 16 or 32 bytes at a time; the instruction set  //
+// is chosen at run time according to what the processor supports.      //
 //                                                                      //
 //                                                                      //
 // Author: Alexandre V. Vaniachine <AVVaniachine@lbl.gov>               //
@@ -40,8 +45,11 @@
 
 #if !defined(__CINT__)
 #include <sys/types.h>
+#include <string.h>
 #endif
 
+#if defined(__i386__)
+
 extern inline void * bswapcpy16(void * to, const void * from, size_t n)
 {
 int d0, d1, d2, d3;
@@ -78,4 +86,133 @@ __asm__ __volatile__(
         :"memory");
 return (to);
 }
+
+inline void * bswapcpy64(void * to, const void * from, size_t n)
+{
+   const char *f = (const char *)from;
+   char *t = (char *)to;
+   for (size_t i = 0; i < n; ++i, f += 8, t += 8)
+      for (int b = 0; b < 8; ++b)
+         t[b] = f[7-b];
+   return (to);
+}
+
+#else
+
+#if defined(__x86_64__) && !defined(__CINT__) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define R__BSWAPCPY_SIMD
+#include <immintrin.h>
+#endif
+
+//______________________________________________________________________________
+// Swap the remaining (or all) nbytes elements of the given width one at a time.
+inline void R__bswapcpy_scalar(char * to, const char * from, size_t nbytes, int width)
+{
+   for (size_t i = 0; i < nbytes; i += width) {
+      if (width == 2) {
+         unsigned short v;
+         memcpy(&v, from + i, 2);
+         v = __builtin_bswap16(v);
+         memcpy(to + i, &v, 2);
+      } else if (width == 4) {
+         unsigned int v;
+         memcpy(&v, from + i, 4);
+         v = __builtin_bswap32(v);
+         memcpy(to + i, &v, 4);
+      } else {
+         unsigned long long v;
+         memcpy(&v, from + i, 8);
+         v = __builtin_bswap64(v);
+         memcpy(to + i, &v, 8);
+      }
+   }
+}
+
+#ifdef R__BSWAPCPY_SIMD
+//______________________________________________________________________________
+// Swap 16 bytes at a time, return the number of bytes swapped.
+__attribute__((target("ssse3")))
+inline size_t R__bswapcpy_ssse3(char * to, const char * from, size_t nbytes, int width)
+{
+   const __m128i mask = width == 2 ? _mm_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14)
+                      : width == 4 ? _mm_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12)
+                      :              _mm_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+   size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(from + i));
+      _mm_storeu_si128((__m128i *)(to + i), _mm_shuffle_epi8(v, mask));
+   }
+   return i;
+}
+
+//______________________________________________________________________________
+// Swap 32 bytes at a time, return the number of bytes swapped.
+// The shuffle works within each 128 bits lane, hence the repeated masks.
+__attribute__((target("avx2")))
+inline size_t R__bswapcpy_avx2(char * to, const char * from, size_t nbytes, int width)
+{
+   const __m256i mask = width == 2 ? _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+                                                      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14)
+                      : width == 4 ? _mm256_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,
+                                                      3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12)
+                      :              _mm256_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8,
+                                                      7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+   size_t i = 0;
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(from + i));
+      _mm256_storeu_si256((__m256i *)(to + i), _mm256_shuffle_epi8(v, mask));
+   }
+   return i;
+}
+
+//______________________________________________________________________________
+// Return 2 if the processor supports AVX2, 1 for SSSE3, 0 otherwise.
+inline int R__bswapcpy_level()
+{
+   static const int level = []() {
+#if !defined(__clang__)
+      __builtin_cpu_init();
+#endif
+      if (__builtin_cpu_supports("avx2")) return 2;
+      if (__builtin_cpu_supports("ssse3")) return 1;
+      return 0;
+   }();
+   return level;
+}
+#endif
+
+//______________________________________________________________________________
+inline void * R__bswapcpy(void * to, const void * from, size_t n, int width)
+{
+   size_t nbytes = n*width;
+   size_t done = 0;
+#ifdef R__BSWAPCPY_SIMD
+   int level = R__bswapcpy_level();
+   if (level == 2)
+      done = R__bswapcpy_avx2((char *)to, (const char *)from, nbytes, width);
+   else if (level == 1)
+      done = R__bswapcpy_ssse3((char *)to, (const char *)from, nbytes, width);
+#endif
+   R__bswapcpy_scalar((char *)to + done, (const char *)from + done, nbytes - done, width);
+   return (to);
+}
+
+inline void * bswapcpy16(void * to, const void * from, size_t n)
+{
+   return R__bswapcpy(to, from, n, 2);
+}
+
+inline void * bswapcpy32(void * to, const void * from, size_t n)
+{
+   return R__bswapcpy(to, from, n, 4);
+}
+
+inline void * bswapcpy64(void * to, const void * from, size_t n)
+{
+   return R__bswapcpy(to, from, n, 8);
+}
+
+#endif
+
 #endif
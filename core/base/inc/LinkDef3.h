@@ -166,6 +166,9 @@
 #pragma link C++ class TVirtualAuth;
 #pragma link C++ class TVirtualMutex;
 #pragma link C++ class TLockGuard;
+#pragma link C++ class TVirtualRWMutex;
+#pragma link C++ class TReadLockGuard;
+#pragma link C++ class TWriteLockGuard;
 #pragma link C++ class TRedirectOutputGuard;
 #pragma link C++ class TVirtualPerfStats;
 #pragma link C++ enum TVirtualPerfStats::EEventType;
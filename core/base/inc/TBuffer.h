@@ -52,11 +52,12 @@ protected:
    char            *fBufMax;        //End of buffer
    TObject         *fParent;        //Pointer to parent object owning this buffer
    ReAllocCharFun_t fReAllocFunc;   //! Realloc function to be used when extending the buffer.
+   Int_t            fPoolSize;      //! Number of bytes of fBuffer when it comes from the TBufferPool (kIsPooled)
    CacheList_t      fCacheStack;    //Stack of pointers to the cache where to temporarily store the value of 'missing' data members
 
    // Default ctor
    TBuffer() : TObject(), fMode(0), fVersion(0), fBufSize(0), fBuffer(0),
-     fBufCur(0), fBufMax(0), fParent(0), fReAllocFunc(0), fCacheStack(0,(TVirtualArray*)0) {}
+     fBufCur(0), fBufMax(0), fParent(0), fReAllocFunc(0), fPoolSize(0), fCacheStack(0,(TVirtualArray*)0) {}
 
    // TBuffer objects cannot be copied or assigned
    TBuffer(const TBuffer &);           // not implemented
@@ -72,6 +73,7 @@ public:
    enum EMode { kRead = 0, kWrite = 1 };
    enum { kIsOwner = BIT(16) };                        //if set TBuffer owns fBuffer
    enum { kCannotHandleMemberWiseStreaming = BIT(17)}; //if set TClonesArray should not use member wise streaming
+   enum { kIsPooled = BIT(19) };                       //if set fBuffer comes from, and goes back to, the TBufferPool
    enum { kInitialSize = 1024, kMinimalSize = 128 };
 
    TBuffer(EMode mode);
@@ -92,7 +94,7 @@ public:
    TObject *GetParent()  const;
    char    *Buffer()     const { return fBuffer; }
    Int_t    BufferSize() const { return fBufSize; }
-   void     DetachBuffer() { fBuffer = 0; }
+   void     DetachBuffer() { fBuffer = 0; ResetBit(kIsPooled); }
    Int_t    Length()     const { return (Int_t)(fBufCur - fBuffer); }
    void     Expand(Int_t newsize, Bool_t copy = kTRUE);  // expand buffer to newsize
    void     AutoExpand(Int_t size_needed);  // expand buffer to newsize
@@ -0,0 +1,63 @@
+// @(#)root/base:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferPool
+#define ROOT_TBufferPool
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TBufferPool                                                          //
+//                                                                      //
+// Pool of I/O buffers recycled by size class. Each thread keeps a few  //
+// buffers of each size class, the others are kept in a global pool.    //
+// The memory retained by the pool is capped.                           //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+
+class TBufferPool {
+
+public:
+   enum {
+      kMinShift    = 8,    // Smallest size class is 2^kMinShift bytes
+      kMaxShift    = 26,   // Largest size class is 2^kMaxShift bytes, larger buffers are not pooled
+      kNSubClasses = 4,    // Number of size classes per power of two
+      kNClasses    = (kMaxShift - kMinShift) * kNSubClasses + 1,
+      kNLocal      = 4     // Number of buffers per size class kept by each thread
+   };
+
+   virtual ~TBufferPool() { }
+
+   static char     *Acquire(size_t &size);
+   static void      Release(char *buf, size_t size);
+   static char     *ReAllocChar(char *ovp, size_t size, size_t oldsize);
+   static void      Clear();
+
+   static Long64_t  GetMaxRetainedBytes();
+   static Long64_t  GetRetainedBytes();
+   static void      SetMaxRetainedBytes(Long64_t max);
+
+   static ULong64_t GetNAcquired();
+   static ULong64_t GetNReused();
+   static ULong64_t GetNReleased();
+   static ULong64_t GetNFreed();
+   static void      ResetStatistics();
+   static void      Print();
+
+   ClassDef(TBufferPool,0)  // Pool of I/O buffers recycled by size class
+};
+
+#endif
@@ -28,6 +28,7 @@
 
 
 class TFile;
+class TBranch;
 
 
 class TVirtualPerfStats : public TObject {
@@ -48,6 +49,7 @@ public:
    };
 
    static TVirtualPerfStats *&CurrentPerfStats();  // Return the current perfStats for this thread.
+   static Double_t GetSteadyTime();                   // Return a monotonic time in seconds, without locking.
 
    virtual void SimpleEvent(EEventType type) = 0;
 
@@ -65,6 +67,11 @@ public:
 
    virtual void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) = 0;
 
+   // Per branch events, see TTreePerfStats. The starts are GetSteadyTime().
+   virtual void BasketReadEvent(TBranch * /*branch*/, Int_t /*len*/, Bool_t /*cacheMiss*/) {}
+   virtual void BasketUnzipEvent(TBranch * /*branch*/, Double_t /*start*/, Int_t /*complen*/, Int_t /*objlen*/) {}
+   virtual void BranchStreamerEvent(TBranch * /*branch*/, Double_t /*start*/) {}
+
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
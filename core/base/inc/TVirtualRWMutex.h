@@ -0,0 +1,110 @@
+// @(#)root/base:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TVirtualRWMutex
+#define ROOT_TVirtualRWMutex
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TVirtualRWMutex                                                      //
+//                                                                      //
+// This class implements a reader/writer mutex interface. Any number of //
+// threads can hold the read lock at the same time, the write lock is   //
+// exclusive. Lock() and UnLock() take the write lock, so that a        //
+// TVirtualRWMutex can be used wherever a TVirtualMutex is expected.    //
+// The actual work is done via TRWMutex which is available as soon as   //
+// the thread library is loaded.                                        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TVirtualMutex
+#include "TVirtualMutex.h"
+#endif
+
+class TVirtualRWMutex;
+
+// Reader/writer mutex set in TThread::Init, shared by gROOTMutex and
+// gInterpreterMutex
+R__EXTERN TVirtualRWMutex *gCoreMutex;
+
+class TVirtualRWMutex : public TVirtualMutex {
+
+public:
+   TVirtualRWMutex() { }
+   virtual ~TVirtualRWMutex() { }
+
+   virtual Int_t ReadLock() = 0;
+   virtual Int_t ReadUnLock() = 0;
+   virtual Int_t WriteLock() = 0;
+   virtual Int_t WriteUnLock() = 0;
+
+   virtual Int_t Lock() { return WriteLock(); }
+   virtual Int_t UnLock() { return WriteUnLock(); }
+
+   virtual ULong64_t GetNReadContentions() const = 0;
+   virtual ULong64_t GetNWriteContentions() const = 0;
+   virtual void      ResetContentionCounters() = 0;
+
+   ClassDef(TVirtualRWMutex,0)  // Virtual reader/writer mutex lock class
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TReadLockGuard, TWriteLockGuard                                      //
+//                                                                      //
+// Same as TLockGuard, but taking respectively the read lock and the    //
+// write lock of a TVirtualRWMutex.                                     //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+class TReadLockGuard {
+
+private:
+   TVirtualRWMutex *fMutex;
+
+   TReadLockGuard(const TReadLockGuard&);             // not implemented
+   TReadLockGuard& operator=(const TReadLockGuard&);  // not implemented
+
+public:
+   TReadLockGuard(TVirtualRWMutex *mutex)
+     : fMutex(mutex) { if (fMutex) fMutex->ReadLock(); }
+   ~TReadLockGuard() { if (fMutex) fMutex->ReadUnLock(); }
+
+   ClassDefNV(TReadLockGuard,0)  // Exception safe read locking/unlocking of reader/writer mutex
+};
+
+class TWriteLockGuard {
+
+private:
+   TVirtualRWMutex *fMutex;
+
+   TWriteLockGuard(const TWriteLockGuard&);             // not implemented
+   TWriteLockGuard& operator=(const TWriteLockGuard&);  // not implemented
+
+public:
+   TWriteLockGuard(TVirtualRWMutex *mutex)
+     : fMutex(mutex) { if (fMutex) fMutex->WriteLock(); }
+   ~TWriteLockGuard() { if (fMutex) fMutex->WriteUnLock(); }
+
+   ClassDefNV(TWriteLockGuard,0)  // Exception safe write locking/unlocking of reader/writer mutex
+};
+
+// Zero overhead macros in case not compiled with thread support
+#if defined (_REENTRANT) || defined (WIN32)
+#define R__READ_LOCKGUARD(mutex) TReadLockGuard _R__UNIQUE_(R__readguard)(mutex)
+#define R__WRITE_LOCKGUARD(mutex) TWriteLockGuard _R__UNIQUE_(R__writeguard)(mutex)
+#else
+#define R__READ_LOCKGUARD(mutex) if (mutex) { }
+#define R__WRITE_LOCKGUARD(mutex) if (mutex) { }
+#endif
+
+#endif
@@ -14,9 +14,12 @@ Buffer base class used for serializing objects.
 */
 
 #include "TBuffer.h"
+#include "TBufferPool.h"
 #include "TClass.h"
 #include "TProcessID.h"
 
+#include <string.h>
+
 const Int_t  kExtraSpace        = 8;   // extra space at end of buffer (used for free block count)
 
 ClassImp(TBuffer)
@@ -41,6 +44,7 @@ TBuffer::TBuffer(EMode mode)
    fMode         = mode;
    fVersion      = 0;
    fParent       = 0;
+   fPoolSize     = 0;
 
    SetBit(kIsOwner);
 
@@ -63,6 +67,7 @@ TBuffer::TBuffer(EMode mode, Int_t bufsiz)
    fMode     = mode;
    fVersion  = 0;
    fParent   = 0;
+   fPoolSize = 0;
 
    SetBit(kIsOwner);
 
@@ -84,6 +89,11 @@ TBuffer::TBuffer(EMode mode, Int_t bufsiz)
 /// If the new buffer is _not_ adopted and no memory allocation routine
 /// is provided, a Fatal error will be issued if the Buffer attempts to
 /// expand.
+///
+/// If no buffer is passed and reallocfunc is TBufferPool::ReAllocChar,
+/// the buffer is taken from the TBufferPool, and given back to it when
+/// it is expanded or deleted. Its size is then rounded up to the size
+/// class of the pool.
 
 TBuffer::TBuffer(EMode mode, Int_t bufsiz, void *buf, Bool_t adopt, ReAllocCharFun_t reallocfunc)
 {
@@ -91,6 +101,7 @@ TBuffer::TBuffer(EMode mode, Int_t bufsiz, void *buf, Bool_t adopt, ReAllocCharF
    fMode     = mode;
    fVersion  = 0;
    fParent   = 0;
+   fPoolSize = 0;
 
    SetBit(kIsOwner);
 
@@ -104,7 +115,15 @@ TBuffer::TBuffer(EMode mode, Int_t bufsiz, void *buf, Bool_t adopt, ReAllocCharF
       if (fBufSize < kMinimalSize) {
          fBufSize = kMinimalSize;
       }
-      fBuffer = new char[fBufSize+kExtraSpace];
+      if (reallocfunc == TBufferPool::ReAllocChar) {
+         size_t size = fBufSize+kExtraSpace;
+         fBuffer = TBufferPool::Acquire(size);
+         fPoolSize = (Int_t)size;
+         fBufSize = fPoolSize-kExtraSpace;
+         SetBit(kIsPooled);
+      } else {
+         fBuffer = new char[fBufSize+kExtraSpace];
+      }
    }
    fBufCur = fBuffer;
    fBufMax = fBuffer + fBufSize;
@@ -123,7 +142,10 @@ TBuffer::~TBuffer()
 {
    if (TestBit(kIsOwner)) {
       //printf("Deleting fBuffer=%lx\n", fBuffer);
-      delete [] fBuffer;
+      if (TestBit(kIsPooled))
+         TBufferPool::Release(fBuffer, fPoolSize);
+      else
+         delete [] fBuffer;
    }
    fBuffer = 0;
    fParent = 0;
@@ -162,8 +184,14 @@ void TBuffer::AutoExpand(Int_t size_needed)
 
 void TBuffer::SetBuffer(void *buf, UInt_t newsiz, Bool_t adopt, ReAllocCharFun_t reallocfunc)
 {
-   if (fBuffer && TestBit(kIsOwner))
-      delete [] fBuffer;
+   if (fBuffer && TestBit(kIsOwner)) {
+      if (TestBit(kIsPooled))
+         TBufferPool::Release(fBuffer, fPoolSize);
+      else
+         delete [] fBuffer;
+   }
+   ResetBit(kIsPooled);
+   fPoolSize = 0;
 
    if (adopt)
       SetBit(kIsOwner);
@@ -195,6 +223,9 @@ void TBuffer::SetBuffer(void *buf, UInt_t newsiz, Bool_t adopt, ReAllocCharFun_t
 ///
 /// In order to avoid losing data, if the current length is greater than
 /// the requested size, we only shrink down to the current length.
+///
+/// A buffer taken from the TBufferPool is replaced by another one from the
+/// pool, and its size is rounded up to the size class of the pool.
 
 void TBuffer::Expand(Int_t newsize, Bool_t copy)
 {
@@ -202,6 +233,22 @@ void TBuffer::Expand(Int_t newsize, Bool_t copy)
    if ( (l > newsize) && copy ) {
       newsize = l;
    }
+   if (TestBit(kIsPooled)) {
+      // fBufSize depends on the mode, fPoolSize is the real allocated size.
+      size_t size = newsize+kExtraSpace;
+      size_t oldsize = fPoolSize;
+      char *buf = TBufferPool::Acquire(size);
+      size_t ncopy = copy ? (oldsize < size ? oldsize : size) : 0;
+      memcpy(buf, fBuffer, ncopy);
+      memset(buf+ncopy, 0, size-ncopy);
+      TBufferPool::Release(fBuffer, oldsize);
+      fBuffer   = buf;
+      fPoolSize = (Int_t)size;
+      fBufSize  = fPoolSize-kExtraSpace;
+      fBufCur  = fBuffer + l;
+      fBufMax  = fBuffer + fBufSize;
+      return;
+   }
    if ( (fMode&kWrite)!=0 ) {
       fBuffer  = fReAllocFunc(fBuffer, newsize+kExtraSpace,
                               copy ? fBufSize+kExtraSpace : 0);
@@ -261,6 +308,11 @@ void  TBuffer::SetReAllocFunc(ReAllocCharFun_t reallocfunc )
          fReAllocFunc = R__NoReAllocChar;
       }
    }
+   if (fReAllocFunc != TBufferPool::ReAllocChar) {
+      // From now on the buffer is managed by the new function, it is a
+      // plain array which can be freed with delete [].
+      ResetBit(kIsPooled);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
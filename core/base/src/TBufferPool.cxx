@@ -0,0 +1,325 @@
+// @(#)root/base:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TBufferPool
+
+Pool of I/O buffers recycled by size class.
+
+Reading a tree allocates and frees a buffer for each basket read, and
+small baskets make this allocator churn visible. TBufferPool keeps the
+freed buffers to hand them out again. The sizes are rounded up to size
+classes, four per power of two from 2^kMinShift to 2^kMaxShift bytes, so
+that at most 25% of a buffer is wasted; larger buffers are neither
+rounded nor kept.
+
+Each thread keeps up to kNLocal buffers of each size class, which it
+reuses without any locking. The other buffers go to a global pool,
+protected by a mutex, from which any thread can take them. The buffers
+kept by a thread are given to the global pool when the thread ends.
+
+The total size of the buffers kept, by all the threads, is capped by
+SetMaxRetainedBytes (64 MB by default); the buffers released beyond the
+cap are freed. Print() shows the number of buffers acquired, reused,
+released and freed.
+
+The buffers are plain arrays allocated with new char[]: a buffer which
+does not come back to the pool is simply freed by its owner.
+
+The pool is used by the TBuffer created with TBufferPool::ReAllocChar as
+reallocation function and no buffer, for example:
+
+    TBufferFile b(TBuffer::kRead, len, 0, kTRUE, TBufferPool::ReAllocChar);
+*/
+
+#include "TBufferPool.h"
+#include "TString.h"
+#include "ThreadLocalStorage.h"
+
+#include <atomic>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+ClassImp(TBufferPool)
+
+namespace {
+
+   // Buffers kept by the current thread, given to the global pool when the
+   // thread ends.
+   struct TLocalPool {
+      char  *fBuffers[TBufferPool::kNClasses][TBufferPool::kNLocal];
+      Int_t  fN[TBufferPool::kNClasses];
+
+      TLocalPool() { memset(fN, 0, sizeof(fN)); }
+      ~TLocalPool();
+   };
+
+   struct TGlobalPool {
+      std::mutex         fMutex;
+      std::vector<char*> fBuffers[TBufferPool::kNClasses];
+   };
+
+   std::atomic<Long64_t>  gMaxRetained(64*1024*1024);
+   std::atomic<Long64_t>  gRetained(0);
+   std::atomic<ULong64_t> gNAcquired(0);
+   std::atomic<ULong64_t> gNReused(0);
+   std::atomic<ULong64_t> gNReleased(0);
+   std::atomic<ULong64_t> gNFreed(0);
+
+   // Set once the pool of the current thread is destructed.
+   TTHREAD_TLS(Bool_t) gLocalPoolDone = kFALSE;
+
+   TGlobalPool &GetGlobalPool()
+   {
+      // Never deleted: the thread pools may be given back to it after the
+      // destruction of the static objects.
+      static TGlobalPool *pool = new TGlobalPool;
+      return *pool;
+   }
+
+   TLocalPool *GetLocalPool()
+   {
+      if (gLocalPoolDone) return 0;
+      TTHREAD_TLS_DECL(TLocalPool, pool);
+      return &pool;
+   }
+
+   TLocalPool::~TLocalPool()
+   {
+      TGlobalPool &global = GetGlobalPool();
+      std::lock_guard<std::mutex> lock(global.fMutex);
+      for (Int_t c = 0; c < TBufferPool::kNClasses; ++c) {
+         for (Int_t i = 0; i < fN[c]; ++i)
+            global.fBuffers[c].push_back(fBuffers[c][i]);
+         fN[c] = 0;
+      }
+      gLocalPoolDone = kTRUE;
+   }
+
+   // Return the size of the size class c.
+   size_t ClassSize(Int_t c)
+   {
+      return (size_t(1) << (TBufferPool::kMinShift + c / TBufferPool::kNSubClasses))
+             / TBufferPool::kNSubClasses * (TBufferPool::kNSubClasses + c % TBufferPool::kNSubClasses);
+   }
+
+   // Return the smallest size class holding size bytes, -1 if there is none.
+   Int_t ClassOf(size_t size)
+   {
+      if (size <= ClassSize(0)) return 0;
+      Int_t shift = TBufferPool::kMinShift;
+      while ((size_t(1) << (shift + 1)) < size) ++shift;
+      if (shift >= TBufferPool::kMaxShift) return -1;
+      size_t step = (size_t(1) << shift) / TBufferPool::kNSubClasses;
+      size_t sub = (size - (size_t(1) << shift) + step - 1) / step;
+      return (shift - TBufferPool::kMinShift) * TBufferPool::kNSubClasses + (Int_t)sub;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a buffer of at least size bytes. size is set to the actual size
+/// of the buffer, which must be given back to Release.
+
+char *TBufferPool::Acquire(size_t &size)
+{
+   ++gNAcquired;
+   Int_t c = ClassOf(size);
+   if (c < 0) return new char[size];
+   size = ClassSize(c);
+
+   TLocalPool *local = GetLocalPool();
+   if (local && local->fN[c] > 0) {
+      ++gNReused;
+      gRetained -= size;
+      return local->fBuffers[c][--local->fN[c]];
+   }
+   TGlobalPool &global = GetGlobalPool();
+   {
+      std::lock_guard<std::mutex> lock(global.fMutex);
+      if (!global.fBuffers[c].empty()) {
+         char *buf = global.fBuffers[c].back();
+         global.fBuffers[c].pop_back();
+         ++gNReused;
+         gRetained -= size;
+         return buf;
+      }
+   }
+   return new char[size];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give back a buffer allocated with new char[] of at least size bytes,
+/// usually obtained from Acquire. The buffer is kept if size is the size
+/// of a size class and the cap on the retained memory is not reached,
+/// otherwise it is freed.
+
+void TBufferPool::Release(char *buf, size_t size)
+{
+   if (!buf) return;
+   Int_t c = ClassOf(size);
+   Bool_t keep = (c >= 0 && ClassSize(c) == size);
+   // Reserve the bytes under the cap atomically, concurrent releases must
+   // not exceed it together.
+   Long64_t retained = gRetained;
+   while (keep) {
+      if (retained + (Long64_t)size > gMaxRetained) {
+         keep = kFALSE;
+      } else if (gRetained.compare_exchange_weak(retained, retained + (Long64_t)size)) {
+         break;
+      }
+   }
+   if (!keep) {
+      ++gNFreed;
+      delete [] buf;
+      return;
+   }
+   ++gNReleased;
+
+   TLocalPool *local = GetLocalPool();
+   if (local && local->fN[c] < kNLocal) {
+      local->fBuffers[c][local->fN[c]++] = buf;
+      return;
+   }
+   TGlobalPool &global = GetGlobalPool();
+   std::lock_guard<std::mutex> lock(global.fMutex);
+   global.fBuffers[c].push_back(buf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reallocate (i.e. resize) array of chars, like TStorage::ReAllocChar,
+/// but taking the buffers from the pool and giving them back to it.
+/// ovp must have been allocated with at least oldsize bytes.
+
+char *TBufferPool::ReAllocChar(char *ovp, size_t size, size_t oldsize)
+{
+   if (ovp && oldsize == size)
+      return ovp;
+
+   size_t capacity = size;
+   char *vp = Acquire(capacity);
+   size_t ncopy = 0;
+   if (ovp) {
+      ncopy = oldsize < size ? oldsize : size;
+      memcpy(vp, ovp, ncopy);
+      Release(ovp, oldsize);
+   }
+   memset(vp + ncopy, 0, size - ncopy);
+   return vp;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Free the buffers kept by the global pool and by the current thread.
+
+void TBufferPool::Clear()
+{
+   TLocalPool *local = GetLocalPool();
+   if (local) {
+      for (Int_t c = 0; c < kNClasses; ++c) {
+         for (Int_t i = 0; i < local->fN[c]; ++i) {
+            gRetained -= ClassSize(c);
+            delete [] local->fBuffers[c][i];
+         }
+         local->fN[c] = 0;
+      }
+   }
+   TGlobalPool &global = GetGlobalPool();
+   std::lock_guard<std::mutex> lock(global.fMutex);
+   for (Int_t c = 0; c < kNClasses; ++c) {
+      for (size_t i = 0; i < global.fBuffers[c].size(); ++i) {
+         gRetained -= ClassSize(c);
+         delete [] global.fBuffers[c][i];
+      }
+      global.fBuffers[c].clear();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum number of bytes kept by the pool.
+
+Long64_t TBufferPool::GetMaxRetainedBytes()
+{
+   return gMaxRetained;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes currently kept by the pool, by all threads.
+
+Long64_t TBufferPool::GetRetainedBytes()
+{
+   return gRetained;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of bytes kept by the pool; 0 disables the reuse
+/// of the buffers. If more bytes are already kept, the pool is cleared.
+
+void TBufferPool::SetMaxRetainedBytes(Long64_t max)
+{
+   gMaxRetained = max;
+   if (gRetained > max) Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers acquired.
+
+ULong64_t TBufferPool::GetNAcquired()
+{
+   return gNAcquired;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers acquired which were taken from the pool.
+
+ULong64_t TBufferPool::GetNReused()
+{
+   return gNReused;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers released which were kept by the pool.
+
+ULong64_t TBufferPool::GetNReleased()
+{
+   return gNReleased;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers released which were freed, because of
+/// their size or of the cap on the retained memory.
+
+ULong64_t TBufferPool::GetNFreed()
+{
+   return gNFreed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the counters of acquired, reused, released and freed buffers.
+
+void TBufferPool::ResetStatistics()
+{
+   gNAcquired = 0;
+   gNReused = 0;
+   gNReleased = 0;
+   gNFreed = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the pool.
+
+void TBufferPool::Print()
+{
+   Printf("TBufferPool: %lld bytes retained, maximum %lld bytes",
+          (Long64_t)gRetained, (Long64_t)gMaxRetained);
+   Printf("   buffers acquired: %llu, reused from the pool: %llu",
+          (ULong64_t)gNAcquired, (ULong64_t)gNReused);
+   Printf("   buffers released: %llu kept, %llu freed",
+          (ULong64_t)gNReleased, (ULong64_t)gNFreed);
+}
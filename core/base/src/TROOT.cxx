@@ -125,6 +125,7 @@ char *dlerror() {
 #include "TMap.h"
 #include "TObjString.h"
 #include "TVirtualMutex.h"
+#include "TVirtualRWMutex.h"
 #include "TInterpreter.h"
 #include "TListOfTypes.h"
 #include "TListOfDataMembers.h"
@@ -455,6 +456,22 @@ namespace Internal {
 #endif
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Returns the number of threads of the implicit multi-threading pool, or 0
+   /// if it was never enabled.
+   UInt_t GetImplicitMTPoolSize()
+   {
+#ifdef R__USE_IMT
+      static UInt_t (*sym)() = (UInt_t(*)())Internal::GetSymInLibThread("ROOT_TImplicitMT_GetImplicitMTPoolSize");
+      if (sym)
+         return sym();
+      else
+         return 0;
+#else
+      return 0;
+#endif
+   }
+
 }
 
 TROOT *ROOT::Internal::gROOTLocal = ROOT::GetROOT();
@@ -1055,7 +1072,7 @@ TObject *TROOT::FindObject(const char *name) const
    temp   = fFiles->FindObject(name);       if (temp) return temp;
    temp   = fMappedFiles->FindObject(name); if (temp) return temp;
    {
-      R__LOCKGUARD2(gROOTMutex);
+      R__READ_LOCKGUARD(gCoreMutex);
       temp   = fFunctions->FindObject(name);   if (temp) return temp;
    }
    temp   = fGeometries->FindObject(name);  if (temp) return temp;
@@ -1110,7 +1127,7 @@ TObject *TROOT::FindSpecialObject(const char *name, void *&where)
       where = fMappedFiles;
    }
    if (!temp) {
-      R__LOCKGUARD2(gROOTMutex);
+      R__READ_LOCKGUARD(gCoreMutex);
       temp  = fFunctions->FindObject(name);
       where = fFunctions;
    }
@@ -1167,7 +1184,7 @@ TObject *TROOT::FindObjectAny(const char *name) const
 
 TObject *TROOT::FindObjectAnyFile(const char *name) const
 {
-   R__LOCKGUARD(gROOTMutex);
+   R__READ_LOCKGUARD(gCoreMutex);
    TDirectory *d;
    TIter next(GetListOfFiles());
    while ((d = (TDirectory*)next())) {
@@ -1301,7 +1318,7 @@ TDataType *TROOT::GetType(const char *name, Bool_t /* load */) const
 
 TFile *TROOT::GetFile(const char *name) const
 {
-   R__LOCKGUARD(gROOTMutex);
+   R__READ_LOCKGUARD(gCoreMutex);
    return (TFile*)GetListOfFiles()->FindObject(name);
 }
 
@@ -1323,7 +1340,7 @@ TObject *TROOT::GetFunction(const char *name) const
    }
 
    {
-      R__LOCKGUARD2(gROOTMutex);
+      R__READ_LOCKGUARD(gCoreMutex);
       TObject *f1 = fFunctions->FindObject(name);
       if (f1) return f1;
    }
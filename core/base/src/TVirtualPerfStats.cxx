@@ -18,6 +18,8 @@ and event tracing.
 #include "TVirtualPerfStats.h"
 #include "TThreadSlots.h"
 
+#include <chrono>
+
 
 ClassImp(TVirtualPerfStats)
 
@@ -46,6 +48,16 @@ TVirtualPerfStats *&TVirtualPerfStats::CurrentPerfStats()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the time in seconds of a monotonic clock, from an arbitrary origin.
+/// Unlike TTimeStamp it takes no lock, so that it can time the events of
+/// each entry read by several threads.
+
+Double_t TVirtualPerfStats::GetSteadyTime()
+{
+   return std::chrono::duration<Double_t>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the name of the event type.
 
@@ -0,0 +1,47 @@
+// @(#)root/base:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TVirtualRWMutex
+
+This class implements a reader/writer mutex interface. Any number of
+threads can hold the read lock at the same time while the write lock is
+exclusive. Lock() and UnLock() take and release the write lock, hence a
+TVirtualRWMutex can be used wherever a TVirtualMutex is expected, e.g.
+with R__LOCKGUARD. The actual work is done via TRWMutex which is
+available as soon as the thread library is loaded.
+
+and
+
+TReadLockGuard, TWriteLockGuard
+
+These classes provide the same exception safe resource management as
+TLockGuard, for respectively the read lock and the write lock:
+~~~ {.cpp}
+{
+   R__READ_LOCKGUARD(gCoreMutex);
+   ... // only look at the shared data
+}
+~~~
+A read locked section must not take the write lock of the same mutex,
+either directly or through R__LOCKGUARD(gROOTMutex) or
+R__LOCKGUARD(gInterpreterMutex): two threads doing so at the same time
+would wait for each other.
+*/
+
+#include "TVirtualRWMutex.h"
+
+ClassImp(TVirtualRWMutex)
+ClassImp(TReadLockGuard)
+ClassImp(TWriteLockGuard)
+
+// Reader/writer mutex set in TThread::Init. gROOTMutex and
+// gInterpreterMutex point to it, so that the code only reading the
+// lists they protect can take the read lock instead.
+TVirtualRWMutex *gCoreMutex = 0;
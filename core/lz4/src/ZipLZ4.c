@@ -0,0 +1,90 @@
+// @(#)root/lz4:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipLZ4.h"
+#include "lz4.h"
+#include "lz4hc.h"
+#include <stdio.h>
+
+static const int kHeaderSize = 9;
+
+/* Compression levels 1 to 3 use the fast LZ4 compressor, higher levels use
+   the LZ4HC compressor.  Both produce the same block format, hence the
+   decompression speed does not depend on the level used for writing. */
+static const int kMinHCLevel = 4;
+
+void R__zipLZ4(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+   int out_size;                  /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+   int capacity;
+
+   *irep = 0;
+
+   if (*tgtsize <= kHeaderSize) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   capacity = *tgtsize - kHeaderSize;
+   if (cxlevel > 9) cxlevel = 9;
+   if (cxlevel >= kMinHCLevel) {
+      out_size = LZ4_compress_HC(src, &tgt[kHeaderSize], *srcsize, capacity, cxlevel);
+   } else {
+      out_size = LZ4_compress_default(src, &tgt[kHeaderSize], *srcsize, capacity);
+   }
+   if (out_size <= 0) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'L';  /* Signature of LZ4 block format */
+   tgt[1] = '4';
+   tgt[2] = 1;    /* Method: plain LZ4 block */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = out_size + kHeaderSize;
+}
+
+void R__unzipLZ4(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   int returnStatus;
+
+   *irep = 0;
+
+   if (*srcsize <= kHeaderSize) {
+      fprintf(stderr, "R__unzipLZ4: too small source\n");
+      return;
+   }
+
+   returnStatus = LZ4_decompress_safe((const char *)(&src[kHeaderSize]), (char *)tgt,
+                                      *srcsize - kHeaderSize, *tgtsize);
+   if (returnStatus < 0) {
+      fprintf(stderr,
+              "R__unzipLZ4: error %d in LZ4_decompress_safe\n",
+              returnStatus);
+      return;
+   }
+
+   *irep = returnStatus;
+}
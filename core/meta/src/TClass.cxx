@@ -69,6 +69,7 @@ a 'using namespace std;' has been applied to and with:
 #include "TVirtualIsAProxy.h"
 #include "TVirtualRefProxy.h"
 #include "TVirtualMutex.h"
+#include "TVirtualRWMutex.h"
 #include "TVirtualPad.h"
 #include "THashTable.h"
 #include "TSchemaRuleSet.h"
@@ -78,8 +79,10 @@ a 'using namespace std;' has been applied to and with:
 #include "TSystem.h"
 #include "TThreadSlots.h"
 
+#include <atomic>
 #include <cstdio>
 #include <cctype>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -419,6 +422,152 @@ namespace ROOT {
    };
 }
 
+namespace ROOT {
+namespace Internal {
+   class TLoadedClassMap {
+      // Map of the fully loaded classes, by name (or std::type_info name),
+      // readable without any lock.  The buckets are chained lists to which
+      // nodes are only ever prepended; removing a class only clears the
+      // pointer of its node.  The writers are serialized by fWriteMutex.
+      // Only the classes whose initialization is complete are published,
+      // so a reader can use the TClass right away.
+      //
+      // The table starts with about one bucket per class expected, and
+      // doubles when there are more nodes than buckets.  The new table gets
+      // copies of the nodes, the previous tables and their nodes are never
+      // deleted since a reader may still be walking them.  The memory is
+      // bounded nevertheless: there is one node per name ever published,
+      // and all the previous tables together are smaller than the current
+      // one.
+
+      struct TNode {
+         std::string          fName;
+         std::atomic<TClass*> fClass;
+         TNode               *fNext;  // Immutable once the node is published.
+         TNode(const std::string &name, TClass *cl, TNode *next) : fName(name), fClass(cl), fNext(next) {}
+      };
+
+      struct TTable {
+         UInt_t               fMask;     // Number of buckets minus 1, the number of buckets is a power of 2.
+         std::atomic<TNode*> *fBuckets;
+         TTable              *fPrevious; // Table replaced by this one, kept for the readers.
+         TTable(UInt_t nbuckets, TTable *previous) : fMask(nbuckets - 1), fBuckets(new std::atomic<TNode*>[nbuckets]), fPrevious(previous) {
+            for (UInt_t i = 0; i < nbuckets; ++i) fBuckets[i].store(0, std::memory_order_relaxed);
+         }
+      };
+
+      static const UInt_t kMinBuckets = 256;
+      std::atomic<TTable*> fTable;
+      UInt_t               fNnodes;     // Protected by fWriteMutex.
+      std::mutex           fWriteMutex;
+
+      static UInt_t Hash(const char *name) {
+         return TString::Hash(name, strlen(name));
+      }
+
+      static TNode *FindNode(const TTable *table, const char *name, UInt_t hash) {
+         for (TNode *node = table->fBuckets[hash & table->fMask].load(std::memory_order_acquire); node; node = node->fNext) {
+            if (strcmp(node->fName.c_str(), name) == 0) return node;
+         }
+         return 0;
+      }
+
+      // Replace the table by one twice larger.  Must be called with fWriteMutex taken.
+      TTable *Grow(TTable *table) {
+         TTable *grown = new TTable(2 * (table->fMask + 1), table);
+         for (UInt_t i = 0; i <= table->fMask; ++i) {
+            for (TNode *node = table->fBuckets[i].load(std::memory_order_relaxed); node; node = node->fNext) {
+               std::atomic<TNode*> &bucket = grown->fBuckets[Hash(node->fName.c_str()) & grown->fMask];
+               bucket.store(new TNode(node->fName, node->fClass.load(std::memory_order_relaxed), bucket.load(std::memory_order_relaxed)),
+                            std::memory_order_relaxed);
+            }
+         }
+         fTable.store(grown, std::memory_order_release);
+         return grown;
+      }
+
+   public:
+      TLoadedClassMap(UInt_t expected) : fNnodes(0) {
+         UInt_t nbuckets = kMinBuckets;
+         while (nbuckets < expected) nbuckets *= 2;
+         fTable.store(new TTable(nbuckets, 0), std::memory_order_relaxed);
+      }
+
+      TClass *Find(const char *name) const {
+         TNode *node = FindNode(fTable.load(std::memory_order_acquire), name, Hash(name));
+         return node ? node->fClass.load(std::memory_order_acquire) : 0;
+      }
+
+      void Add(const char *name, TClass *cl) {
+         std::lock_guard<std::mutex> lock(fWriteMutex);
+         TTable *table = fTable.load(std::memory_order_relaxed);
+         UInt_t hash = Hash(name);
+         TNode *node = FindNode(table, name, hash);
+         if (node) {
+            node->fClass.store(cl, std::memory_order_release);
+            return;
+         }
+         if (fNnodes > table->fMask) table = Grow(table);
+         std::atomic<TNode*> &bucket = table->fBuckets[hash & table->fMask];
+         bucket.store(new TNode(name, cl, bucket.load(std::memory_order_relaxed)), std::memory_order_release);
+         ++fNnodes;
+      }
+
+      void Remove(const char *name, TClass *cl) {
+         std::lock_guard<std::mutex> lock(fWriteMutex);
+         TNode *node = FindNode(fTable.load(std::memory_order_relaxed), name, Hash(name));
+         if (node && node->fClass.load(std::memory_order_relaxed) == cl) {
+            node->fClass.store(0, std::memory_order_release);
+         }
+      }
+   };
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the lock-free map of the loaded classes by name.
+
+static ROOT::Internal::TLoadedClassMap &GetLoadedClassMap()
+{
+   static ROOT::Internal::TLoadedClassMap *gLoadedClassMap =
+      new ROOT::Internal::TLoadedClassMap(gClassTable ? gClassTable->Classes() : 0);
+   return *gLoadedClassMap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the lock-free map of the loaded classes by std::type_info name.
+
+static ROOT::Internal::TLoadedClassMap &GetLoadedTypeIdMap()
+{
+   static ROOT::Internal::TLoadedClassMap *gLoadedTypeIdMap =
+      new ROOT::Internal::TLoadedClassMap(gClassTable ? gClassTable->Classes() : 0);
+   return *gLoadedTypeIdMap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make cl, which is loaded and whose initialization is complete, visible
+/// to the lock-free lookups of TClass::GetClass.  Must be called with
+/// gInterpreterMutex taken.
+
+static void R__PublishLoadedClass(TClass *cl)
+{
+   GetLoadedClassMap().Add(cl->GetName(), cl);
+   if (cl->GetTypeInfo()) {
+      GetLoadedTypeIdMap().Add(cl->GetTypeInfo()->name(), cl);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove cl from the lock-free lookups of TClass::GetClass.
+
+static void R__UnpublishLoadedClass(TClass *cl)
+{
+   GetLoadedClassMap().Remove(cl->GetName(), cl);
+   if (cl->GetTypeInfo()) {
+      GetLoadedTypeIdMap().Remove(cl->GetTypeInfo()->name(), cl);
+   }
+}
+
 IdMap_t *TClass::GetIdMap() {
 
 #ifdef R__COMPLETE_MEM_TERMINATION
@@ -475,6 +624,7 @@ void TClass::RemoveClass(TClass *oldcl)
    if (!oldcl) return;
 
    R__LOCKGUARD2(gInterpreterMutex);
+   R__UnpublishLoadedClass(oldcl);
    gROOT->GetListOfClasses()->Remove(oldcl);
    if (oldcl->GetTypeInfo()) {
       GetIdMap()->Remove(oldcl->GetTypeInfo()->name());
@@ -1558,6 +1708,10 @@ void TClass::Init(const char *name, Version_t cversion,
 
 TClass::~TClass()
 {
+   // Stop the lock-free lookups of TClass::GetClass from returning this
+   // class before anything is torn down.
+   R__UnpublishLoadedClass(this);
+
    R__LOCKGUARD(gInterpreterMutex);
 
    // Remove from the typedef hashtables.
@@ -2798,6 +2952,9 @@ TVirtualIsAProxy* TClass::GetIsAProxy() const
 /// If silent is 'true', do not warn about missing dictionary for the class.
 /// (typically used for class that are used only for transient members)
 /// Returns 0 in case class is not found.
+///
+/// A class which is already loaded, requested by its normalized name, is
+/// found without taking any lock.
 
 TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
 {
@@ -2807,6 +2964,20 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
    if (strncmp(name,"class ",6)==0) name += 6;
    if (strncmp(name,"struct ",7)==0) name += 7;
 
+   // The classes already loaded are found without taking any lock.
+   if (TClass *loadedcl = GetLoadedClassMap().Find(name)) return loadedcl;
+
+   // Then the list of classes, which can be searched by several threads
+   // at once.
+   {
+      R__READ_LOCKGUARD(gCoreMutex);
+      TClass *cl = gROOT->GetListOfClasses() ? (TClass*)gROOT->GetListOfClasses()->FindObject(name) : 0;
+      if (cl && cl->IsLoaded() && !cl->TestBit(kLoading)) {
+         R__PublishLoadedClass(cl);
+         return cl;
+      }
+   }
+
    R__LOCKGUARD(gInterpreterMutex);
 
    if (!gROOT->GetListOfClasses())  return 0;
@@ -2816,7 +2987,12 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
    // Early return to release the lock without having to execute the
    // long-ish normalization.
    if (cl) {
-      if (cl->IsLoaded() || cl->TestBit(kUnloading)) return cl;
+      if (cl->IsLoaded() || cl->TestBit(kUnloading)) {
+         // Once its initialization is complete, the next lookups of this
+         // class can skip the lock (kLoading and kUnloading are the same bit).
+         if (!cl->TestBit(kLoading)) R__PublishLoadedClass(cl);
+         return cl;
+      }
 
       // We could speed-up some of the search by adding (the equivalent of)
       //
@@ -2982,6 +3158,9 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
 
 TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /* silent */)
 {
+   // The classes already loaded are found without taking any lock.
+   if (TClass *loadedcl = GetLoadedTypeIdMap().Find(typeinfo.name())) return loadedcl;
+
    //protect access to TROOT::GetListOfClasses
    R__LOCKGUARD2(gInterpreterMutex);
 
@@ -2990,7 +3169,10 @@ TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /*
    TClass* cl = GetIdMap()->Find(typeinfo.name());
 
    if (cl) {
-      if (cl->IsLoaded()) return cl;
+      if (cl->IsLoaded()) {
+         if (!cl->TestBit(kLoading)) R__PublishLoadedClass(cl);
+         return cl;
+      }
       //we may pass here in case of a dummy class created by TVirtualStreamerInfo
       load = kTRUE;
    } else {
@@ -5760,6 +5942,7 @@ void TClass::SetUnloaded()
       // Don't redo the work.
       return;
    }
+   R__UnpublishLoadedClass(this);
    SetBit(kUnloading);
 
    //R__ASSERT(fState == kLoaded);
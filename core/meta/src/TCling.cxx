@@ -51,6 +51,7 @@ clang/LLVM technology.
 #include "TVirtualPad.h"
 #include "TSystem.h"
 #include "TVirtualMutex.h"
+#include "TVirtualRWMutex.h"
 #include "TError.h"
 #include "TEnv.h"
 #include "TEnum.h"
@@ -1869,7 +1870,7 @@ Long_t TCling::ProcessLine(const char* line, EErrorCode* error/*=0*/)
             if (gGlobalMutex && !gInterpreterMutex && fLockProcessLine) {
                gGlobalMutex->Lock();
                if (!gInterpreterMutex)
-                  gInterpreterMutex = gGlobalMutex->Factory(kTRUE);
+                  gInterpreterMutex = gCoreMutex ? gCoreMutex : gGlobalMutex->Factory(kTRUE);
                gGlobalMutex->UnLock();
             }
             R__LOCKGUARD(fLockProcessLine ? gInterpreterMutex : 0);
@@ -1886,7 +1887,7 @@ Long_t TCling::ProcessLine(const char* line, EErrorCode* error/*=0*/)
    if (gGlobalMutex && !gInterpreterMutex && fLockProcessLine) {
       gGlobalMutex->Lock();
       if (!gInterpreterMutex)
-         gInterpreterMutex = gGlobalMutex->Factory(kTRUE);
+         gInterpreterMutex = gCoreMutex ? gCoreMutex : gGlobalMutex->Factory(kTRUE);
       gGlobalMutex->UnLock();
    }
    R__LOCKGUARD(fLockProcessLine ? gInterpreterMutex : 0);
@@ -20,7 +20,8 @@ THREADDH     := $(THREADDS:.cxx=.h)
 
 THREADH      := $(MODDIRI)/TCondition.h $(MODDIRI)/TConditionImp.h \
                 $(MODDIRI)/TMutex.h $(MODDIRI)/TMutexImp.h \
-                $(MODDIRI)/TRWLock.h $(MODDIRI)/TSemaphore.h \
+                $(MODDIRI)/TRWLock.h $(MODDIRI)/TRWMutex.h \
+                $(MODDIRI)/TSemaphore.h \
                 $(MODDIRI)/TThread.h $(MODDIRI)/TThreadFactory.h \
                 $(MODDIRI)/TThreadImp.h $(MODDIRI)/TAtomicCount.h \
                 $(MODDIRI)/TThreadPool.h $(MODDIRI)/ThreadLocalStorage.h
@@ -39,7 +40,8 @@ endif
 
 THREADS      := $(MODDIRS)/TCondition.cxx $(MODDIRS)/TConditionImp.cxx \
                 $(MODDIRS)/TMutex.cxx $(MODDIRS)/TMutexImp.cxx \
-                $(MODDIRS)/TRWLock.cxx $(MODDIRS)/TSemaphore.cxx \
+                $(MODDIRS)/TRWLock.cxx $(MODDIRS)/TRWMutex.cxx \
+                $(MODDIRS)/TSemaphore.cxx \
                 $(MODDIRS)/TThread.cxx $(MODDIRS)/TThreadFactory.cxx \
                 $(MODDIRS)/TThreadImp.cxx
 ifneq ($(ARCH),win32)
@@ -34,6 +34,7 @@
 #pragma link C++ class TThreadFactory;
 #pragma link C++ class TThreadImp;
 #pragma link C++ class TRWLock;
+#pragma link C++ class TRWMutex;
 #pragma link C++ class TAtomicCount;
 
 #endif
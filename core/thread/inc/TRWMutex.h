@@ -0,0 +1,90 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TRWMutex
+#define ROOT_TRWMutex
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TRWMutex                                                             //
+//                                                                      //
+// This class implements a recursive reader/writer mutex. Readers only  //
+// touch a counter in a per-thread slot, so that they do not contend    //
+// with each other. A read lock cannot be upgraded to the write lock.   //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TVirtualRWMutex
+#include "TVirtualRWMutex.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+class TRWMutex : public TVirtualRWMutex {
+
+public:
+   enum { kNSlots = 64 };   // Number of reader slots, the threads share them modulo kNSlots
+
+private:
+   struct TSlot {
+      std::atomic<Int_t> fReaders;                            // Number of read locks held by the threads of this slot
+      char               fPad[64 - sizeof(std::atomic<Int_t>)]; // Keep the slots in different cache lines
+   };
+
+   TSlot                    fSlots[kNSlots];       // Reader slots
+   std::atomic<Bool_t>      fWriterActive;         // True while a writer holds, or is taking, the write lock
+   std::atomic<std::thread::id> fOwner;            // Thread holding the write lock
+   Int_t                    fWriteRecurse;         // Recursion level of the write lock
+   std::mutex               fWriteMutex;           // Serializes the writers
+   std::mutex               fWaitMutex;            // Protects the waiting of the readers on fWriterDone
+   std::condition_variable  fWriterDone;           // Signaled when fWriterActive goes back to false
+   std::atomic<Bool_t>      fWriterWaiting;        // True while a writer waits on fReadersDone
+   std::condition_variable  fReadersDone;          // Signaled when a reader leaves while a writer waits
+   std::atomic<ULong64_t>   fNReadContentions;     // Number of read locks which had to wait for a writer
+   std::atomic<ULong64_t>   fNWriteContentions;    // Number of write locks which had to wait
+
+   TRWMutex(const TRWMutex&);              // not implemented
+   TRWMutex& operator=(const TRWMutex&);   // not implemented
+
+   static Int_t GetSlot();
+   Int_t       &GetLocalReadCount() const;
+   Int_t        GetNReaders() const;
+   void         ReleaseWriterFlag();
+   void         NotifyWriter();
+
+public:
+   TRWMutex();
+   virtual ~TRWMutex() { }
+
+   Int_t  ReadLock();
+   Int_t  ReadUnLock();
+   Int_t  WriteLock();
+   Int_t  WriteUnLock();
+
+   Int_t  TryLock();
+   Int_t  CleanUp();
+
+   ULong64_t GetNReadContentions() const { return fNReadContentions; }
+   ULong64_t GetNWriteContentions() const { return fNWriteContentions; }
+   void      ResetContentionCounters();
+
+   TVirtualMutex *Factory(Bool_t recursive = kFALSE);
+
+   void   Print(Option_t *option="") const;
+
+   ClassDef(TRWMutex,0)  // Recursive reader/writer mutex with per-thread reader slots
+};
+
+#endif
@@ -36,6 +36,12 @@ static bool &GetIMTFlag()
    return enabled;
 }
 
+static UInt_t &GetImplicitMTPoolSize()
+{
+   static UInt_t size = 0;
+   return size;
+}
+
 extern "C" void ROOT_TImplicitMT_EnableImplicitMT(UInt_t numthreads)
 {
    if (!GetIMTFlag()) {
@@ -43,9 +49,10 @@ extern "C" void ROOT_TImplicitMT_EnableImplicitMT(UInt_t numthreads)
          TThread::Initialize();
 
          if (numthreads == 0)
-            numthreads = tbb::task_scheduler_init::automatic;
+            numthreads = tbb::task_scheduler_init::default_num_threads();
 
          GetScheduler().initialize(numthreads);
+         GetImplicitMTPoolSize() = numthreads;
       }
       GetIMTFlag() = true;
    }
@@ -69,3 +76,7 @@ extern "C" bool ROOT_TImplicitMT_IsImplicitMTEnabled()
    return GetIMTFlag();
 };
 
+extern "C" UInt_t ROOT_TImplicitMT_GetImplicitMTPoolSize()
+{
+   return GetImplicitMTPoolSize();
+};
@@ -0,0 +1,314 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TRWMutex
+
+This class implements a recursive reader/writer mutex.
+
+Each thread is assigned one of kNSlots reader slots. Taking the read lock
+only increments the counter of the slot of the calling thread and checks
+that no writer is active, so that readers running in different threads
+do not write to a shared cache line. A writer first announces itself,
+which makes the new readers wait, then sleeps on a condition variable
+until the readers already in are gone; they only signal it when they see
+it waiting. Writers are therefore rare and expensive while readers are
+cheap, which matches the use of gCoreMutex: the lists of files and of
+classes are looked up much more often than they are modified.
+
+A writer cannot be starved by a continuous flow of readers: once it is
+announced, only the threads which already hold the read lock can take it
+again (they would deadlock otherwise), so its wait is bounded by the
+longest read locked section in progress. The writers among themselves are
+served in the order of fWriteMutex.
+
+Both locks are recursive. A thread holding the write lock can take the
+read lock. The reverse, upgrading a read lock to the write lock, is
+forbidden: two threads doing so at the same time would wait for each
+other forever. WriteLock() calls Fatal() if the current thread holds the
+read lock and TryLock() fails.
+
+The number of read locks which had to wait for a writer and of write
+locks which had to wait for readers or another writer are counted, see
+GetNReadContentions(), GetNWriteContentions() and Print().
+*/
+
+#include "TRWMutex.h"
+#include "ThreadLocalStorage.h"
+#include "TError.h"
+#include "TString.h"
+
+#include <errno.h>
+
+ClassImp(TRWMutex)
+
+namespace {
+
+   // Read locks held by the current thread on one TRWMutex.
+   struct TLocalReadCount_t {
+      const TRWMutex *fMutex;
+      Int_t           fCount;
+   };
+
+   const Int_t kNLocalReadCounts = 16;
+
+   std::atomic<Int_t> gRWMutexNextSlot(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a reader/writer mutex.
+
+TRWMutex::TRWMutex() : fWriterActive(kFALSE), fOwner(std::thread::id()), fWriteRecurse(0),
+                       fWriterWaiting(kFALSE), fNReadContentions(0), fNWriteContentions(0)
+{
+   for (Int_t i = 0; i < kNSlots; ++i)
+      fSlots[i].fReaders = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the reader slot of the current thread.
+
+Int_t TRWMutex::GetSlot()
+{
+   TTHREAD_TLS(Int_t) slot = -1;
+   if (slot < 0)
+      slot = gRWMutexNextSlot++ % kNSlots;
+   return slot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of read locks held by the current thread on this mutex.
+
+Int_t &TRWMutex::GetLocalReadCount() const
+{
+   TTHREAD_TLS_ARRAY(TLocalReadCount_t, kNLocalReadCounts, counts);
+   TLocalReadCount_t *unused = 0;
+   for (Int_t i = 0; i < kNLocalReadCounts; ++i) {
+      if (counts[i].fMutex == this)
+         return counts[i].fCount;
+      if (!unused && counts[i].fCount == 0)
+         unused = &counts[i];
+   }
+   if (!unused)
+      ::Fatal("TRWMutex::ReadLock", "a thread cannot hold the read lock of more than %d TRWMutex", kNLocalReadCounts);
+   unused->fMutex = this;
+   return unused->fCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of read locks currently held, by all threads.
+
+Int_t TRWMutex::GetNReaders() const
+{
+   Int_t n = 0;
+   for (Int_t i = 0; i < kNSlots; ++i)
+      n += fSlots[i].fReaders;
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset fWriterActive and wake up the readers waiting for it.
+
+void TRWMutex::ReleaseWriterFlag()
+{
+   {
+      std::lock_guard<std::mutex> lock(fWaitMutex);
+      fWriterActive = kFALSE;
+   }
+   fWriterDone.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wake up the writer waiting for the readers to leave, if any. Called after
+/// a reader counter is decremented.
+
+void TRWMutex::NotifyWriter()
+{
+   // The writer sets fWriterWaiting before checking the counters, under
+   // fWaitMutex: either it sees the decrement or we see it waiting.
+   if (fWriterWaiting) {
+      std::lock_guard<std::mutex> lock(fWaitMutex);
+      fReadersDone.notify_one();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the read lock. Waits only while a writer holds the write lock.
+/// Returns 0.
+
+Int_t TRWMutex::ReadLock()
+{
+   Int_t &local = GetLocalReadCount();
+   std::atomic<Int_t> &readers = fSlots[GetSlot()].fReaders;
+
+   if (local > 0 || fOwner == std::this_thread::get_id()) {
+      // Recursive read lock or read lock inside our own write lock: a
+      // writer might be waiting for us, do not wait for it.
+      ++readers;
+      ++local;
+      return 0;
+   }
+
+   while (1) {
+      ++readers;
+      if (!fWriterActive) break;
+      // A writer is active, step back until it is done.
+      --readers;
+      NotifyWriter();
+      ++fNReadContentions;
+      std::unique_lock<std::mutex> lock(fWaitMutex);
+      fWriterDone.wait(lock, [this] { return !fWriterActive; });
+   }
+   ++local;
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the read lock. Returns 0 when no error, EPERM when the current
+/// thread does not hold the read lock.
+
+Int_t TRWMutex::ReadUnLock()
+{
+   Int_t &local = GetLocalReadCount();
+   if (local <= 0) {
+      Error("ReadUnLock", "the read lock is not held by this thread");
+      return EPERM;
+   }
+   --local;
+   --fSlots[GetSlot()].fReaders;
+   NotifyWriter();
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the write lock. Waits for the other writers and for the readers.
+/// The current thread must not hold the read lock. Returns 0.
+
+Int_t TRWMutex::WriteLock()
+{
+   const std::thread::id self = std::this_thread::get_id();
+   if (fOwner == self) {
+      ++fWriteRecurse;
+      return 0;
+   }
+   if (GetLocalReadCount() > 0)
+      ::Fatal("TRWMutex::WriteLock", "the current thread holds the read lock, it cannot take the write lock");
+
+   Bool_t contended = kFALSE;
+   if (!fWriteMutex.try_lock()) {
+      contended = kTRUE;
+      fWriteMutex.lock();
+   }
+
+   // Stop the new readers, then let those already in finish. A reader
+   // increments its counter before checking fWriterActive and we set
+   // fWriterActive before reading the counters: either it steps back or
+   // we see it.
+   fWriterActive = kTRUE;
+   if (GetNReaders() != 0) {
+      contended = kTRUE;
+      std::unique_lock<std::mutex> lock(fWaitMutex);
+      fWriterWaiting = kTRUE;
+      fReadersDone.wait(lock, [this] { return GetNReaders() == 0; });
+      fWriterWaiting = kFALSE;
+   }
+
+   fOwner = self;
+   fWriteRecurse = 1;
+   if (contended) ++fNWriteContentions;
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the write lock. Returns 0 when no error, EPERM when the current
+/// thread does not hold the write lock.
+
+Int_t TRWMutex::WriteUnLock()
+{
+   if (fOwner != std::this_thread::get_id()) {
+      Error("WriteUnLock", "the write lock is not held by this thread");
+      return EPERM;
+   }
+   if (--fWriteRecurse > 0)
+      return 0;
+
+   fOwner = std::thread::id();
+   ReleaseWriterFlag();
+   fWriteMutex.unlock();
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Try to take the write lock without waiting. Returns 0 when the lock was
+/// taken, EBUSY otherwise, in particular when the current thread holds the
+/// read lock.
+
+Int_t TRWMutex::TryLock()
+{
+   const std::thread::id self = std::this_thread::get_id();
+   if (fOwner == self) {
+      ++fWriteRecurse;
+      return 0;
+   }
+   if (GetLocalReadCount() > 0 || !fWriteMutex.try_lock())
+      return EBUSY;
+
+   if (GetNReaders() == 0) {
+      fWriterActive = kTRUE;
+      if (GetNReaders() == 0) {
+         fOwner = self;
+         fWriteRecurse = 1;
+         return 0;
+      }
+      ReleaseWriterFlag();
+   }
+   fWriteMutex.unlock();
+   return EBUSY;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the write lock if it is held by the current thread, whatever
+/// its recursion level. Returns 0.
+
+Int_t TRWMutex::CleanUp()
+{
+   if (fOwner == std::this_thread::get_id()) {
+      fWriteRecurse = 1;
+      WriteUnLock();
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the contention counters.
+
+void TRWMutex::ResetContentionCounters()
+{
+   fNReadContentions = 0;
+   fNWriteContentions = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a reader/writer mutex. TRWMutex is always recursive.
+
+TVirtualMutex *TRWMutex::Factory(Bool_t /* recursive */)
+{
+   return new TRWMutex();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the number of readers and the contention counters.
+
+void TRWMutex::Print(Option_t *) const
+{
+   Printf("TRWMutex: %d read locks held, write lock %s", GetNReaders(),
+          fWriterActive ? "held" : "free");
+   Printf("   read locks which waited for a writer: %llu", (ULong64_t)fNReadContentions);
+   Printf("   write locks which waited:             %llu", (ULong64_t)fNWriteContentions);
+}
@@ -30,6 +30,7 @@
 #include "TVirtualPad.h"
 #include "TMethodCall.h"
 #include "TMutex.h"
+#include "TRWMutex.h"
 #include "TTimeStamp.h"
 #include "TInterpreter.h"
 #include "TError.h"
@@ -330,6 +331,11 @@ void TThread::Init()
    gThreadXAR  = TThread::XARequest;
 
 
+   // Create the reader/writer mutex before gGlobalMutex: TCling creates
+   // gInterpreterMutex on demand once gGlobalMutex exists, and then uses
+   // gCoreMutex. gCoreMutex is therefore never null with threads enabled.
+   gCoreMutex = new TRWMutex();
+
    // Create the single global mutex
    gGlobalMutex = new TMutex(kTRUE);
    // We need to make sure that gCling is initialized.
@@ -337,12 +343,13 @@ void TThread::Init()
    gCling->SetAllocunlockfunc(CINT_alloc_unlock);
 
    //To avoid deadlocks, gInterpreterMutex and gROOTMutex need
-   // to point at the same instance
+   // to point at the same instance. It is a reader/writer mutex, so that
+   // the code which only looks up the lists it protects can take the read
+   // lock through gCoreMutex.
    {
      R__LOCKGUARD(gGlobalMutex);
-     if (!gInterpreterMutex) {
-       gInterpreterMutex = gGlobalMutex->Factory(kTRUE);
-     }
+     if (!gInterpreterMutex)
+       gInterpreterMutex = gCoreMutex;
      gROOTMutex = gInterpreterMutex;
    }
 }
@@ -26,6 +26,15 @@ namespace ROOT {
    // and memory when compressing.  LZMA memory usage is particularly
    // high for compression levels 8 and 9.
    //
+   // If ROOT was built with the corresponding libraries, the LZ4
+   // and Zstandard (ZSTD) algorithms are also available. LZ4 gives
+   // lower compression factors than ZLIB but decompresses many times
+   // faster; ZSTD compresses about as well as ZLIB and decompresses
+   // several times faster. They are well suited for data that is
+   // read back many times. Files can contain a mix of algorithms,
+   // each buffer is decompressed according to its own header.
+   // Requesting an algorithm that is not available falls back to ZLIB.
+   //
    // The current algorithms support level 1 to 9. The higher
    // the level the greater the compression and more CPU time
    // and memory resources used during compression. Level 0
@@ -34,6 +43,8 @@ namespace ROOT {
                                 kZLIB,
                                 kLZMA,
                                 kOldCompressionAlgo,
+                                kLZ4,
+                                kZSTD,
                                 // if adding new algorithm types,
                                 // keep this enum value last
                                 kUndefinedCompressionAlgorithm
@@ -18,12 +18,18 @@ extern "C" unsigned long R__memcompress(char *tgt, unsigned long tgtsize, char *
 
 extern "C" void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, int compressionAlgorithm);
 
+extern "C" int R__zipMultipleAlgorithmDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, int compressionAlgorithm, const char *dict, int dictsize);
+
 extern "C" void R__zip(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep);
 
 extern "C" void R__unzip(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep);
 
+extern "C" void R__unzipDict(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep, const unsigned char *dict, int dictsize);
+
 extern "C" int R__unzip_header(int *srcsize, unsigned char *src, int *tgtsize);
 
+extern "C" int R__trainDictionary(int compressionAlgorithm, int nsamples, const char *samples, const int *samplesizes, char *dict, int dictcapacity);
+
 enum { kMAXZIPBUF = 0xffffff };
 
 #endif
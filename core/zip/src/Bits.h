@@ -15,6 +15,12 @@
 #include "zlib.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#ifdef R__HAS_LZ4
+#include "ZipLZ4.h"
+#endif
+#ifdef R__HAS_ZSTD
+#include "ZipZSTD.h"
+#endif
 
 #include <stdio.h>
 #include <assert.h>
@@ -289,9 +295,15 @@ struct bits_internal_state {
    R__ZipMode = 2 : LZMA compression algorithm is used
    R__ZipMode = 0 or 3 : a very old compression algorithm is used
    (the very old algorithm is supported for backward compatibility)
+   R__ZipMode = 4 : LZ4 compression algorithm is used
+   R__ZipMode = 5 : Zstandard compression algorithm is used
    The LZMA algorithm requires the external XZ package be installed when linking
    is done. LZMA typically has significantly higher compression factors, but takes
    more CPU time and memory resources while compressing.
+   LZ4 and Zstandard require liblz4 and libzstd respectively. LZ4 trades compression
+   factor for very fast decompression; Zstandard reaches compression factors close
+   to ZLIB while decompressing several times faster. If ROOT was built without
+   support for one of them, ZLIB is used instead.
 */
 int R__ZipMode = 1;
 
@@ -558,6 +570,9 @@ local int R__mem_read(bits_internal_state *state,char *b, unsigned bsize)
 #define HDRSIZE 9
 /* static  __thread int error_flag; */
 
+int R__zipMultipleAlgorithmDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, int compressionAlgorithm,
+                                const char *dict, int dictsize);
+
 void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, int compressionAlgorithm)
      /* int cxlevel;                      compression level */
      /* int  *srcsize, *tgtsize, *irep;   source and target sizes, replay */
@@ -566,13 +581,28 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
      /*                      1 = zlib */
      /*                      2 = lzma */
      /*                      3 = old */
+     /*                      4 = lz4 */
+     /*                      5 = zstd */
+{
+  R__zipMultipleAlgorithmDict(cxlevel, srcsize, src, tgtsize, tgt, irep, compressionAlgorithm, 0, 0);
+}
+
+int R__zipMultipleAlgorithmDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, int compressionAlgorithm,
+                                const char *dict, int dictsize)
+     /* Same as R__zipMultipleAlgorithm, using dict as a preset dictionary */
+     /* when the algorithm supports it (zlib and zstd).  The same         */
+     /* dictionary must be passed to R__unzipDict to decompress the data. */
+     /* Other algorithms ignore the dictionary.                            */
+     /* Returns 0, also when the buffer is left uncompressed (*irep = 0), */
+     /* or the zlib error code if the dictionary cannot be used, in which */
+     /* case *irep = 0 and the caller reports the error.                  */
 {
   int err;
   int method   = Z_DEFLATED;
 
   if (cxlevel <= 0) {
     *irep = 0;
-    return;
+    return 0;
   }
 
   if (compressionAlgorithm == 0) {
@@ -582,8 +612,24 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
   // The LZMA compression algorithm from the XZ package
   if (compressionAlgorithm == 2) {
     R__zipLZMA(cxlevel, srcsize, src, tgtsize, tgt, irep);
-    return;
+    return 0;
+  }
+
+#ifdef R__HAS_LZ4
+  // The LZ4 compression algorithm
+  if (compressionAlgorithm == 4) {
+    R__zipLZ4(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return 0;
+  }
+#endif
+
+#ifdef R__HAS_ZSTD
+  // The Zstandard compression algorithm
+  if (compressionAlgorithm == 5) {
+    R__zipZSTDDict(cxlevel, srcsize, src, tgtsize, tgt, irep, dict, dictsize);
+    return 0;
   }
+#endif
 
   // The very old algorithm for backward compatibility
   // 0 for selecting with R__ZipMode in a backward compatible way
@@ -599,11 +645,11 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     /* error_flag   = 0; */
     if (*tgtsize <= 0) {
        R__error("target buffer too small");
-       return;
+       return 0;
     }
     if (*srcsize > 0xffffff) {
        R__error("source buffer too big");
-       return;
+       return 0;
     }
 
 #ifdef DYN_ALLOC
@@ -622,12 +668,12 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     state.out_offset  = HDRSIZE;
     state.R__window_size = 0L;
 
-    if (0 != R__bi_init(&state) ) return;       /* initialize bit routines */
+    if (0 != R__bi_init(&state) ) return 0;       /* initialize bit routines */
     state.t_state = R__get_thread_tree_state();
-    if (0 != R__ct_init(state.t_state,&att, &method)) return; /* initialize tree routines */
-    if (0 != R__lm_init(&state,level, &flags)) return; /* initialize compression */
+    if (0 != R__ct_init(state.t_state,&att, &method)) return 0; /* initialize tree routines */
+    if (0 != R__lm_init(&state,level, &flags)) return 0; /* initialize compression */
     R__Deflate(&state,&state.error_flag);                  /* compress data */
-    if (state.error_flag != 0) return;
+    if (state.error_flag != 0) return 0;
 
     tgt[0] = 'C';               /* Signature 'C'-Chernyaev, 'S'-Smirnov */
     tgt[1] = 'S';
@@ -643,7 +689,7 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     tgt[8] = (char)((state.in_size >> 16) & 0xff);
 
     *irep     = state.out_offset;
-    return;
+    return 0;
 
   // 1 is for ZLIB (which is the default), ZLIB is also used for any illegal
   // algorithm setting
@@ -657,11 +703,11 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     /* error_flag   = 0; */
     if (*tgtsize <= 0) {
        R__error("target buffer too small");
-       return;
+       return 0;
     }
     if (*srcsize > 0xffffff) {
        R__error("source buffer too big");
-       return;
+       return 0;
     }
 
     stream.next_in   = (Bytef*)src;
@@ -678,7 +724,15 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     err = deflateInit(&stream, cxlevel);
     if (err != Z_OK) {
        printf("error %d in deflateInit (zlib)\n",err);
-       return;
+       return 0;
+    }
+
+    if (dict && dictsize > 0) {
+       err = deflateSetDictionary(&stream, (const Bytef*)dict, (uInt)dictsize);
+       if (err != Z_OK) {
+          deflateEnd(&stream);
+          return err;
+       }
     }
 
     err = deflate(&stream, Z_FINISH);
@@ -688,7 +742,7 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
           the buffer cannot be compressed or compressed buffer would be larger than original buffer
           printf("error %d in deflate (zlib) is not = %d\n",err,Z_STREAM_END);
        */
-       return;
+       return 0;
     }
 
     err = deflateEnd(&stream);
@@ -708,7 +762,7 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     tgt[8] = (char)((l_in_size >> 16) & 0xff);
 
     *irep = stream.total_out + HDRSIZE;
-    return;
+    return 0;
   }
 }
 
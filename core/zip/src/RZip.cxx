@@ -10,10 +10,51 @@
  *************************************************************************/
 
 #include "RZip.h"
+#include "RConfigure.h"
 
 #include "zlib.h"
+#ifdef R__HAS_ZSTD
+extern "C" {
+#include "ZipZSTD.h"
+}
+#endif
+
+#include <string.h>
+
+extern "C" int R__ZipMode;
 
 unsigned long R__crc32(unsigned long crc, const unsigned char* buf, unsigned int len)
 {
    return crc32(crc, buf, len);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build a compression dictionary from nsamples buffers stored back to back
+/// in samples (samplesizes gives the length of each of them). The dictionary
+/// is written to dict and its size, at most dictcapacity, is returned.
+///
+/// For Zstandard a dictionary is trained on the samples; for the other
+/// algorithms, or if the training fails, the dictionary is the tail of the
+/// samples, which is where the compressor looks first for matches. ZLIB
+/// only uses the last 32 kB of a dictionary.
+
+int R__trainDictionary(int compressionAlgorithm, int nsamples, const char *samples, const int *samplesizes,
+                       char *dict, int dictcapacity)
+{
+   if (nsamples <= 0 || dictcapacity <= 0) return 0;
+   if (compressionAlgorithm == 0) compressionAlgorithm = R__ZipMode;
+
+#ifdef R__HAS_ZSTD
+   if (compressionAlgorithm == 5) {
+      int size = R__trainZSTD(nsamples, samples, samplesizes, dict, dictcapacity);
+      if (size > 0) return size;
+   }
+#endif
+
+   long total = 0;
+   for (int i = 0; i < nsamples; ++i) total += samplesizes[i];
+   long size = total < dictcapacity ? total : dictcapacity;
+   if (compressionAlgorithm != 5 && size > 32768) size = 32768;
+   memcpy(dict, samples + total - size, size);
+   return (int)size;
+}
@@ -20,6 +20,12 @@ static const int qflag = 0;
 #include "zlib.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#ifdef R__HAS_LZ4
+#include "ZipLZ4.h"
+#endif
+#ifdef R__HAS_ZSTD
+#include "ZipZSTD.h"
+#endif
 
 
 /* inflate.c -- put in the public domain by Mark Adler
@@ -1119,6 +1125,8 @@ int R__Inflate_free()
  ***********************************************************************/
 #define HDRSIZE 9
 
+void R__unzipDict(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep, const uch *dict, int dictsize);
+
 int R__unzip_header(int *srcsize, uch *src, int *tgtsize)
 {
   // Reads header envelope, and determines target size.
@@ -1130,7 +1138,9 @@ int R__unzip_header(int *srcsize, uch *src, int *tgtsize)
   /*   C H E C K   H E A D E R   */
   if (!(src[0] == 'Z' && src[1] == 'L' && src[2] == Z_DEFLATED) &&
       !(src[0] == 'C' && src[1] == 'S' && src[2] == Z_DEFLATED) &&
-      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0)) {
+      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0) &&
+      !(src[0] == 'L' && src[1] == '4' && src[2] == 1) &&
+      !(src[0] == 'Z' && src[1] == 'S' && src[2] == 1)) {
     fprintf(stderr, "Error R__unzip_header: error in header\n");
     return 1;
   }
@@ -1142,6 +1152,15 @@ int R__unzip_header(int *srcsize, uch *src, int *tgtsize)
 }
 
 void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
+{
+  R__unzipDict(srcsize, src, tgtsize, tgt, irep, 0, 0);
+}
+
+/* Same as R__unzip. If the buffer was compressed with a preset dictionary  */
+/* (see R__zipMultipleAlgorithmDict), dict must point to that dictionary.    */
+/* Buffers compressed without dictionary are decompressed whatever the      */
+/* value of dict.                                                            */
+void R__unzipDict(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep, const uch *dict, int dictsize)
 {
   long isize;
   uch  *ibufptr,*obufptr;
@@ -1159,7 +1178,9 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
   /*   C H E C K   H E A D E R   */
   if (!(src[0] == 'Z' && src[1] == 'L' && src[2] == Z_DEFLATED) &&
       !(src[0] == 'C' && src[1] == 'S' && src[2] == Z_DEFLATED) &&
-      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0)) {
+      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0) &&
+      !(src[0] == 'L' && src[1] == '4' && src[2] == 1) &&
+      !(src[0] == 'Z' && src[1] == 'S' && src[2] == 1)) {
     fprintf(stderr,"Error R__unzip: error in header\n");
     return;
   }
@@ -1202,6 +1223,10 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
     }
 
     err = inflate(&stream, Z_FINISH);
+    if (err == Z_NEED_DICT && dict && dictsize > 0) {
+      err = inflateSetDictionary(&stream, (const Bytef*)dict, (uInt)dictsize);
+      if (err == Z_OK) err = inflate(&stream, Z_FINISH);
+    }
     if (err != Z_STREAM_END) {
       inflateEnd(&stream);
       fprintf(stderr,"R__unzip: error %d in inflate (zlib)\n",err);
@@ -1217,6 +1242,22 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
     R__unzipLZMA(srcsize, src, tgtsize, tgt, irep);
     return;
   }
+  else if (src[0] == 'L' && src[1] == '4') {
+#ifdef R__HAS_LZ4
+    R__unzipLZ4(srcsize, src, tgtsize, tgt, irep);
+#else
+    fprintf(stderr,"R__unzip: buffer compressed with LZ4 but ROOT was built without LZ4 support\n");
+#endif
+    return;
+  }
+  else if (src[0] == 'Z' && src[1] == 'S') {
+#ifdef R__HAS_ZSTD
+    R__unzipZSTDDict(srcsize, src, tgtsize, tgt, irep, dict, dictsize);
+#else
+    fprintf(stderr,"R__unzip: buffer compressed with Zstandard but ROOT was built without Zstandard support\n");
+#endif
+    return;
+  }
 
   /* Old zlib format */
   if (R__Inflate(&ibufptr, &ibufcnt, &obufptr, &obufcnt)) {
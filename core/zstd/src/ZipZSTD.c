@@ -0,0 +1,133 @@
+// @(#)root/zstd:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipZSTD.h"
+#include "zstd.h"
+#include "zdict.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+static const int kHeaderSize = 9;
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+   R__zipZSTDDict(cxlevel, srcsize, src, tgtsize, tgt, irep, 0, 0);
+}
+
+void R__zipZSTDDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, const char *dict, int dictsize)
+{
+   size_t out_size;               /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+
+   *irep = 0;
+
+   if (*tgtsize <= kHeaderSize) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   /* The ROOT levels 1 to 9 are passed as is as Zstandard levels. */
+   if (cxlevel > 9) cxlevel = 9;
+   if (dict && dictsize > 0) {
+      ZSTD_CCtx *cctx = ZSTD_createCCtx();
+      if (!cctx) return;
+      out_size = ZSTD_compress_usingDict(cctx, &tgt[kHeaderSize], (size_t)(*tgtsize - kHeaderSize),
+                                         src, (size_t)(*srcsize), dict, (size_t)dictsize, cxlevel);
+      ZSTD_freeCCtx(cctx);
+   } else {
+      out_size = ZSTD_compress(&tgt[kHeaderSize], (size_t)(*tgtsize - kHeaderSize),
+                               src, (size_t)(*srcsize), cxlevel);
+   }
+   if (ZSTD_isError(out_size) || out_size > 0xffffff) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'Z';  /* Signature of Zstandard */
+   tgt[1] = 'S';
+   tgt[2] = 1;    /* Method: single Zstandard frame */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = (int)out_size + kHeaderSize;
+}
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   R__unzipZSTDDict(srcsize, src, tgtsize, tgt, irep, 0, 0);
+}
+
+void R__unzipZSTDDict(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep,
+                      const unsigned char *dict, int dictsize)
+{
+   size_t returnStatus;
+
+   *irep = 0;
+
+   if (*srcsize <= kHeaderSize) {
+      fprintf(stderr, "R__unzipZSTD: too small source\n");
+      return;
+   }
+
+   if (dict && dictsize > 0) {
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      if (!dctx) {
+         fprintf(stderr, "R__unzipZSTD: cannot create decompression context\n");
+         return;
+      }
+      returnStatus = ZSTD_decompress_usingDict(dctx, tgt, (size_t)(*tgtsize),
+                                               &src[kHeaderSize], (size_t)(*srcsize - kHeaderSize),
+                                               dict, (size_t)dictsize);
+      ZSTD_freeDCtx(dctx);
+   } else {
+      returnStatus = ZSTD_decompress(tgt, (size_t)(*tgtsize),
+                                     &src[kHeaderSize], (size_t)(*srcsize - kHeaderSize));
+   }
+   if (ZSTD_isError(returnStatus)) {
+      fprintf(stderr,
+              "R__unzipZSTD: error %s in ZSTD_decompress\n",
+              ZSTD_getErrorName(returnStatus));
+      return;
+   }
+
+   *irep = (int)returnStatus;
+}
+
+int R__trainZSTD(int nsamples, const char *samples, const int *samplesizes, char *dict, int dictcapacity)
+{
+   /* Train a Zstandard dictionary on the nsamples buffers stored back to back
+      in samples. Returns the size of the dictionary, or 0 if the training
+      failed (typically because there are too few or too small samples). */
+   size_t *sizes;
+   size_t result;
+   int i;
+
+   if (nsamples <= 0 || dictcapacity <= 0) return 0;
+   sizes = (size_t *)malloc(nsamples * sizeof(size_t));
+   if (!sizes) return 0;
+   for (i = 0; i < nsamples; ++i) sizes[i] = (size_t)samplesizes[i];
+
+   result = ZDICT_trainFromBuffer(dict, (size_t)dictcapacity, samples, sizes, (unsigned)nsamples);
+   free(sizes);
+   if (ZDICT_isError(result)) return 0;
+   return (int)result;
+}
@@ -41,6 +41,7 @@ class TFileCacheWrite;
 class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
+class TFileMapping;
 
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
@@ -92,12 +93,16 @@ protected:
    Bool_t           fInitDone : 1;   ///<!True if the file has been initialized
    Bool_t           fMustFlush : 1;  ///<!True if the file buffers must be flushed
    Bool_t           fIsPcmFile : 1;  ///<!True if the file is a ROOT pcm file.
+   Bool_t           fIsMapped : 1;   ///<!True if reads are served from the memory mapped file content
    TFileOpenHandle *fAsyncHandle;    ///<!For proper automatic cleanup
    EAsyncOpenStatus fAsyncOpenStatus; ///<!Status of an asynchronous open request
    TUrl             fUrl;            ///<!URL of file
 
    TList           *fInfoCache;      ///<!Cached list of the streamer infos in this file
    TList           *fOpenPhases;     ///<!Time info about open phases
+   char            *fMappedBuffer;   ///<!Start of the memory mapped file content (see SetMemoryMapped)
+   Long64_t         fMappedSize;     ///<!Number of bytes mapped at fMappedBuffer
+   TFileMapping    *fMapping;        ///<!Reference to the mapping, shared with the baskets aliasing it
 
    static TList    *fgAsyncOpenRequests; //List of handles for pending open requests
 
@@ -189,6 +194,8 @@ public:
    Int_t               GetCompressionSettings() const;
    Float_t             GetCompressionFactor();
    virtual Long64_t    GetEND() const { return fEND; }
+   const char         *GetMappedBuffer(Long64_t pos, Int_t len);
+   TFileMapping       *AcquireMapping();
    virtual Int_t       GetErrno() const;
    virtual void        ResetErrno() const;
    Int_t               GetFd() const { return fD; }
@@ -217,6 +224,7 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsMemoryMapped() const { return fIsMapped; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
    virtual void        ls(Option_t *option="") const;
@@ -244,6 +252,7 @@ public:
    virtual void        SetCompressionLevel(Int_t level=1);
    virtual void        SetCompressionSettings(Int_t settings=1);
    virtual void        SetEND(Long64_t last) { fEND = last; }
+           Bool_t      SetMemoryMapped(Bool_t mapped = kTRUE);
    virtual void        SetOffset(Long64_t offset, ERelativeTo pos = kBeg);
    virtual void        SetOption(Option_t *option=">") { fOption = option; }
    virtual void        SetReadCalls(Int_t readcalls = 0) { fReadCalls = readcalls; }
@@ -277,6 +286,7 @@ public:
    static Long64_t     GetFileBytesWritten();
    static Int_t        GetFileReadCalls();
    static Int_t        GetReadaheadSize();
+   static void         ReleaseMapping(TFileMapping *mapping);
 
    static void         SetFileBytesRead(Long64_t bytes = 0);
    static void         SetFileBytesWritten(Long64_t bytes = 0);
@@ -56,6 +56,7 @@
 #include "TFile.h"
 #include "TKey.h"
 #include "TBufferFile.h"
+#include "TBufferPool.h"
 #include "TFree.h"
 #include "TBrowser.h"
 #include "Bytes.h"
@@ -736,7 +737,7 @@ TObject *TKey::ReadObj()
       return (TObject*)ReadObjectAny(0);
    }
 
-   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen);
+   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen, 0, kTRUE, TBufferPool::ReAllocChar);
    if (!fBufferRef) {
       Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
       return 0;
@@ -745,12 +746,13 @@ TObject *TKey::ReadObj()
    fBufferRef->SetParent(GetFile());
    fBufferRef->SetPidOffset(fPidOffset);
 
+   size_t compressedSize = fNbytes;
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
+      fBuffer = TBufferPool::Acquire(compressedSize);
       if( !ReadFile() )                    //Read object structure from file
       {
         delete fBufferRef;
-        delete [] fBuffer;
+        TBufferPool::Release(fBuffer, compressedSize);
         fBufferRef = 0;
         fBuffer = 0;
         return 0;
@@ -808,9 +810,9 @@ TObject *TKey::ReadObj()
       }
       if (nout) {
          tobj->Streamer(*fBufferRef); //does not work with example 2 above
-         delete [] fBuffer;
+         TBufferPool::Release(fBuffer, compressedSize);
       } else {
-         delete [] fBuffer;
+         TBufferPool::Release(fBuffer, compressedSize);
          // Even-though we have a TObject, if the class is emulated the virtual
          // table may not be 'right', so let's go via the TClass.
          cl->Destructor(pobj);
@@ -84,6 +84,11 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
+#   if defined(R__LINUX) || defined(R__MACOSX)
+#      define R__HAS_POSIX_AIO
+#      include <aio.h>
+#   endif
 #else
 #   define ssize_t int
 #   include <io.h>
@@ -128,6 +133,7 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "compiledata.h"
 #include <cmath>
 #include <set>
+#include <vector>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
@@ -164,6 +170,20 @@ AddPseudoGlobals() {
 }
 } gAddPseudoGlobals;
 }
+////////////////////////////////////////////////////////////////////////////////
+/// Memory mapping of the content of a file (see TFile::SetMemoryMapped),
+/// shared by the file and the baskets aliasing it. The memory is unmapped
+/// when the last of them releases it (see TFile::ReleaseMapping).
+
+class TFileMapping {
+public:
+   char               *fBuffer;   // Start of the mapped memory
+   Long64_t            fSize;     // Number of bytes mapped
+   std::atomic<Int_t>  fRefCount; // Number of references to the mapping
+
+   TFileMapping(char *buffer, Long64_t size) : fBuffer(buffer), fSize(size), fRefCount(1) { }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// File default Constructor.
 
@@ -193,6 +213,10 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fInitDone        = kFALSE;
    fMustFlush       = kTRUE;
    fIsPcmFile       = kFALSE;
+   fIsMapped        = kFALSE;
+   fMappedBuffer    = 0;
+   fMappedSize      = 0;
+   fMapping         = 0;
    fAsyncHandle     = 0;
    fAsyncOpenStatus = kAOSNotAsync;
    SetBit(kBinaryFile, kTRUE);
@@ -294,6 +318,11 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// will build an integer which will set the compression to use
 /// the LZMA algorithm and compression level 1.  These are defined
 /// in the header file <em>Compression.h</em>.
+/// Depending on the build configuration, ROOT::kLZ4 (fastest
+/// decompression) and ROOT::kZSTD (ZLIB-like compression factor with
+/// much faster decompression) are also available. Buffers are always
+/// decompressed according to their own header, so a file may contain
+/// objects and branches written with different algorithms.
 /// Note that the compression settings may be changed at any time.
 /// The new compression settings will only apply to branches created
 /// or attached after the setting is changed and other objects written
@@ -351,6 +380,12 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    fInitDone   = kFALSE;
    fMustFlush  = kTRUE;
 
+   // Reads are served from the file descriptor until SetMemoryMapped is called
+   fIsMapped     = kFALSE;
+   fMappedBuffer = 0;
+   fMappedSize   = 0;
+   fMapping      = 0;
+
    // We are opening synchronously
    fAsyncHandle = 0;
    fAsyncOpenStatus = kAOSNotAsync;
@@ -530,7 +565,7 @@ zombie:
 ////////////////////////////////////////////////////////////////////////////////
 /// TFile objects can not be copied.
 
-TFile::TFile(const TFile &) : TDirectoryFile(), fInfoCache(0)
+TFile::TFile(const TFile &) : TDirectoryFile(), fInfoCache(0), fMappedBuffer(0), fMappedSize(0), fMapping(0)
 {
    MayNotUse("TFile::TFile(const TFile &)");
 }
@@ -835,6 +870,10 @@ void TFile::Init(Bool_t create)
       }
    }
 
+   // Serve the reads from a memory mapping of the file if requested
+   if (!fWritable && gEnv->GetValue("TFile.MemoryMapped", 0) == 1)
+      SetMemoryMapped(kTRUE);
+
    {
       R__LOCKGUARD2(gROOTMutex);
       gROOT->GetListOfFiles()->Add(this);
@@ -963,6 +1002,14 @@ void TFile::Close(Option_t *option)
       fD = -1;
    }
 
+   // The baskets still aliasing the mapping (for example those of a tree
+   // detached from this file) keep it alive until they release it.
+   ReleaseMapping(fMapping);
+   fMapping      = 0;
+   fMappedBuffer = 0;
+   fMappedSize   = 0;
+   fIsMapped     = kFALSE;
+
    fWritable = kFALSE;
 
    // delete the TProcessIDs
@@ -1189,6 +1236,59 @@ void TFile::ResetErrno() const
    TSystem::ResetErrno();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the len bytes at offset pos of the memory mapped file
+/// content, or 0 if the file is not memory mapped (see SetMemoryMapped) or
+/// the range is not entirely mapped.
+///
+/// The bytes are accounted for as read from the file. The returned memory
+/// stays valid until the file is closed; to use it beyond, a reference to
+/// the mapping must be taken with AcquireMapping.
+
+const char *TFile::GetMappedBuffer(Long64_t pos, Int_t len)
+{
+   if (!fIsMapped || pos < 0 || len < 0 || pos + len > fMappedSize)
+      return 0;
+
+   fBytesRead  += len;
+   fgBytesRead += len;
+   fReadCalls++;
+   fgReadCalls++;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   return fMappedBuffer + pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new reference to the memory mapping of the file content, or 0
+/// if the file is not mapped. The memory returned by GetMappedBuffer stays
+/// valid, even after the file is closed or deleted, until the reference is
+/// given back with TFile::ReleaseMapping.
+
+TFileMapping *TFile::AcquireMapping()
+{
+   if (!fMapping)
+      return 0;
+   ++fMapping->fRefCount;
+   return fMapping;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give back a reference to a memory mapping obtained with AcquireMapping.
+/// The memory is unmapped when the file and all the baskets aliasing it
+/// have released their reference.
+
+void TFile::ReleaseMapping(TFileMapping *mapping)
+{
+   if (!mapping || --mapping->fRefCount > 0)
+      return;
+#ifndef WIN32
+   munmap(mapping->fBuffer, (size_t)mapping->fSize);
+#endif
+   delete mapping;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a pointer to the current read cache.
 
@@ -1558,6 +1658,14 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
          return kFALSE;
       }
 
+      if (const char *mapped = GetMappedBuffer(pos, len)) {
+         memcpy(buf, mapped, len);
+         if (gPerfStats != 0) {
+            gPerfStats->FileReadEvent(this, len, start);
+         }
+         return kFALSE;
+      }
+
       Seek(pos);
       ssize_t siz;
 
@@ -1635,6 +1743,107 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
    return kTRUE;
 }
 
+#ifdef R__HAS_POSIX_AIO
+////////////////////////////////////////////////////////////////////////////////
+/// Read exactly len bytes at offset off of the file descriptor fd.
+/// Returns kTRUE in case of failure.
+
+static Bool_t R__ReadFully(Int_t fd, char *buf, Long64_t len, Long64_t off)
+{
+   while (len > 0) {
+      ssize_t siz = pread(fd, buf, (size_t)len, (off_t)off);
+      if (siz < 0 && errno == EINTR)
+         continue;
+      if (siz <= 0)
+         return kTRUE;
+      buf += siz;
+      off += siz;
+      len -= siz;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf blocks described in arrays pos and len from the file
+/// descriptor fd with POSIX asynchronous I/O.
+///
+/// Contiguous blocks are merged and all the reads are submitted at once so
+/// that the device sees all of them; the blocks are read directly at their
+/// place in buf. Returns the number of read requests issued, 0 if there is
+/// no point in issuing asynchronous reads (a single contiguous read) or -1
+/// in case of failure.
+
+static Int_t R__ReadBuffersAIO(Int_t fd, char *buf, const Long64_t *pos, const Int_t *len, Int_t nbuf,
+                               Long64_t offset)
+{
+   std::vector<struct aiocb> cbs;
+   cbs.reserve(nbuf);
+   Long64_t k = 0;
+   for (Int_t i = 0; i < nbuf; ++i) {
+      if (!cbs.empty() && cbs.back().aio_offset + (Long64_t)cbs.back().aio_nbytes == pos[i] + offset) {
+         cbs.back().aio_nbytes += len[i];
+      } else {
+         struct aiocb cb;
+         memset(&cb, 0, sizeof(cb));
+         cb.aio_fildes = fd;
+         cb.aio_offset = pos[i] + offset;
+         cb.aio_buf = buf + k;
+         cb.aio_nbytes = len[i];
+         cb.aio_lio_opcode = LIO_READ;
+         cb.aio_sigevent.sigev_notify = SIGEV_NONE;
+         cbs.push_back(cb);
+      }
+      k += len[i];
+   }
+   Int_t ncbs = cbs.size();
+   if (ncbs < 2)
+      return 0;
+
+   std::vector<struct aiocb *> list(ncbs);
+   for (Int_t i = 0; i < ncbs; ++i)
+      list[i] = &cbs[i];
+
+   // Submit by batches of at most AIO_LISTIO_MAX requests. The requests of a
+   // batch that could not be queued, and of all the following ones, are read
+   // synchronously.
+   Long_t maxlist = sysconf(_SC_AIO_LISTIO_MAX);
+   if (maxlist <= 0)
+      maxlist = 16;
+   Int_t nqueued = 0;
+   while (nqueued < ncbs) {
+      Int_t n = TMath::Min((Long_t)(ncbs - nqueued), maxlist);
+      if (lio_listio(LIO_NOWAIT, &list[nqueued], n, 0) != 0)
+         break;
+      nqueued += n;
+   }
+
+   Bool_t failed = kFALSE;
+   for (Int_t i = 0; i < ncbs; ++i) {
+      struct aiocb &cb = cbs[i];
+      if (i >= nqueued) {
+         // Part of a failed batch: some of its requests may still be in flight.
+         while (aio_error(&cb) == EINPROGRESS)
+            aio_suspend(&list[i], 1, 0);
+         if (!failed)
+            failed = R__ReadFully(fd, (char *)cb.aio_buf, cb.aio_nbytes, cb.aio_offset);
+         continue;
+      }
+      while (aio_error(&cb) == EINPROGRESS)
+         aio_suspend(&list[i], 1, 0);
+      ssize_t siz = aio_return(&cb);
+      if (failed)
+         continue;
+      if (siz < 0) {
+         failed = kTRUE;
+      } else if ((size_t)siz < cb.aio_nbytes) {
+         // Short read, get the rest synchronously.
+         failed = R__ReadFully(fd, (char *)cb.aio_buf + siz, cb.aio_nbytes - siz, cb.aio_offset + siz);
+      }
+   }
+   return failed ? -1 : ncbs;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the nbuf blocks described in arrays pos and len.
 ///
@@ -1642,6 +1851,12 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
 /// Note that for nbuf=1, this call is equivalent to TFile::ReafBuffer.
 /// This function is overloaded by TNetFile, TWebFile, etc.
 /// Returns kTRUE in case of failure.
+///
+/// For a local file, the blocks can be read with asynchronous I/O requests
+/// all submitted at once, which keeps the device queue busy. This is
+/// enabled with the rootrc variable:
+///
+///     TFile.AsyncReads: 1
 
 Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
@@ -1655,6 +1870,46 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
       return kFALSE;
    }
 
+   if (fIsMapped) {
+      Int_t k = 0;
+      for (Int_t j = 0; j < nbuf; j++) {
+         const char *mapped = GetMappedBuffer(pos[j], len[j]);
+         if (!mapped)
+            return kTRUE;
+         memcpy(&buf[k], mapped, len[j]);
+         k += len[j];
+      }
+      return kFALSE;
+   }
+
+#ifdef R__HAS_POSIX_AIO
+   Bool_t asyncReads = (gEnv->GetValue("TFile.AsyncReads", 0) == 1);
+   if (asyncReads && nbuf > 1 && IsA() == TFile::Class() && IsOpen()) {
+      Double_t start = 0;
+      if (gPerfStats != 0) start = TTimeStamp();
+      Int_t nreq = R__ReadBuffersAIO(fD, buf, pos, len, nbuf, fArchiveOffset);
+      if (nreq < 0) {
+         Error("ReadBuffers", "error reading %d blocks from file %s", nbuf, GetName());
+         return kTRUE;
+      }
+      if (nreq > 0) {
+         Long64_t nbytes = 0;
+         for (Int_t j = 0; j < nbuf; j++)
+            nbytes += len[j];
+         fBytesRead  += nbytes;
+         fgBytesRead += nbytes;
+         fReadCalls  += nreq;
+         fgReadCalls += nreq;
+         if (gMonitoringWriter)
+            gMonitoringWriter->SendFileReadProgress(this);
+         if (gPerfStats != 0) {
+            gPerfStats->FileReadEvent(this, nbytes, start);
+         }
+         return kFALSE;
+      }
+   }
+#endif
+
    Int_t k = 0;
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
@@ -2034,6 +2289,10 @@ Int_t TFile::ReOpen(Option_t *mode)
          fD = -1;
       }
 
+      // The mapping would not see what is written from now on; it stays
+      // alive for the baskets still referencing it (see AcquireMapping).
+      fIsMapped = kFALSE;
+
       // open in UPDATE mode
       fOption = opt;    // set fOption before SysOpen() for TNetFile
 #ifndef WIN32
@@ -2151,6 +2410,63 @@ void TFile::SetCompressionSettings(Int_t settings)
    fCompress = settings;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Serve the reads of this file from a memory mapping of its content.
+///
+/// Only local files opened in READ mode can be mapped. Once mapped, the
+/// baskets of the uncompressed branches directly use the mapped memory
+/// instead of a copy of the file content and the compressed baskets are
+/// unzipped straight from it. The mapping can also be requested for all
+/// the files opened in READ mode with the rootrc variable:
+///
+///     TFile.MemoryMapped: 1
+///
+/// Calling SetMemoryMapped(kFALSE) stops serving reads from the mapping;
+/// the mapping itself is only released when the file is closed and the
+/// baskets aliasing it are deleted or read again.
+/// Returns kTRUE if the reads are served from the mapping.
+
+Bool_t TFile::SetMemoryMapped(Bool_t mapped)
+{
+   if (!mapped) {
+      fIsMapped = kFALSE;
+      return kFALSE;
+   }
+   if (IsA() != TFile::Class() || fArchive || !fIsRootFile || !IsOpen() || IsWritable())
+      return kFALSE;
+
+   Long64_t size = GetSize();
+   if (fMappedBuffer) {
+      // The file may have been updated since it was mapped (see ReOpen).
+      if (size != fMappedSize) {
+         Warning("SetMemoryMapped", "file %s has changed since it was mapped", GetName());
+         return kFALSE;
+      }
+      fIsMapped = kTRUE;
+      return kTRUE;
+   }
+#ifndef WIN32
+   if (size <= 0 || (ULong64_t)size > (ULong64_t)((size_t)-1))
+      return kFALSE;
+   // Private writable pages: a basket writing into its buffer does not
+   // modify the file. The pages are shared by all the baskets of this
+   // process aliasing them though, copy on write does not isolate them
+   // from each other: the baskets must not modify a mapped buffer.
+   void *addr = mmap(0, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fD, 0);
+   if (addr == MAP_FAILED) {
+      SysError("SetMemoryMapped", "cannot map file %s in memory", GetName());
+      return kFALSE;
+   }
+   fMappedBuffer = (char *)addr;
+   fMappedSize   = size;
+   fMapping      = new TFileMapping(fMappedBuffer, fMappedSize);
+   fIsMapped     = kTRUE;
+   return kTRUE;
+#else
+   return kFALSE;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set a pointer to the read cache.
 ///
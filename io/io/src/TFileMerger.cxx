@@ -39,6 +39,7 @@ to be merged, like the standalone hadd program.
 #include "TClassRef.h"
 #include "TROOT.h"
 #include "TMemFile.h"
+#include "TError.h"
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -49,6 +50,11 @@ to be merged, like the standalone hadd program.
 #include <sys/resource.h>
 #endif
 
+#ifdef R__USE_IMT
+#include "tbb/task_group.h"
+#include <vector>
+#endif
+
 ClassImp(TFileMerger)
 
 TClassRef R__TH1_Class("TH1");
@@ -83,6 +89,78 @@ static Int_t R__GetSystemMaxOpenedFiles()
    }
 }
 
+#ifdef R__USE_IMT
+static const Int_t kParallelMergeChunk = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge into the histogram obj the objects named 'name' found in the
+/// directory 'path' of the files of sourcelist, starting at nextsource.
+///
+/// The objects of the different files are read concurrently,
+/// kParallelMergeChunk files at a time to bound the memory use. They are then
+/// merged into obj in the order of the files, as the sequential loop of
+/// MergeRecursive does: the addition of the bin contents is not associative
+/// in floating point, and neither is the merge of histograms with labels or
+/// extendable axes, so the result is identical to the sequential merge.
+
+static void R__MergeHistogramsParallel(TObject *obj, TClass *cl, const char *name, const TString &path,
+                                       TList *sourcelist, TFile *nextsource, Bool_t oneGo, TFileMergeInfo &info)
+{
+   ROOT::MergeFunc_t func = cl->GetMerge();
+   tbb::task_group g;
+   TList inputs;
+   while (nextsource) {
+      std::vector<TFile*> sources;
+      while (nextsource && sources.size() < (size_t)kParallelMergeChunk) {
+         sources.push_back(nextsource);
+         nextsource = (TFile*)sourcelist->After(nextsource);
+      }
+
+      std::vector<TObject*> objs(sources.size(), nullptr);
+      for (size_t i = 0; i < sources.size(); ++i) {
+         g.run([&, i]() {
+            // gDirectory is per thread, restore it for the next task.
+            TDirectory::TContext ctxt;
+            TDirectory *ndir = sources[i]->GetDirectory(path);
+            if (!ndir) return;
+            ndir->cd();
+            TKey *key = (TKey*)ndir->GetListOfKeys()->FindObject(name);
+            if (!key) return;
+            TObject *hobj = key->ReadObj();
+            if (!hobj) {
+               ::Info("TFileMerger::MergeRecursive", "could not read object for key %s; skipping file %s",
+                      name, sources[i]->GetName());
+               return;
+            }
+            hobj->ResetBit(kMustCleanup);
+            objs[i] = hobj;
+         });
+      }
+      g.wait();
+
+      for (size_t i = 0; i < objs.size(); ++i) {
+         if (!objs[i]) continue;
+         inputs.Add(objs[i]);
+         if (!oneGo) {
+            Long64_t result = func(obj, &inputs, &info);
+            info.fIsFirst = kFALSE;
+            if (result < 0) {
+               ::Error("TFileMerger::MergeRecursive", "calling Merge() on '%s' with the corresponding object in '%s'",
+                       obj->GetName(), sources[i]->GetName());
+            }
+            inputs.Delete();
+         }
+      }
+   }
+   // Merge the list, if still to be done
+   if (oneGo || info.fIsFirst) {
+      func(obj, &inputs, &info);
+      info.fIsFirst = kFALSE;
+      inputs.Delete();
+   }
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create file merger object.
 
@@ -379,8 +457,14 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
 
    TFileMergeInfo info(target);
 
-   if (fFastMethod && ((type&kKeepCompression) || !fCompressionChange) ) {
-      info.fOptions.Append(" fast");
+   if (fFastMethod) {
+      if ((type&kKeepCompression) || !fCompressionChange) {
+         info.fOptions.Append(" fast");
+      } else {
+         // Copy the baskets without unstreaming them, compressing them
+         // again with the settings of the output file.
+         info.fOptions.Append(" fast recompress");
+      }
    }
 
    TFile      *current_file;
@@ -528,6 +612,11 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
                   ROOT::MergeFunc_t func = cl->GetMerge();
                   func(obj, &inputs, &info);
                   info.fIsFirst = kFALSE;
+#ifdef R__USE_IMT
+               } else if (ROOT::IsImplicitMTEnabled() && cl->InheritsFrom(R__TH1_Class)) {
+                  // Read and merge the histograms of the source files concurrently.
+                  R__MergeHistogramsParallel(obj, cl, key->GetName(), path, sourcelist, nextsource, oneGo, info);
+#endif
                } else {
                   do {
                      // make sure we are at the correct directory level by cd'ing to path
@@ -884,6 +973,71 @@ Bool_t TFileMerger::OpenExcessFiles()
    TString localcopy;
    // We want gDirectory untouched by anything going on here
    TDirectory::TContext ctxt;
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      // Copy and open the next batch of files concurrently, then add them
+      // to fFileList in their original order.
+      std::vector<TObjString*> urls;
+      std::vector<TString> localcopies;
+      while( urls.size() < (size_t)(fMaxOpenedFiles-1) && ( url = (TObjString*)next() ) ) {
+         urls.push_back(url);
+         if (fLocal) {
+            // TUUID is not thread safe, name the local copies upfront.
+            TUUID uuid;
+            localcopy.Form("file:%s/ROOTMERGE-%s.root", gSystem->TempDirectory(), uuid.AsString());
+         }
+         localcopies.push_back(localcopy);
+      }
+      std::vector<TFile*> files(urls.size(), nullptr);
+      std::vector<Int_t> copyfailed(urls.size(), 0);
+      tbb::task_group g;
+      for (size_t i = 0; i < urls.size(); ++i) {
+         g.run([&, i]() {
+            TDirectory::TContext taskctxt;
+            if (fLocal) {
+               // Concurrent progress bars would be garbled, do not show them.
+               if (!TFile::Cp(urls[i]->GetName(), localcopies[i], kFALSE)) {
+                  copyfailed[i] = 1;
+                  return;
+               }
+               files[i] = TFile::Open(localcopies[i], "READ");
+            } else {
+               files[i] = TFile::Open(urls[i]->GetName(), "READ");
+            }
+         });
+      }
+      g.wait();
+
+      Bool_t result = kTRUE;
+      for (size_t i = 0; i < urls.size(); ++i) {
+         if (!result) {
+            // Like the sequential case, stop at the first failure: the
+            // files after it are closed and stay in fExcessFiles.
+            if (files[i]) {
+               delete files[i];
+               if (fLocal) gSystem->Unlink(TUrl(localcopies[i]).GetFile());
+            }
+         } else if (copyfailed[i]) {
+            Error("OpenExcessFiles", "cannot get a local copy of file %s", urls[i]->GetName());
+            result = kFALSE;
+         } else if (!files[i]) {
+            if (fLocal)
+               Error("OpenExcessFiles", "cannot open local copy %s of URL %s",
+                     localcopies[i].Data(), urls[i]->GetName());
+            else
+               Error("OpenExcessFiles", "cannot open file %s", urls[i]->GetName());
+            result = kFALSE;
+         } else {
+            if (fOutputFile && fOutputFile->GetCompressionLevel() != files[i]->GetCompressionLevel()) fCompressionChange = kTRUE;
+
+            files[i]->SetBit(kCanDelete);
+            fFileList->Add(files[i]);
+            fExcessFiles->Remove(urls[i]);
+         }
+      }
+      return result;
+   }
+#endif
    while( nfiles < (fMaxOpenedFiles-1) && ( url = (TObjString*)next() ) ) {
       TFile *newfile = 0;
       if (fLocal) {
@@ -226,6 +226,55 @@ namespace TStreamerInfoActions
       return 0;
    }
 
+   // The array actions stream, in a single call, either a fixed size array or
+   // a run of consecutive data members of the same type which were regrouped
+   // by TStreamerInfo::Compile (fType == kOffsetL + basic type). The number
+   // of values is the configuration's fLength.
+
+   template <typename T>
+   INLINE_TEMPLATE_ARGS Int_t ReadBasicArray(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      T *x = (T*)( ((char*)addr) + config->fOffset );
+      buf.ReadFastArray(x, config->fLength);
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t ReadBasicArrayFloat16(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      Float_t *x = (Float_t*)( ((char*)addr) + config->fOffset );
+      buf.ReadFastArrayFloat16(x, config->fLength, config->fCompInfo->fElem);
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t ReadBasicArrayDouble32(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      Double_t *x = (Double_t*)( ((char*)addr) + config->fOffset );
+      buf.ReadFastArrayDouble32(x, config->fLength, config->fCompInfo->fElem);
+      return 0;
+   }
+
+   template <typename T>
+   INLINE_TEMPLATE_ARGS Int_t WriteBasicArray(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      T *x = (T*)( ((char*)addr) + config->fOffset );
+      buf.WriteFastArray(x, config->fLength);
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t WriteBasicArrayFloat16(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      Float_t *x = (Float_t*)( ((char*)addr) + config->fOffset );
+      buf.WriteFastArrayFloat16(x, config->fLength, config->fCompInfo->fElem);
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t WriteBasicArrayDouble32(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      Double_t *x = (Double_t*)( ((char*)addr) + config->fOffset );
+      buf.WriteFastArrayDouble32(x, config->fLength, config->fCompInfo->fElem);
+      return 0;
+   }
+
    class TConfWithFactor : public TConfiguration {
       // Configuration object for the Float16/Double32 where a factor has been specified.
    public:
@@ -2135,6 +2184,22 @@ static TConfiguredAction GetCollectionReadAction(TVirtualStreamerInfo *info, TSt
          }
          break;
       }
+      // fixed size arrays
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kBool:     return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Bool_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kChar:     return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Char_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kShort:    return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Short_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kInt:      return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Int_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong:     return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Long_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong64:   return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Long64_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat:    return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Float_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble:   return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<Double_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUChar:    return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<UChar_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUShort:   return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<UShort_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUInt:     return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<UInt_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong:    return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<ULong_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong64:  return TConfiguredAction( Looper::template ReadAction<ReadBasicArray<ULong64_t> >, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat16:  return TConfiguredAction( Looper::template ReadAction<ReadBasicArrayFloat16>, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble32: return TConfiguredAction( Looper::template ReadAction<ReadBasicArrayDouble32>, new TConfiguration(info,i,compinfo,offset,compinfo->fLength) ); break;
       case TStreamerInfo::kTNamed:  return TConfiguredAction( Looper::template ReadAction<ReadTNamed >, new TConfiguration(info,i,compinfo,offset) );    break;
          // Idea: We should calculate the CanIgnoreTObjectStreamer here and avoid calling the
          // Streamer alltogether.
@@ -2357,11 +2422,14 @@ void TStreamerInfo::Compile()
       fComp[fNdata].fClassName = TString(element->GetTypeName()).Strip(TString::kTrailing, '*');
       fComp[fNdata].fStreamer = element->GetStreamer();
 
-      // try to group consecutive members of the same type
+      // try to group consecutive members of the same type, they are then
+      // streamed by a single array action.
       if (!TestBit(kCannotOptimize)
           && (keep >= 0)
           && (element->GetType() >=0)
-          && (element->GetType() < 10)
+          && (element->GetType() < kOffsetL)
+          && (element->GetType() != kLegacyChar)
+          && (element->GetType() != kBits)
           && (fComp[fNdata].fType == fComp[fNdata].fNewType)
           && (fComp[keep].fMethod == 0)
           && (element->GetType() > 0)
@@ -2552,6 +2620,22 @@ void TStreamerInfo::AddReadAction(TStreamerInfoActions::TActionSequence *readSeq
          }
          break;
       }
+      // read fixed size arrays and runs of regrouped data members in one call
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kBool:     readSequence->AddAction( ReadBasicArray<Bool_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kChar:     readSequence->AddAction( ReadBasicArray<Char_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kShort:    readSequence->AddAction( ReadBasicArray<Short_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kInt:      readSequence->AddAction( ReadBasicArray<Int_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong:     readSequence->AddAction( ReadBasicArray<Long_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong64:   readSequence->AddAction( ReadBasicArray<Long64_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat:    readSequence->AddAction( ReadBasicArray<Float_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble:   readSequence->AddAction( ReadBasicArray<Double_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUChar:    readSequence->AddAction( ReadBasicArray<UChar_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUShort:   readSequence->AddAction( ReadBasicArray<UShort_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUInt:     readSequence->AddAction( ReadBasicArray<UInt_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong:    readSequence->AddAction( ReadBasicArray<ULong_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong64:  readSequence->AddAction( ReadBasicArray<ULong64_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat16:  readSequence->AddAction( ReadBasicArrayFloat16, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble32: readSequence->AddAction( ReadBasicArrayDouble32, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
       case TStreamerInfo::kTNamed:  readSequence->AddAction( ReadTNamed, new TConfiguration(this,i,compinfo,compinfo->fOffset) );    break;
          // Idea: We should calculate the CanIgnoreTObjectStreamer here and avoid calling the
          // Streamer alltogether.
@@ -2782,6 +2866,22 @@ void TStreamerInfo::AddWriteAction(TStreamerInfoActions::TActionSequence *writeS
       case TStreamerInfo::kUInt:    writeSequence->AddAction( WriteBasicType<UInt_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset) );    break;
       case TStreamerInfo::kULong:   writeSequence->AddAction( WriteBasicType<ULong_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset) );   break;
       case TStreamerInfo::kULong64: writeSequence->AddAction( WriteBasicType<ULong64_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset) ); break;
+      // write fixed size arrays and runs of regrouped data members in one call
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kBool:     writeSequence->AddAction( WriteBasicArray<Bool_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kChar:     writeSequence->AddAction( WriteBasicArray<Char_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kShort:    writeSequence->AddAction( WriteBasicArray<Short_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kInt:      writeSequence->AddAction( WriteBasicArray<Int_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong:     writeSequence->AddAction( WriteBasicArray<Long_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kLong64:   writeSequence->AddAction( WriteBasicArray<Long64_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat:    writeSequence->AddAction( WriteBasicArray<Float_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble:   writeSequence->AddAction( WriteBasicArray<Double_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUChar:    writeSequence->AddAction( WriteBasicArray<UChar_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUShort:   writeSequence->AddAction( WriteBasicArray<UShort_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kUInt:     writeSequence->AddAction( WriteBasicArray<UInt_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong:    writeSequence->AddAction( WriteBasicArray<ULong_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kULong64:  writeSequence->AddAction( WriteBasicArray<ULong64_t>, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kFloat16:  writeSequence->AddAction( WriteBasicArrayFloat16, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
+      case TStreamerInfo::kOffsetL + TStreamerInfo::kDouble32: writeSequence->AddAction( WriteBasicArrayDouble32, new TConfiguration(this,i,compinfo,compinfo->fOffset,compinfo->fLength) ); break;
        // case TStreamerInfo::kBits:    writeSequence->AddAction( WriteBasicType<BitsMarker>, new TConfiguration(this,i,compinfo,compinfo->fOffset) );    break;
      /*case TStreamerInfo::kFloat16: {
          if (element->GetFactor() != 0) {
@@ -20,6 +20,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TMessage.h"
+#include "TBufferPool.h"
 #include "Compression.h"
 #include "TVirtualStreamerInfo.h"
 #include "Bytes.h"
@@ -44,7 +45,7 @@ ClassImp(TMessage)
 /// (only if message is > 256 bytes).
 
 TMessage::TMessage(UInt_t what, Int_t bufsiz) :
-   TBufferFile(TBuffer::kWrite, bufsiz + 2*sizeof(UInt_t))
+   TBufferFile(TBuffer::kWrite, bufsiz + 2*sizeof(UInt_t), 0, kTRUE, TBufferPool::ReAllocChar)
 {
    // space at the beginning of the message reserved for the message length
    UInt_t   reserved = 0;
@@ -12,6 +12,8 @@
 //               and using ">>+elist" in TTree::Draw
 //   - Test3() - transforming TEventList objects into TEntryList objects for a TChain
 //   - Test4() - same as Test3() but for a TTree
+//   - Test7() - union, intersection and difference of entry lists for a TTree
+//               and for a TChain, against the lists of the combined selections
 //
 //   To run in batch mode, do
 //     stressEntryList
@@ -31,6 +33,9 @@
 // Test2: Adding and subtracting entry lists-------------------------- OK
 // Test3: TEntryList and TEventList for TChain------------------------ OK
 // Test4: TEntryList and TEventList for TTree------------------------- OK
+// Test5: Full and Empty TEntryList----------------------------------- OK
+// Test6: Full and Empty TEntryList w/ TTrees in TDirectories--------- OK
+// Test7: Union, intersection and difference of entry lists----------- OK
 // **********************************************************************
 // *******************Deleting the data files****************************
 // **********************************************************************
@@ -533,6 +538,7 @@ Bool_t Test6()
 }
 
 
+
 void SetupTree(TTree* tree, Double_t x, Double_t y, Double_t z)
 {
    tree->Branch("x", &x, "x/D");
@@ -542,6 +548,88 @@ void SetupTree(TTree* tree, Double_t x, Double_t y, Double_t z)
 
 const char* gRootFileNameTemplate = "stressEntryListTrees_%d.root";
 
+Int_t CompareLists(const TEntryList *elist, const TEntryList *echeck, const char *what)
+{
+   //Return the number of entries of elist which differ from the ones of echeck
+
+   Int_t wrongentries = 0;
+   Long64_t n = echeck->GetN();
+   if (elist->GetN() != n) {
+      printf("\n%s: %lld entries instead of %lld\n", what, elist->GetN(), n);
+      wrongentries++;
+   }
+   for (Long64_t i=0; i<n; i++){
+      if (const_cast<TEntryList*>(elist)->GetEntry(i) != const_cast<TEntryList*>(echeck)->GetEntry(i))
+         wrongentries++;
+   }
+   if (wrongentries>0)
+      printf("\nwrong entries after %s = %d\n", what, wrongentries);
+   return wrongentries;
+}
+
+Bool_t Test7()
+{
+   //Test Add, Intersect and Subtract, for a TTree and for a TChain (with
+   //sublists), against the entry lists of the combined selections. The
+   //selections mix dense and sparse blocks. A list of the chain is also
+   //intersected with the list of one of its trees.
+
+   TCut cut1("cut1", "Entry$%2==0");
+   TCut cut2("cut2", "Entry$%97<3 || Entry$%5000>3000");
+   Int_t wrongentries = 0;
+
+   TFile f(TString::Format(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("tree1");
+   TChain *chain = new TChain("chain", "chain");
+   chain->Add(TString::Format(gRootFileNameTemplate, 0) + "/tree1");
+   chain->Add(TString::Format(gRootFileNameTemplate, 0) + "/tree2");
+   TTree *trees[2] = {tree, chain};
+
+   TEntryList *elist1 = 0, *elist2 = 0, *echeck = 0;
+   for (Int_t t=0; t<2; t++){
+      TTree *tr = trees[t];
+      const char *opts[3] = {"union", "intersection", "difference"};
+      TCut checks[3] = {cut1 || cut2, cut1 && cut2, cut1 && !cut2};
+      for (Int_t op=0; op<3; op++){
+         tr->Draw(">>elist1", cut1, "entrylist");
+         elist1 = (TEntryList*)gDirectory->Get("elist1");
+         tr->Draw(">>elist2", cut2, "entrylist");
+         elist2 = (TEntryList*)gDirectory->Get("elist2");
+         tr->Draw(">>echeck", checks[op], "entrylist");
+         echeck = (TEntryList*)gDirectory->Get("echeck");
+         if (op == 0) elist1->Add(elist2);
+         else if (op == 1) elist1->Intersect(elist2);
+         else elist1->Subtract(elist2);
+         wrongentries += CompareLists(elist1, echeck, TString::Format("%s for the %s", opts[op], t ? "chain" : "tree"));
+         delete elist1;
+         delete elist2;
+         delete echeck;
+      }
+   }
+
+   //the intersection keeps only the entries of the first tree
+   chain->Draw(">>elist1", cut1, "entrylist");
+   elist1 = (TEntryList*)gDirectory->Get("elist1");
+   tree->Draw(">>elist2", cut2, "entrylist");
+   elist2 = (TEntryList*)gDirectory->Get("elist2");
+   tree->Draw(">>echeck", cut1 && cut2, "entrylist");
+   echeck = (TEntryList*)gDirectory->Get("echeck");
+   elist1->Intersect(elist2);
+   if (elist1->GetN() != echeck->GetN()) {
+      printf("\nintersection with the list of a tree: %lld entries instead of %lld\n", elist1->GetN(), echeck->GetN());
+      wrongentries++;
+   }
+   delete elist1;
+   delete elist2;
+   delete echeck;
+   delete chain;
+
+   if (wrongentries>0)
+      return kFALSE;
+   return kTRUE;
+}
+
+
 void MakeTrees(Int_t nentries, Int_t nfiles)
 {
    //Creates nfiles files with 2 trees of nentries each
@@ -618,7 +706,8 @@ Int_t stressEntryList(Int_t nentries, Int_t nfiles)
       {Test3, "Test3: TEntryList and TEventList for TChain------------------------ "},
       {Test4, "Test4: TEntryList and TEventList for TTree------------------------- "},
       {Test5, "Test5: Full and Empty TEntryList----------------------------------- "},
-      {Test6, "Test6: Full and Empty TEntryList w/ TTrees in TDirectories--------- "}
+      {Test6, "Test6: Full and Empty TEntryList w/ TTrees in TDirectories--------- "},
+      {Test7, "Test7: Union, intersection and difference of entry lists----------- "}
    };
 
    for (auto const & testDescrPair : testDescrList) {
@@ -0,0 +1,432 @@
+// @(#)root/test:$Id$
+// Author: agent   18/10/2026
+
+/////////////////////////////////////////////////////////////////
+//
+//___A stress test for the locks and the thread safe caches of ROOT___
+//
+//   The functions below test
+//   - Test1() - gCoreMutex, gROOTMutex and gInterpreterMutex after
+//               ROOT::EnableThreadSafety
+//   - Test2() - exclusion of the readers and the writers of TRWMutex,
+//               with recursive read locks and read locks inside write locks
+//   - Test3() - a writer of TRWMutex is not starved by a continuous flow of
+//               readers, and a read lock is not upgraded by TryLock
+//   - Test4() - concurrent TClass::GetClass lookups by name and by
+//               std::type_info while other classes are being loaded
+//   - Test5() - reuse of the TBufferPool buffers, their ownership by a
+//               TBufferFile and by concurrent threads
+//
+//   To run in batch mode, do
+//     stressThreads
+//     stressThreads 8
+//     stressThreads 8 100000
+//     stressThreads 8 100000 1
+//   Here the 1st parameter is the number of threads,
+//            2nd parameter is the number of iterations of each thread,
+//            3rd parameter, if not 0, prints the timings of Test4
+//   Default values are 8 100000 0
+//
+//   An example of output when all tests pass:
+// **********************************************************************
+// ****************Starting the threads stress test**********************
+// **********************************************************************
+// Test1: gCoreMutex with thread safety enabled----------------------- OK
+// Test2: Readers and writers of TRWMutex----------------------------- OK
+// Test3: Writer starvation and read lock upgrade of TRWMutex--------- OK
+// Test4: Concurrent TClass::GetClass--------------------------------- OK
+// Test5: TBufferPool reuse and ownership----------------------------- OK
+// **********************************************************************
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include "TApplication.h"
+#include "TBufferFile.h"
+#include "TBufferPool.h"
+#include "TClass.h"
+#include "TList.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#include "TRWMutex.h"
+#include "TStopwatch.h"
+#include "TVirtualMutex.h"
+#include "TVirtualRWMutex.h"
+
+Int_t stressThreads(Int_t nthreads = 8, Int_t niter = 100000, Int_t verbose = 0);
+
+Int_t gNthreads = 8;
+Int_t gNiter    = 100000;
+Bool_t gVerbose = kFALSE;
+
+Bool_t Test1()
+{
+   // ROOT::EnableThreadSafety must always create gCoreMutex, and make
+   // gROOTMutex and gInterpreterMutex point to it, otherwise the read locks
+   // taken on gCoreMutex do not exclude the writers.
+
+   ROOT::EnableThreadSafety();
+   if (!gCoreMutex) {
+      printf("\ngCoreMutex is not set\n");
+      return kFALSE;
+   }
+   if (gROOTMutex != gCoreMutex || gInterpreterMutex != gCoreMutex) {
+      printf("\ngROOTMutex=%p and gInterpreterMutex=%p differ from gCoreMutex=%p\n",
+             (void*)gROOTMutex, (void*)gInterpreterMutex, (void*)gCoreMutex);
+      return kFALSE;
+   }
+
+   // Read lock, nested in a write lock, through the macros.
+   {
+      R__LOCKGUARD(gROOTMutex);
+      R__READ_LOCKGUARD(gCoreMutex);
+   }
+   {
+      R__READ_LOCKGUARD(gCoreMutex);
+      R__READ_LOCKGUARD(gCoreMutex);
+   }
+   return kTRUE;
+}
+
+Bool_t Test2()
+{
+   // Each thread takes mostly read locks, sometimes recursively, and now
+   // and then the write lock. The readers check that no writer is in, the
+   // writers that they are alone.
+
+   TRWMutex m;
+   std::atomic<Int_t> nreaders(0), nwriters(0), nerrors(0);
+   Long64_t shared = 0;
+   Long64_t expected = 0;
+
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < gNthreads; ++t) {
+      if (t % 50 < gNiter) expected += (gNiter - 1 - t % 50) / 50 + 1;
+      threads.emplace_back([&, t]() {
+         for (Int_t i = 0; i < gNiter; ++i) {
+            if (i % 50 == t % 50) {
+               m.WriteLock();
+               if (++nwriters != 1 || nreaders != 0) ++nerrors;
+               m.ReadLock();
+               ++shared;
+               m.ReadUnLock();
+               --nwriters;
+               m.WriteUnLock();
+            } else {
+               m.ReadLock();
+               ++nreaders;
+               if (nwriters != 0) ++nerrors;
+               m.ReadLock();
+               m.ReadUnLock();
+               --nreaders;
+               m.ReadUnLock();
+            }
+         }
+      });
+   }
+   for (auto &thread : threads) thread.join();
+
+   if (nerrors || shared != expected) {
+      printf("\n%d exclusion errors, %lld writes instead of %lld\n", (Int_t)nerrors, shared, expected);
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test3()
+{
+   // The readers overlap so that there is always one of them holding the
+   // lock: a reader preferring mutex would never let the writer in.
+
+   TRWMutex m;
+   std::atomic<Bool_t> stop(kFALSE);
+   std::atomic<Int_t> nwrites(0);
+
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < gNthreads; ++t) {
+      threads.emplace_back([&]() {
+         while (!stop) {
+            m.ReadLock();
+            std::this_thread::yield();
+            m.ReadUnLock();
+         }
+      });
+   }
+   std::thread writer([&]() {
+      for (Int_t i = 0; i < 100; ++i) {
+         m.WriteLock();
+         ++nwrites;
+         m.WriteUnLock();
+      }
+   });
+   writer.join();
+   stop = kTRUE;
+   for (auto &thread : threads) thread.join();
+
+   if (nwrites != 100) {
+      printf("\n%d writes instead of 100\n", (Int_t)nwrites);
+      return kFALSE;
+   }
+
+   // Upgrading a read lock is refused.
+   m.ReadLock();
+   Int_t res = m.TryLock();
+   m.ReadUnLock();
+   if (res == 0) {
+      m.WriteUnLock();
+      printf("\nTryLock upgraded a read lock\n");
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test4()
+{
+   // The threads look up loaded classes, by name and by std::type_info,
+   // which must not take any lock, while one thread loads new ones. Each
+   // lookup must return the TClass found before the threads started, and
+   // the lookups of the classes being loaded either nothing or their final
+   // TClass. The lookups per second are printed in verbose mode.
+
+   const char *names[] = {"TObject", "TNamed", "TList", "TObjArray", "TObjString", "TString"};
+   const std::type_info *types[] = {&typeid(TObject), &typeid(TNamed), &typeid(TList), &typeid(TObjArray), &typeid(TObjString), &typeid(TString)};
+   const Int_t nnames = sizeof(names) / sizeof(names[0]);
+   const char *newNames[] = {"vector<Int_t>", "vector<Double_t>", "vector<TString>", "list<TObject*>", "map<Int_t,TString>", "vector<vector<Float_t> >"};
+   const Int_t nnew = sizeof(newNames) / sizeof(newNames[0]);
+
+   TClass *expected[nnames];
+   for (Int_t i = 0; i < nnames; ++i) {
+      expected[i] = TClass::GetClass(names[i]);
+      if (!expected[i] || TClass::GetClass(*types[i]) != expected[i]) {
+         printf("\nno TClass or a different one by std::type_info for %s\n", names[i]);
+         return kFALSE;
+      }
+   }
+
+   std::atomic<Int_t> nerrors(0);
+   std::vector<std::vector<TClass*>> seen(gNthreads, std::vector<TClass*>(nnew, (TClass*)0));
+   std::vector<std::thread> threads;
+   TStopwatch timer;
+   for (Int_t t = 0; t < gNthreads; ++t) {
+      threads.emplace_back([&, t]() {
+         for (Int_t i = 0; i < gNiter; ++i) {
+            Int_t k = (i + t) % nnames;
+            TClass *cl = (i % 2) ? TClass::GetClass(names[k]) : TClass::GetClass(*types[k]);
+            if (cl != expected[k]) ++nerrors;
+            if (i % 100 == 0) {
+               Int_t n = (i / 100 + t) % nnew;
+               TClass *cln = TClass::GetClass(newNames[n], kFALSE);
+               if (cln) {
+                  if (seen[t][n] && seen[t][n] != cln) ++nerrors;
+                  seen[t][n] = cln;
+               }
+            }
+         }
+      });
+   }
+   std::thread loader([&]() {
+      for (Int_t n = 0; n < nnew; ++n) TClass::GetClass(newNames[n]);
+   });
+   loader.join();
+   for (auto &thread : threads) thread.join();
+   timer.Stop();
+
+   for (Int_t n = 0; n < nnew; ++n) {
+      TClass *cln = TClass::GetClass(newNames[n]);
+      for (Int_t t = 0; t < gNthreads; ++t) {
+         if (seen[t][n] && seen[t][n] != cln) ++nerrors;
+      }
+   }
+   if (gVerbose)
+      printf("\n%d threads: %.3g lookups per second\n", gNthreads, gNthreads * (Double_t)gNiter / timer.RealTime());
+   if (nerrors) {
+      printf("\n%d lookups returned a wrong TClass\n", (Int_t)nerrors);
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test5()
+{
+   // A released buffer of the size of a size class is handed out again,
+   // other sizes and the buffers above the cap are freed. A pooled
+   // TBufferFile keeps its data when expanded, and gives up its buffer when
+   // detached. The threads fill the buffers they acquire with their own
+   // value and check it before releasing them: a buffer handed out to two
+   // threads at once would be overwritten.
+
+   Long64_t maxRetained = TBufferPool::GetMaxRetainedBytes();
+   TBufferPool::Clear();
+   TBufferPool::ResetStatistics();
+
+   size_t size = 1000;
+   char *buf = TBufferPool::Acquire(size);
+   if (size != 1024) {
+      printf("\nAcquire(1000) returned %lu bytes instead of 1024\n", (unsigned long)size);
+      return kFALSE;
+   }
+   TBufferPool::Release(buf, size);
+   size_t size2 = 1000;
+   char *buf2 = TBufferPool::Acquire(size2);
+   if (buf2 != buf || TBufferPool::GetNReused() != 1 || TBufferPool::GetRetainedBytes() != 0) {
+      printf("\nthe released buffer is not reused: %p instead of %p, %llu reused, %lld bytes retained\n",
+             (void*)buf2, (void*)buf, TBufferPool::GetNReused(), TBufferPool::GetRetainedBytes());
+      return kFALSE;
+   }
+   // 1000 bytes is not the size of a size class.
+   TBufferPool::Release(buf2, 1000);
+   if (TBufferPool::GetNFreed() != 1 || TBufferPool::GetRetainedBytes() != 0) {
+      printf("\na buffer of 1000 bytes is kept by the pool\n");
+      return kFALSE;
+   }
+
+   // Only two buffers of 2048 bytes fit under the cap.
+   TBufferPool::SetMaxRetainedBytes(4096);
+   char *bufs[3];
+   for (Int_t i = 0; i < 3; ++i) {
+      size = 2048;
+      bufs[i] = TBufferPool::Acquire(size);
+   }
+   for (Int_t i = 0; i < 3; ++i) TBufferPool::Release(bufs[i], 2048);
+   Long64_t retained = TBufferPool::GetRetainedBytes();
+   TBufferPool::SetMaxRetainedBytes(maxRetained);
+   if (retained != 4096 || TBufferPool::GetNFreed() != 2) {
+      printf("\n%lld bytes retained instead of 4096 and %llu buffers freed instead of 2\n",
+             retained, TBufferPool::GetNFreed());
+      return kFALSE;
+   }
+   TBufferPool::Clear();
+
+   ULong64_t nreleased;
+   {
+      TBufferFile b(TBuffer::kWrite, 1000, 0, kTRUE, TBufferPool::ReAllocChar);
+      if (!b.TestBit(TBuffer::kIsPooled)) {
+         printf("\nthe TBufferFile does not use the pool\n");
+         return kFALSE;
+      }
+      for (Int_t i = 0; i < 10000; ++i) b.WriteInt(i);
+      b.SetReadMode();
+      b.SetBufferOffset(0);
+      for (Int_t i = 0; i < 10000; ++i) {
+         Int_t value;
+         b.ReadInt(value);
+         if (value != i) {
+            printf("\nvalue %d read instead of %d from the expanded TBufferFile\n", value, i);
+            return kFALSE;
+         }
+      }
+      // The caller owns the detached buffer, the TBufferFile must not give
+      // it back to the pool.
+      char *detached = b.Buffer();
+      b.DetachBuffer();
+      if (b.TestBit(TBuffer::kIsPooled)) {
+         printf("\nthe detached TBufferFile is still pooled\n");
+         return kFALSE;
+      }
+      delete [] detached;
+      nreleased = TBufferPool::GetNReleased();
+   }
+   if (TBufferPool::GetNReleased() != nreleased) {
+      printf("\nthe deleted TBufferFile gave its detached buffer back to the pool\n");
+      return kFALSE;
+   }
+
+   std::atomic<Int_t> nerrors(0);
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < gNthreads; ++t) {
+      threads.emplace_back([&, t]() {
+         const Int_t nheld = 8;
+         char *held[nheld];
+         size_t sizes[nheld];
+         for (Int_t i = 0; i < gNiter / 10; ++i) {
+            for (Int_t k = 0; k < nheld; ++k) {
+               sizes[k] = 256 + ((i * 7 + k * 13 + t) % 64) * 64;
+               held[k] = TBufferPool::Acquire(sizes[k]);
+               memset(held[k], t, sizes[k]);
+            }
+            std::this_thread::yield();
+            for (Int_t k = 0; k < nheld; ++k) {
+               for (size_t j = 0; j < sizes[k]; ++j) {
+                  if (held[k][j] != (char)t) {
+                     ++nerrors;
+                     break;
+                  }
+               }
+               TBufferPool::Release(held[k], sizes[k]);
+            }
+         }
+      });
+   }
+   for (auto &thread : threads) thread.join();
+
+   if (nerrors) {
+      printf("\n%d buffers were used by two threads at once\n", (Int_t)nerrors);
+      return kFALSE;
+   }
+   // The buffers of the finished threads went back to the global pool.
+   if (TBufferPool::GetRetainedBytes() <= 0 || TBufferPool::GetRetainedBytes() > maxRetained) {
+      printf("\n%lld bytes retained after the threads finished\n", TBufferPool::GetRetainedBytes());
+      return kFALSE;
+   }
+   TBufferPool::Clear();
+   if (TBufferPool::GetRetainedBytes() != 0) {
+      printf("\n%lld bytes retained after Clear\n", TBufferPool::GetRetainedBytes());
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Int_t stressThreads(Int_t nthreads, Int_t niter, Int_t verbose)
+{
+   gNthreads = nthreads;
+   gNiter = niter;
+   gVerbose = verbose != 0;
+
+   printf("**********************************************************************\n");
+   printf("****************Starting the threads stress test**********************\n");
+   printf("**********************************************************************\n");
+
+   Int_t retval = 0;
+   using fcnCharPtrPair = std::pair<std::function<bool()>,const char*>;
+   std::list<fcnCharPtrPair> testDescrList = {
+      {Test1, "Test1: gCoreMutex with thread safety enabled----------------------- "},
+      {Test2, "Test2: Readers and writers of TRWMutex----------------------------- "},
+      {Test3, "Test3: Writer starvation and read lock upgrade of TRWMutex--------- "},
+      {Test4, "Test4: Concurrent TClass::GetClass--------------------------------- "},
+      {Test5, "Test5: TBufferPool reuse and ownership----------------------------- "}
+   };
+
+   for (auto const & testDescrPair : testDescrList) {
+      auto test = testDescrPair.first;
+      auto descr = testDescrPair.second;
+      Bool_t testRes = test();
+      retval += !testRes; // increment by one upon failure
+      printf("%s %s\n", descr, testRes ? "OK" : "FAILED" );
+   }
+
+   printf("**********************************************************************\n");
+   return retval;
+}
+//_____________________________batch only_____________________
+#ifndef __CINT__
+
+int main(int argc, char *argv[])
+{
+   gROOT->SetBatch();
+   TApplication theApp("App", &argc, argv);
+   Int_t nthreads = 8;
+   Int_t niter = 100000;
+   if (argc > 1) nthreads = atoi(argv[1]);
+   if (argc > 2) niter = atoi(argv[2]);
+   Int_t verbose = 0;
+   if (argc > 3) verbose = atoi(argv[3]);
+   return stressThreads(nthreads, niter, verbose);
+}
+
+#endif
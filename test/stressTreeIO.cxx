@@ -0,0 +1,945 @@
+// @(#)root/test:$Id$
+// Author: agent   18/10/2026
+
+/////////////////////////////////////////////////////////////////
+//
+//___A stress test for the reading, writing and merging of trees___
+//
+//   The functions below test
+//   - Test1() - TFileMerger with the implicit multi-threading against the
+//               sequential merge, bit for bit
+//   - Test2() - branches used by a TTreeCache saved in its learn file and
+//               reused by the next reading of the same tree
+//   - Test3() - trees read from a memory mapped file against the ones read
+//               with read calls, compressed and uncompressed
+//   - Test4() - round trip of small baskets compressed with a trained
+//               dictionary, with ZLIB and ZSTD
+//   - Test5() - TBranch::GetBulkEntries and GetEntriesSerialized against
+//               TBranch::GetEntry, for all the basic types
+//   - Test6() - round trip of the tree compressed with LZ4 and ZSTD
+//   - Test7() - tree written with the baskets compressed in parallel against
+//               the one written sequentially, basket for basket
+//   - Test8() - trees read through a TTreeCache with and without the
+//               asynchronous reads of TFile::ReadBuffers
+//   - Test9() - round trip of a fast clone recompressing the baskets,
+//               sequentially and in parallel
+//   - Test10() - round trip of the data members streamed as one array: a
+//               fixed size array, runs of members of the same type, object
+//               wise and member wise in a collection
+//
+//   To run in batch mode, do
+//     stressTreeIO
+//     stressTreeIO 10000
+//     stressTreeIO 10000 5
+//   Here the 1st parameter is the number of entries in each TTree,
+//            2nd parameter is the number of created files
+//   Default values are 10000 5
+//
+//   An example of output when all tests pass:
+// **********************************************************************
+// ****************Starting the tree I/O stress test*********************
+// **********************************************************************
+// ***********Generating 5 data files, 1 tree of 10000 in each***********
+// **********************************************************************
+// Test1: Parallel and sequential TFileMerger------------------------- OK
+// Test2: TTreeCache learn file--------------------------------------- OK
+// Test3: Memory mapped and read files-------------------------------- OK
+// Test4: Baskets compressed with a dictionary------------------------ OK
+// Test5: Bulk reading of the branches-------------------------------- OK
+// Test6: LZ4 and ZSTD compression------------------------------------ OK
+// Test7: Parallel compression of the baskets------------------------- OK
+// Test8: Asynchronous reads of the TTreeCache------------------------ OK
+// Test9: Recompression of the baskets of a fast clone---------------- OK
+// Test10: Data members streamed as one array------------------------- OK
+// **********************************************************************
+// *******************Deleting the data files****************************
+// **********************************************************************
+
+#include <functional>
+#include <list>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include "Bytes.h"
+#include "Compression.h"
+#include "RConfigure.h"
+#include "TApplication.h"
+#include "TAttLine.h"
+#include "TBasket.h"
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH2Poly.h"
+#include "TRandom.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+
+Int_t stressTreeIO(Int_t nentries = 10000, Int_t nfiles = 5);
+void MakeTrees(Int_t nentries, Int_t nfiles);
+
+const char *gRootFileNameTemplate = "stressTreeIO_%d.root";
+const char *gMergedFileName       = "stressTreeIO_merged.root";
+Int_t gNentries = 10000;
+Int_t gNfiles   = 5;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if h1 and h2 have bit for bit the same contents, errors,
+/// labels and statistics.
+
+Bool_t IdenticalHistograms(const TH1 *h1, const TH1 *h2)
+{
+   if (!h1 || !h2 || h1->GetNcells() != h2->GetNcells() || h1->GetEntries() != h2->GetEntries())
+      return kFALSE;
+   for (Int_t bin = 0; bin < h1->GetNcells(); ++bin) {
+      if (h1->GetBinContent(bin) != h2->GetBinContent(bin) || h1->GetBinError(bin) != h2->GetBinError(bin))
+         return kFALSE;
+   }
+   for (Int_t bin = 1; bin <= h1->GetXaxis()->GetNbins(); ++bin) {
+      if (strcmp(h1->GetXaxis()->GetBinLabel(bin), h2->GetXaxis()->GetBinLabel(bin)))
+         return kFALSE;
+   }
+   Double_t stats1[TH1::kNstat], stats2[TH1::kNstat];
+   h1->GetStats(stats1);
+   h2->GetStats(stats2);
+   for (Int_t i = 0; i < TH1::kNstat; ++i) {
+      if (stats1[i] != stats2[i]) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the histograms of all the data files into gMergedFileName.
+
+Bool_t MergeFiles(Bool_t histoOneGo)
+{
+   TFileMerger merger(kFALSE, histoOneGo);
+   merger.SetNotrees(kTRUE);
+   merger.SetPrintLevel(0);
+   for (Int_t i = 0; i < gNfiles; ++i)
+      merger.AddFile(Form(gRootFileNameTemplate, i), kFALSE);
+   merger.OutputFile(gMergedFileName, "RECREATE");
+   return merger.Merge();
+}
+
+Bool_t Test1()
+{
+   // Merge the files sequentially and with the implicit multi-threading,
+   // in one go and file by file: the merged histograms must be identical,
+   // the weighted sums and the alphanumeric labels included.
+
+   const char *names[] = {"hw", "hlab", "hxy"};
+   for (Int_t pass = 0; pass < 2; ++pass) {
+      Bool_t oneGo = (pass == 0);
+      if (!MergeFiles(oneGo)) return kFALSE;
+      TH1 *ref[3];
+      {
+         TFile f(gMergedFileName);
+         for (Int_t i = 0; i < 3; ++i) {
+            ref[i] = (TH1*)f.Get(names[i]);
+            if (ref[i]) ref[i]->SetDirectory(0);
+         }
+      }
+
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT();
+#endif
+      Bool_t ok = MergeFiles(oneGo);
+#ifdef R__USE_IMT
+      ROOT::DisableImplicitMT();
+#endif
+      if (ok) {
+         TFile f(gMergedFileName);
+         for (Int_t i = 0; i < 3; ++i) {
+            if (!IdenticalHistograms(ref[i], (TH1*)f.Get(names[i]))) {
+               printf("\nmerged histogram %s differs (one go: %d)\n", names[i], oneGo);
+               ok = kFALSE;
+            }
+         }
+      }
+      for (Int_t i = 0; i < 3; ++i) delete ref[i];
+      if (!ok) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the branches x and n of the tree of the data file i through a
+/// TTreeCache saving the branches used in learnfile. Return in key the key
+/// of the tree in learnfile, and in learning and ncached whether the cache
+/// was learning and how many branches it held after the first entry.
+
+void ReadWithLearnFile(Int_t i, const char *learnfile, TString &key, Bool_t &learning, Int_t &ncached)
+{
+   TFile f(Form(gRootFileNameTemplate, i));
+   TTree *tree = (TTree*)f.Get("T");
+   tree->SetBranchStatus("*", 0);
+   tree->SetBranchStatus("x", 1);
+   tree->SetBranchStatus("n", 1);
+   tree->SetCacheSize(10000000);
+   TTreeCache *tc = (TTreeCache*)f.GetCacheRead(tree);
+   tc->SetLearnFile(learnfile);
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree->GetEntry(entry);
+      if (entry == 0) {
+         learning = tc->IsLearning();
+         ncached = tc->GetCachedBranches()->GetEntriesFast();
+      }
+   }
+   key.Form("%s.T", f.GetUUID().AsString());
+   // Saves the branches used in the learn file.
+   delete tree;
+}
+
+Bool_t Test2()
+{
+   // The first reading learns the branches and saves them under the UUID of
+   // the file, the second one takes them from the learn file and does not
+   // learn. The tree of the same name in another file is not affected.
+
+   const char *learnfile = "stressTreeIO.cachelearn";
+   gSystem->Unlink(learnfile);
+   TString key0, key1;
+   Bool_t learning;
+   Int_t ncached;
+
+   ReadWithLearnFile(0, learnfile, key0, learning, ncached);
+   TString saved;
+   {
+      TEnv env;
+      env.ReadFile(learnfile, kEnvLocal);
+      saved = env.GetValue(key0, "");
+   }
+   if (!learning || saved != "x n") {
+      printf("\nfirst read: learning %d, saved branches '%s' under %s\n", learning, saved.Data(), key0.Data());
+      return kFALSE;
+   }
+
+   ReadWithLearnFile(0, learnfile, key0, learning, ncached);
+   if (learning || ncached != 2) {
+      printf("\nsecond read: learning %d with %d branches in the cache\n", learning, ncached);
+      return kFALSE;
+   }
+
+   if (gNfiles > 1) {
+      ReadWithLearnFile(1, learnfile, key1, learning, ncached);
+      if (!learning || key1 == key0) {
+         printf("\nother file: learning %d, key %s\n", learning, key1.Data());
+         return kFALSE;
+      }
+   }
+
+   // No temporary file is left behind.
+   void *dir = gSystem->OpenDirectory(".");
+   Bool_t leftover = kFALSE;
+   while (const char *entry = gSystem->GetDirEntry(dir)) {
+      if (TString(entry).BeginsWith(TString(learnfile) + ".")) leftover = kTRUE;
+   }
+   gSystem->FreeDirectory(dir);
+   gSystem->Unlink(learnfile);
+   if (leftover) {
+      printf("\ntemporary learn file left behind\n");
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if all the entries of the trees T of the two files are
+/// identical.
+
+Bool_t SameTrees(TFile &f1, TFile &f2)
+{
+   TTree *trees[2] = {(TTree*)f1.Get("T"), (TTree*)f2.Get("T")};
+   if (!trees[0] || !trees[1] || trees[0]->GetEntries() != trees[1]->GetEntries())
+      return kFALSE;
+   Int_t run[2], event[2], n[2];
+   Float_t x[2];
+   Double_t v[2][10];
+   for (Int_t t = 0; t < 2; ++t) {
+      trees[t]->SetBranchAddress("run", &run[t]);
+      trees[t]->SetBranchAddress("event", &event[t]);
+      trees[t]->SetBranchAddress("x", &x[t]);
+      trees[t]->SetBranchAddress("n", &n[t]);
+      trees[t]->SetBranchAddress("v", v[t]);
+   }
+   Long64_t nentries = trees[0]->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      if (trees[0]->GetEntry(entry) != trees[1]->GetEntry(entry))
+         return kFALSE;
+      if (run[0] != run[1] || event[0] != event[1] || x[0] != x[1] || n[0] != n[1] ||
+          memcmp(v[0], v[1], n[0] * sizeof(Double_t)))
+         return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test3()
+{
+   // Read the compressed tree of the first file and an uncompressed copy of
+   // it, whose baskets alias the mapping, with and without the memory
+   // mapping of the file: the entries must be the same.
+
+   const char *uncompressedName = "stressTreeIO_uncompressed.root";
+   {
+      TFile f(Form(gRootFileNameTemplate, 0));
+      TFile out(uncompressedName, "RECREATE", "", 0);
+      TTree *tree = (TTree*)f.Get("T");
+      TTree *copy = tree->CloneTree(-1);
+      copy->Write();
+      delete tree;
+   }
+
+   Bool_t ok = kTRUE;
+   TString names[2] = {Form(gRootFileNameTemplate, 0), uncompressedName};
+   for (Int_t i = 0; i < 2 && ok; ++i) {
+      TFile fread(names[i]);
+      TFile fmapped(names[i]);
+      if (!fmapped.SetMemoryMapped(kTRUE)) {
+         printf("\ncannot map %s\n", names[i].Data());
+         ok = kFALSE;
+      } else if (!SameTrees(fread, fmapped)) {
+         printf("\nthe memory mapped %s differs\n", names[i].Data());
+         ok = kFALSE;
+      }
+   }
+   gSystem->Unlink(uncompressedName);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the tree of the first data file into the file outName, with the
+/// compression settings and small baskets, all the branches being compressed
+/// with a dictionary trained on their first baskets when dictionary is true.
+
+void CopyTree(const char *outName, Int_t settings, Bool_t dictionary)
+{
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   TFile out(outName, "RECREATE", "", settings);
+   TTree *copy = tree->CloneTree(0);
+   // The branches of the clone keep the compression of the original ones.
+   TIter next(copy->GetListOfBranches());
+   while (TBranch *branch = (TBranch*)next())
+      branch->SetCompressionSettings(settings);
+   copy->SetBasketSize("*", 1000);
+   if (dictionary) copy->SetCompressionDictionary("*", 5);
+   copy->CopyEntries(tree);
+   copy->Write();
+}
+
+Bool_t Test4()
+{
+   // Write the tree with small baskets compressed with a dictionary, and
+   // read it back: the entries must be the ones of the original tree, and
+   // the dictionaries must have been trained and stored with the branches.
+
+   const char *dictName = "stressTreeIO_dictionary.root";
+   ROOT::ECompressionAlgorithm algorithms[2] = {ROOT::kZLIB, ROOT::kZSTD};
+   Bool_t ok = kTRUE;
+   for (Int_t a = 0; a < 2 && ok; ++a) {
+      CopyTree(dictName, ROOT::CompressionSettings(algorithms[a], 1), kTRUE);
+      TFile f(Form(gRootFileNameTemplate, 0));
+      TFile fdict(dictName);
+      TTree *tree = (TTree*)fdict.Get("T");
+      Int_t dictsize = 0;
+      if (!tree || !tree->GetBranch("x")->GetCompressionDictionary(dictsize) || dictsize <= 0) {
+         printf("\nalgorithm %d: no dictionary stored with the branch x\n", algorithms[a]);
+         ok = kFALSE;
+      } else if (!SameTrees(f, fdict)) {
+         printf("\nalgorithm %d: the tree compressed with a dictionary differs\n", algorithms[a]);
+         ok = kFALSE;
+      }
+   }
+   gSystem->Unlink(dictName);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the branch name, of len values of type T per entry, in bulk and
+/// serialized, and compare each entry with the one read by GetEntry.
+/// Return the number of wrong entries.
+
+template <typename T>
+Int_t CompareBulkEntries(TTree *tree, const char *name, Int_t len)
+{
+   TBranch *branch = tree->GetBranch(name);
+   T values[3];
+   branch->SetAddress(values);
+   TBufferFile bulk(TBuffer::kRead, 1000);
+   TBufferFile serialized(TBuffer::kRead, 1000);
+   Int_t nwrong = 0;
+   Long64_t nentries = branch->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ) {
+      Int_t n = branch->GetBulkEntries(entry, bulk);
+      if (n <= 0 || branch->GetEntriesSerialized(entry, serialized) != n) {
+         printf("\n%s: cannot read entry %lld in bulk\n", name, entry);
+         return nwrong + 1;
+      }
+      const T *bulkValues = reinterpret_cast<const T*>(bulk.Buffer());
+      char *serializedValues = serialized.Buffer();
+      for (Int_t i = 0; i < n; ++i) {
+         branch->GetEntry(entry + i);
+         Bool_t same = memcmp(values, bulkValues + i * len, len * sizeof(T)) == 0;
+         for (Int_t k = 0; k < len; ++k) {
+            T value;
+            frombuf(serializedValues, &value);
+            if (value != values[k]) same = kFALSE;
+         }
+         if (!same) {
+            if (nwrong < 10) printf("\n%s: entry %lld differs\n", name, entry + i);
+            ++nwrong;
+         }
+      }
+      entry += n;
+   }
+   return nwrong;
+}
+
+Bool_t Test5()
+{
+   // Write a branch of each basic type, and a fixed size array, in small
+   // baskets, and read them in bulk: the values must be the ones read entry
+   // by entry. A branch of variable size must be refused.
+
+   const char *bulkName = "stressTreeIO_bulk.root";
+   {
+      TFile f(bulkName, "RECREATE");
+      TTree *tree = new TTree("B", "bulk");
+      Char_t b;
+      Short_t s;
+      Int_t i, n;
+      Long64_t l;
+      Float_t x;
+      Double_t d, a[3], v[10];
+      Bool_t o;
+      tree->Branch("b", &b, "b/B");
+      tree->Branch("s", &s, "s/S");
+      tree->Branch("i", &i, "i/I");
+      tree->Branch("l", &l, "l/L");
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("d", &d, "d/D");
+      tree->Branch("o", &o, "o/O");
+      tree->Branch("a", a, "a[3]/D");
+      tree->Branch("n", &n, "n/I");
+      tree->Branch("v", v, "v[n]/D");
+      tree->SetBasketSize("*", 1000);
+      for (Int_t entry = 0; entry < gNentries; ++entry) {
+         b = (Char_t)gRandom->Integer(256);
+         s = (Short_t)(gRandom->Integer(65536) - 32768);
+         i = (Int_t)gRandom->Integer(2000000000) - 1000000000;
+         l = (Long64_t)i * 1000003;
+         x = gRandom->Gaus(0, 1);
+         d = gRandom->Gaus(0, 1);
+         o = gRandom->Rndm() > 0.5;
+         for (Int_t k = 0; k < 3; ++k) a[k] = gRandom->Rndm();
+         n = gRandom->Integer(10);
+         for (Int_t k = 0; k < n; ++k) v[k] = gRandom->Rndm();
+         tree->Fill();
+      }
+      tree->Write();
+   }
+
+   Int_t nwrong = 0;
+   {
+      TFile f(bulkName);
+      TTree *tree = (TTree*)f.Get("B");
+      nwrong += CompareBulkEntries<Char_t>(tree, "b", 1);
+      nwrong += CompareBulkEntries<Short_t>(tree, "s", 1);
+      nwrong += CompareBulkEntries<Int_t>(tree, "i", 1);
+      nwrong += CompareBulkEntries<Long64_t>(tree, "l", 1);
+      nwrong += CompareBulkEntries<Float_t>(tree, "x", 1);
+      nwrong += CompareBulkEntries<Double_t>(tree, "d", 1);
+      nwrong += CompareBulkEntries<Bool_t>(tree, "o", 1);
+      nwrong += CompareBulkEntries<Double_t>(tree, "a", 3);
+      TBufferFile buf(TBuffer::kRead, 1000);
+      if (tree->GetBranch("v")->GetBulkEntries(0, buf) != -1) {
+         printf("\nthe branch of variable size is read in bulk\n");
+         ++nwrong;
+      }
+   }
+   gSystem->Unlink(bulkName);
+   return nwrong == 0;
+}
+
+Bool_t Test6()
+{
+   // Copy the tree with LZ4 and ZSTD at the levels 1, 5 and 9, and read it
+   // back: the entries must be the ones of the original tree. When ROOT is
+   // built with the library, the baskets must have its signature (without
+   // it, the compression falls back to ZLIB).
+
+   const char *copyName = "stressTreeIO_algorithm.root";
+   struct {
+      ROOT::ECompressionAlgorithm fAlgorithm;
+      const char                 *fSignature;
+      Bool_t                      fSupported;
+   } algorithms[2] = {
+#ifdef R__HAS_LZ4
+      {ROOT::kLZ4, "L4", kTRUE},
+#else
+      {ROOT::kLZ4, "L4", kFALSE},
+#endif
+#ifdef R__HAS_ZSTD
+      {ROOT::kZSTD, "ZS", kTRUE}
+#else
+      {ROOT::kZSTD, "ZS", kFALSE}
+#endif
+   };
+   Int_t levels[3] = {1, 5, 9};
+   Bool_t ok = kTRUE;
+   for (Int_t a = 0; a < 2 && ok; ++a) {
+      for (Int_t l = 0; l < 3 && ok; ++l) {
+         CopyTree(copyName, ROOT::CompressionSettings(algorithms[a].fAlgorithm, levels[l]), kFALSE);
+         TFile f(Form(gRootFileNameTemplate, 0));
+         TFile fcopy(copyName);
+         if (!SameTrees(f, fcopy)) {
+            printf("\nalgorithm %d level %d: the copy differs\n", algorithms[a].fAlgorithm, levels[l]);
+            ok = kFALSE;
+            break;
+         }
+         if (!algorithms[a].fSupported) continue;
+         TTree *tree = (TTree*)fcopy.Get("T");
+         tree->ResetBranchAddresses();
+         TBranch *branch = tree->GetBranch("x");
+         TBasket *basket = branch->GetBasket(0);
+         char signature[2];
+         if (!basket || fcopy.ReadBuffer(signature, branch->GetBasketSeek(0) + basket->GetKeylen(), 2) ||
+             strncmp(signature, algorithms[a].fSignature, 2)) {
+            printf("\nalgorithm %d level %d: the baskets are not compressed with it\n", algorithms[a].fAlgorithm, levels[l]);
+            ok = kFALSE;
+         }
+      }
+   }
+   gSystem->Unlink(copyName);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the entries of the tree of the first data file into a new tree of
+/// the file outName, with small baskets and an AutoSave every 1000 entries,
+/// the implicit multi-threading of the tree being set to mt.
+
+void FillCopy(const char *outName, Bool_t mt)
+{
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   Int_t run, event, n;
+   Float_t x;
+   Double_t v[10];
+   tree->SetBranchAddress("run", &run);
+   tree->SetBranchAddress("event", &event);
+   tree->SetBranchAddress("x", &x);
+   tree->SetBranchAddress("n", &n);
+   tree->SetBranchAddress("v", v);
+
+   TFile out(outName, "RECREATE");
+   TTree *copy = new TTree("T", "stressTreeIO");
+   copy->Branch("run", &run, "run/I");
+   copy->Branch("event", &event, "event/I");
+   copy->Branch("x", &x, "x/F");
+   copy->Branch("n", &n, "n/I");
+   copy->Branch("v", v, "v[n]/D");
+   copy->SetBasketSize("*", 1000);
+   copy->SetImplicitMT(mt);
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree->GetEntry(entry);
+      copy->Fill();
+      if (entry % 1000 == 999) copy->AutoSave("SaveSelf");
+   }
+   copy->Write();
+}
+
+Bool_t Test7()
+{
+   // Write the tree with many small baskets, sequentially and with their
+   // compression done in parallel: the baskets must have the same sizes and
+   // places in both files, and the entries must be the same.
+
+   const char *seqName = "stressTreeIO_seqfill.root";
+   const char *mtName = "stressTreeIO_parfill.root"; // Same length as seqName, for the same layout.
+   FillCopy(seqName, kFALSE);
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   FillCopy(mtName, kTRUE);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   Bool_t ok = kTRUE;
+   {
+      TFile fseq(seqName);
+      TFile fmt(mtName);
+      TTree *trees[2] = {(TTree*)fseq.Get("T"), (TTree*)fmt.Get("T")};
+      TIter next(trees[0]->GetListOfBranches());
+      while (TBranch *bseq = (TBranch*)next()) {
+         TBranch *bmt = trees[1]->GetBranch(bseq->GetName());
+         Bool_t same = bmt && bseq->GetWriteBasket() == bmt->GetWriteBasket() &&
+                       bseq->GetZipBytes() == bmt->GetZipBytes();
+         for (Int_t b = 0; same && b < bseq->GetWriteBasket(); ++b) {
+            same = bseq->GetBasketSeek(b) == bmt->GetBasketSeek(b) &&
+                   bseq->GetBasketBytes()[b] == bmt->GetBasketBytes()[b];
+         }
+         if (!same) {
+            printf("\nthe baskets of the branch %s differ\n", bseq->GetName());
+            ok = kFALSE;
+         }
+      }
+      if (ok && !SameTrees(fseq, fmt)) {
+         printf("\nthe entries of the trees differ\n");
+         ok = kFALSE;
+      }
+   }
+   gSystem->Unlink(seqName);
+   gSystem->Unlink(mtName);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read all the entries of the tree of the data file i through a TTreeCache
+/// of all the branches, and append their values to values. Return the
+/// number of bytes read from the file.
+
+Long64_t ReadWithCache(Int_t i, std::vector<Double_t> &values)
+{
+   TFile f(Form(gRootFileNameTemplate, i));
+   TTree *tree = (TTree*)f.Get("T");
+   Int_t run, event, n;
+   Float_t x;
+   Double_t v[10];
+   tree->SetBranchAddress("run", &run);
+   tree->SetBranchAddress("event", &event);
+   tree->SetBranchAddress("x", &x);
+   tree->SetBranchAddress("n", &n);
+   tree->SetBranchAddress("v", v);
+   tree->SetCacheSize(100000);
+   tree->AddBranchToCache("*", kTRUE);
+   tree->StopCacheLearningPhase();
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree->GetEntry(entry);
+      values.push_back(run);
+      values.push_back(event);
+      values.push_back(x);
+      for (Int_t k = 0; k < n; ++k) values.push_back(v[k]);
+   }
+   return f.GetBytesRead();
+}
+
+Bool_t Test8()
+{
+   // Read the trees with a TTreeCache smaller than them, so that it is
+   // filled several times with many blocks, with TFile.AsyncReads off and
+   // on: the values and the number of bytes read must be the same.
+
+   Int_t asyncReads = gEnv->GetValue("TFile.AsyncReads", 0);
+   Bool_t ok = kTRUE;
+   for (Int_t i = 0; i < gNfiles && ok; ++i) {
+      std::vector<Double_t> values[2];
+      Long64_t nbytes[2];
+      for (Int_t async = 0; async < 2; ++async) {
+         gEnv->SetValue("TFile.AsyncReads", async);
+         nbytes[async] = ReadWithCache(i, values[async]);
+      }
+      if (values[0] != values[1] || nbytes[0] != nbytes[1]) {
+         printf("\nfile %d: %lld bytes read asynchronously instead of %lld, or different values\n", i, nbytes[1], nbytes[0]);
+         ok = kFALSE;
+      }
+   }
+   gEnv->SetValue("TFile.AsyncReads", asyncReads);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fast clone the tree of the first data file into the file outName, the
+/// baskets being recompressed with the compression settings.
+
+void RecompressTree(const char *outName, Int_t settings)
+{
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   TFile out(outName, "RECREATE", "", settings);
+   TTree *copy = tree->CloneTree(0);
+   TIter next(copy->GetListOfBranches());
+   while (TBranch *branch = (TBranch*)next())
+      branch->SetCompressionSettings(settings);
+   copy->CopyEntries(tree, -1, "fast Recompress");
+   copy->Write();
+}
+
+Bool_t Test9()
+{
+   // Fast clone the ZLIB tree with its baskets recompressed with LZMA,
+   // sequentially and with the implicit multi-threading: the baskets must
+   // be compressed with LZMA, at the same places in both files, and the
+   // entries must be the ones of the original tree.
+
+   const char *seqName = "stressTreeIO_seqrecompress.root";
+   const char *mtName = "stressTreeIO_parrecompress.root"; // Same length as seqName, for the same layout.
+   Int_t settings = ROOT::CompressionSettings(ROOT::kLZMA, 5);
+   RecompressTree(seqName, settings);
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   RecompressTree(mtName, settings);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   Bool_t ok = kTRUE;
+   {
+      TFile f(Form(gRootFileNameTemplate, 0));
+      TFile fseq(seqName);
+      TFile fmt(mtName);
+      if (!SameTrees(f, fseq) || !SameTrees(f, fmt)) {
+         printf("\nthe entries of the recompressed trees differ\n");
+         ok = kFALSE;
+      }
+      TTree *trees[2] = {(TTree*)fseq.Get("T"), (TTree*)fmt.Get("T")};
+      trees[0]->ResetBranchAddresses();
+      TIter next(trees[0]->GetListOfBranches());
+      while (TBranch *bseq = (TBranch*)next()) {
+         if (!ok) break;
+         TBranch *bmt = trees[1]->GetBranch(bseq->GetName());
+         Bool_t same = bmt && bseq->GetWriteBasket() == bmt->GetWriteBasket();
+         for (Int_t b = 0; same && b < bseq->GetWriteBasket(); ++b) {
+            same = bseq->GetBasketSeek(b) == bmt->GetBasketSeek(b) &&
+                   bseq->GetBasketBytes()[b] == bmt->GetBasketBytes()[b];
+         }
+         if (!same) {
+            printf("\nthe baskets of the branch %s differ\n", bseq->GetName());
+            ok = kFALSE;
+            break;
+         }
+         TBasket *basket = bseq->GetBasket(0);
+         char signature[2];
+         if (!basket || fseq.ReadBuffer(signature, bseq->GetBasketSeek(0) + basket->GetKeylen(), 2) ||
+             strncmp(signature, "XZ", 2)) {
+            printf("\nthe baskets of the branch %s are not recompressed\n", bseq->GetName());
+            ok = kFALSE;
+         }
+      }
+   }
+   gSystem->Unlink(seqName);
+   gSystem->Unlink(mtName);
+   return ok;
+}
+
+Bool_t Test10()
+{
+   // Write a TH2Poly (its overflow bins are a fixed size array) as a key and
+   // in an unsplit branch, and vectors of TAttLine (its three Short_t
+   // members are a regrouped run) unsplit, hence streamed member wise, and
+   // split. The tree header holds a run of Long64_t. Everything read back
+   // must be equal to what was written.
+
+   const char *arrayName = "stressTreeIO_arrays.root";
+   const Int_t nentries = 100;
+   auto makePoly = []() {
+      TH2Poly *h = new TH2Poly("poly", "poly", 0, 3, 0, 3);
+      for (Int_t i = 0; i < 3; ++i) {
+         for (Int_t j = 0; j < 3; ++j) h->AddBin(i, j, i + 1, j + 1);
+      }
+      h->SetDirectory(0);
+      return h;
+   };
+   TH2Poly *poly = makePoly();
+   std::vector<TAttLine> *lines = new std::vector<TAttLine>;
+   Long64_t header[3];
+   {
+      TFile f(arrayName, "RECREATE");
+      TTree *tree = new TTree("A", "arrays");
+      tree->Branch("poly", &poly, 32000, 0);
+      tree->Branch("lines", &lines, 32000, 0);
+      tree->Branch("splitlines.", &lines, 32000, 99);
+      gRandom->SetSeed(4357);
+      for (Int_t entry = 0; entry < nentries; ++entry) {
+         poly->Fill(gRandom->Uniform(-1, 4), gRandom->Uniform(-1, 4));
+         lines->resize(entry % 5);
+         for (auto &line : *lines) {
+            line.SetLineColor(gRandom->Integer(100));
+            line.SetLineStyle(gRandom->Integer(10));
+            line.SetLineWidth(gRandom->Integer(5));
+         }
+         tree->Fill();
+      }
+      poly->Write();
+      tree->Write();
+      header[0] = tree->GetEntries();
+      header[1] = tree->GetTotBytes();
+      header[2] = tree->GetZipBytes();
+   }
+
+   Int_t nwrong = 0;
+   {
+      TFile f(arrayName);
+      TH2Poly *keyPoly = (TH2Poly*)f.Get("poly");
+      for (Int_t bin = -9; keyPoly && bin <= 9; ++bin) {
+         if (bin != 0 && keyPoly->GetBinContent(bin) != poly->GetBinContent(bin)) ++nwrong;
+      }
+      if (!keyPoly || nwrong) {
+         printf("\nthe bins of the TH2Poly key differ\n");
+         ++nwrong;
+      }
+
+      TTree *tree = (TTree*)f.Get("A");
+      if (tree->GetEntries() != header[0] || tree->GetTotBytes() != header[1] || tree->GetZipBytes() != header[2]) {
+         printf("\nthe tree header differs\n");
+         ++nwrong;
+      }
+      TH2Poly *readPoly = 0;
+      std::vector<TAttLine> *readLines = 0, *readSplitLines = 0;
+      tree->SetBranchAddress("poly", &readPoly);
+      tree->SetBranchAddress("lines", &readLines);
+      tree->SetBranchAddress("splitlines.", &readSplitLines);
+      gRandom->SetSeed(4357);
+      delete poly;
+      poly = makePoly();
+      for (Int_t entry = 0; entry < nentries; ++entry) {
+         poly->Fill(gRandom->Uniform(-1, 4), gRandom->Uniform(-1, 4));
+         lines->resize(entry % 5);
+         for (auto &line : *lines) {
+            line.SetLineColor(gRandom->Integer(100));
+            line.SetLineStyle(gRandom->Integer(10));
+            line.SetLineWidth(gRandom->Integer(5));
+         }
+         tree->GetEntry(entry);
+         Bool_t same = readPoly && readLines && readSplitLines &&
+                       readLines->size() == lines->size() && readSplitLines->size() == lines->size();
+         for (Int_t bin = -9; same && bin <= 9; ++bin) {
+            if (bin != 0 && readPoly->GetBinContent(bin) != poly->GetBinContent(bin)) same = kFALSE;
+         }
+         for (size_t k = 0; same && k < lines->size(); ++k) {
+            const TAttLine &line = (*lines)[k];
+            for (const TAttLine &read : {(*readLines)[k], (*readSplitLines)[k]}) {
+               if (read.GetLineColor() != line.GetLineColor() || read.GetLineStyle() != line.GetLineStyle() ||
+                   read.GetLineWidth() != line.GetLineWidth())
+                  same = kFALSE;
+            }
+         }
+         if (!same) {
+            if (nwrong < 10) printf("\nentry %d differs\n", entry);
+            ++nwrong;
+         }
+      }
+      tree->ResetBranchAddresses();
+      delete readPoly;
+      delete readLines;
+      delete readSplitLines;
+   }
+   delete poly;
+   delete lines;
+   gSystem->Unlink(arrayName);
+   return nwrong == 0;
+}
+
+void MakeTrees(Int_t nentries, Int_t nfiles)
+{
+   const char *labels[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta"};
+   gRandom->SetSeed(4357);
+   Int_t event = 0;
+   for (Int_t i = 0; i < nfiles; ++i) {
+      TFile f(Form(gRootFileNameTemplate, i), "RECREATE");
+      TTree *tree = new TTree("T", "stressTreeIO");
+      Int_t run, n;
+      Float_t x;
+      Double_t v[10];
+      tree->Branch("run", &run, "run/I");
+      tree->Branch("event", &event, "event/I");
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("n", &n, "n/I");
+      tree->Branch("v", v, "v[n]/D");
+
+      TH1D *hw = new TH1D("hw", "weighted", 100, -4, 4);
+      hw->Sumw2();
+      // Each file sees its own subset of the labels.
+      Int_t nlabels = i + 3 < 7 ? i + 3 : 7;
+      TH1F *hlab = new TH1F("hlab", "labels", 3, 0, 3);
+      hlab->SetCanExtend(TH1::kAllAxes);
+      TH2F *hxy = new TH2F("hxy", "x vs v[0]", 40, -4, 4, 40, 0, 1);
+      for (Int_t j = 0; j < nentries; ++j) {
+         run = gRandom->Integer(20);
+         x = gRandom->Gaus(0, 1);
+         n = gRandom->Integer(10);
+         for (Int_t k = 0; k < n; ++k) v[k] = gRandom->Rndm();
+         tree->Fill();
+         ++event;
+         hw->Fill(x, gRandom->Rndm() * 1.7);
+         hlab->Fill(labels[run % nlabels], 1);
+         hxy->Fill(x, n ? v[0] : 0.5);
+      }
+      f.Write();
+   }
+}
+
+void CleanUp(Int_t nfiles)
+{
+   for (Int_t i = 0; i < nfiles; ++i)
+      gSystem->Unlink(Form(gRootFileNameTemplate, i));
+   gSystem->Unlink(gMergedFileName);
+}
+
+Int_t stressTreeIO(Int_t nentries, Int_t nfiles)
+{
+   gNentries = nentries;
+   gNfiles = nfiles;
+
+   MakeTrees(nentries, nfiles);
+   printf("**********************************************************************\n");
+   printf("****************Starting the tree I/O stress test*********************\n");
+   printf("**********************************************************************\n");
+   printf("***********Generating %d data files, 1 tree of %d in each***********\n", nfiles, nentries);
+   printf("**********************************************************************\n");
+
+   Int_t retval = 0;
+   using fcnCharPtrPair = std::pair<std::function<bool()>,const char*>;
+   std::list<fcnCharPtrPair> testDescrList = {
+      {Test1, "Test1: Parallel and sequential TFileMerger------------------------- "},
+      {Test2, "Test2: TTreeCache learn file--------------------------------------- "},
+      {Test3, "Test3: Memory mapped and read files-------------------------------- "},
+      {Test4, "Test4: Baskets compressed with a dictionary------------------------ "},
+      {Test5, "Test5: Bulk reading of the branches-------------------------------- "},
+      {Test6, "Test6: LZ4 and ZSTD compression------------------------------------ "},
+      {Test7, "Test7: Parallel compression of the baskets------------------------- "},
+      {Test8, "Test8: Asynchronous reads of the TTreeCache------------------------ "},
+      {Test9, "Test9: Recompression of the baskets of a fast clone---------------- "},
+      {Test10, "Test10: Data members streamed as one array------------------------- "}
+   };
+
+   for (auto const & testDescrPair : testDescrList) {
+      auto test = testDescrPair.first;
+      auto descr = testDescrPair.second;
+      Bool_t testRes = test();
+      retval += !testRes; // increment by one upon failure
+      printf("%s %s\n", descr, testRes ? "OK" : "FAILED" );
+   }
+
+   printf("**********************************************************************\n");
+   printf("*******************Deleting the data files****************************\n");
+   printf("**********************************************************************\n");
+   CleanUp(nfiles);
+   return retval;
+}
+//_____________________________batch only_____________________
+#ifndef __CINT__
+
+int main(int argc, char *argv[])
+{
+   gROOT->SetBatch();
+   TApplication theApp("App", &argc, argv);
+   Int_t nentries = 10000;
+   Int_t nfiles = 5;
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) nfiles = atoi(argv[2]);
+   return stressTreeIO(nentries, nfiles);
+}
+
+#endif
@@ -0,0 +1,689 @@
+// @(#)root/test:$Id$
+// Author: agent   18/10/2026
+
+/////////////////////////////////////////////////////////////////
+//
+//___A stress test for the tree player and the tree indices___
+//
+//   The functions below test
+//   - Test1() - TTreeBlockIndex lookups and range queries against the
+//               ones of TTreeIndex
+//   - Test2() - TTreeBlockIndex written with its tree, read back,
+//               appended to and written again
+//   - Test3() - TTreeBlockIndex built on a TChain
+//   - Test4() - TTree::Draw with the implicit multi-threading against the
+//               sequential one, on a TTree and on a TChain
+//   - Test5() - TDataFrame Count, Histo1D and Snapshot against TTree::Draw,
+//               sequentially and with the implicit multi-threading
+//   - Test6() - TTreeFormula::EvalBlock against EvalInstance
+//   - Test7() - zone maps of a fast cloned tree, and TTree::Draw skipping
+//               the baskets with them
+//   - Test8() - TTreeProcessorMT against TTree::Draw, on files, on a TChain
+//               and for a part of the entries
+//   - Test9() - TTreeReaderArray reading the members of a split
+//               std::vector as columns against the whole vector, on a TChain
+//
+//   To run in batch mode, do
+//     stressTreePlayer
+//     stressTreePlayer 10000
+//     stressTreePlayer 10000 3
+//   Here the 1st parameter is the number of entries in each TTree,
+//            2nd parameter is the number of created files
+//   Default values are 10000 3
+//
+//   An example of output when all tests pass:
+// **********************************************************************
+// ****************Starting the tree player stress test******************
+// **********************************************************************
+// ***********Generating 3 data files, 1 tree of 10000 in each***********
+// **********************************************************************
+// Test1: TTreeBlockIndex lookups and ranges vs TTreeIndex------------ OK
+// Test2: TTreeBlockIndex file round trip and Append------------------ OK
+// Test3: TTreeBlockIndex on a TChain--------------------------------- OK
+// Test4: Parallel and sequential TTree::Draw------------------------- OK
+// Test5: TDataFrame results and event loops-------------------------- OK
+// Test6: TTreeFormula evaluated by block----------------------------- OK
+// Test7: Zone maps of a fast clone and basket skipping--------------- OK
+// Test8: TTreeProcessorMT results------------------------------------ OK
+// Test9: TTreeReaderArray columns of a split std::vector------------- OK
+// **********************************************************************
+// *******************Deleting the data files****************************
+// **********************************************************************
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include "TApplication.h"
+#include "TAttLine.h"
+#include "TChain.h"
+#include "TDataFrame.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TMath.h"
+#include "TRandom.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeBlockIndex.h"
+#include "TTreeFormula.h"
+#include "TTreeIndex.h"
+#include "TTreeProcessorMT.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
+
+Int_t stressTreePlayer(Int_t nentries = 10000, Int_t nfiles = 3);
+void MakeTrees(Int_t nentries, Int_t nfiles);
+
+const char *gRootFileNameTemplate = "stressTreePlayer_%d.root";
+Int_t gNentries = 10000;
+Int_t gNfiles   = 3;
+
+Bool_t Test1()
+{
+   // Build both indices on the first tree, with small blocks so that the
+   // lookups go through many of them, and compare all the lookups.
+
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   TTreeIndex index(tree, "run", "event");
+   TTreeBlockIndex bindex(tree, "run", "event", 64);
+   if (bindex.IsZombie() || bindex.GetN() != index.GetN() || bindex.GetNblocks() < 2) {
+      printf("\nTTreeBlockIndex has %lld entries in %lld blocks, TTreeIndex %lld\n",
+             bindex.GetN(), bindex.GetNblocks(), index.GetN());
+      return kFALSE;
+   }
+
+   Int_t run, event;
+   tree->SetBranchAddress("run", &run);
+   tree->SetBranchAddress("event", &event);
+   Int_t nwrong = 0;
+   for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+      tree->GetEntry(i);
+      if (bindex.GetEntryNumberWithIndex(run, event) != i) ++nwrong;
+      // Missing pairs, between and after the existing ones.
+      if (bindex.GetEntryNumberWithIndex(run + 20, event) != -1) ++nwrong;
+      if (bindex.GetEntryNumberWithBestIndex(run, event + 1) != index.GetEntryNumberWithBestIndex(run, event + 1)) ++nwrong;
+      if (bindex.GetEntryNumberWithBestIndex(run + 20, event) != index.GetEntryNumberWithBestIndex(run + 20, event)) ++nwrong;
+   }
+   if (bindex.GetEntryNumberWithBestIndex(-1, 0) != -1) ++nwrong;
+
+   // Range of runs, compared with a scan of the tree.
+   std::vector<Long64_t> entries, expected;
+   bindex.GetEntryNumbersWithMajorRange(5, 9, entries);
+   for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+      tree->GetEntry(i);
+      if (run >= 5 && run <= 9) expected.push_back(i);
+   }
+   std::sort(entries.begin(), entries.end());
+   if (entries != expected) ++nwrong;
+
+   if (nwrong) {
+      printf("\nnumber of wrong lookups=%d\n", nwrong);
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test2()
+{
+   // Write the index with its tree in a copy of the first file, read it back,
+   // append it to itself and write it again: the lookups must stay right.
+
+   const char *copy = "stressTreePlayer_index.root";
+   {
+      TFile in(Form(gRootFileNameTemplate, 0));
+      TFile out(copy, "RECREATE");
+      TTree *tree = ((TTree*)in.Get("T"))->CloneTree(-1, "fast");
+      tree->SetTreeIndex(new TTreeBlockIndex(tree, "run", "event", 64));
+      tree->Write();
+   }
+
+   Int_t nwrong = 0;
+   for (Int_t pass = 0; pass < 2; ++pass) {
+      TFile f(copy, "UPDATE");
+      TTree *tree = (TTree*)f.Get("T");
+      TTreeBlockIndex *bindex = dynamic_cast<TTreeBlockIndex*>(tree->GetTreeIndex());
+      Long64_t n = tree->GetEntries();
+      if (!bindex || bindex->GetN() != n * (pass + 1)) {
+         printf("\npass %d: the index read back is %s with %lld entries\n", pass,
+                bindex ? "a TTreeBlockIndex" : "not a TTreeBlockIndex", bindex ? bindex->GetN() : 0);
+         return kFALSE;
+      }
+
+      Int_t run, event;
+      tree->SetBranchAddress("run", &run);
+      tree->SetBranchAddress("event", &event);
+      for (Long64_t i = 0; i < n; ++i) {
+         tree->GetEntry(i);
+         if (bindex->GetEntryNumberWithIndex(run, event) != i) ++nwrong;
+      }
+
+      if (pass == 0) {
+         // The appended entries follow the ones of the tree, their keys
+         // replace the ones of the blocks read.
+         TTreeBlockIndex add(tree, "run", "event", 64);
+         bindex->Append(&add, kTRUE);
+         bindex->Append(0, kFALSE);
+         tree->Write("", TObject::kOverwrite);
+      }
+   }
+   gSystem->Unlink(copy);
+
+   if (nwrong) {
+      printf("\nnumber of wrong lookups=%d\n", nwrong);
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test3()
+{
+   // A single index on the chain of all the files.
+
+   TChain chain("T");
+   for (Int_t i = 0; i < gNfiles; ++i) chain.Add(Form(gRootFileNameTemplate, i));
+   TTreeBlockIndex *bindex = new TTreeBlockIndex(&chain, "run", "event", 256);
+   chain.SetTreeIndex(bindex);
+
+   Int_t run, event;
+   chain.SetBranchAddress("run", &run);
+   chain.SetBranchAddress("event", &event);
+   Int_t nwrong = 0;
+   Long64_t n = chain.GetEntries();
+   if (bindex->GetN() != n) ++nwrong;
+   for (Long64_t i = 0; i < n; i += 7) {
+      chain.GetEntry(i);
+      if (chain.GetEntryNumberWithIndex(run, event) != i) ++nwrong;
+   }
+   chain.SetTreeIndex(0);
+   delete bindex;
+
+   if (nwrong) {
+      printf("\nnumber of wrong lookups=%d\n", nwrong);
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if h1 and h2 have the same binning and the same contents,
+/// up to the rounding of the sums done in another order.
+
+Bool_t SameHistograms(const TH1 *h1, const TH1 *h2)
+{
+   if (h1->GetNcells() != h2->GetNcells() || h1->GetEntries() != h2->GetEntries())
+      return kFALSE;
+   const TAxis *axes1[3] = {h1->GetXaxis(), h1->GetYaxis(), h1->GetZaxis()};
+   const TAxis *axes2[3] = {h2->GetXaxis(), h2->GetYaxis(), h2->GetZaxis()};
+   for (Int_t a = 0; a < 3; ++a) {
+      if (axes1[a]->GetXmin() != axes2[a]->GetXmin() || axes1[a]->GetXmax() != axes2[a]->GetXmax())
+         return kFALSE;
+   }
+   for (Int_t bin = 0; bin < h1->GetNcells(); ++bin) {
+      Double_t c1 = h1->GetBinContent(bin);
+      Double_t c2 = h2->GetBinContent(bin);
+      if (TMath::Abs(c1 - c2) > 1e-9 * TMath::Max(1., TMath::Abs(c1)))
+         return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t Test4()
+{
+   // Draw the same expressions sequentially and with the implicit
+   // multi-threading, where the entries after the first buffer of values
+   // are processed by parallel tasks: the histograms must be the same.
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   const char *draws[][3] = {
+      {"x",                      "y>0",  "goff"},
+      {"x>>hfixed(50,-3,3)",     "",     "goff"},
+      {"x:y",                    "n>2",  "goff colz"},
+      {"v",                      "x<1",  "goff"},
+      {"y:x>>hprof(20,-3,3)",    "",     "goff prof"},
+      {"x:y:v",                  "",     "goff box"}
+   };
+
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   TChain chain("T");
+   for (Int_t i = 0; i < gNfiles; ++i) chain.Add(Form(gRootFileNameTemplate, i));
+   TTree *trees[2] = {tree, &chain};
+
+   Int_t nwrong = 0;
+   for (Int_t t = 0; t < 2; ++t) {
+      for (UInt_t d = 0; d < sizeof(draws) / sizeof(draws[0]); ++d) {
+         trees[t]->SetImplicitMT(kFALSE);
+         Long64_t nseq = trees[t]->Draw(draws[d][0], draws[d][1], draws[d][2]);
+         TH1 *hseq = (TH1*)trees[t]->GetHistogram()->Clone("hseq");
+         hseq->SetDirectory(0);
+         trees[t]->SetImplicitMT(kTRUE);
+         Long64_t nmt = trees[t]->Draw(draws[d][0], draws[d][1], draws[d][2]);
+         if (nmt != nseq || !SameHistograms(hseq, trees[t]->GetHistogram())) {
+            printf("\n%s: Draw(\"%s\",\"%s\") differs, %lld rows instead of %lld\n",
+                   t ? "chain" : "tree", draws[d][0], draws[d][1], nmt, nseq);
+            ++nwrong;
+         }
+         delete hseq;
+      }
+   }
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   return nwrong == 0;
+}
+
+Bool_t Test5()
+{
+   // Book a Count and a Histo1D on the entries with y>0 of the chain, and
+   // compare them with TTree::Draw, sequentially and with the implicit
+   // multi-threading. The model histogram holds an entry which must not
+   // appear in the results, and the histogram of a second event loop must
+   // not accumulate the first one. A Snapshot runs its own event loop only.
+
+   using namespace ROOT::Experimental;
+   const char *snapshotName = "stressTreePlayer_snapshot.root";
+   TChain chain("T");
+   for (Int_t i = 0; i < gNfiles; ++i) chain.Add(Form(gRootFileNameTemplate, i));
+   Long64_t nref = chain.Draw("x>>href(50,-3,3)", "y>0", "goff");
+   TH1 *href = (TH1*)chain.GetHistogram()->Clone("hrefclone");
+   href->SetDirectory(0);
+
+   TH1D model("model", "x", 50, -3, 3);
+   model.Fill(0.);
+   Int_t nwrong = 0;
+   for (Int_t mt = 0; mt < 2; ++mt) {
+#ifdef R__USE_IMT
+      if (mt) ROOT::EnableImplicitMT();
+#else
+      if (mt) break;
+#endif
+      TDataFrame d(chain, {"x"});
+      auto positive = d.Filter([](Float_t y) { return y > 0; }, {"y"});
+      auto n = positive.Count();
+      auto h1 = positive.Histo1D<Float_t>(model);
+      if ((Long64_t)*n != nref || !SameHistograms(href, &*h1)) {
+         printf("\nmt %d: first loop, %llu entries instead of %lld\n", mt, *n, nref);
+         ++nwrong;
+      }
+      auto h2 = positive.Histo1D<Float_t>(model);
+      if (!SameHistograms(href, &*h2)) {
+         printf("\nmt %d: the second loop differs from the first one\n", mt);
+         ++nwrong;
+      }
+
+      auto pending = positive.Count();
+      {
+         auto snapshot = positive.Snapshot<Float_t>("S", snapshotName, {"x"});
+         if (pending.IsReady() || (Long64_t)*snapshot.Count() != nref) {
+            printf("\nmt %d: Snapshot ran the pending actions or wrote the wrong entries\n", mt);
+            ++nwrong;
+         }
+      }
+      if ((Long64_t)*pending != nref) {
+         printf("\nmt %d: %llu entries after the Snapshot instead of %lld\n", mt, *pending, nref);
+         ++nwrong;
+      }
+      gSystem->Unlink(snapshotName);
+   }
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   if (model.GetEntries() != 1) {
+      printf("\nthe model histogram has %g entries\n", model.GetEntries());
+      ++nwrong;
+   }
+   delete href;
+   return nwrong == 0;
+}
+
+Bool_t Test6()
+{
+   // Evaluate formulas using all the kinds of operations by block, and
+   // entry by entry with EvalInstance: the values must be the same.
+
+   const char *exprs[] = {
+      "x*2+y-3/y",
+      "sqrt(abs(x))*sin(y)+cos(x)/tan(y)",
+      "exp(x)-log(abs(y))+log10(abs(y))+pow(x,2)",
+      "atan2(y,x)+fmod(y,3)+min(x,y)-max(x,y)+sign(x)*int(y)",
+      "acos(x/4)+asin(x/4)+atan(x)+cosh(x)+sinh(x)-tanh(y)+acosh(abs(y))+asinh(y)+atanh(x/4)",
+      "x>0 && y<5 || !(n==3) && (run!=2)",
+      "(x<y)+(x>y)+(x<=y)+(x>=y)-x*x",
+      "(run&5)+(run|2)+(run<<2)+(n>>1)+n%3+pi",
+      "-x+sq(y)"
+   };
+
+   TFile f(Form(gRootFileNameTemplate, 0));
+   TTree *tree = (TTree*)f.Get("T");
+   const Long64_t nentries = tree->GetEntries();
+   std::vector<Double_t> values(1000);
+   Int_t nwrong = 0;
+   for (UInt_t e = 0; e < sizeof(exprs) / sizeof(exprs[0]); ++e) {
+      TTreeFormula formula("formula", exprs[e], tree);
+      Long64_t entry = 0;
+      while (entry < nentries) {
+         Int_t n = formula.EvalBlock(entry, (Int_t)values.size(), values.data());
+         if (n <= 0) {
+            printf("\n%s cannot be evaluated by block at entry %lld\n", exprs[e], entry);
+            ++nwrong;
+            break;
+         }
+         for (Int_t k = 0; k < n; ++k) {
+            tree->LoadTree(entry + k);
+            formula.GetNdata();
+            Double_t value = formula.EvalInstance();
+            if (TMath::Abs(value - values[k]) > 1e-12 * TMath::Max(1., TMath::Abs(value)) &&
+                !(value != value && values[k] != values[k])) {
+               if (nwrong < 10)
+                  printf("\n%s at entry %lld: %g by block, %g by instance\n", exprs[e], entry + k, values[k], value);
+               ++nwrong;
+            }
+         }
+         entry += n;
+      }
+   }
+   return nwrong == 0;
+}
+
+Bool_t Test7()
+{
+   // Write a tree with zone maps on a slowly increasing leaf, so that most
+   // baskets can be skipped, and fast clone it: the clone must have the
+   // same basket ranges, and TTree::Draw the same results on both.
+
+   const char *inName = "stressTreePlayer_zone.root";
+   const char *outName = "stressTreePlayer_zoneclone.root";
+   const Float_t cut = gNentries / 2;
+   Float_t x;
+   Int_t n;
+   Long64_t nref = 0;
+   {
+      TFile f(inName, "RECREATE");
+      TTree *tree = new TTree("Z", "zone maps");
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("n", &n, "n/I");
+      tree->SetBasketSize("*", 1000);
+      tree->SetZoneMaps("x");
+      for (Int_t i = 0; i < gNentries; ++i) {
+         x = i + gRandom->Uniform(0, 10);
+         n = i % 7;
+         if (x > cut && n != 3) ++nref;
+         tree->Fill();
+      }
+      tree->Write();
+   }
+
+   Int_t nwrong = 0;
+   {
+      TFile fin(inName);
+      TTree *in = (TTree*)fin.Get("Z");
+      TFile fout(outName, "RECREATE");
+      TTree *out = in->CloneTree(-1, "fast");
+      out->Write();
+
+      TBranch *bin = in->GetBranch("x");
+      TBranch *bout = out->GetBranch("x");
+      if (!bin->HasZoneMaps() || !bout->HasZoneMaps() || bin->GetWriteBasket() != bout->GetWriteBasket()) {
+         printf("\nThe clone has no zone maps or a different number of baskets\n");
+         return kFALSE;
+      }
+      for (Int_t b = 0; b < bin->GetWriteBasket(); ++b) {
+         Double_t minin, maxin, minout, maxout;
+         if (!bin->GetBasketRange(b, minin, maxin) || !bout->GetBasketRange(b, minout, maxout) ||
+             minin != minout || maxin != maxout || minout == -TMath::Infinity()) {
+            if (nwrong < 10)
+               printf("\nBasket %d: range [%g,%g] in the clone, [%g,%g] in the input\n", b, minout, maxout, minin, maxin);
+            ++nwrong;
+         }
+      }
+
+      TString sel = Form("x>%g && n!=3", cut);
+      Long64_t nin = in->Draw("x", sel, "goff");
+      Long64_t nout = out->Draw("x", sel, "goff");
+      if (nin != nref || nout != nref) {
+         printf("\n%s selects %lld entries in the input, %lld in the clone instead of %lld\n", sel.Data(), nin, nout, nref);
+         ++nwrong;
+      }
+   }
+   gSystem->Unlink(inName);
+   gSystem->Unlink(outName);
+   return nwrong == 0;
+}
+
+Bool_t Test8()
+{
+   // Fill a histogram of x for y>0 with TTreeProcessorMT, with one and with
+   // two clusters per task, from the file names (with and without the name
+   // of the tree) and from a TChain, sequentially and with the implicit
+   // multi-threading: the merged result must be the one of TTree::Draw. A
+   // limit on the number of entries spanning two files is also checked.
+
+   TChain chain("T");
+   std::vector<std::string> fileNames;
+   for (Int_t i = 0; i < gNfiles; ++i) {
+      chain.Add(Form(gRootFileNameTemplate, i));
+      fileNames.push_back(Form(gRootFileNameTemplate, i));
+   }
+   chain.Draw("x>>hprocref(50,-3,3)", "y>0", "goff");
+   TH1 *href = (TH1*)chain.GetHistogram()->Clone("hprocrefclone");
+   href->SetDirectory(0);
+   const Long64_t npart = gNfiles > 1 ? gNentries + gNentries / 2 : gNentries / 2;
+   chain.Draw("x>>hprocpart(50,-3,3)", "y>0", "goff", npart);
+   TH1 *hpart = (TH1*)chain.GetHistogram()->Clone("hprocpartclone");
+   hpart->SetDirectory(0);
+
+   auto fillX = [](TTreeReader &reader) {
+      TTreeReaderValue<Float_t> x(reader, "x");
+      TTreeReaderValue<Float_t> y(reader, "y");
+      TH1F *h = new TH1F("hproc", "x", 50, -3, 3);
+      while (reader.Next()) {
+         if (*y > 0) h->Fill(*x);
+      }
+      return h;
+   };
+
+   Int_t nwrong = 0;
+   for (Int_t mt = 0; mt < 2; ++mt) {
+#ifdef R__USE_IMT
+      if (mt) ROOT::EnableImplicitMT();
+#else
+      if (mt) break;
+#endif
+      for (UInt_t clusters = 1; clusters <= 2; ++clusters) {
+         TTreeProcessorMT processor;
+         processor.SetClustersPerTask(clusters);
+         TH1F *results[4] = {
+            processor.ProcTree(fileNames, fillX, "T"),
+            processor.ProcTree(fileNames, fillX, ""),
+            processor.ProcTree(chain, fillX),
+            processor.ProcTree(fileNames, fillX, "T", npart)
+         };
+         for (Int_t r = 0; r < 4; ++r) {
+            if (!results[r] || !SameHistograms(r == 3 ? hpart : href, results[r])) {
+               printf("\nmt %d, %u clusters per task: result %d differs from TTree::Draw\n", mt, clusters, r);
+               ++nwrong;
+            }
+            delete results[r];
+         }
+      }
+#ifdef R__USE_IMT
+      if (mt) ROOT::DisableImplicitMT();
+#endif
+   }
+   delete href;
+   delete hpart;
+   return nwrong == 0;
+}
+
+Bool_t Test9()
+{
+   // Write a split std::vector<TAttLine> in two files, and read its Short_t
+   // members with TTreeReaderArray, which reads them as columns, from a
+   // chain of both files: the values must be the ones of the vectors read
+   // whole with TTreeReaderValue, entry by entry and across the files.
+
+   const char *columnTemplate = "stressTreePlayer_columns_%d.root";
+   std::vector<TAttLine> *lines = new std::vector<TAttLine>;
+   for (Int_t ifile = 0; ifile < 2; ++ifile) {
+      TFile f(Form(columnTemplate, ifile), "RECREATE");
+      TTree *tree = new TTree("C", "columns");
+      tree->Branch("lines", &lines, 32000, 99);
+      for (Int_t i = 0; i < gNentries; ++i) {
+         lines->resize(gRandom->Integer(8));
+         for (auto &line : *lines) {
+            line.SetLineColor(gRandom->Integer(100));
+            line.SetLineStyle(gRandom->Integer(10));
+            line.SetLineWidth(gRandom->Integer(5));
+         }
+         tree->Fill();
+      }
+      tree->Write();
+   }
+   delete lines;
+
+   std::vector<std::vector<Short_t>> expected;
+   {
+      TChain chain("C");
+      for (Int_t ifile = 0; ifile < 2; ++ifile) chain.Add(Form(columnTemplate, ifile));
+      TTreeReader reader(&chain);
+      TTreeReaderValue<std::vector<TAttLine>> whole(reader, "lines");
+      while (reader.Next()) {
+         std::vector<Short_t> values;
+         for (const auto &line : *whole) {
+            values.push_back(line.GetLineColor());
+            values.push_back(line.GetLineStyle());
+            values.push_back(line.GetLineWidth());
+         }
+         expected.push_back(values);
+      }
+   }
+
+   Int_t nwrong = 0;
+   {
+      TChain chain("C");
+      for (Int_t ifile = 0; ifile < 2; ++ifile) chain.Add(Form(columnTemplate, ifile));
+      TTreeReader reader(&chain);
+      TTreeReaderArray<Short_t> colors(reader, "lines.fLineColor");
+      TTreeReaderArray<Short_t> styles(reader, "lines.fLineStyle");
+      TTreeReaderArray<Short_t> widths(reader, "lines.fLineWidth");
+      size_t entry = 0;
+      while (reader.Next()) {
+         Bool_t same = entry < expected.size() && colors.GetSize() * 3 == expected[entry].size() &&
+                       styles.GetSize() == colors.GetSize() && widths.GetSize() == colors.GetSize();
+         for (size_t k = 0; same && k < colors.GetSize(); ++k) {
+            same = colors[k] == expected[entry][3 * k] && styles[k] == expected[entry][3 * k + 1] &&
+                   widths[k] == expected[entry][3 * k + 2];
+         }
+         if (!same) {
+            if (nwrong < 10) printf("\nentry %d: the columns differ from the vector\n", (Int_t)entry);
+            ++nwrong;
+         }
+         ++entry;
+      }
+      if (entry != expected.size()) {
+         printf("\n%d entries read as columns instead of %d\n", (Int_t)entry, (Int_t)expected.size());
+         ++nwrong;
+      }
+   }
+   for (Int_t ifile = 0; ifile < 2; ++ifile) gSystem->Unlink(Form(columnTemplate, ifile));
+   return nwrong == 0;
+}
+
+void MakeTrees(Int_t nentries, Int_t nfiles)
+{
+   // Creates nfiles files with a tree of nentries each. The pairs
+   // (run,event) are unique over all the files, and not sorted.
+
+   Int_t run, event, n;
+   Float_t x, y, v[10];
+   gRandom->SetSeed(4357);
+   for (Int_t ifile = 0; ifile < nfiles; ++ifile) {
+      TFile f(Form(gRootFileNameTemplate, ifile), "RECREATE");
+      TTree *tree = new TTree("T", "stressTreePlayer");
+      tree->Branch("run", &run, "run/I");
+      tree->Branch("event", &event, "event/I");
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("y", &y, "y/F");
+      tree->Branch("n", &n, "n/I");
+      tree->Branch("v", v, "v[n]/F");
+      for (Int_t i = 0; i < nentries; ++i) {
+         run = gRandom->Integer(20);
+         event = ifile * nentries + i;
+         x = gRandom->Gaus(0, 1);
+         y = gRandom->Uniform(-10, 10);
+         n = gRandom->Integer(10);
+         for (Int_t j = 0; j < n; ++j) v[j] = gRandom->Uniform(0, 100);
+         tree->Fill();
+      }
+      tree->Write();
+   }
+}
+
+void CleanUp(Int_t nfiles)
+{
+   for (Int_t i = 0; i < nfiles; ++i)
+      gSystem->Unlink(Form(gRootFileNameTemplate, i));
+}
+
+Int_t stressTreePlayer(Int_t nentries, Int_t nfiles)
+{
+   gNentries = nentries;
+   gNfiles = nfiles;
+
+   MakeTrees(nentries, nfiles);
+   printf("**********************************************************************\n");
+   printf("****************Starting the tree player stress test******************\n");
+   printf("**********************************************************************\n");
+   printf("***********Generating %d data files, 1 tree of %d in each***********\n", nfiles, nentries);
+   printf("**********************************************************************\n");
+
+   Int_t retval = 0;
+   using fcnCharPtrPair = std::pair<std::function<bool()>,const char*>;
+   std::list<fcnCharPtrPair> testDescrList = {
+      {Test1, "Test1: TTreeBlockIndex lookups and ranges vs TTreeIndex------------ "},
+      {Test2, "Test2: TTreeBlockIndex file round trip and Append------------------ "},
+      {Test3, "Test3: TTreeBlockIndex on a TChain--------------------------------- "},
+      {Test4, "Test4: Parallel and sequential TTree::Draw------------------------- "},
+      {Test5, "Test5: TDataFrame results and event loops-------------------------- "},
+      {Test6, "Test6: TTreeFormula evaluated by block----------------------------- "},
+      {Test7, "Test7: Zone maps of a fast clone and basket skipping--------------- "},
+      {Test8, "Test8: TTreeProcessorMT results------------------------------------ "},
+      {Test9, "Test9: TTreeReaderArray columns of a split std::vector------------- "}
+   };
+
+   for (auto const & testDescrPair : testDescrList) {
+      auto test = testDescrPair.first;
+      auto descr = testDescrPair.second;
+      Bool_t testRes = test();
+      retval += !testRes; // increment by one upon failure
+      printf("%s %s\n", descr, testRes ? "OK" : "FAILED" );
+   }
+
+   printf("**********************************************************************\n");
+   printf("*******************Deleting the data files****************************\n");
+   printf("**********************************************************************\n");
+   CleanUp(nfiles);
+   return retval;
+}
+//_____________________________batch only_____________________
+#ifndef __CINT__
+
+int main(int argc, char *argv[])
+{
+   gROOT->SetBatch();
+   TApplication theApp("App", &argc, argv);
+   Int_t nentries = 10000;
+   Int_t nfiles = 3;
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) nfiles = atoi(argv[2]);
+   return stressTreePlayer(nentries, nfiles);
+}
+
+#endif
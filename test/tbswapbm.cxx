@@ -0,0 +1,117 @@
+// @(#)root/test:$Id$
+// Author: agent   18/10/2026
+
+#include <stdlib.h>
+
+#include "Riostream.h"
+#include "Bytes.h"
+#include "TBufferFile.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+//
+// This program benchmarks the conversion of arrays of basic types from
+// and to their on-file (big endian) representation done by
+// TBufferFile::ReadFastArray and TBufferFile::WriteFastArray, and compares
+// it with the element by element conversion done with frombuf/tobuf.
+//
+// Usage: tbswapbm [nelements] [ntimes]
+//
+// parameters:
+//       nelements     - number of elements of the arrays (default 100000)
+//       ntimes        - number of conversions of each array (default 1000)
+//
+
+Int_t nelements = 100000;   // Number of elements per array.
+Int_t ntimes    = 1000;     // Number of conversions.
+Int_t nerrors   = 0;        // Number of arrays not restored identically.
+
+//_____________________________________________________________
+// Print the throughput of one benchmark in MB/s.
+void Report(const char *type, const char *what, Double_t seconds, Long64_t nbytes)
+{
+   Double_t mbs = seconds > 0 ? nbytes/seconds/1048576. : 0;
+   std::cout << TString::Format("%-10s %-22s %8.3f s %10.1f MB/s", type, what, seconds, mbs) << std::endl;
+}
+
+//_____________________________________________________________
+// Benchmark the conversions of an array of n elements of type T.
+template <typename T>
+void Bench(const char *type)
+{
+   T *in  = new T[nelements];
+   T *out = new T[nelements];
+   for (Int_t i = 0; i < nelements; ++i)
+      in[i] = (T)(rand() - RAND_MAX/2);
+
+   Long64_t nbytes = (Long64_t)sizeof(T)*nelements*ntimes;
+   TBufferFile b(TBuffer::kWrite, sizeof(T)*nelements + 1024);
+   TStopwatch timer;
+
+   // Element by element conversion, as done by frombuf/tobuf.
+   timer.Start();
+   for (Int_t t = 0; t < ntimes; ++t) {
+      char *buf = b.Buffer();
+      for (Int_t i = 0; i < nelements; ++i)
+         tobuf(buf, in[i]);
+   }
+   timer.Stop();
+   Report(type, "tobuf loop", timer.RealTime(), nbytes);
+
+   timer.Start();
+   for (Int_t t = 0; t < ntimes; ++t) {
+      char *buf = b.Buffer();
+      for (Int_t i = 0; i < nelements; ++i)
+         frombuf(buf, &out[i]);
+   }
+   timer.Stop();
+   Report(type, "frombuf loop", timer.RealTime(), nbytes);
+
+   // Array conversion of TBufferFile.
+   timer.Start();
+   for (Int_t t = 0; t < ntimes; ++t) {
+      b.SetWriteMode();
+      b.SetBufferOffset(0);
+      b.WriteFastArray(in, nelements);
+   }
+   timer.Stop();
+   Report(type, "WriteFastArray", timer.RealTime(), nbytes);
+
+   timer.Start();
+   for (Int_t t = 0; t < ntimes; ++t) {
+      b.SetReadMode();
+      b.SetBufferOffset(0);
+      b.ReadFastArray(out, nelements);
+   }
+   timer.Stop();
+   Report(type, "ReadFastArray", timer.RealTime(), nbytes);
+
+   for (Int_t i = 0; i < nelements; ++i) {
+      if (in[i] != out[i]) {
+         std::cout << type << ": element " << i << " not restored identically" << std::endl;
+         ++nerrors;
+         break;
+      }
+   }
+   delete [] in;
+   delete [] out;
+}
+
+//_____________________________________________________________
+int main(int argc, char **argv)
+{
+   if (argc > 1) nelements = atoi(argv[1]);
+   if (argc > 2) ntimes = atoi(argv[2]);
+   if (nelements <= 0 || ntimes <= 0) {
+      std::cout << "Usage: tbswapbm [nelements] [ntimes]" << std::endl;
+      return 1;
+   }
+
+   Bench<Short_t>("Short_t");
+   Bench<Int_t>("Int_t");
+   Bench<Long64_t>("Long64_t");
+   Bench<Float_t>("Float_t");
+   Bench<Double_t>("Double_t");
+
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+// @(#)root/test:$Id$
+// Author: agent   18/10/2026
+
+#include <stdlib.h>
+
+#include "Riostream.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCacheUnzip.h"
+
+//
+// This program benchmarks the reading of a compressed tree through the
+// TTreeCacheUnzip, with the baskets of a cluster unzipped by the reading
+// thread only and with the baskets unzipped ahead by parallel tasks
+// (requires ROOT to be built with imt), and checks that both reads give
+// the same values.
+//
+// Usage: tunzipbm [nentries] [nbranches] [ntimes]
+//
+// parameters:
+//       nentries      - number of entries of the tree (default 200000)
+//       nbranches     - number of Float_t[16] branches (default 20)
+//       ntimes        - number of reads of the tree per mode (default 3)
+//
+
+Int_t nentries  = 200000;   // Number of entries of the tree.
+Int_t nbranches = 20;       // Number of branches.
+Int_t ntimes    = 3;        // Number of reads per mode.
+
+const char *gFileName = "tunzipbm.root";
+const Int_t kNvalues  = 16;
+
+//_____________________________________________________________
+// Print the throughput of one benchmark in MB/s (uncompressed).
+void Report(const char *what, Double_t seconds, Long64_t nbytes)
+{
+   Double_t mbs = seconds > 0 ? nbytes/seconds/1048576. : 0;
+   std::cout << TString::Format("%-26s %8.3f s %10.1f MB/s", what, seconds, mbs) << std::endl;
+}
+
+//_____________________________________________________________
+// Write the tree, with compressible but not trivial values.
+Long64_t Write()
+{
+   TFile f(gFileName, "RECREATE", "", 1);
+   TTree t("T", "tunzipbm");
+   Float_t *values = new Float_t[nbranches*kNvalues];
+   for (Int_t b = 0; b < nbranches; ++b)
+      t.Branch(TString::Format("b%d", b), values + b*kNvalues, TString::Format("b%d[%d]/F", b, kNvalues));
+   for (Int_t i = 0; i < nentries; ++i) {
+      for (Int_t v = 0; v < nbranches*kNvalues; ++v)
+         values[v] = (Float_t)((rand() % 1000) * 0.01);
+      t.Fill();
+   }
+   t.Write();
+   delete [] values;
+   return t.GetTotBytes();
+}
+
+//_____________________________________________________________
+// Read all the entries, return the sum of the values.
+Double_t Read(Bool_t parallel, Double_t &seconds)
+{
+   TTreeCacheUnzip::SetParallelUnzip(parallel ? TTreeCacheUnzip::kEnable : TTreeCacheUnzip::kDisable);
+
+   // The cache is created by SetCacheSize, with the unzipping mode set above.
+   TFile f(gFileName);
+   TTree *t = (TTree*)f.Get("T");
+   t->SetCacheSize(30000000);
+   t->AddBranchToCache("*", kTRUE);
+   t->StopCacheLearningPhase();
+
+   Float_t *values = new Float_t[nbranches*kNvalues];
+   for (Int_t b = 0; b < nbranches; ++b)
+      t->SetBranchAddress(TString::Format("b%d", b), values + b*kNvalues);
+
+   TStopwatch timer;
+   timer.Start();
+   Double_t sum = 0;
+   Long64_t n = t->GetEntries();
+   for (Long64_t i = 0; i < n; ++i) {
+      t->GetEntry(i);
+      for (Int_t v = 0; v < nbranches*kNvalues; ++v)
+         sum += values[v];
+   }
+   timer.Stop();
+   seconds = timer.RealTime();
+
+   delete t;
+   delete [] values;
+   return sum;
+}
+
+//_____________________________________________________________
+int main(int argc, char **argv)
+{
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) nbranches = atoi(argv[2]);
+   if (argc > 3) ntimes = atoi(argv[3]);
+   if (nentries <= 0 || nbranches <= 0 || ntimes <= 0) {
+      std::cout << "Usage: tunzipbm [nentries] [nbranches] [ntimes]" << std::endl;
+      return 1;
+   }
+
+   Long64_t nbytes = Write();
+
+   Double_t seconds, best = 0;
+   Double_t ref = 0;
+   for (Int_t i = 0; i < ntimes; ++i) {
+      ref = Read(kFALSE, seconds);
+      if (i == 0 || seconds < best) best = seconds;
+   }
+   Report("sequential unzip", best, nbytes);
+   Double_t sequential = best;
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+   Int_t nerrors = 0;
+   for (Int_t i = 0; i < ntimes; ++i) {
+      Double_t sum = Read(kTRUE, seconds);
+      if (sum != ref) {
+         std::cout << "parallel unzip: sum " << sum << " differs from " << ref << std::endl;
+         ++nerrors;
+      }
+      if (i == 0 || seconds < best) best = seconds;
+   }
+   Report(TString::Format("parallel unzip (%u threads)", ROOT::GetImplicitMTPoolSize()), best, nbytes);
+   if (best > 0)
+      std::cout << TString::Format("speed-up %.2f", sequential/best) << std::endl;
+   gSystem->Unlink(gFileName);
+   return nerrors ? 1 : 0;
+#else
+   std::cout << "parallel unzip: not available, ROOT is built without imt" << std::endl;
+   gSystem->Unlink(gFileName);
+   return 0;
+#endif
+}
@@ -32,6 +32,7 @@
 
 
 class TFile;
+class TFileMapping;
 class TTree;
 class TBranch;
 
@@ -44,6 +45,7 @@ private:
    // Internal corner cases for ReadBasketBuffers
    Int_t ReadBasketBuffersUnzip(char*, Int_t, Bool_t, TFile*);
    Int_t ReadBasketBuffersUncompressedCase();
+   void  ReleaseMapping();
 
    // Helper for managing the compressed buffer.
    void InitializeCompressedBuffer(Int_t len, TFile* file);
@@ -60,6 +62,8 @@ protected:
    TBuffer    *fCompressedBufferRef; //! Compressed buffer.
    Bool_t      fOwnsCompressedBuffer; //! Whether or not we own the compressed buffer.
    Int_t       fLastWriteBufferSize; //! Size of the buffer last time we wrote it to disk
+   Int_t       fCompressedSize;  //! Number of bytes prepared by CompressBuffer and not yet written, -1 if none
+   TFileMapping *fMapping;       //! Memory mapped file content aliased by fBufferRef, if any
 
 public:
 
@@ -72,6 +76,7 @@ public:
    virtual void    DeleteEntryOffset();
    virtual Int_t   DropBuffers();
    TBranch        *GetBranch() const {return fBranch;}
+           Int_t   CompressBuffer(TFile *file);
            Int_t   GetBufferSize() const {return fBufferSize;}
            Int_t  *GetDisplacement() const {return fDisplacement;}
            Int_t  *GetEntryOffset() const {return fEntryOffset;}
@@ -87,6 +92,7 @@ public:
 
            Int_t   LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tree = 0);
    Long64_t        CopyTo(TFile *to);
+           Int_t   RecompressBuffer(Int_t cxlevel, Int_t cxAlgorithm, const char *dict = 0, Int_t dictsize = 0);
 
            void    SetBranch(TBranch *branch) { fBranch = branch; }
            void    SetNevBufSize(Int_t n) { fNevBufSize=n; }
@@ -40,6 +40,8 @@
 #include "TDataType.h"
 #endif
 
+#include <vector>
+
 class TTree;
 class TBasket;
 class TLeaf;
@@ -59,6 +61,7 @@ class TBranch : public TNamed , public TAttFill {
 
 protected:
    friend class TTreeCloner;
+   friend class TTree;
    // TBranch status bits
    enum EStatusBits {
       kAutoDelete = BIT(15),
@@ -97,9 +100,17 @@ protected:
    char       *fAddress;         //! Address of 1st leaf (variable or object)
    TDirectory *fDirectory;       //! Pointer to directory where this branch buffers are stored
    TString     fFileName;        //  Name of file where buffers are stored ("" if in same file as Tree header)
+   Int_t       fCompressDictBaskets; //  Number of baskets used to train the compression dictionary (0 if not used)
+   Int_t       fCompressDictMaxSize; //  Maximum size of the compression dictionary
+   Int_t       fCompressDictSize;    //  Size of the compression dictionary (0 until trained)
+   char       *fCompressDict;        //[fCompressDictSize] Compression dictionary shared by all the baskets
+   Double_t   *fBasketMin;       //[fMaxBaskets] Minimum value of the leaf in each basket (0 if there are no zone maps)
+   Double_t   *fBasketMax;       //[fMaxBaskets] Maximum value of the leaf in each basket (0 if there are no zone maps)
    TBuffer    *fEntryBuffer;     //! Buffer used to directly pass the content without streaming
    TBuffer    *fTransientBuffer; //! Pointer to the current transient buffer.
    TList      *fBrowsables;      //! List of TVirtualBranchBrowsables used for Browse()
+   std::vector<char>  fCompressDictSamples;     //! Content of the baskets collected to train the dictionary
+   std::vector<Int_t> fCompressDictSampleSizes; //! Size of each of the collected baskets
 
    Bool_t      fSkipZip;         //! After being read, the buffer will not be unzipped.
 
@@ -112,17 +123,20 @@ protected:
    void     ReadLeaves1Impl(TBuffer &b);
    void     ReadLeaves2Impl(TBuffer &b);
    void     FillLeavesImpl(TBuffer &b);
+   void     FillZoneMap(Bool_t first);
 
    void     SetSkipZip(Bool_t skip = kTRUE) { fSkipZip = skip; }
    void     Init(const char *name, const char *leaflist, Int_t compress);
 
    TBasket *GetFreshBasket();
+   TBuffer *GetEntryBuffer(Long64_t entry);
    Int_t    WriteBasket(TBasket* basket, Int_t where);
 
    TString  GetRealFileName() const;
 
 private:
    Int_t FillEntryBuffer(TBasket* basket,TBuffer* buf, Int_t& lnew);
+   Int_t FillBulkBuffer(Long64_t entry, TBuffer &user_buf, Bool_t deserialize);
    TBranch(const TBranch&);             // not implemented
    TBranch& operator=(const TBranch&);  // not implemented
 
@@ -134,6 +148,7 @@ public:
 
    virtual void      AddBasket(TBasket &b, Bool_t ondisk, Long64_t startEntry);
    virtual void      AddLastBasket(Long64_t startEntry);
+           void      AddCompressionDictionarySample(const char *buffer, Int_t size);
    virtual void      Browse(TBrowser *b);
    virtual void      DeleteBaskets(Option_t* option="");
    virtual void      DropBaskets(Option_t *option = "");
@@ -148,6 +163,7 @@ public:
            TBasket  *GetBasket(Int_t basket);
            Int_t    *GetBasketBytes() const {return fBasketBytes;}
            Long64_t *GetBasketEntry() const {return fBasketEntry;}
+           Bool_t    GetBasketRange(Int_t basket, Double_t &min, Double_t &max) const;
    virtual Long64_t  GetBasketSeek(Int_t basket) const;
    virtual Int_t     GetBasketSize() const {return fBasketSize;}
    virtual TList    *GetBrowsables();
@@ -155,9 +171,12 @@ public:
            Int_t     GetCompressionAlgorithm() const;
            Int_t     GetCompressionLevel() const;
            Int_t     GetCompressionSettings() const;
+   const char       *GetCompressionDictionary(Int_t &size) const { size = fCompressDictSize; return fCompressDict; }
    TDirectory       *GetDirectory() const {return fDirectory;}
    virtual Int_t     GetEntry(Long64_t entry=0, Int_t getall = 0);
    virtual Int_t     GetEntryExport(Long64_t entry, Int_t getall, TClonesArray *list, Int_t n);
+           Int_t     GetBulkEntries(Long64_t entry, TBuffer &user_buf);
+           Int_t     GetEntriesSerialized(Long64_t entry, TBuffer &user_buf);
            Int_t     GetEntryOffsetLen() const { return fEntryOffsetLen; }
            Int_t     GetEvent(Long64_t entry=0) {return GetEntry(entry);}
    const char       *GetIconName() const;
@@ -165,6 +184,7 @@ public:
    virtual TLeaf    *GetLeaf(const char *name) const;
    virtual TFile    *GetFile(Int_t mode=0);
    const char       *GetFileName()    const {return fFileName.Data();}
+   TString           GetFullName() const;
            Int_t     GetOffset()      const {return fOffset;}
            Int_t     GetReadBasket()  const {return fReadBasket;}
            Long64_t  GetReadEntry()   const {return fReadEntry;}
@@ -178,6 +198,7 @@ public:
          TObjArray  *GetListOfBranches() {return &fBranches;}
          TObjArray  *GetListOfLeaves()   {return &fLeaves;}
            Int_t     GetMaxBaskets()  const  {return fMaxBaskets;}
+           Bool_t    HasZoneMaps()    const  {return fBasketMin != 0;}
            Int_t     GetNleaves()     const {return fNleaves;}
            Int_t     GetSplitLevel()  const {return fSplitLevel;}
            Long64_t  GetEntries()     const {return fEntries;}
@@ -205,6 +226,7 @@ public:
    virtual void      SetBufferAddress(TBuffer *entryBuffer);
    void              SetCompressionAlgorithm(Int_t algorithm=0);
    void              SetCompressionLevel(Int_t level=1);
+   virtual void      SetCompressionDictionary(Int_t nbaskets = 10, Int_t maxsize = 16384);
    void              SetCompressionSettings(Int_t settings=1);
    virtual void      SetEntries(Long64_t entries);
    virtual void      SetEntryOffsetLen(Int_t len, Bool_t updateSubBranches = kFALSE);
@@ -216,12 +238,13 @@ public:
    virtual void      SetStatus(Bool_t status=1);
    virtual void      SetTree(TTree *tree) { fTree = tree;}
    virtual void      SetupAddresses();
+   virtual Bool_t    SetZoneMaps(Bool_t enable = kTRUE);
    virtual void      UpdateAddress() {;}
    virtual void      UpdateFile();
 
    static  void      ResetCount();
 
-   ClassDef(TBranch,12);  //Branch descriptor
+   ClassDef(TBranch,13);  //Branch descriptor
 };
 
 //______________________________________________________________________________
@@ -184,6 +184,7 @@ public:
    TVirtualCollectionProxy *GetCollectionProxy();
    TClass                  *GetCurrentClass(); // Class referenced by transient description
    virtual Int_t            GetEntry(Long64_t entry = 0, Int_t getall = 0);
+           Int_t            GetEntryColumn(Long64_t entry, TBuffer &user_buf);
    virtual Int_t            GetExpectedType(TClass *&clptr,EDataType &type);
            const char      *GetIconName() const;
            Int_t            GetID() const { return fID; }
@@ -91,6 +91,7 @@ public:
    virtual Bool_t   IsUnsigned() const { return fIsUnsigned; }
    virtual void     PrintValue(Int_t i = 0) const;
    virtual void     ReadBasket(TBuffer&) {}
+   virtual Bool_t   ReadBasketFast(TBuffer&, void* /*output*/, Int_t /*n*/) { return kFALSE; }
    virtual void     ReadBasketExport(TBuffer&, TClonesArray*, Int_t) {}
    virtual void     ReadValue(std::istream& /*s*/, Char_t /*delim*/ = ' ') {
       Error("ReadValue", "Not implemented!");
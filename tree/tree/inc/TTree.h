@@ -152,6 +152,8 @@ protected:
    Bool_t         fIMTEnabled;        //! true if implicit multi-threading is enabled for this tree
    UInt_t         fNEntriesSinceSorting; //! Number of entries processed since the last re-sorting of branches
    std::vector<std::pair<Long64_t,TBranch*>> fSortedBranches; //! Branches sorted by average task time
+   Bool_t         fIMTFlush;          //! true if TBranch::Fill must leave its full basket to TTree::Fill for compression
+   std::vector<TBranch*> fIMTFullBranches; //! Branches whose full basket is compressed in parallel at the end of TTree::Fill
 
    static Int_t     fgBranchStyle;      //  Old/New branch style
    static Long64_t  fgMaxTreeSize;      //  Maximum size of a file containg a Tree
@@ -162,6 +164,8 @@ private:
 
    void             InitializeSortedBranches();
    void             SortBranchesByTime();
+   void             CollectBasketsToCompress(TBranch *branch, std::vector<std::pair<TBasket*,TFile*>> &baskets, Bool_t recursive) const;
+   void             CompressBaskets(const std::vector<std::pair<TBasket*,TFile*>> &baskets) const;
 
 protected:
    void             AddClone(TTree*);
@@ -201,9 +205,12 @@ protected:
    friend class TFriendLock;
    // So that the index class can use TFriendLock:
    friend class TTreeIndex;
+   friend class TTreeBlockIndex;
    friend class TChainIndex;
    // So that the TTreeCloner can access the protected interfaces
    friend class TTreeCloner;
+   // So that TBranch::Fill can hand its full basket over to TTree::Fill
+   friend class TBranch;
 
    // use to update fFriendLockStatus
    enum ELockStatusBits {
@@ -538,6 +545,7 @@ public:
    virtual void            SetCacheLearnEntries(Int_t n=10);
    virtual void            SetChainOffset(Long64_t offset = 0) { fChainOffset=offset; }
    virtual void            SetCircular(Long64_t maxEntries);
+   virtual void            SetCompressionDictionary(const char* bname = "*", Int_t nbaskets = 10, Int_t maxsize = 16384);
    virtual void            SetDebug(Int_t level = 1, Long64_t min = 0, Long64_t max = 9999999); // *MENU*
    virtual void            SetDefaultEntryOffsetLen(Int_t newdefault, Bool_t updateExisting = kFALSE);
    virtual void            SetDirectory(TDirectory* dir);
@@ -560,6 +568,7 @@ public:
    virtual void            SetTimerInterval(Int_t msec = 333) { fTimerInterval=msec; }
    virtual void            SetTreeIndex(TVirtualIndex* index);
    virtual void            SetWeight(Double_t w = 1, Option_t* option = "");
+   virtual void            SetZoneMaps(const char* bname = "*", Bool_t enable = kTRUE);
    virtual void            SetUpdate(Int_t freq = 0) { fUpdate = freq; }
    virtual void            Show(Long64_t entry = -1, Int_t lenmax = 20);
    virtual void            StartViewer(); // *MENU*
@@ -30,6 +30,7 @@
 
 class TTree;
 class TBranch;
+class THashList;
 
 class TTreeCache : public TFileCacheRead {
 
@@ -61,11 +62,19 @@ protected:
    EPrefillType    fPrefillType; // Whether a prefilling is enabled (and if applicable which type)
    static  Int_t   fgLearnEntries; // number of entries used for learning mode
    Bool_t          fAutoCreated; //! true if cache was automatically created
+   Bool_t          fLearnLate;   //! true if the branches read after the learning phase are added to the cache
+   TString         fLearnFile;   //! file where the branches used are saved for the next jobs (see TTreeCache.LearnFile)
+   Bool_t          fLearnLoaded; //! true once the branches saved in fLearnFile have been looked for
+   TString         fLearnedNames;//! names of the branches read from fLearnFile
+   THashList      *fUsedBranches;//! names of the branches used, in the order of their first use (if fLearnFile is set)
 
 private:
    TTreeCache(const TTreeCache &);            //this class cannot be copied
    TTreeCache& operator=(const TTreeCache &);
 
+protected:
+   TString              GetLearnKey(TTree *tree) const;
+
 public:
 
    TTreeCache();
@@ -78,17 +87,23 @@ public:
    virtual void         Disable() {fEnabled = kFALSE;}
    virtual void         Enable() {fEnabled = kTRUE;}
    const TObjArray     *GetCachedBranches() const { return fBranches; }
+   TString              GetConfiguredLearnFile() const;
+   Bool_t               GetConfiguredLearnLate() const;
    EPrefillType         GetConfiguredPrefillType() const;
    Double_t             GetEfficiency() const;
    Double_t             GetEfficiencyRel() const;
    virtual Int_t        GetEntryMin() const {return fEntryMin;}
    virtual Int_t        GetEntryMax() const {return fEntryMax;}
    static Int_t         GetLearnEntries();
+   const char          *GetLearnFile() const {return fLearnFile;}
+   Bool_t               GetLearnLate() const {return fLearnLate;}
    virtual EPrefillType GetLearnPrefill() const {return fPrefillType;}
    TTree               *GetTree() const {return fTree;}
    Bool_t               IsAutoCreated() const {return fAutoCreated;}
    virtual Bool_t       IsEnabled() const {return fEnabled;}
    virtual Bool_t       IsLearning() const {return fIsLearning;}
+   virtual Int_t        LearnBranch(TBranch *b, Bool_t subbranches = kFALSE);
+   virtual Bool_t       LoadLearnedBranches();
 
    virtual Bool_t       FillBuffer();
    virtual void         LearnPrefill();
@@ -98,7 +113,10 @@ public:
    virtual Int_t        ReadBufferNormal(char *buf, Long64_t pos, Int_t len);
    virtual Int_t        ReadBufferPrefetch(char *buf, Long64_t pos, Int_t len);
    virtual void         ResetCache();
+   virtual void         SaveLearnedBranches();
    void                 SetAutoCreated(Bool_t val) {fAutoCreated = val;}
+   void                 SetLearnFile(const char *filename) {fLearnFile = filename;}
+   void                 SetLearnLate(Bool_t late = kTRUE) {fLearnLate = late;}
    virtual Int_t        SetBufferSize(Int_t buffersize);
    virtual void         SetEntryRange(Long64_t emin,   Long64_t emax);
    virtual void         SetFile(TFile *file, TFile::ECacheAction action=TFile::kDisconnect);
@@ -29,12 +29,13 @@
 #include "TTreeCache.h"
 #endif
 
-#include <queue>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
 
 class TTree;
 class TBranch;
-class TThread;
-class TCondition;
 class TBasket;
 class TMutex;
 
@@ -45,53 +46,51 @@ public:
    enum EParUnzipMode { kEnable, kDisable, kForce };
 
 protected:
+   // State of an entry of the unzipping arrays
+   enum EUnzipState { kUntouched, kProgress, kFinished };
 
    // Members for paral. managing
-   TThread    *fUnzipThread[10];
-   Bool_t      fActiveThread;          // Used to terminate gracefully the unzippers
-   TCondition *fUnzipStartCondition;   // Used to signal the threads to start.
-   TCondition *fUnzipDoneCondition;    // Used to wait for an unzip tour to finish. Gives the Async feel.
    Bool_t      fParallel;              // Indicate if we want to activate the parallelism (for this instance)
-   Bool_t      fAsyncReading;
-   TMutex     *fMutexList;             // Mutex to protect the various lists. Used by the condvars.
-   TMutex     *fIOMutex;
+   TMutex     *fMutexList;             // Mutex to protect the list of branches and the creation of the tasks
+   TMutex     *fIOMutex;               // Mutex to protect the reads through the cache
 
-   Int_t       fCycle;
    static TTreeCacheUnzip::EParUnzipMode fgParallel;  // Indicate if we want to activate the parallelism
 
-   Int_t       fLastReadPos;
-   Int_t       fBlocksToGo;
-
-   // Unzipping related members
+   // Unzipping related members, indexed like the sorted blocks of the cache (fSeekSort)
    Int_t      *fUnzipLen;         //! [fNseek] Length of the unzipped buffers
    char      **fUnzipChunks;      //! [fNseek] Individual unzipped chunks. Their summed size is kept under control.
-   Byte_t     *fUnzipStatus;      //! [fNSeek] For each blk, tells us if it's unzipped or pending
-   Long64_t    fTotalUnzipBytes;  //! The total sum of the currently unzipped blks
+   std::atomic<Byte_t> *fUnzipStatus; //! [fNSeek] For each blk, tells us if it's untouched, being unzipped or done
+   std::atomic<Long64_t> fTotalUnzipBytes; //! The total sum of the currently unzipped blks
 
    Int_t       fNseekMax;         //!  fNseek can change so we need to know its max size
    Long64_t    fUnzipBufferSize;  //!  Max Size for the ready unzipped blocks (default is 2*fBufferSize)
 
+   void       *fUnzipTaskGroup;   //! tbb::task_group running the unzipping tasks
+   std::atomic<Int_t>  fUnzipNext;     //! Next block to be picked up by the unzipping tasks
+   std::atomic<Int_t>  fNUnzipTasks;   //! Number of running unzipping tasks
+   std::atomic<Bool_t> fUnzipAbort;    //! Tells the running tasks to stop picking up blocks
+   std::mutex          fUnzipDoneMutex;//! Protects the wait of the reader on fUnzipDone
+   std::condition_variable fUnzipDone; //! Notified by the tasks when a block is done
+
    static Double_t fgRelBuffSize; // This is the percentage of the TTreeCacheUnzip that will be used
 
    // Members use to keep statistics
-   Int_t       fNUnzip;           //! number of blocks that were unzipped
-   Int_t       fNFound;           //! number of blocks that were found in the cache
-   Int_t       fNStalls;          //! number of hits which caused a stall
-   Int_t       fNMissed;          //! number of blocks that were not found in the cache and were unzipped
+   std::atomic<Int_t> fNUnzip;    //! number of blocks that were unzipped
+   std::atomic<Int_t> fNFound;    //! number of blocks that were found in the cache
+   std::atomic<Int_t> fNStalls;   //! number of hits which caused a stall
+   std::atomic<Int_t> fNMissed;   //! number of blocks that were not found in the cache and were unzipped
 
-   std::queue<Int_t>       fActiveBlks; // The blocks which are active now
+   std::map<Long64_t,TBranch*> fDictBranches; //! Branches using a compression dictionary, indexed by basket position
 
 private:
    TTreeCacheUnzip(const TTreeCacheUnzip &);            //this class cannot be copied
    TTreeCacheUnzip& operator=(const TTreeCacheUnzip &);
 
-   char *fCompBuffer;
-   Int_t fCompBufferSize;
-
    // Private methods
    void  Init();
-   Int_t StartThreadUnzip(Int_t nthreads);
-   Int_t StopThreadUnzip();
+   void  CreateTasks();
+   void  FinishUnzip(Int_t index);
+   void  StopTasks();
 
 public:
    TTreeCacheUnzip();
@@ -102,20 +101,15 @@ public:
    Bool_t              FillBuffer();
    virtual Int_t       ReadBufferExt(char *buf, Long64_t pos, Int_t len, Int_t &loc);
    void                SetEntryRange(Long64_t emin,   Long64_t emax);
+   virtual void        SetFile(TFile *file, TFile::ECacheAction action=TFile::kDisconnect);
    virtual void        StopLearningPhase();
    void                UpdateBranches(TTree *tree);
 
-   // Methods related to the thread
+   // Methods related to the parallel unzipping
    static EParUnzipMode GetParallelUnzip();
    static Bool_t        IsParallelUnzip();
    static Int_t         SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option = TTreeCacheUnzip::kEnable);
 
-   Bool_t               IsActiveThread();
-   Bool_t               IsQueueEmpty();
-
-   void                 WaitUnzipStartSignal();
-   void                 SendUnzipStartSignal(Bool_t broadcast);
-
    // Unzipping related methods
    Int_t          GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes, Int_t &objlen, Int_t &keylen);
    virtual void   ResetCache();
@@ -124,7 +118,8 @@ public:
    void           SetUnzipBufferSize(Long64_t bufferSize);
    static void    SetUnzipRelBufferSize(Float_t relbufferSize);
    Int_t          UnzipBuffer(char **dest, char *src);
-   Int_t          UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff);
+   Int_t          UnzipBuffer(char **dest, char *src, Long64_t pos);
+   Int_t          UnzipCache(Int_t index);
 
    // Methods to get stats
    Int_t  GetNUnzip() { return fNUnzip; }
@@ -133,8 +128,6 @@ public:
 
    void Print(Option_t* option = "") const;
 
-   // static members
-   static void* UnzipLoop(void *arg);
    ClassDef(TTreeCacheUnzip,0)  //Specialization of TTreeCache for parallel unzipping
 };
 
@@ -60,6 +60,7 @@ class TTreeCloner {
 
    UInt_t     fCloneMethod;      //Indicates which cloning method was selected.
    Long64_t   fToStartEntries;   //Number of entries in the target tree before any addition.
+   Bool_t     fRecompress;       //True if the baskets are recompressed with the settings of the output branches.
 
    enum ECloneMethod {
       kDefault             = 0,
@@ -85,6 +86,7 @@ class TTreeCloner {
    friend class CompareSeek;
    friend class CompareEntry;
 
+   void CopyBasketRange(TBranch *from, Int_t index, TBranch *to, Int_t where);
    void ImportClusterRanges();
 
 private:
@@ -11,6 +11,7 @@
 #include "TBasket.h"
 #include "TBuffer.h"
 #include "TBufferFile.h"
+#include "TBufferPool.h"
 #include "TTree.h"
 #include "TBranch.h"
 #include "TFile.h"
@@ -50,7 +51,7 @@ See picture in TTree.
 ////////////////////////////////////////////////////////////////////////////////
 /// Default contructor.
 
-TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fMapping(0)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -67,7 +68,7 @@ TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLa
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor used during reading.
 
-TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fMapping(0)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -85,7 +86,7 @@ TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0
 /// Basket normal constructor, used during writing.
 
 TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
-   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fMapping(0)
 {
    SetName(name);
    SetTitle(title);
@@ -135,6 +136,7 @@ TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
 
 TBasket::~TBasket()
 {
+   ReleaseMapping();
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
    if (fBufferRef) delete fBufferRef;
@@ -182,6 +184,81 @@ Long64_t TBasket::CopyTo(TFile *to)
    return nBytes>0 ? nBytes : -1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Recompress the on-file content of this basket, as loaded by
+/// LoadBasketBuffers, with the given compression level and algorithm.
+/// The dictionary, if any, is used to uncompress the basket and to
+/// compress it again.
+///
+/// Like CompressBuffer, this touches neither the file nor the branch, so
+/// the baskets can be recompressed concurrently before being written in
+/// order with CopyTo (see TTreeCloner).
+/// The function returns 0 in case of success, 1 in case of error, in which
+/// case the basket is left untouched.
+
+Int_t TBasket::RecompressBuffer(Int_t cxlevel, Int_t cxAlgorithm, const char *dict, Int_t dictsize)
+{
+   if (!fBufferRef || fObjlen <= 0 || fNbytes <= fKeylen) return 1;
+   char *raw = fBufferRef->Buffer();
+
+   // Uncompress the object, unless it was stored as is.
+   char *objbuf = 0;
+   if (fObjlen > fNbytes - fKeylen) {
+      objbuf = new char[fObjlen];
+      UChar_t *src = (UChar_t*)raw + fKeylen;
+      Int_t noutot = 0;
+      while (noutot < fObjlen) {
+         Int_t nin, nbuf, nout = 0;
+         if (R__unzip_header(&nin, src, &nbuf) != 0) break;
+         R__unzipDict(&nin, src, &nbuf, (UChar_t*)objbuf + noutot, &nout, (const UChar_t*)dict, dictsize);
+         if (!nout) break;
+         noutot += nout;
+         src += nin;
+      }
+      if (noutot != fObjlen) {
+         Error("RecompressBuffer", "fNbytes = %d, fKeylen = %d, fObjlen = %d, noutot = %d", fNbytes, fKeylen, fObjlen, noutot);
+         delete [] objbuf;
+         return 1;
+      }
+   }
+   char *obj = objbuf ? objbuf : raw + fKeylen;
+
+   // Compress it again, the buffer is stored as is if it does not shrink.
+   Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
+   Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28;
+   char *newbuf = new char[buflen];
+   memcpy(newbuf, raw, fKeylen);
+   Int_t noutot = 0;
+   if (cxlevel > 0) {
+      char *bufcur = newbuf + fKeylen;
+      for (Int_t i = 0, nzip = 0; i < nbuffers; ++i, nzip += kMAXZIPBUF) {
+         Int_t bufmax = (i == nbuffers - 1) ? fObjlen - nzip : kMAXZIPBUF;
+         Int_t nout = 0;
+         Int_t err = R__zipMultipleAlgorithmDict(cxlevel, &bufmax, obj + nzip, &bufmax, bufcur, &nout, cxAlgorithm, dict, dictsize);
+         if (err) {
+            Error("RecompressBuffer", "error %d while setting the compression dictionary of branch %s, the basket is not compressed",
+                  err, fBranch ? fBranch->GetName() : "");
+         }
+         if (nout == 0 || nout >= fObjlen) {
+            noutot = 0;
+            break;
+         }
+         bufcur += nout;
+         noutot += nout;
+      }
+   }
+   if (noutot == 0) {
+      memcpy(newbuf + fKeylen, obj, fObjlen);
+      noutot = fObjlen;
+   }
+   delete [] objbuf;
+
+   fBufferRef->SetBuffer(newbuf, buflen, kTRUE);
+   fBuffer = newbuf;
+   fNbytes = fKeylen + noutot;
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///  Delete fEntryOffset array.
 
@@ -199,6 +276,7 @@ Int_t TBasket::DropBuffers()
 {
    if (!fBuffer && !fBufferRef) return 0;
 
+   ReleaseMapping();
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
    if (fBufferRef)    delete fBufferRef;
@@ -231,6 +309,7 @@ Int_t TBasket::GetEntryPointer(Int_t entry)
 
 Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tree)
 {
+   ReleaseMapping();
    if (fBufferRef) {
       // Reuse the buffer if it exist.
       fBufferRef->Reset();
@@ -390,6 +469,20 @@ Int_t TBasket::ReadBasketBuffersUnzip(char* buffer, Int_t size, Bool_t mustFree,
    return fObjlen+fKeylen;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Stop aliasing the memory mapped file content and give back the reference
+/// to the mapping, which may then be unmapped.
+
+void TBasket::ReleaseMapping()
+{
+   if (!fMapping) return;
+   delete fBufferRef;
+   fBufferRef = 0;
+   fBuffer = 0;
+   TFile::ReleaseMapping(fMapping);
+   fMapping = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize a buffer for reading if it is not already initialized
 
@@ -399,14 +492,19 @@ static inline TBuffer* R__InitializeReadBasketBuffer(TBuffer* bufferRef, Int_t l
    if (R__likely(bufferRef)) {
       bufferRef->SetReadMode();
       Int_t curBufferSize = bufferRef->BufferSize();
-      if (curBufferSize < len) {
+      if (R__unlikely(!bufferRef->TestBit(TBuffer::kIsOwner))) {
+         // The buffer refers to memory owned by someone else (the cache
+         // or a memory mapped file), it can neither be expanded nor reused.
+         bufferRef->SetBuffer(new char[len], len, kTRUE);
+      } else if (curBufferSize < len) {
          // Experience shows that giving 5% "wiggle-room" decreases churn.
          bufferRef->Expand(Int_t(len*1.05));
       }
       bufferRef->Reset();
       result = bufferRef;
    } else {
-      result = new TBufferFile(TBuffer::kRead, len);
+      // The buffers of the baskets read are recycled through the TBufferPool.
+      result = new TBufferFile(TBuffer::kRead, len, 0, kTRUE, TBufferPool::ReAllocChar);
    }
    result->SetParent(file);
    return result;
@@ -445,9 +543,14 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       return -1;
    }
 
+   // fBufferRef is going to be reused, stop aliasing a memory mapped file.
+   ReleaseMapping();
+
    Bool_t oldCase;
    char *rawUncompressedBuffer, *rawCompressedBuffer;
    Int_t uncompressedBufferLen;
+   Bool_t cacheMiss = kFALSE; // The basket was read from the file instead of the TTreeCache.
+   Double_t mapStart = 0;     // Start of the access to a memory mapped basket, for the perf stats.
 
    // See if the cache has already unzipped the buffer for us.
    TFileCacheRead *pf = nullptr;
@@ -469,6 +572,47 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+   // If the file is memory mapped, use the mapped content in place: an
+   // uncompressed basket is not copied at all and a compressed one is
+   // unzipped directly from the mapping. The uncompressed basket keeps a
+   // reference to the mapping, which thus outlives the file if needed.
+   if (R__unlikely(gPerfStats || fBranch->GetTree()->GetPerfStats())) {
+      mapStart = TTimeStamp();
+   }
+   const char *mapped;
+   {
+      R__LOCKGUARD_IMT2(gROOTMutex); // Lock for parallel TTree I/O
+      mapped = file->GetMappedBuffer(pos, len);
+      if (mapped) fMapping = file->AcquireMapping();
+   }
+   if (mapped) {
+      fBranch->GetTree()->IncrementTotalBuffers(-fBufferSize);
+      // Let fBufferRef alias the mapping and unstream the header.
+      Int_t res = ReadBasketBuffersUnzip(const_cast<char*>(mapped), len, kFALSE, file);
+
+      TVirtualPerfStats* temp = gPerfStats;
+      if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
+      if (R__unlikely(gPerfStats)) {
+         // The pages are read from the disk when they are touched: the time
+         // reported is the one of the lookup and of the header only, the
+         // rest of the basket is paged in when it is unzipped or used.
+         gPerfStats->FileReadEvent(file, len, mapStart);
+      }
+      gPerfStats = temp;
+
+      if (res <= 0) return -res;
+      oldCase = OLD_CASE_EXPRESSION;
+      if (fObjlen > fNbytes-fKeylen || oldCase) {
+         // fBufferRef gets its own memory to unzip into, the reference of
+         // the file keeps the mapping alive meanwhile.
+         rawCompressedBuffer = const_cast<char*>(mapped);
+         TFile::ReleaseMapping(fMapping);
+         fMapping = 0;
+         goto UnzipBuffer;
+      }
+      goto AfterBuffer;
+   }
+
    // Determine which buffer to use, so that we can avoid a memcpy in case of
    // the basket was not compressed.
    TBuffer* readBufferRef;
@@ -503,6 +647,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          // Read directly from file, not from the cache
          // If we are using a TTreeCache, disable reading from the default cache
          // temporarily, to force reading directly from file
+         cacheMiss = kTRUE;
          R__LOCKGUARD_IMT2(gROOTMutex);  // Lock for parallel TTree I/O
          TTreeCache *fc = dynamic_cast<TTreeCache*>(file->GetCacheRead());
          if (fc) fc->Disable();
@@ -516,7 +661,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
       gPerfStats = temp;
    } else {
-      // Read from the file and unstream the header information.
+      // Read from the file and unstream the header information. Without a
+      // TTreeCache, every basket read from the file is a cache miss.
+      cacheMiss = kTRUE;
       TVirtualPerfStats* temp = gPerfStats;
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
       R__LOCKGUARD_IMT2(gROOTMutex);  // Lock for parallel TTree I/O
@@ -553,6 +700,8 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+UnzipBuffer:
+
    // Initialize buffer to hold the uncompressed data
    // Note that in previous versions we didn't allocate buffers until we verified
    // the zip headers; this is no longer beforehand as the buffer lifetime is scoped
@@ -571,8 +720,10 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
       // Optional monitor for zip time profiling.
       Double_t start = 0;
-      if (R__unlikely(gPerfStats)) {
+      Double_t steadyStart = 0;
+      if (R__unlikely(gPerfStats || fBranch->GetTree()->GetPerfStats())) {
          start = TTimeStamp();
+         steadyStart = TVirtualPerfStats::GetSteadyTime();
       }
 
       memcpy(rawUncompressedBuffer, rawCompressedBuffer, fKeylen);
@@ -580,6 +731,8 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       UChar_t *rawCompressedObjectBuffer = (UChar_t*)rawCompressedBuffer+fKeylen;
       Int_t nin, nbuf;
       Int_t nout = 0, noutot = 0, nintot = 0;
+      Int_t dictsize = 0;
+      const char *dict = fBranch->GetCompressionDictionary(dictsize);
 
       // Unzip all the compressed objects in the compressed object buffer.
       while (1) {
@@ -594,7 +747,8 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
             goto AfterBuffer;
          }
 
-         R__unzip(&nin, rawCompressedObjectBuffer, &nbuf, (unsigned char*) rawUncompressedObjectBuffer, &nout);
+         R__unzipDict(&nin, rawCompressedObjectBuffer, &nbuf, (unsigned char*) rawUncompressedObjectBuffer, &nout,
+                      (const UChar_t*)dict, dictsize);
          if (!nout) break;
          noutot += nout;
          nintot += nin;
@@ -614,6 +768,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
       if (R__unlikely(gPerfStats)) {
          gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
+         gPerfStats->BasketUnzipEvent(fBranch,steadyStart,nintot,fObjlen);
       }
       gPerfStats = temp;
    } else {
@@ -625,6 +780,10 @@ AfterBuffer:
 
    fBranch->GetTree()->IncrementTotalBuffers(fBufferSize);
 
+   if (R__unlikely(fBranch->GetTree()->GetPerfStats())) {
+      fBranch->GetTree()->GetPerfStats()->BasketReadEvent(fBranch,fNbytes,cacheMiss);
+   }
+
    // Read offsets table if needed.
    if (!fBranch->GetEntryOffsetLen()) {
       return 0;
@@ -730,6 +889,7 @@ void TBasket::Reset()
    fNevBufSize = newNevBufSize;
 
    fNevBuf      = 0;
+   fCompressedSize = -1;
    Int_t *storeEntryOffset = fEntryOffset;
    fEntryOffset = 0;
    Int_t *storeDisplacement = fDisplacement;
@@ -927,43 +1087,24 @@ void TBasket::Update(Int_t offset, Int_t skipped)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Write buffer of this basket on the current file.
+/// Prepare the content of this basket for writing: transfer the entry
+/// offsets at the end of the buffer and compress it.
 ///
-/// The function returns the number of bytes committed to the memory.
-/// If a write error occurs, the number of bytes returned is -1.
-/// If no data are written, the number of bytes returned is 0.
-
-Int_t TBasket::WriteBuffer()
+/// This does not modify the file nor the branch bookkeeping, so it can be
+/// run concurrently for baskets of different branches (see TTree::Fill and
+/// TTree::FlushBaskets with implicit multi-threading). The following call
+/// to WriteBuffer then only reserves the space in the file and writes the
+/// prepared buffer.
+/// The function returns the number of bytes of the object as it will be
+/// written (compressed or not), or -1 if the compressed buffer could not
+/// be allocated.
+
+Int_t TBasket::CompressBuffer(TFile *file)
 {
-   const Int_t kWrite = 1;
-
-   TFile *file = fBranch->GetFile(kWrite);
-   if (!file) return 0;
-   if (!file->IsWritable()) {
-      return -1;
-   }
-   fMotherDir = file; // fBranch->GetDirectory();
-
+   if (fCompressedSize >= 0) return fCompressedSize;
    if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
-      // Read the basket information that was saved inside the buffer.
-      Bool_t writing = fBufferRef->IsWriting();
-      fBufferRef->SetReadMode();
-      fBufferRef->SetBufferOffset(0);
-
-      Streamer(*fBufferRef);
-      if (writing) fBufferRef->SetWriteMode();
-      Int_t nout = fNbytes - fKeylen;
-
-      fBuffer = fBufferRef->Buffer();
-
-      Create(nout,file);
-      fBufferRef->SetBufferOffset(0);
-      fHeaderOnly = kTRUE;
-
-      Streamer(*fBufferRef);         //write key itself again
-      int nBytes = WriteFileKeepBuffer();
-      fHeaderOnly = kFALSE;
-      return nBytes>0 ? fKeylen+nout : -1;
+      // The content is already compressed, WriteBuffer copies it as is.
+      return 0;
    }
 
    // Transfer fEntryOffset table at the end of fBuffer.
@@ -987,8 +1128,6 @@ Int_t TBasket::WriteBuffer()
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
-   fHeaderOnly = kTRUE;
-   fCycle = fBranch->GetWriteBasket();
    Int_t cxlevel = fBranch->GetCompressionLevel();
    Int_t cxAlgorithm = fBranch->GetCompressionAlgorithm();
    if (cxlevel > 0) {
@@ -996,7 +1135,7 @@ Int_t TBasket::WriteBuffer()
       Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28; //add 28 bytes in case object is placed in a deleted gap
       InitializeCompressedBuffer(buflen, file);
       if (!fCompressedBufferRef) {
-         Warning("WriteBuffer", "Unable to allocate the compressed buffer");
+         Warning("CompressBuffer", "Unable to allocate the compressed buffer");
          return -1;
       }
       fCompressedBufferRef->SetWriteMode();
@@ -1005,51 +1144,103 @@ Int_t TBasket::WriteBuffer()
       char *bufcur = &fBuffer[fKeylen];
       noutot = 0;
       nzip   = 0;
+      // Baskets are compressed with the branch dictionary once it is trained,
+      // until then they are used as samples for the training.
+      Int_t dictsize = 0;
+      const char *dict = fBranch->GetCompressionDictionary(dictsize);
+      if (!dict) fBranch->AddCompressionDictionarySample(objbuf, fObjlen);
       for (Int_t i = 0; i < nbuffers; ++i) {
          if (i == nbuffers - 1) bufmax = fObjlen - nzip;
          else bufmax = kMAXZIPBUF;
          //compress the buffer
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
+         Int_t err = R__zipMultipleAlgorithmDict(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm, dict, dictsize);
+         if (err) {
+            Error("CompressBuffer", "error %d while setting the compression dictionary of branch %s, the basket is not compressed",
+                  err, fBranch->GetName());
+         }
 
          // test if buffer has really been compressed. In case of small buffers
          // when the buffer contains random data, it may happen that the compressed
          // buffer is larger than the input. In this case, we write the original uncompressed buffer
          if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
             // We used to delete fBuffer here, we no longer want to since
             // the buffer (held by fCompressedBufferRef) might be re-used later.
             fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
-               Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
+            if ((fObjlen+fKeylen)>buflen) {
+               Warning("CompressBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
+                  (fObjlen+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
             }
-            goto WriteFile;
+            fCompressedSize = fObjlen;
+            return fCompressedSize;
          }
          bufcur += nout;
          noutot += nout;
          objbuf += kMAXZIPBUF;
          nzip   += kMAXZIPBUF;
       }
-      nout = noutot;
-      Create(noutot,file);
+      fCompressedSize = noutot;
+   } else {
+      fBuffer = fBufferRef->Buffer();
+      fCompressedSize = fObjlen;
+   }
+   return fCompressedSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write buffer of this basket on the current file.
+///
+/// The function returns the number of bytes committed to the memory.
+/// If a write error occurs, the number of bytes returned is -1.
+/// If no data are written, the number of bytes returned is 0.
+
+Int_t TBasket::WriteBuffer()
+{
+   const Int_t kWrite = 1;
+
+   TFile *file = fBranch->GetFile(kWrite);
+   if (!file) return 0;
+   if (!file->IsWritable()) {
+      return -1;
+   }
+   fMotherDir = file; // fBranch->GetDirectory();
+
+   if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
+      // Read the basket information that was saved inside the buffer.
+      Bool_t writing = fBufferRef->IsWriting();
+      fBufferRef->SetReadMode();
       fBufferRef->SetBufferOffset(0);
 
-      Streamer(*fBufferRef);         //write key itself again
-      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
-   } else {
+      Streamer(*fBufferRef);
+      if (writing) fBufferRef->SetWriteMode();
+      Int_t nout = fNbytes - fKeylen;
+
       fBuffer = fBufferRef->Buffer();
-      Create(fObjlen,file);
+
+      Create(nout,file);
       fBufferRef->SetBufferOffset(0);
+      fHeaderOnly = kTRUE;
 
       Streamer(*fBufferRef);         //write key itself again
-      nout = fObjlen;
+      int nBytes = WriteFileKeepBuffer();
+      fHeaderOnly = kFALSE;
+      return nBytes>0 ? fKeylen+nout : -1;
+   }
+
+   // Unless it was already done concurrently, compress the buffer.
+   Int_t nout = CompressBuffer(file);
+   if (nout < 0) return -1;
+   fCompressedSize = -1;
+
+   fHeaderOnly = kTRUE;
+   fCycle = fBranch->GetWriteBasket();
+   Create(nout,file);
+   fBufferRef->SetBufferOffset(0);
+
+   Streamer(*fBufferRef);         //write key itself again
+   if (fBuffer != fBufferRef->Buffer()) {
+      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
    }
 
-WriteFile:
    Int_t nBytes = WriteFileKeepBuffer();
    fHeaderOnly = kFALSE;
    return nBytes>0 ? fKeylen+nout : -1;
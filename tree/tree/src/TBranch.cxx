@@ -31,6 +31,7 @@
 #include "TLeafObject.h"
 #include "TLeafS.h"
 #include "TMessage.h"
+#include "RZip.h"
 #include "TROOT.h"
 #include "TSystem.h"
 #include "TMath.h"
@@ -38,6 +39,7 @@
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
 #include "TVirtualMutex.h"
+#include "TVirtualPerfStats.h"
 #include "TVirtualPad.h"
 
 #include <atomic>
@@ -112,6 +114,12 @@ TBranch::TBranch()
 , fAddress(0)
 , fDirectory(0)
 , fFileName("")
+, fCompressDictBaskets(0)
+, fCompressDictMaxSize(0)
+, fCompressDictSize(0)
+, fCompressDict(0)
+, fBasketMin(0)
+, fBasketMax(0)
 , fEntryBuffer(0)
 , fTransientBuffer(0)
 , fBrowsables(0)
@@ -215,6 +223,12 @@ TBranch::TBranch(TTree *tree, const char* name, void* address, const char* leafl
 , fAddress((char*) address)
 , fDirectory(fTree->GetDirectory())
 , fFileName("")
+, fCompressDictBaskets(0)
+, fCompressDictMaxSize(0)
+, fCompressDictSize(0)
+, fCompressDict(0)
+, fBasketMin(0)
+, fBasketMax(0)
 , fEntryBuffer(0)
 , fTransientBuffer(0)
 , fBrowsables(0)
@@ -265,6 +279,12 @@ TBranch::TBranch(TBranch *parent, const char* name, void* address, const char* l
 , fAddress((char*) address)
 , fDirectory(fTree ? fTree->GetDirectory() : 0)
 , fFileName("")
+, fCompressDictBaskets(0)
+, fCompressDictMaxSize(0)
+, fCompressDictSize(0)
+, fCompressDict(0)
+, fBasketMin(0)
+, fBasketMax(0)
 , fEntryBuffer(0)
 , fTransientBuffer(0)
 , fBrowsables(0)
@@ -428,6 +448,12 @@ TBranch::~TBranch()
    delete [] fBasketBytes;
    fBasketBytes = 0;
 
+   delete [] fBasketMin;
+   fBasketMin = 0;
+
+   delete [] fBasketMax;
+   fBasketMax = 0;
+
    fBaskets.Delete();
    fNBaskets = 0;
    fCurrentBasket = 0;
@@ -477,6 +503,9 @@ TBranch::~TBranch()
       delete fTransientBuffer;
       fTransientBuffer = 0;
    }
+
+   delete [] fCompressDict;
+   fCompressDict = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -542,9 +571,20 @@ void TBranch::AddBasket(TBasket& b, Bool_t ondisk, Long64_t startEntry)
             fBasketBytes[j] = fBasketBytes[j-1];
             fBasketSeek[j]  = fBasketSeek[j-1];
          }
+         if (fBasketMin) {
+            for (Int_t j=fWriteBasket; j > where; --j) {
+               fBasketMin[j] = fBasketMin[j-1];
+               fBasketMax[j] = fBasketMax[j-1];
+            }
+         }
       }
    }
    fBasketEntry[where] = startEntry;
+   if (fBasketMin) {
+      // The values of a basket copied as is are not known.
+      fBasketMin[where] = -TMath::Infinity();
+      fBasketMax[where] = TMath::Infinity();
+   }
 
    if (ondisk) {
       fBasketBytes[where] = basket->GetNbytes();  // not for in mem
@@ -723,6 +763,16 @@ void TBranch::ExpandBasketArrays()
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
    fBasketSeek   = (Long64_t*)TStorage::ReAlloc(fBasketSeek,
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
+   if (fBasketMin) {
+      fBasketMin = (Double_t*)TStorage::ReAlloc(fBasketMin,
+                                                newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+      fBasketMax = (Double_t*)TStorage::ReAlloc(fBasketMax,
+                                                newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+      for (Int_t i=fMaxBaskets;i<newsize;i++) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
+   }
 
    fMaxBaskets   = newsize;
 
@@ -780,6 +830,9 @@ Int_t TBranch::Fill()
       ++fEntries;
       ++fEntryNumber;
       (this->*fFillLeaves)(*buf);
+      if (fBasketMin) {
+         FillZoneMap(basket->GetNevBuf() == 1);
+      }
       if (buf->GetMapCount()) {
          // The map is used.
          ResetBit(TBranch::kDoNotUseBufferMap);
@@ -806,6 +859,12 @@ Int_t TBranch::Fill()
       if (fTree->TestBit(TTree::kCircular)) {
          return nbytes;
       }
+      if (fTree->fIMTFlush) {
+         // TTree::Fill compresses the full baskets of all its branches
+         // concurrently and writes them once all the branches are filled.
+         fTree->fIMTFullBranches.push_back(this);
+         return nbytes;
+      }
       Int_t nout = WriteBasket(basket,fWriteBasket);
       return (nout >= 0) ? nbytes : -1;
    }
@@ -1133,7 +1192,7 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
       R__LOCKGUARD_IMT2(gROOTMutex); // Lock for parallel TTree I/O
       TFileCacheRead *pf = file->GetCacheRead(fTree);
       if (pf){
-         if (pf->IsLearning()) pf->AddBranch(this);
+         pf->LearnBranch(this);
          if (fSkipZip) pf->SetSkipZip();
       }
    }
@@ -1173,6 +1232,21 @@ Long64_t TBranch::GetBasketSeek(Int_t basketnumber) const
    return fBasketSeek[basketnumber];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Get in min and max the range of the values of the leaf in the basket
+/// basketnumber, as recorded in the zone maps of the branch (see
+/// TBranch::SetZoneMaps). Return kFALSE if the branch has no zone maps or
+/// if the basket does not exist. The range is infinite if it is not known,
+/// and min is greater than max if the basket holds no value.
+
+Bool_t TBranch::GetBasketRange(Int_t basketnumber, Double_t &min, Double_t &max) const
+{
+   if (!fBasketMin || basketnumber < 0 || basketnumber > fWriteBasket) return kFALSE;
+   min = fBasketMin[basketnumber];
+   max = fBasketMax[basketnumber];
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns (and, if 0, creates) browsable objects for this branch
 /// See TVirtualBranchBrowsable::FillListOfBrowsables.
@@ -1305,10 +1379,166 @@ Int_t TBranch::GetEntry(Long64_t entry, Int_t getall)
    }
 
    // Int_t bufbegin = buf->Length();
-   (this->*fReadLeaves)(*buf);
+   TVirtualPerfStats *perfStats = fTree->GetPerfStats();
+   if (R__unlikely(perfStats)) {
+      Double_t start = TVirtualPerfStats::GetSteadyTime();
+      (this->*fReadLeaves)(*buf);
+      perfStats->BranchStreamerEvent(this, start);
+   } else {
+      (this->*fReadLeaves)(*buf);
+   }
    return buf->Length() - bufbegin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read in one go the entries of this branch from entry up to the end of the
+/// basket containing it.
+///
+/// The values are stored contiguously, in memory representation, in
+/// user_buf, which is expanded if needed and left positioned at its
+/// beginning. The function returns the number of entries read, or -1 if
+/// the branch is not suitable for bulk reading.
+///
+/// Bulk reading is supported for branches with a single leaf of a basic
+/// type (or a fixed size array of it), for instance those created with
+/// a leaflist like "px/F" or "vals[3]/D". There is neither a per-entry
+/// call nor a virtual call per value: the basket content is converted
+/// as a whole, which lets numerical analysis process a basket at a time:
+///
+///     TBufferFile buf(TBuffer::kRead, 10000);
+///     for (Long64_t entry = 0; entry < branch->GetEntries(); ) {
+///        Int_t n = branch->GetBulkEntries(entry, buf);
+///        if (n <= 0) break;
+///        const Float_t *px = reinterpret_cast<Float_t*>(buf.Buffer());
+///        for (Int_t i = 0; i < n; ++i) sum += px[i];
+///        entry += n;
+///     }
+///
+/// This does not modify the current entry of the branch nor the values at
+/// the address of its leaf.
+
+Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
+{
+   return FillBulkBuffer(entry, user_buf, kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Same as GetBulkEntries, but the values are left in their serialized (big
+/// endian) representation, as they are stored in the file.
+
+Int_t TBranch::GetEntriesSerialized(Long64_t entry, TBuffer &user_buf)
+{
+   return FillBulkBuffer(entry, user_buf, kFALSE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Implementation of GetBulkEntries and GetEntriesSerialized.
+
+Int_t TBranch::FillBulkBuffer(Long64_t entry, TBuffer &user_buf, Bool_t deserialize)
+{
+   if (fNleaves != 1) {
+      return -1;
+   }
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   if (leaf->GetLeafCount()) {
+      return -1;
+   }
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return -1;
+   }
+   Int_t basketnumber = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+   if (basketnumber < 0) {
+      return -1;
+   }
+   TBasket *basket = (TBasket*) fBaskets.UncheckedAt(basketnumber);
+   if (!basket) {
+      basket = GetBasket(basketnumber);
+      if (!basket) {
+         return -1;
+      }
+   }
+   TBuffer *buf = basket->GetBufferRef();
+   if (!buf || basket->GetEntryOffset()) {
+      // Entries of variable size.
+      return -1;
+   }
+   Int_t entrySize = basket->GetNevBufSize();
+   if (entrySize != leaf->GetLenType() * leaf->GetLenStatic()) {
+      return -1;
+   }
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+
+   Long64_t first = fBasketEntry[basketnumber];
+   Int_t n = basket->GetNevBuf() - (Int_t)(entry - first);
+   if (n <= 0) {
+      return -1;
+   }
+   Int_t nbytes = n * entrySize;
+   Int_t bufbegin = basket->GetKeylen() + (Int_t)(entry - first) * entrySize;
+
+   user_buf.SetReadMode();
+   user_buf.SetBufferOffset(0);
+   if (user_buf.BufferSize() < nbytes) {
+      user_buf.Expand(nbytes, kFALSE);
+   }
+   if (deserialize) {
+      buf->SetBufferOffset(bufbegin);
+      if (!leaf->ReadBasketFast(*buf, user_buf.Buffer(), n)) {
+         return -1;
+      }
+   } else {
+      memcpy(user_buf.Buffer(), buf->Buffer() + bufbegin, nbytes);
+   }
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the buffer of the basket containing entry, positioned at the
+/// beginning of this entry, or 0 if the entry cannot be found.
+///
+/// The leaves are not read and the current entry of the branch is not
+/// changed: this lets the caller decode the entry by itself.
+
+TBuffer *TBranch::GetEntryBuffer(Long64_t entry)
+{
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return 0;
+   }
+   Int_t basketnumber = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+   if (basketnumber < 0) {
+      return 0;
+   }
+   TBasket *basket = (TBasket*) fBaskets.UncheckedAt(basketnumber);
+   if (!basket) {
+      basket = GetBasket(basketnumber);
+      if (!basket) {
+         return 0;
+      }
+   }
+   basket->PrepareBasket(entry);
+   TBuffer *buf = basket->GetBufferRef();
+   if (!buf) {
+      return 0;
+   }
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+   Long64_t first = fBasketEntry[basketnumber];
+   Int_t *entryOffset = basket->GetEntryOffset();
+   if (entryOffset) {
+      buf->SetBufferOffset(entryOffset[entry-first]);
+      Int_t *displacement = basket->GetDisplacement();
+      if (R__unlikely(displacement)) {
+         buf->SetBufferDisplacement(displacement[entry-first]);
+      }
+   } else {
+      buf->SetBufferOffset(basket->GetKeylen() + (Int_t)(entry-first) * basket->GetNevBufSize());
+   }
+   return buf;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read all leaves of an entry and export buffers to real objects in a TClonesArray list.
 ///
@@ -1542,6 +1772,20 @@ Int_t TBranch::GetRow(Int_t)
    return 1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the branch prefixed by the name of its top-level
+/// branch, unless the name already contains it (as for the branches of a
+/// split object). This name is unique in the tree.
+
+TString TBranch::GetFullName() const
+{
+   TBranch *mother = GetMother();
+   if (!mother || mother == this) return fName;
+   TString motherName(mother->GetName());
+   if (motherName.EndsWith(".") || fName.BeginsWith(motherName + ".")) return fName;
+   return motherName + "." + fName;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return whether this branch is in a mode where the object are decomposed
 /// or not (Also known as MakeClass mode).
@@ -1894,6 +2138,37 @@ void TBranch::FillLeavesImpl(TBuffer& b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Update the zone map of the current write basket with the values of the
+/// leaf which were just filled. first is true for the first entry of the
+/// basket.
+
+void TBranch::FillZoneMap(Bool_t first)
+{
+   Double_t &basketMin = fBasketMin[fWriteBasket];
+   Double_t &basketMax = fBasketMax[fWriteBasket];
+   if (first) {
+      basketMin = TMath::Infinity();
+      basketMax = -TMath::Infinity();
+   } else if (basketMin == -TMath::Infinity() && basketMax == TMath::Infinity()) {
+      // The range is already unknown.
+      return;
+   }
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   Int_t len = leaf->GetLen();
+   for (Int_t i = 0; i < len; ++i) {
+      Double_t value = leaf->GetValue(i);
+      if (value != value) {
+         // A NaN passes no comparison but its negation; give up on this basket.
+         basketMin = -TMath::Infinity();
+         basketMax = TMath::Infinity();
+         return;
+      }
+      if (value < basketMin) basketMin = value;
+      if (value > basketMax) basketMax = value;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Refresh this branch using new information in b
 /// This function is called by TTree::Refresh
@@ -1926,6 +2201,18 @@ void TBranch::Refresh(TBranch* b)
       fBasketEntry[i] = b->fBasketEntry[i];
       fBasketSeek[i]  = b->fBasketSeek[i];
    }
+   delete [] fBasketMin;
+   delete [] fBasketMax;
+   fBasketMin = 0;
+   fBasketMax = 0;
+   if (b->fBasketMin) {
+      fBasketMin = new Double_t[fMaxBaskets];
+      fBasketMax = new Double_t[fMaxBaskets];
+      for (i=0;i<fMaxBaskets;i++) {
+         fBasketMin[i] = b->fBasketMin[i];
+         fBasketMax[i] = b->fBasketMax[i];
+      }
+   }
    fBaskets.Delete();
    Int_t nbaskets = b->fBaskets.GetSize();
    fBaskets.Expand(nbaskets);
@@ -1978,8 +2265,22 @@ void TBranch::Reset(Option_t*)
       }
    }
 
+   if (fBasketMin) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
+   }
+
    fBaskets.Delete();
    fNBaskets = 0;
+
+   // The dictionary was trained on the data being discarded.
+   delete [] fCompressDict;
+   fCompressDict = 0;
+   fCompressDictSize = 0;
+   fCompressDictSamples.clear();
+   fCompressDictSampleSizes.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2019,6 +2320,13 @@ void TBranch::ResetAfterMerge(TFileMergeInfo *)
       }
    }
 
+   if (fBasketMin) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
+   }
+
    TBasket *reusebasket = (TBasket*)fBaskets[fWriteBasket];
    if (reusebasket) {
       fBaskets[fWriteBasket] = 0;
@@ -2150,6 +2458,79 @@ void TBranch::SetBufferAddress(TBuffer* buf)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Train a compression dictionary on the content of the first nbaskets
+/// baskets written for this branch (and its sub-branches) and use it to
+/// compress all the following baskets.
+///
+/// Each basket is compressed independently; for small baskets the
+/// compressor has little data to learn from and the compression factor is
+/// poor. With a dictionary built from representative data, both the
+/// compression factor and the decompression speed of small baskets improve
+/// significantly.  The dictionary (at most maxsize bytes) is stored with
+/// the branch in the TTree header and is used transparently when reading.
+/// It is currently used with the ZLIB and ZSTD algorithms; for ZSTD a real
+/// dictionary is trained, for ZLIB the tail of the sample baskets is used.
+/// The baskets written before the training is complete are compressed as
+/// usual.  Calling this function with nbaskets = 0 disables the training;
+/// an already trained dictionary is kept, as it is needed to read the
+/// baskets compressed with it.
+
+void TBranch::SetCompressionDictionary(Int_t nbaskets, Int_t maxsize)
+{
+   if (nbaskets < 0) nbaskets = 0;
+   if (maxsize < 256) maxsize = 256;
+   fCompressDictBaskets = nbaskets;
+   fCompressDictMaxSize = maxsize;
+   if (!nbaskets) {
+      fCompressDictSamples.clear();
+      fCompressDictSampleSizes.clear();
+   }
+
+   Int_t nb = fBranches.GetEntriesFast();
+   for (Int_t i=0;i<nb;i++) {
+      TBranch *branch = (TBranch*)fBranches.UncheckedAt(i);
+      branch->SetCompressionDictionary(nbaskets, maxsize);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the (uncompressed) content of a basket about to be written as a
+/// sample for the training of the compression dictionary. Once enough
+/// samples are collected the dictionary is trained and the samples are
+/// released. Used by TBasket::WriteBuffer.
+
+void TBranch::AddCompressionDictionarySample(const char *buffer, Int_t size)
+{
+   if (fCompressDict || fCompressDictBaskets <= 0 || size <= 0) return;
+
+   // There is no point in keeping much more than ~100 times the size of
+   // the dictionary; this also bounds the memory used for large baskets.
+   const Long64_t maxSamples = 100 * (Long64_t)fCompressDictMaxSize;
+   Long64_t room = maxSamples - (Long64_t)fCompressDictSamples.size();
+   if (room > 0) {
+      if (size > room) size = room;
+      fCompressDictSamples.insert(fCompressDictSamples.end(), buffer, buffer + size);
+      fCompressDictSampleSizes.push_back(size);
+   }
+   if ((Int_t)fCompressDictSampleSizes.size() < fCompressDictBaskets && room > size) return;
+
+   char *dict = new char[fCompressDictMaxSize];
+   Int_t dictsize = R__trainDictionary(GetCompressionAlgorithm(), fCompressDictSampleSizes.size(),
+                                       &fCompressDictSamples[0], &fCompressDictSampleSizes[0],
+                                       dict, fCompressDictMaxSize);
+   if (dictsize > 0) {
+      fCompressDict = dict;
+      fCompressDictSize = dictsize;
+   } else {
+      delete [] dict;
+      Warning("AddCompressionDictionarySample", "Training of the compression dictionary failed for branch %s", GetName());
+      fCompressDictBaskets = 0;
+   }
+   std::vector<char>().swap(fCompressDictSamples);
+   std::vector<Int_t>().swap(fCompressDictSampleSizes);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set compression algorithm.
 
@@ -2662,6 +3043,45 @@ void TBranch::SetupAddresses()
    // Nothing to do for regular branch, the TLeaf already did it.
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable) the zone maps of this branch: the minimum and the
+/// maximum value of its leaf in each basket, updated by TBranch::Fill and
+/// stored with the branch in the TTree header. A query can then skip the
+/// baskets whose values cannot pass its selection without reading them;
+/// TTree::Draw does so for the selections comparing such leaves with
+/// constants (see TTreeFormula::EvalBlockRange).
+///
+/// Zone maps are only filled for a branch with a single leaf of a basic
+/// type (TLeafB, TLeafS, TLeafI, TLeafL, TLeafF, TLeafD or TLeafO); for the
+/// other branches the function returns kFALSE. The range of the baskets
+/// written before the zone maps were enabled and of the baskets containing a
+/// NaN is left unknown; a fast clone copies the range of the input baskets
+/// when the output branch has zone maps.
+
+Bool_t TBranch::SetZoneMaps(Bool_t enable)
+{
+   if (!enable) {
+      delete [] fBasketMin;
+      delete [] fBasketMax;
+      fBasketMin = 0;
+      fBasketMax = 0;
+      return kFALSE;
+   }
+   if (fBasketMin) return kTRUE;
+   if (IsA() != TBranch::Class() || fNleaves != 1 || fEntryBuffer) return kFALSE;
+   TClass *cl = fLeaves.UncheckedAt(0)->IsA();
+   if (cl != TLeafB::Class() && cl != TLeafS::Class() && cl != TLeafI::Class() && cl != TLeafL::Class() &&
+       cl != TLeafF::Class() && cl != TLeafD::Class() && cl != TLeafO::Class()) return kFALSE;
+
+   fBasketMin = new Double_t[fMaxBaskets];
+   fBasketMax = new Double_t[fMaxBaskets];
+   for (Int_t i = 0; i < fMaxBaskets; ++i) {
+      fBasketMin[i] = -TMath::Infinity();
+      fBasketMax[i] = TMath::Infinity();
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Refresh the value of fDirectory (i.e. where this branch writes/reads its buffers)
 /// with the current value of fTree->GetCurrentFile unless this branch has been
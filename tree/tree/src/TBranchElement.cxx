@@ -2347,6 +2347,83 @@ Int_t TBranchElement::GetEntry(Long64_t entry, Int_t getall)
    return nbytes;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the values of this data member for all the elements of the collection
+/// at the given entry.
+///
+/// This branch must hold a data member of basic type of the elements of a
+/// split collection (fType == 41), for instance fPx of a std::vector<MyStruct>.
+/// Such a collection is streamed member-wise: for each entry, the basket of
+/// this branch contains the values of fPx of all the elements one after the
+/// other. They are copied, in memory representation, contiguously into
+/// user_buf, which is expanded if needed and left positioned at its
+/// beginning. The data member is thus read as a column (structure of arrays)
+/// without reading the collection nor constructing its elements.
+///
+/// Returns the number of values read, or -1 in case of I/O error or if the
+/// branch is not suitable: the data member is an array, a Double32_t or a
+/// Float16_t, or its type changed since the file was written. The current
+/// entry of this branch and of its count branch are not changed.
+
+Int_t TBranchElement::GetEntryColumn(Long64_t entry, TBuffer &user_buf)
+{
+   if (fType != 41 || fID < 0 || !fBranchCount || fBranchCount2 || fBranchCount->GetType() != 4) {
+      return -1;
+   }
+   TStreamerInfo *info = GetInfoImp();
+   if (!info) {
+      return -1;
+   }
+   TStreamerElement *elem = info->GetElement(fID);
+   if (!elem || elem->IsA() != TStreamerBasicType::Class() || elem->GetArrayLength()
+       || elem->GetType() != elem->GetNewType() || elem->GetOffset() == TStreamerInfo::kMissing) {
+      return -1;
+   }
+
+   TBuffer *countbuf = fBranchCount->GetEntryBuffer(entry);
+   if (!countbuf) {
+      return -1;
+   }
+   Int_t n;
+   *countbuf >> n;
+   if ((n < 0) || (n > fBranchCount->fMaximum)) {
+      return -1;
+   }
+
+   user_buf.SetReadMode();
+   user_buf.SetBufferOffset(0);
+   if (n == 0) {
+      return 0;
+   }
+   TBuffer *buf = GetEntryBuffer(entry);
+   if (!buf) {
+      return -1;
+   }
+   Int_t nbytes = n * elem->GetSize();
+   if (user_buf.BufferSize() < nbytes) {
+      user_buf.Expand(nbytes, kFALSE);
+   }
+   char *dest = user_buf.Buffer();
+   switch (elem->GetType()) {
+      case TVirtualStreamerInfo::kBool:     buf->ReadFastArray((Bool_t*)dest, n);    break;
+      case TVirtualStreamerInfo::kChar:     buf->ReadFastArray((Char_t*)dest, n);    break;
+      case TVirtualStreamerInfo::kShort:    buf->ReadFastArray((Short_t*)dest, n);   break;
+      case TVirtualStreamerInfo::kInt:      buf->ReadFastArray((Int_t*)dest, n);     break;
+      case TVirtualStreamerInfo::kLong:     buf->ReadFastArray((Long_t*)dest, n);    break;
+      case TVirtualStreamerInfo::kLong64:   buf->ReadFastArray((Long64_t*)dest, n);  break;
+      case TVirtualStreamerInfo::kFloat:    buf->ReadFastArray((Float_t*)dest, n);   break;
+      case TVirtualStreamerInfo::kDouble:   buf->ReadFastArray((Double_t*)dest, n);  break;
+      case TVirtualStreamerInfo::kUChar:    buf->ReadFastArray((UChar_t*)dest, n);   break;
+      case TVirtualStreamerInfo::kUShort:   buf->ReadFastArray((UShort_t*)dest, n);  break;
+      case TVirtualStreamerInfo::kUInt:     buf->ReadFastArray((UInt_t*)dest, n);    break;
+      case TVirtualStreamerInfo::kULong:    buf->ReadFastArray((ULong_t*)dest, n);   break;
+      case TVirtualStreamerInfo::kULong64:  buf->ReadFastArray((ULong64_t*)dest, n); break;
+      default:
+         return -1;
+   }
+   return n;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill expectedClass and expectedType with information on the data type of the
 /// object/values contained in this branch (and thus the type of pointers
@@ -1576,6 +1576,7 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    fTree->SetMakeClass(fMakeClass);
    fTree->SetMaxVirtualSize(fMaxVirtualSize);
+   if (fPerfStats) fTree->SetPerfStats(fPerfStats);
 
    SetChainOffset(fTreeOffset[fTreeNumber]);
 
@@ -36,6 +36,12 @@ End_Macro
  - __Merge__() - adds all entries from one block to the other. If the first block
              uses array representation, it's changed to bits representation only
              if the total number of passing entries is still less than kBlockSize
+ - __Subtract__(), __Intersect__() - remove the entries which are (not) in the
+             other block
+
+Except for the merging of two short lists, these operations are done on the
+bits representation of the blocks, 16 entries at a time, and the result is
+stored again in the representation chosen by OptimizeStorage().
  - __GetEntry(n)__ - returns n-th non-zero entry.
  - __Next__()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
@@ -44,8 +50,21 @@ End_Macro
 #include "TEntryListBlock.h"
 #include "TString.h"
 
+#include <algorithm>
+
 ClassImp(TEntryListBlock)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Number of bits set in v.
+
+static inline Int_t R__CountBits(UShort_t v)
+{
+   Int_t n = v - ((v >> 1) & 0x5555);
+   n = (n & 0x3333) + ((n >> 2) & 0x3333);
+   n = (n + (n >> 4)) & 0x0F0F;
+   return (n + (n >> 8)) & 0x1F;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default c-tor
 
@@ -205,33 +224,17 @@ Int_t TEntryListBlock::Contains(Int_t entry)
       return result;
    }
    //list
-   if (entry < fCurrent) fCurrent = 0;
-   if (fPassing && fIndices){
-      for (Int_t i = fCurrent; i<fNPassed; i++){
-         if (fIndices[i]==entry){
-            fCurrent = i;
-            return kTRUE;
-         }
-      }
-   } else {
-      if (!fIndices || fNPassed==0){
-         //all entries pass
-         return kTRUE;
-      }
-      if (entry > fIndices[fNPassed-1])
-         return kTRUE;
-      for (Int_t i= fCurrent; i<fNPassed; i++){
-         if (fIndices[i]==entry){
-            fCurrent = i;
-            return kFALSE;
-         }
-         if (fIndices[i]>entry){
-            fCurrent = i;
-            return kTRUE;
-         }
-      }
+   if (!fPassing && (!fIndices || fNPassed==0)){
+      //all entries pass
+      return kTRUE;
    }
-   return 0;
+   //the list is sorted, look for the entry from fCurrent if it is after it
+   UShort_t *first = fIndices;
+   if (fCurrent < fNPassed && fIndices[fCurrent] <= entry) first += fCurrent;
+   UShort_t *found = std::lower_bound(first, fIndices + fNPassed, (UShort_t)entry);
+   fCurrent = found - fIndices;
+   Bool_t listed = found != fIndices + fNPassed && *found == entry;
+   return fPassing ? listed : !listed;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -240,10 +243,12 @@ Int_t TEntryListBlock::Contains(Int_t entry)
 
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
-   Int_t i, j;
+   Int_t i;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
+      if (fIndices)
+         delete [] fIndices;
       fN = block->fN;
       fIndices = new UShort_t[fN];
       for (i=0; i<fN; i++)
@@ -256,111 +261,133 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
       fLastIndexQueried = -1;
       return fNPassed;
    }
-   if (fType==0){
-      //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
-         }
-      } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
+   if (fType==1 && fPassing && block->fType==1 && block->fPassing &&
+       GetNPassed() + block->GetNPassed() <= kBlockSize){
+      //both stored as short lists of passing entries: make a bigger list
+      Int_t en = block->fNPassed;
+      Int_t newsize = fNPassed + en;
+      UShort_t *newlist = new UShort_t[newsize];
+      UShort_t *elst = block->fIndices;
+      Int_t newpos, elpos;
+      newpos = elpos = 0;
+      for (i=0; i<fNPassed; i++) {
+         while (elpos < en && fIndices[i] > elst[elpos]) {
+            newlist[newpos] = elst[elpos];
+            newpos++;
+            elpos++;
          }
+         if (elpos < en && fIndices[i] == elst[elpos]) elpos++;
+         newlist[newpos] = fIndices[i];
+         newpos++;
       }
-   } else {
-      //stored as a list
-      if (GetNPassed() + block->GetNPassed() > kBlockSize){
-         //change to bits
-         UShort_t *bits = new UShort_t[kBlockSize];
-         Transform(1, bits);
-         Merge(block);
-      } else {
-         //this is only possible if fPassing=1 in both blocks
-         if (block->fType==1){
-            //second block stored as a list
-            //make a bigger list
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            UShort_t *elst = block->fIndices;
-            Int_t newpos, elpos;
-            newpos = elpos = 0;
-            for (i=0; i<fNPassed; i++) {
-               while (elpos < en && fIndices[i] > elst[elpos]) {
-                  newlist[newpos] = elst[elpos];
-                  newpos++;
-                  elpos++;
-               }
-               if (fIndices[i] == elst[elpos]) elpos++;
-               newlist[newpos] = fIndices[i];
-               newpos++;
-            }
-            while (elpos < en) {
-               newlist[newpos] = elst[elpos];
-               newpos++;
-               elpos++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         } else {
-            //second block is stored as bits
-
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            Int_t newpos, current;
-            newpos = current = 0;
-            for (i=0; i<kBlockSize*16; i++){
-               if (!block->Contains(i)) continue;
-               while(current < fNPassed && fIndices[current]<i){
-                  newlist[newpos] = fIndices[current];
-                  current++;
-                  newpos++;
-               }
-               if (fIndices[current]==i) current++;
-               newlist[newpos] = i;
-               newpos++;
-            }
-            while(current<fNPassed){
-               newlist[newpos] = fIndices[current];
-               newpos++;
-               current++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         }
+      while (elpos < en) {
+         newlist[newpos] = elst[elpos];
+         newpos++;
+         elpos++;
       }
+      delete [] fIndices;
+      fIndices = newlist;
+      fNPassed = newpos;
+      fN = fNPassed;
+      fCurrent = 0;
+      fLastIndexQueried = -1;
+      fLastIndexReturned = -1;
+      return GetNPassed();
    }
-   fLastIndexQueried = -1;
-   fLastIndexReturned = -1;
+
+   //union of the bits
+   UShort_t buffer[kBlockSize];
+   const UShort_t *other = block->GetBits(buffer);
+   UShort_t *bits = fType==0 ? fIndices : new UShort_t[kBlockSize];
+   if (bits != fIndices) GetBits(bits);
+   for (i=0; i<kBlockSize; i++)
+      bits[i] |= other[i];
+   SetBits(bits);
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove from this block the entries which are in the other block
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   if (GetNPassed() == 0 || block->GetNPassed() == 0) return GetNPassed();
+
+   UShort_t buffer[kBlockSize];
+   const UShort_t *other = block->GetBits(buffer);
+   UShort_t *bits = fType==0 ? fIndices : new UShort_t[kBlockSize];
+   if (bits != fIndices) GetBits(bits);
+   for (Int_t i=0; i<kBlockSize; i++)
+      bits[i] &= ~other[i];
+   SetBits(bits);
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove from this block the entries which are not in the other block
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Intersect(TEntryListBlock *block)
+{
+   if (GetNPassed() == 0) return 0;
+
+   UShort_t buffer[kBlockSize];
+   const UShort_t *other = block->GetBits(buffer);
+   UShort_t *bits = fType==0 ? fIndices : new UShort_t[kBlockSize];
+   if (bits != fIndices) GetBits(bits);
+   for (Int_t i=0; i<kBlockSize; i++)
+      bits[i] &= other[i];
+   SetBits(bits);
    OptimizeStorage();
    return GetNPassed();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the entries of this block as bits. If the block is stored as bits,
+/// return fIndices, otherwise fill buffer (kBlockSize UShort_t) and return it.
+
+const UShort_t *TEntryListBlock::GetBits(UShort_t *buffer) const
+{
+   if (fType==0 && fIndices) return fIndices;
+
+   Int_t i;
+   if (fPassing){
+      for (i=0; i<kBlockSize; i++)
+         buffer[i] = 0;
+      for (i=0; i<fNPassed; i++)
+         buffer[fIndices[i]>>4] |= 1<<(fIndices[i] & 15);
+   } else {
+      for (i=0; i<kBlockSize; i++)
+         buffer[i] = 65535;
+      for (i=0; fIndices && i<fNPassed; i++)
+         buffer[fIndices[i]>>4] ^= 1<<(fIndices[i] & 15);
+   }
+   return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the entries as the bits, of which the block takes the ownership.
+
+void TEntryListBlock::SetBits(UShort_t *bits)
+{
+   if (fIndices && fIndices != bits)
+      delete [] fIndices;
+   fIndices = bits;
+   fType = 0;
+   fN = kBlockSize;
+   fPassing = 1;
+   Int_t n = 0;
+   for (Int_t i=0; i<kBlockSize; i++)
+      n += R__CountBits(bits[i]);
+   fNPassed = n;
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the number of entries, passing the selection.
 /// In case, when the block stores entries that pass (fPassing=1) returns fNPassed
@@ -380,18 +407,25 @@ Int_t TEntryListBlock::GetNPassed()
 Int_t TEntryListBlock::GetEntry(Int_t entry)
 {
    if (entry > kBlockSize*16) return -1;
-   if (entry > GetNPassed()) return -1;
+   if (entry >= GetNPassed()) return -1;
    if (entry == fLastIndexQueried+1) return Next();
    else {
       Int_t i=0; Int_t j=0; Int_t entries_found=0;
       if (fType==0){
-         if ((fIndices[i] & (1<<j))!=0)
-            entries_found++;
-         while (entries_found<entry+1){
-            if (j==15){i++; j=0;}
-            else j++;
-            if ((fIndices[i] & (1<<j))!=0)
+         //skip the words before the one holding the entry
+         Int_t nbits;
+         while (entries_found + (nbits = R__CountBits(fIndices[i])) <= entry){
+            entries_found += nbits;
+            i++;
+         }
+         UShort_t word = fIndices[i];
+         while (1){
+            if (word & 1){
+               if (entries_found == entry) break;
                entries_found++;
+            }
+            word >>= 1;
+            j++;
          }
          fLastIndexQueried = entry;
          fLastIndexReturned = i*16+j;
@@ -457,11 +491,16 @@ Int_t TEntryListBlock::Next()
       fLastIndexReturned++;
       i = fLastIndexReturned>>4;
       j = fLastIndexReturned & 15;
-      Bool_t result=(fIndices[i] & (1<<j))!=0;
-      while (result==0){
-         if (j==15) {j=0; i++;}
-         else j++;
-         result = (fIndices[i] & (1<<j))!=0;
+      //skip the words without entries
+      UShort_t word = fIndices[i] >> j;
+      while (word==0){
+         i++;
+         j = 0;
+         word = fIndices[i];
+      }
+      while ((word & 1)==0){
+         word >>= 1;
+         j++;
       }
       fLastIndexReturned = i*16+j;
       fLastIndexQueried++;
@@ -127,6 +127,18 @@ void TLeafD::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the values of the n entries starting at the current position of the
+/// basket buffer b into the contiguous array output (see TBranch::GetBulkEntries).
+/// Returns kFALSE if the leaf has a variable size.
+
+Bool_t TLeafD::ReadBasketFast(TBuffer &b, void *output, Int_t n)
+{
+   if (fLeafCount) return kFALSE;
+   b.ReadFastArray(static_cast<Double_t*>(output), n*fLen);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
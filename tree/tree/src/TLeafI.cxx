@@ -164,6 +164,18 @@ void TLeafI::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the values of the n entries starting at the current position of the
+/// basket buffer b into the contiguous array output (see TBranch::GetBulkEntries).
+/// Returns kFALSE if the leaf has a variable size.
+
+Bool_t TLeafI::ReadBasketFast(TBuffer &b, void *output, Int_t n)
+{
+   if (fLeafCount) return kFALSE;
+   b.ReadFastArray(static_cast<Int_t*>(output), n*fLen);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
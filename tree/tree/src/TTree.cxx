@@ -691,6 +691,7 @@ TTree::TTree()
 , fCacheUserSet(kFALSE)
 , fIMTEnabled(ROOT::IsImplicitMTEnabled())
 , fNEntriesSinceSorting(0)
+, fIMTFlush(kFALSE)
 {
    fMaxEntries = 1000000000;
    fMaxEntries *= 1000;
@@ -769,6 +770,7 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 , fCacheUserSet(kFALSE)
 , fIMTEnabled(ROOT::IsImplicitMTEnabled())
 , fNEntriesSinceSorting(0)
+, fIMTFlush(kFALSE)
 {
    // TAttLine state.
    SetLineColor(gStyle->GetHistLineColor());
@@ -2518,7 +2520,8 @@ void TTree::Browse(TBrowser* b)
 ///
 /// A TTreeIndex object pointed by fTreeIndex is created.
 /// This object will be automatically deleted by the TTree destructor.
-/// See also comments in TTree::SetTreeIndex().
+/// See also comments in TTree::SetTreeIndex(), and TTreeBlockIndex for a
+/// compressed index supporting range queries, better suited to large trees.
 
 Int_t TTree::BuildIndex(const char* majorname, const char* minorname /* = "0" */)
 {
@@ -2974,6 +2977,14 @@ Int_t TTree::CheckBranchAddressType(TBranch* branch, TClass* ptrClass, EDataType
 /// the file the baskets will be in the order in which they will be
 /// needed when reading the whole tree sequentially.
 ///
+/// When 'fast' is specified, 'option' can also contain 'Recompress':
+/// the baskets whose compression settings differ from the ones of the
+/// cloned branches (i.e. of the destination file) are then uncompressed
+/// and compressed again, by parallel tasks when the implicit
+/// multi-threading is enabled, instead of being copied as is. The basket
+/// sizes are kept; to rebalance them, do not use 'fast' (the baskets are
+/// then refilled and TTree::OptimizeBaskets is applied).
+///
 /// For examples of CloneTree, see tutorials:
 ///
 /// - copytree:
@@ -3137,6 +3148,73 @@ TTree* TTree::CloneTree(Long64_t nentries /* = -1 */, Option_t* option /* = "" *
    return newtree;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add to baskets the basket being filled by branch if it is ready to be
+/// written, together with the file it goes to. If recursive is true, also
+/// look at the sub-branches.
+///
+/// A branch whose earlier baskets are still waiting to be written is
+/// skipped: all the baskets of a branch share its compression buffer, so
+/// they must be compressed one at a time, when they are written.
+
+void TTree::CollectBasketsToCompress(TBranch *branch, std::vector<std::pair<TBasket*,TFile*>> &baskets, Bool_t recursive) const
+{
+   const Int_t kWrite = 1;
+
+   if (branch->fDirectory && branch->fBaskets.GetEntries()) {
+      Bool_t pending = kFALSE;
+      for (Int_t i = 0; i < branch->fWriteBasket; ++i) {
+         TBasket *basket = (TBasket*)branch->fBaskets.UncheckedAt(i);
+         if (basket && basket->GetNevBuf() && branch->fBasketSeek[i] == 0) {
+            pending = kTRUE;
+            break;
+         }
+      }
+      TBasket *basket = (TBasket*)branch->fBaskets.UncheckedAt(branch->fWriteBasket);
+      if (!pending && basket && basket->GetNevBuf() && branch->fBasketSeek[branch->fWriteBasket] == 0) {
+         TFile *file = branch->GetFile(kWrite);
+         if (file && file->IsWritable()) {
+            if (basket->GetBufferRef()->IsReading()) {
+               basket->SetWriteMode();
+            }
+            baskets.push_back(std::make_pair(basket, file));
+         }
+      }
+   }
+   if (recursive) {
+      Int_t nb = branch->fBranches.GetEntriesFast();
+      for (Int_t i = 0; i < nb; ++i) {
+         TBranch *subbranch = (TBranch*)branch->fBranches.UncheckedAt(i);
+         if (subbranch) CollectBasketsToCompress(subbranch, baskets, recursive);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compress the given baskets concurrently (see TBasket::CompressBuffer).
+///
+/// Only the compression is done here: the caller then writes the baskets
+/// one after the other, in the usual order, so that the content of the
+/// file does not depend on the scheduling of the tasks.
+
+void TTree::CompressBaskets(const std::vector<std::pair<TBasket*,TFile*>> &baskets) const
+{
+#ifdef R__USE_IMT
+   if (baskets.size() < 2) return;
+   tbb::task_group g;
+   for (auto &entry : baskets) {
+      TBasket *basket = entry.first;
+      TFile *file = entry.second;
+      g.run([basket, file]() {
+         basket->CompressBuffer(file);
+      });
+   }
+   g.wait();
+#else
+   (void)baskets;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set branch addresses of passed tree equal to ours.
 /// If undo is true, reset the branch address instead of copying them.
@@ -3338,6 +3416,9 @@ namespace {
 ///
 /// See TTree::CloneTree for a detailed explanation of the semantics of these 3 options.
 ///
+/// 'option' can also contain 'Recompress' to compress the copied baskets
+/// again with the settings of this tree, see TTree::CloneTree.
+///
 /// If the tree or any of the underlying tree of the chain has an index, that index and any
 /// index in the subsequent underlying TTree objects will be merged.
 ///
@@ -4232,6 +4313,21 @@ Long64_t TTree::Draw(const char* varexp, const TCut& selection, Option_t* option
 /// You can use the option "goff" to turn off the graphics output
 /// of TTree::Draw in the above example.
 ///
+/// ## Drawing with implicit multi-threading
+///
+/// If the implicit multi-threading is enabled (see ROOT::EnableImplicitMT)
+/// and the result of Draw is a histogram, the entries of a tree read from
+/// a file, or of a TChain, are processed in parallel: the first entries
+/// (up to GetEstimate()) fix the limits of the histogram, then the following
+/// clusters are processed by tasks which compile their own formulas and fill
+/// their own copy of the histogram, and the copies are merged at the end.
+/// The number of threads is the one given to ROOT::EnableImplicitMT.
+/// In that case, the arrays returned by GetV1, GetV2, ..., GetW only contain
+/// values of the first entries. Graphs, event and entry lists, trees with
+/// friends or with an entry list, and histograms filled with the ">>+"
+/// syntax are always processed sequentially, as well as all the entries of
+/// a tree for which SetImplicitMT(kFALSE) was called.
+///
 /// ## Automatic interface to TTree::Draw via the TTreeViewer
 ///
 /// A complete graphical interface to this function is implemented
@@ -4332,6 +4428,14 @@ void TTree::DropBuffers(Int_t)
 /// Note that calling FlushBaskets too often increases the IO time.
 ///
 /// Note that calling AutoSave too often increases the IO time and also the file size.
+///
+/// __Implicit multi-threading__
+///
+/// When implicit multi-threading is enabled (see ROOT::EnableImplicitMT and
+/// SetImplicitMT), the baskets which get full while filling an entry, as well
+/// as the baskets written by FlushBaskets, are compressed in parallel.  They
+/// are then written one after the other in the order of the branches, so the
+/// content of the file is the same as in the sequential case.
 
 Int_t TTree::Fill()
 {
@@ -4350,6 +4454,10 @@ Int_t TTree::Fill()
    if (fBranchRef) {
       fBranchRef->Clear();
    }
+#ifdef R__USE_IMT
+   fIMTFlush = ROOT::IsImplicitMTEnabled() && fIMTEnabled;
+   fIMTFullBranches.clear();
+#endif
    for (Int_t i = 0; i < nb; ++i) {
       // Loop over all branches, filling and accumulating bytes written and error counts.
       TBranch* branch = (TBranch*) fBranches.UncheckedAt(i);
@@ -4379,6 +4487,27 @@ Int_t TTree::Fill()
    if (fBranchRef) {
       fBranchRef->Fill();
    }
+#ifdef R__USE_IMT
+   if (fIMTFlush) {
+      // Compress the baskets which were filled up by this entry in parallel,
+      // then write them in the order of the branches.
+      fIMTFlush = kFALSE;
+      std::vector<std::pair<TBasket*,TFile*>> baskets;
+      for (auto branch : fIMTFullBranches) {
+         CollectBasketsToCompress(branch, baskets, kFALSE);
+      }
+      CompressBaskets(baskets);
+      for (auto branch : fIMTFullBranches) {
+         TBasket *basket = (TBasket*)branch->fBaskets.UncheckedAt(branch->fWriteBasket);
+         Int_t nout = branch->WriteBasket(basket, branch->fWriteBasket);
+         if (nout < 0) {
+            Error("Fill", "Failed writing the basket of branch:%s.%s, entry=%lld", GetName(), branch->GetName(), fEntries+1);
+            ++nerror;
+         }
+      }
+      fIMTFullBranches.clear();
+   }
+#endif
    ++fEntries;
    if (fEntries > fMaxEntries) {
       KeepCircular();
@@ -4768,6 +4897,18 @@ Int_t TTree::FlushBaskets() const
    Int_t nerror = 0;
    TObjArray *lb = const_cast<TTree*>(this)->GetListOfBranches();
    Int_t nb = lb->GetEntriesFast();
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && fIMTEnabled) {
+      // Compress the pending baskets of all the branches in parallel,
+      // the loop below then only has to write them.
+      std::vector<std::pair<TBasket*,TFile*>> baskets;
+      for (Int_t j = 0; j < nb; j++) {
+         TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+         if (branch) CollectBasketsToCompress(branch, baskets, kTRUE);
+      }
+      CompressBaskets(baskets);
+   }
+#endif
    for (Int_t j = 0; j < nb; j++) {
       TBranch* branch = (TBranch*) lb->UncheckedAt(j);
       if (branch) {
@@ -8159,6 +8300,38 @@ void TTree::SetCircular(Long64_t maxEntries)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable the training of a compression dictionary for the given branches.
+///
+/// bname is the name of a branch.
+///
+/// - if bname="*", apply to all branches.
+/// - if bname="xxx*", apply to all branches with name starting with xxx
+///
+/// The dictionary of each branch is trained on its first nbaskets baskets
+/// and holds at most maxsize bytes. See TBranch::SetCompressionDictionary.
+/// This mostly benefits branches with small baskets.
+
+void TTree::SetCompressionDictionary(const char* bname, Int_t nbaskets, Int_t maxsize)
+{
+   Int_t nleaves = fLeaves.GetEntriesFast();
+   TRegexp re(bname, kTRUE);
+   Int_t nb = 0;
+   for (Int_t i = 0; i < nleaves; i++)  {
+      TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(i);
+      TBranch* branch = (TBranch*) leaf->GetBranch();
+      TString s = branch->GetName();
+      if (strcmp(bname, branch->GetName()) && (s.Index(re) == kNPOS)) {
+         continue;
+      }
+      nb++;
+      branch->SetCompressionDictionary(nbaskets, maxsize);
+   }
+   if (!nb) {
+      Error("SetCompressionDictionary", "unknown branch -> '%s'", bname);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the debug level and the debug range.
 ///
@@ -8533,6 +8706,40 @@ void TTree::SetWeight(Double_t w, Option_t*)
    fWeight = w;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable) the zone maps of the given branches: the minimum and
+/// the maximum value of the leaf in each basket, which let TTree::Draw skip
+/// the baskets that cannot pass its selection.
+///
+/// bname is the name of a branch.
+///
+/// - if bname="*", apply to all branches.
+/// - if bname="xxx*", apply to all branches with name starting with xxx
+///
+/// Only the branches with a single leaf of a basic type can have zone maps
+/// (see TBranch::SetZoneMaps), the other matching branches are ignored.
+/// The zone maps should be enabled before the tree is filled.
+
+void TTree::SetZoneMaps(const char* bname, Bool_t enable)
+{
+   Int_t nleaves = fLeaves.GetEntriesFast();
+   TRegexp re(bname, kTRUE);
+   Int_t nb = 0;
+   for (Int_t i = 0; i < nleaves; i++)  {
+      TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(i);
+      TBranch* branch = (TBranch*) leaf->GetBranch();
+      TString s = branch->GetName();
+      if (strcmp(bname, branch->GetName()) && (s.Index(re) == kNPOS)) {
+         continue;
+      }
+      nb++;
+      branch->SetZoneMaps(enable);
+   }
+   if (!nb) {
+      Error("SetZoneMaps", "unknown branch -> '%s'", bname);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print values of all active leaves for entry.
 ///
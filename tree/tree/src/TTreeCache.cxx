@@ -211,6 +211,28 @@ branches that will be used very rarely.
        ... here you process your entry
     }
 ~~~
+### 4. remembering the branches used from one job to the next
+
+The branches found during the learning phase can be saved in a file and
+reused by the next jobs reading the same tree of the same file, which then
+skip the learning phase and read from the first entry all the branches needed. It is
+enabled by giving the name of this file with TTreeCache::SetLearnFile, the
+resource `TTreeCache.LearnFile` or the environment variable
+`ROOT_TTREECACHE_LEARNFILE`. The file is a resource file (see TEnv) holding,
+for each tree identified by the UUID of its file and its name, the names of
+the branches in the order of their first use. It is updated when the cache is
+deleted if the branches used have changed, by writing a new file and renaming
+it, so that the concurrent jobs never read a partially written file (the last
+job to finish wins if several of them update it at the same time).
+With a saved list, or after TTreeCache::SetLearnLate (resource
+`TTreeCache.LearnLate`), a branch read for the first time after the learning
+phase is added to the cache instead of being read basket by basket.
+~~~ {.cpp}
+    TTree *T = (TTree*)f->Get("mytree");
+    T->SetCacheSize(10000000);
+    TTreeCache *tc = (TTreeCache*)f->GetCacheRead(T);
+    tc->SetLearnFile("mytree.cachelearn");
+~~~
 ## SPECIAL CASES WHERE TreeCache should not be activated
 
 When reading only a small fraction of all entries such that not all branch
@@ -229,6 +251,9 @@ of effective system reads for a given file with a code like
 #include "TSystem.h"
 #include "TEnv.h"
 #include "TTreeCache.h"
+#include "THashList.h"
+#include "TROOT.h"
+#include "TVirtualMutex.h"
 #include "TChain.h"
 #include "TList.h"
 #include "TBranch.h"
@@ -270,7 +295,11 @@ TTreeCache::TTreeCache() : TFileCacheRead(),
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fLearnLate(GetConfiguredLearnLate()),
+   fLearnFile(GetConfiguredLearnFile()),
+   fLearnLoaded(kFALSE),
+   fUsedBranches(0)
 {
 }
 
@@ -300,7 +329,11 @@ TTreeCache::TTreeCache(TTree *tree, Int_t buffersize) : TFileCacheRead(tree->Get
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fLearnLate(GetConfiguredLearnLate()),
+   fLearnFile(GetConfiguredLearnFile()),
+   fLearnLoaded(kFALSE),
+   fUsedBranches(0)
 {
    fEntryNext = fEntryMin + fgLearnEntries;
    Int_t nleaves = tree->GetListOfLeaves()->GetEntries();
@@ -316,8 +349,11 @@ TTreeCache::~TTreeCache()
    // we are deleted explicitly by legacy user code).
    if (fFile) fFile->SetCacheRead(0, fTree);
 
+   SaveLearnedBranches();
+
    delete fBranches;
    if (fBrNames) {fBrNames->Delete(); delete fBrNames; fBrNames=0;}
+   if (fUsedBranches) {fUsedBranches->Delete(); delete fUsedBranches; fUsedBranches=0;}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -914,6 +950,40 @@ Bool_t TTreeCache::FillBuffer()
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the file where the branches used are remembered from
+/// one job to the next, from the environment or resource variable (an empty
+/// name disables the feature).
+
+TString TTreeCache::GetConfiguredLearnFile() const
+{
+   const char *stcp;
+
+   if (!(stcp = gSystem->Getenv("ROOT_TTREECACHE_LEARNFILE")) || !*stcp) {
+      stcp = gEnv->GetValue("TTreeCache.LearnFile", "");
+   }
+
+   return TString(stcp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether the branches read for the first time after the learning
+/// phase are added to the cache, from the environment or resource variable.
+
+Bool_t TTreeCache::GetConfiguredLearnLate() const
+{
+   const char *stcp;
+   Int_t s = 0;
+
+   if (!(stcp = gSystem->Getenv("ROOT_TTREECACHE_LEARNLATE")) || !*stcp) {
+      s = gEnv->GetValue("TTreeCache.LearnLate", 0);
+   } else {
+      s = TString(stcp).Atoi();
+   }
+
+   return s != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the desired prefill type from the environment or resource variable
 /// - 0 - No prefill
@@ -971,6 +1041,126 @@ Int_t TTreeCache::GetLearnEntries()
    return fgLearnEntries;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Register the use of a branch, this function is called by TBranch::GetBasket
+/// for every basket read.
+///  - During the learning phase the branch is added to the cache (see
+///    AddBranch). If a learn file is set (see SetLearnFile) and holds the
+///    branches used by a previous job on this tree, these branches are put
+///    in the cache at the first call and the learning phase is skipped.
+///  - After the learning phase, a branch which is not yet in the cache is
+///    added to it if SetLearnLate was called, or if the branches were taken
+///    from the learn file. When not prefetching, the cluster being read is
+///    then refilled with the new branch at the next cache miss.
+/// If a learn file is set, the names of the branches used are recorded and
+/// saved in the file when the cache is deleted.
+/// Returns:
+///  - 0 branch added, already included or not to be cached
+///  - -1 on error
+
+Int_t TTreeCache::LearnBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
+{
+   // Reject branch that are not from the cached tree.
+   if (!b || !fTree || fTree->GetTree() != b->GetTree()) return -1;
+
+   if (!fLearnFile.IsNull()) {
+      if (!fUsedBranches) {
+         fUsedBranches = new THashList;
+         fUsedBranches->SetName(GetLearnKey(b->GetTree()));
+      }
+      if (!fUsedBranches->FindObject(b->GetName())) {
+         fUsedBranches->Add(new TObjString(b->GetName()));
+      }
+   }
+
+   if (fIsLearning) {
+      if (fNbranches != 0 || fIsManual || fLearnLoaded || !LoadLearnedBranches()) {
+         return AddBranch(b, subbranches);
+      }
+   }
+
+   if (fIsManual || !(fLearnLate || fLearnedNames.Length())) return 0;
+
+   //Is branch already in the cache?
+   for (int i=0;i<fNbranches;i++) {
+      if (fBranches->UncheckedAt(i) == b) return 0;
+   }
+   fBranches->AddAtAndExpand(b, fNbranches);
+   fBrNames->Add(new TObjString(b->GetName()));
+   fNbranches++;
+   if (gDebug > 0) printf("Entry: %lld, registering late branch: %s\n",b->GetTree()->GetReadEntry(),b->GetName());
+
+   if (!fEnablePrefetching) {
+      // Force the [re-]reading of the cluster, now including this branch.
+      fEntryCurrent = -1;
+      fEntryNext = -1;
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key of the branches of tree in the learn file: the UUID of the
+/// file of the tree followed by the name of the tree, so that the trees of
+/// the same name in different files are not mixed up.
+
+TString TTreeCache::GetLearnKey(TTree *tree) const
+{
+   TString key;
+   TFile *file = tree->GetCurrentFile();
+   if (file) key.Form("%s.", file->GetUUID().AsString());
+   key += tree->GetName();
+   return key;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Put in the cache the branches saved in the learn file by a previous job
+/// reading the same tree, and stop the learning phase.
+/// Returns kTRUE if at least one of these branches was found in the tree.
+
+Bool_t TTreeCache::LoadLearnedBranches()
+{
+   fLearnLoaded = kTRUE;
+   if (fLearnFile.IsNull() || !fTree || !fBrNames) return kFALSE;
+
+   TTree *tree = fTree->GetTree();
+   TString filename(fLearnFile);
+   gSystem->ExpandPathName(filename);
+   {
+      R__LOCKGUARD(gROOTMutex);
+      TEnv env;
+      if (env.ReadFile(filename, kEnvLocal) < 0) return kFALSE;
+      fLearnedNames = env.GetValue(GetLearnKey(tree), "");
+   }
+
+   TObjArray *names = fLearnedNames.Tokenize(" ");
+   TIter next(names);
+   TObjString *os;
+   while ((os = (TObjString*)next())) {
+      TBranch *b = tree->GetBranch(os->GetName());
+      if (!b) continue;
+      Bool_t isNew = kTRUE;
+      for (int i=0;i<fNbranches;i++) {
+         if (fBranches->UncheckedAt(i) == b) {isNew = kFALSE; break;}
+      }
+      if (!isNew) continue;
+      fBranches->AddAtAndExpand(b, fNbranches);
+      fBrNames->Add(new TObjString(b->GetName()));
+      fNbranches++;
+   }
+   delete names;
+
+   if (fNbranches == 0) {
+      fLearnedNames.Clear();
+      return kFALSE;
+   }
+   if (gDebug > 0) printf("Entry: %lld, %d branches taken from %s\n",tree->GetReadEntry(),fNbranches,filename.Data());
+
+   // Like FillBuffer at the end of the learning phase.
+   StopLearningPhase();
+   fIsManual = kFALSE;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print cache statistics. Like:
 ///
@@ -1109,6 +1299,48 @@ void TTreeCache::ResetCache()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Save the names of the branches used, in the order of their first use, in
+/// the learn file (see SetLearnFile), under the key returned by GetLearnKey.
+/// The other entries of the file are kept. Nothing is written if the list of
+/// branches has not changed since it was loaded. The file is written under a
+/// temporary name, unique to the host and the process, and then renamed, so
+/// that it is replaced atomically. This function is called by the destructor.
+
+void TTreeCache::SaveLearnedBranches()
+{
+   if (fLearnFile.IsNull() || !fUsedBranches || fUsedBranches->IsEmpty()) return;
+
+   TString names;
+   TIter next(fUsedBranches);
+   TObject *obj;
+   while ((obj = next())) {
+      if (names.Length()) names += " ";
+      names += obj->GetName();
+   }
+   if (names == fLearnedNames) return;
+
+   TString filename(fLearnFile);
+   gSystem->ExpandPathName(filename);
+
+   TString tmpname = TString::Format("%s.%s.%d.tmp", filename.Data(), gSystem->HostName(), gSystem->GetPid());
+
+   R__LOCKGUARD(gROOTMutex);
+   TEnv env;
+   env.ReadFile(filename, kEnvLocal);
+   env.SetValue(fUsedBranches->GetName(), names, kEnvLocal);
+   if (env.WriteFile(tmpname) != 0) {
+      gSystem->Unlink(tmpname);
+      return;
+   }
+   if (gSystem->Rename(tmpname, filename) != 0) {
+      Warning("SaveLearnedBranches", "cannot rename %s to %s", tmpname.Data(), filename.Data());
+      gSystem->Unlink(tmpname);
+      return;
+   }
+   fLearnedNames = names;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change the underlying buffer size of the cache.
 /// If the change of size means some cache content is lost, or if the buffer
@@ -20,9 +20,11 @@ Core TTree-related code borrowed from the previous version
 ## Parallel Unzipping
 
 TTreeCache has been specialised in order to let additional threads
-free to unzip in advance its content. In this implementation we
-support up to 10 threads, but right now it makes more sense to
-limit their number to 1-2
+free to unzip in advance its content. The unzipping is done by tasks
+scheduled with the implicit multi-threading (see ROOT::EnableImplicitMT)
+as soon as the baskets of a cluster have been transferred in the cache.
+The tasks pick up the baskets one after the other, so the work is spread
+over all the available cores.
 
 The application reading data is carefully synchronized, in order to:
  - if the block it wants is not unzipped, it self-unzips it without
@@ -31,12 +33,16 @@ The application reading data is carefully synchronized, in order to:
    for that unzip to finish
  - if the block has already been unzipped, it takes it
 
+The state of each block is kept in an atomic flag, so taking an unzipped
+block does not require any lock.
+
 This is supposed to cancel a part of the unzipping latency, at the
 expenses of cpu time.
 
-The default parameters are the same of the prev version, i.e. 20%
-of the TTreeCache cache size. To change it use
-TTreeCache::SetUnzipBufferSize(Long64_t bufferSize)
+The memory used by the unzipped blocks waiting to be read is limited,
+by default to 50% of the TTreeCache cache size. When the limit is reached
+the tasks stop and are restarted as the blocks are consumed. To change it
+use TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
 where bufferSize must be passed in bytes.
 */
 
@@ -47,15 +53,16 @@ where bufferSize must be passed in bytes.
 #include "TEventList.h"
 #include "TMutex.h"
 #include "TVirtualMutex.h"
-#include "TThread.h"
-#include "TCondition.h"
+#include "TROOT.h"
 #include "TMath.h"
 #include "Bytes.h"
 
-#include "TEnv.h"
+#ifdef R__USE_IMT
+#include "tbb/task.h"
+#include "tbb/task_group.h"
+#endif
 
-#define THREADCNT 2
-extern "C" void R__unzip(Int_t *nin, UChar_t *bufin, Int_t *lout, char *bufout, Int_t *nout);
+extern "C" void R__unzipDict(Int_t *nin, UChar_t *bufin, Int_t *lout, UChar_t *bufout, Int_t *nout, const UChar_t *dict, Int_t dictsize);
 extern "C" int R__unzip_header(Int_t *nin, UChar_t *bufin, Int_t *lout);
 
 TTreeCacheUnzip::EParUnzipMode TTreeCacheUnzip::fgParallel = TTreeCacheUnzip::kDisable;
@@ -70,23 +77,20 @@ ClassImp(TTreeCacheUnzip)
 ////////////////////////////////////////////////////////////////////////////////
 
 TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
-
-   fActiveThread(kFALSE),
-   fAsyncReading(kFALSE),
-   fCycle(0),
-   fLastReadPos(0),
-   fBlocksToGo(0),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
    fTotalUnzipBytes(0),
    fNseekMax(0),
    fUnzipBufferSize(0),
+   fUnzipTaskGroup(0),
+   fUnzipNext(0),
+   fNUnzipTasks(0),
+   fUnzipAbort(kFALSE),
    fNUnzip(0),
    fNFound(0),
    fNStalls(0),
    fNMissed(0)
-
 {
    // Default Constructor.
 
@@ -97,17 +101,16 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
 /// Constructor.
 
 TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tree,buffersize),
-   fActiveThread(kFALSE),
-   fAsyncReading(kFALSE),
-   fCycle(0),
-   fLastReadPos(0),
-   fBlocksToGo(0),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
    fTotalUnzipBytes(0),
    fNseekMax(0),
    fUnzipBufferSize(0),
+   fUnzipTaskGroup(0),
+   fUnzipNext(0),
+   fNUnzipTasks(0),
+   fUnzipAbort(kFALSE),
    fNUnzip(0),
    fNFound(0),
    fNStalls(0),
@@ -124,43 +127,28 @@ void TTreeCacheUnzip::Init()
    fMutexList        = new TMutex(kTRUE);
    fIOMutex          = new TMutex(kTRUE);
 
-   fUnzipStartCondition   = new TCondition(fMutexList);
-   fUnzipDoneCondition   = new TCondition(fMutexList);
-
    fTotalUnzipBytes = 0;
 
-   fCompBuffer = new char[16384];
-   fCompBufferSize = 16384;
-
    if (fgParallel == kDisable) {
       fParallel = kFALSE;
    }
    else if(fgParallel == kEnable || fgParallel == kForce) {
-      SysInfo_t info;
-      gSystem->GetSysInfo(&info);
-
       fUnzipBufferSize = Long64_t(fgRelBuffSize * GetBufferSize());
 
-      if(gDebug > 0)
-         Info("TTreeCacheUnzip", "Enabling Parallel Unzipping");
-
-      fParallel = kTRUE;
-
-      for (Int_t i = 0; i < 10; i++) fUnzipThread[i] = 0;
-
-      StartThreadUnzip(THREADCNT);
+#ifdef R__USE_IMT
+      // The tasks only make sense if implicit multi-threading is enabled,
+      // unless the user insists.
+      fParallel = (fgParallel == kForce) || ROOT::IsImplicitMTEnabled();
+#else
+      fParallel = kFALSE;
+#endif
 
+      if(gDebug > 0)
+         Info("TTreeCacheUnzip", "%s Parallel Unzipping", fParallel ? "Enabling" : "Not enabling");
    }
    else {
       Warning("TTreeCacheUnzip", "Parallel Option unknown");
    }
-
-   // Check if asynchronous reading is supported by this TFile specialization
-   if (gEnv->GetValue("TFile.AsyncReading", 1)) {
-      if (fFile && !(fFile->ReadBufferAsync(0, 0)))
-         fAsyncReading = kTRUE;
-   }
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,14 +158,12 @@ TTreeCacheUnzip::~TTreeCacheUnzip()
 {
    ResetCache();
 
-   if (IsActiveThread())
-      StopThreadUnzip();
+#ifdef R__USE_IMT
+   delete (tbb::task_group*)fUnzipTaskGroup;
+#endif
 
    delete [] fUnzipLen;
 
-   delete fUnzipStartCondition;
-   delete fUnzipDoneCondition;
-
    delete fMutexList;
    delete fIOMutex;
 
@@ -256,8 +242,12 @@ Bool_t TTreeCacheUnzip::FillBuffer()
          }
       }
 
+      // The tasks of the previous cluster must be done with the cache buffer
+      StopTasks();
+
       //clear cache buffer
       TFileCacheRead::Prefetch(0,0);
+      fDictBranches.clear();
 
       //store baskets
       for (Int_t i=0;i<fNbranches;i++) {
@@ -271,6 +261,8 @@ Bool_t TTreeCacheUnzip::FillBuffer()
          //we have found the branch. We now register all its baskets
          //from the requested offset to the basket below fEntrymax
          Int_t blistsize = b->GetListOfBaskets()->GetSize();
+         Int_t dictsize = 0;
+         Bool_t hasDict = b->GetCompressionDictionary(dictsize) != 0;
          for (Int_t j=0;j<nb;j++) {
             // This basket has already been read, skip it
             if (j<blistsize && b->GetListOfBaskets()->UncheckedAt(j)) continue;
@@ -289,6 +281,7 @@ Bool_t TTreeCacheUnzip::FillBuffer()
             fNReadPref++;
 
             TFileCacheRead::Prefetch(pos,len);
+            if (hasDict) fDictBranches[pos] = b;
          }
          if (gDebug > 0) printf("Entry: %lld, registering baskets branch %s, fEntryNext=%lld, fNseek=%d, fNtot=%d\n",entry,((TBranch*)fBranches->UncheckedAt(i))->GetName(),fEntryNext,fNseek,fNtot);
       }
@@ -314,6 +307,7 @@ Int_t TTreeCacheUnzip::SetBufferSize(Int_t buffersize)
 {
    R__LOCKGUARD(fMutexList);
 
+   StopTasks();
    Int_t res = TTreeCache::SetBufferSize(buffersize);
    if (res < 0) {
       return res;
@@ -335,6 +329,18 @@ void TTreeCacheUnzip::SetEntryRange(Long64_t emin, Long64_t emax)
    TTreeCache::SetEntryRange(emin, emax);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Change the file that is being cached; the unzipping tasks are stopped
+/// first since they may still be reading the cache buffer.
+
+void TTreeCacheUnzip::SetFile(TFile *file, TFile::ECacheAction action)
+{
+   R__LOCKGUARD(fMutexList);
+
+   StopTasks();
+   TTreeCache::SetFile(file, action);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// It's the same as TTreeCache::StopLearningPhase but we guarantee that
 /// we start the unzipping just after getting the buffers
@@ -354,6 +360,7 @@ void TTreeCacheUnzip::UpdateBranches(TTree *tree)
 {
    R__LOCKGUARD(fMutexList);
 
+   StopTasks();
    TTreeCache::UpdateBranches(tree);
 }
 
@@ -383,63 +390,17 @@ Bool_t TTreeCacheUnzip::IsParallelUnzip()
    return kFALSE;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// This indicates if the thread is active in this moment...
-/// this variable is very important because if we change it from true to
-/// false the thread will stop... ( see StopThreadTreeCacheUnzip() )
-
-Bool_t TTreeCacheUnzip::IsActiveThread()
-{
-   R__LOCKGUARD(fMutexList);
-
-   return fActiveThread;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// It says if the queue is empty... useful to see if we have to process it.
-
-Bool_t TTreeCacheUnzip::IsQueueEmpty()
-{
-   R__LOCKGUARD(fMutexList);
-
-   if ( fIsLearning )
-      return kTRUE;
-
-   return kFALSE;
-}
-
-void TTreeCacheUnzip::WaitUnzipStartSignal()
-{
-   // Here the threads sleep waiting for some blocks to unzip
-
-   fUnzipStartCondition->TimedWaitRelative(2000);
-
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// This will send the signal corresponfing to the queue... normally used
-/// when we want to start processing the list of buffers.
-
-void TTreeCacheUnzip::SendUnzipStartSignal(Bool_t broadcast)
-{
-   if (gDebug > 0) Info("SendSignal", " fUnzipCondition->Signal()");
-
-   if (broadcast)
-      fUnzipStartCondition->Broadcast();
-   else
-      fUnzipStartCondition->Signal();
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function that (de)activates multithreading unzipping
 ///
 /// The possible options are:
-///  - kEnable _Enable_ it, which causes an automatic detection and launches the
-///    additional thread if the number of cores in the machine is greater than
-///    one
-///  - kDisable _Disable_ will not activate the additional thread.
-///  - kForce _Force_ will start the additional thread even if there is only one
-///    core. the default will be taken as kEnable.
+///  - kEnable _Enable_ it, the baskets are then unzipped by parallel tasks
+///    if the implicit multi-threading is enabled (see ROOT::EnableImplicitMT)
+///  - kDisable _Disable_ will not start any unzipping task.
+///  - kForce _Force_ will start the unzipping tasks even if the implicit
+///    multi-threading is not enabled. the default will be taken as kEnable.
+///
+/// The parallel unzipping requires ROOT to be built with the imt option.
 ///
 /// Returns 0 if there was an error, 1 otherwise.
 
@@ -452,135 +413,60 @@ Int_t TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option)
    return 0;
 }
 
-class TTreeCacheUnzipData {
-public:
-   TTreeCacheUnzip *fInstance;
-   Int_t            fCount;
-};
-
 ////////////////////////////////////////////////////////////////////////////////
-/// The Thread is only a part of the TTreeCache but it is the part that
-/// waits for info in the queue and process it... unfortunatly, a Thread is
-/// not an object an we have to deal with it in the old C-Style way
-/// Returns 0 if the thread was initialized or 1 if it was already running
-
-Int_t TTreeCacheUnzip::StartThreadUnzip(Int_t nthreads)
-{
-   Int_t nt = nthreads;
-   if (nt > 10) nt = 10;
-
-   if (gDebug > 0)
-      Info("StartThreadUnzip", "Going to start %d threads.", nt);
-
-   for (Int_t i = 0; i < nt; i++) {
-      if (!fUnzipThread[i]) {
-         TString nm("UnzipLoop");
-         nm += i;
-
-         if (gDebug > 0)
-            Info("StartThreadUnzip", "Going to start thread '%s'", nm.Data());
-
-         TTreeCacheUnzipData *d = new TTreeCacheUnzipData;
-         d->fInstance = this;
-         d->fCount = i;
-
-         fUnzipThread[i] = new TThread(nm.Data(), UnzipLoop, (void*)d);
-         if (!fUnzipThread[i])
-            Error("TTreeCacheUnzip::StartThreadUnzip", " Unable to create new thread.");
-
-         fUnzipThread[i]->Run();
-
-         // There is at least one active thread
-         fActiveThread=kTRUE;
-
-      }
-   }
-
-   return (fActiveThread == kTRUE);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// To stop the thread we only need to change the value of the variable
-/// fActiveThread to false and the loop will stop (of course, we will have)
-/// to do the cleaning after that.
+/// Start the tasks unzipping the blocks of the current cluster, up to one
+/// per core.
 ///
-/// Note: The syncronization part is important here or we will try to delete
-///       teh object while it's still processing the queue
+/// Each task picks up the next block which is neither unzipped nor being
+/// unzipped, until all the blocks have been seen or the unzipped blocks
+/// waiting to be read exceed fUnzipBufferSize. In the latter case the
+/// tasks are started again by GetUnzipBuffer once some memory was released.
 
-Int_t TTreeCacheUnzip::StopThreadUnzip()
+void TTreeCacheUnzip::CreateTasks()
 {
-   fActiveThread = kFALSE;
+#ifdef R__USE_IMT
+   R__LOCKGUARD(fMutexList);
 
-   for (Int_t i = 0; i < 1; i++) {
-      if(fUnzipThread[i]){
+   if (!fUnzipTaskGroup) fUnzipTaskGroup = new tbb::task_group;
+   tbb::task_group *group = (tbb::task_group*)fUnzipTaskGroup;
 
-         SendUnzipStartSignal(kTRUE);
+   Int_t ntasks = ROOT::GetImplicitMTPoolSize();
+   if (ntasks < 1) ntasks = 1;
+   if (ntasks > fNseek) ntasks = fNseek;
+   ntasks -= fNUnzipTasks;
 
-         if (fUnzipThread[i]->Exists()) {
-            fUnzipThread[i]->Join();
-            delete fUnzipThread[i];
+   if (gDebug > 0)
+      Info("CreateTasks", "Starting %d unzipping tasks, fNseek: %d fUnzipNext: %d", ntasks, fNseek, (Int_t)fUnzipNext);
+
+   for (Int_t i = 0; i < ntasks; ++i) {
+      ++fNUnzipTasks;
+      group->run([this]() {
+         while (!fUnzipAbort && fTotalUnzipBytes < fUnzipBufferSize) {
+            Int_t index = fUnzipNext++;
+            if (index >= fNseek) break;
+            // Small blocks are not worth a task, the reader unzips them.
+            if (fSeekSortLen[index] > 256) UnzipCache(index);
          }
-      }
-
+         --fNUnzipTasks;
+      });
    }
-
-   return 1;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// This is a static function.
-///
-/// This is the call that will be executed in the Thread generated by
-/// StartThreadTreeCacheUnzip... what we want to do is to inflate the next
-/// series of buffers leaving them in the second cache.
-///
-/// Returns 0 when it finishes
+/// Stop the unzipping tasks and wait for the ones which are running.
+/// Must be called before changing the content of the cache.
 
-void* TTreeCacheUnzip::UnzipLoop(void *arg)
+void TTreeCacheUnzip::StopTasks()
 {
-   TTreeCacheUnzipData *d = (TTreeCacheUnzipData *)arg;
-   TTreeCacheUnzip *unzipMng = d->fInstance;
-
-   TThread::SetCancelOn();
-   TThread::SetCancelDeferred();
-
-   Int_t thrnum = d->fCount;
-   Int_t startindex = thrnum;
-   Int_t locbuffsz = 16384;
-   char *locbuff = new char[16384];
-   Int_t res = 0;
-   Int_t myCycle = 0;
-
-   while( unzipMng->IsActiveThread() ) {
-      res = 1;
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-         if (myCycle != unzipMng->fCycle) startindex = thrnum;
-         myCycle = unzipMng->fCycle;
-         if (unzipMng->fNseek) startindex = startindex % unzipMng->fNseek;
-         else startindex = -1;
-      }
-
-      if (startindex >= 0)
-         res = unzipMng->UnzipCache(startindex, locbuffsz, locbuff);
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-
-         if(!unzipMng->IsActiveThread()) break;
-
-         if ((res == 1) || (!unzipMng->fIsTransferred)) {
-            unzipMng->WaitUnzipStartSignal();
-            startindex = unzipMng->fLastReadPos+3+thrnum;
-         }
-      }
-
+#ifdef R__USE_IMT
+   if (fUnzipTaskGroup) {
+      fUnzipAbort = kTRUE;
+      ((tbb::task_group*)fUnzipTaskGroup)->wait();
+      fUnzipAbort = kFALSE;
    }
-
-   delete d;
-   delete [] locbuff;
-   return (void *)0;
+#endif
+   fUnzipNext = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -641,32 +527,29 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
 
 void TTreeCacheUnzip::ResetCache()
 {
-   {
    R__LOCKGUARD(fMutexList);
 
+   StopTasks();
+
    if (gDebug > 0)
-      Info("ResetCache", "Thread: %ld -- Resetting the cache. fNseek:%d fNSeekMax:%d fTotalUnzipBytes:%lld", TThread::SelfId(), fNseek, fNseekMax, fTotalUnzipBytes);
+      Info("ResetCache", "Resetting the cache. fNseek:%d fNSeekMax:%d fTotalUnzipBytes:%lld", fNseek, fNseekMax, (Long64_t)fTotalUnzipBytes);
 
    // Reset all the lists and wipe all the chunks
-   fCycle++;
    for (Int_t i = 0; i < fNseekMax; i++) {
       if (fUnzipLen) fUnzipLen[i] = 0;
       if (fUnzipChunks) {
          if (fUnzipChunks[i]) delete [] fUnzipChunks[i];
          fUnzipChunks[i] = 0;
       }
-      if (fUnzipStatus) fUnzipStatus[i] = 0;
-
+      if (fUnzipStatus) fUnzipStatus[i] = kUntouched;
    }
 
-   while (fActiveBlks.size()) fActiveBlks.pop();
-
    if(fNseekMax < fNseek){
       if (gDebug > 0)
          Info("ResetCache", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
 
-      Byte_t *aUnzipStatus = new Byte_t[fNseek];
-      memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
+      std::atomic<Byte_t> *aUnzipStatus = new std::atomic<Byte_t>[fNseek];
+      for (Int_t i = 0; i < fNseek; i++) aUnzipStatus[i] = kUntouched;
 
       Int_t *aUnzipLen = new Int_t[fNseek];
       memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
@@ -685,13 +568,7 @@ void TTreeCacheUnzip::ResetCache()
       fNseekMax  = fNseek;
    }
 
-   fLastReadPos = 0;
    fTotalUnzipBytes = 0;
-   fBlocksToGo = fNseek;
-   }
-
-   SendUnzipStartSignal(kTRUE);
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -707,195 +584,76 @@ void TTreeCacheUnzip::ResetCache()
 Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_t *free)
 {
    Int_t res = 0;
-   Int_t loc = -1;
-
-   {
-      R__LOCKGUARD(fMutexList);
-
-      // We go straight to TTreeCache/TfileCacheRead, in order to get the info we need
-      //  pointer to the original zipped chunk
-      //  its index in the original unsorted offsets lists
-      //
-      // Actually there are situations in which copying the buffer is not
-      // useful. But the choice is among doing once more a small memcpy or a binary search in a large array. I prefer the former.
-      // Also, here we prefer not to trigger the (re)population of the chunks in the TFileCacheRead. That is
-      // better to be done in the main thread.
-
-      // And now loc is the position of the chunk in the array of the sorted chunks
-      Int_t myCycle = fCycle;
-
-      if (fParallel && !fIsLearning) {
-
-         if(fNseekMax < fNseek){
-            if (gDebug > 0)
-               Info("GetUnzipBuffer", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
-
-            Byte_t *aUnzipStatus = new Byte_t[fNseek];
-            memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
-
-            Int_t *aUnzipLen = new Int_t[fNseek];
-            memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
-
-            char **aUnzipChunks = new char *[fNseek];
-            memset(aUnzipChunks, 0, fNseek*sizeof(char *));
-
-            for (Int_t i = 0; i < fNseekMax; i++) {
-               aUnzipStatus[i] = fUnzipStatus[i];
-               aUnzipLen[i] = fUnzipLen[i];
-               aUnzipChunks[i] = fUnzipChunks[i];
+   Int_t unzipLoc = -1;
+
+   // The tasks only work on the blocks of the current cluster, once they
+   // have been transferred in the cache buffer. With asynchronous reading or
+   // prefetching the blocks are not kept in the buffer, so we unzip here.
+   if (fParallel && !fIsLearning && fIsTransferred && fNseek > 0 && fNseek <= fNseekMax &&
+       !TFileCacheRead::fAsyncReading && !fEnablePrefetching) {
+
+      // loc is the position of the chunk in the array of the sorted chunks,
+      // which is also the index used for the unzipping arrays.
+      Int_t loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
+      if ( (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
+         unzipLoc = loc;
+
+         // (Re)start the tasks if none is running and there is something left to do.
+         if (!fNUnzipTasks && fUnzipNext < fNseek && fTotalUnzipBytes < fUnzipBufferSize)
+            CreateTasks();
+
+         // Either we take the block so that no task will touch it, or a task
+         // has it and we get its result.
+         Byte_t expected = kUntouched;
+         if (!fUnzipStatus[loc].compare_exchange_strong(expected, (Byte_t)kProgress)) {
+
+            // If the status of the unzipped chunk is pending we wait only for
+            // this chunk to be done, the task notifies fUnzipDone.
+            Bool_t stalled = kFALSE;
+            if (fUnzipStatus[loc] == kProgress) {
+               stalled = kTRUE;
+               std::unique_lock<std::mutex> lock(fUnzipDoneMutex);
+               fUnzipDone.wait(lock, [this, loc]() { return fUnzipStatus[loc] != kProgress; });
             }
 
-            if (fUnzipStatus) delete [] fUnzipStatus;
-            if (fUnzipLen) delete [] fUnzipLen;
-            if (fUnzipChunks) delete [] fUnzipChunks;
-
-            fUnzipStatus  = aUnzipStatus;
-            fUnzipLen  = aUnzipLen;
-            fUnzipChunks = aUnzipChunks;
-
-            fNseekMax  = fNseek;
-         }
-
-         loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
-         if ( (fCycle == myCycle) && (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
-
-            // The buffer is, at minimum, in the file cache. We must know its index in the requests list
-            // In order to get its info
-            Int_t seekidx = fSeekIndex[loc];
-
-            fLastReadPos = seekidx;
-
-            do {
-
-               // If the block is ready we get it immediately.
-               // And also we don't have to alloc the blks. This is supposed to be
-               // the main thread of the app.
-               if ((fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0)) {
-
-                  //if (gDebug > 0)
-                  //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheHIT Block wanted: %d  len:%d req_len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], len,  fNseek);
-
-                  if(!(*buf)) {
-                     *buf = fUnzipChunks[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kTRUE;
-                  }
-                  else {
-                     memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                     delete fUnzipChunks[seekidx];
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kFALSE;
-                  }
-
-                  fNFound++;
-
-                  return fUnzipLen[seekidx];
-               }
-
-               // If the status of the unzipped chunk is pending
-               // we wait on the condvar, hoping that the next signal is the good one
-               if ( fUnzipStatus[seekidx] == 1 ) {
-                  //fMutexList->UnLock();
-                  fUnzipDoneCondition->TimedWaitRelative(200);
-                  //fMutexList->Lock();
-
-                  if ( myCycle != fCycle ) {
-                     if (gDebug > 0)
-                        Info("GetUnzipBuffer", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                             IsActiveThread(), fNseek, fIsLearning);
-
-                     fLastReadPos = 0;
-
-                     seekidx = -1;
-                     break;
-                  }
-
-               }
-
-            } while ( fUnzipStatus[seekidx] == 1 );
-
-            //if (gDebug > 0)
-            //   Info("GetUnzipBuffer", "------- Block wanted: %d  status: %d len: %d chunk: %llx ", seekidx, fUnzipStatus[seekidx], fUnzipLen[seekidx], fUnzipChunks[seekidx]);
-
-            // Here the block is not pending. It could be done or aborted or not yet being processed.
-            if ( (seekidx >= 0) && (fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0) ) {
-
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheLateHIT Block wanted: %d  len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], fNseek);
-
+            // The task hands over its chunk, it is not referenced anywhere else.
+            if (fUnzipChunks[loc]) {
+               Int_t unzipLen = fUnzipLen[loc];
                if(!(*buf)) {
-                  *buf = fUnzipChunks[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  SendUnzipStartSignal(kFALSE);
+                  *buf = fUnzipChunks[loc];
                   *free = kTRUE;
                }
                else {
-                  memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                  delete fUnzipChunks[seekidx];
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  SendUnzipStartSignal(kFALSE);
+                  memcpy(*buf, fUnzipChunks[loc], unzipLen);
+                  delete [] fUnzipChunks[loc];
                   *free = kFALSE;
                }
+               fUnzipChunks[loc] = 0;
+               fTotalUnzipBytes -= unzipLen;
 
-               fNStalls++;
+               if (stalled) fNStalls++;
+               else         fNFound++;
 
-               return fUnzipLen[seekidx];
+               return unzipLen;
             }
-            else {
-               // This is a complete miss. We want to avoid the threads
-               // to try unzipping this block in the future.
-               fUnzipStatus[seekidx] = 2;
-               fUnzipChunks[seekidx] = 0;
 
-               if ((fTotalUnzipBytes < fUnzipBufferSize) && fBlocksToGo)
-                  SendUnzipStartSignal(kFALSE);
-
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS Block wanted: %d  len:%d fNseek:%d", seekidx, len, fNseek);
-            }
-
-         } else {
-            loc = -1;
-            //fLastReadPos = 0;
-            fIsTransferred = kFALSE;
+            // The task could not unzip the block (too big, read error...),
+            // we do it ourselves.
          }
-
-      } else {
-         // We need to reset it for new transferences...
-         //ResetCache();
-         //TFileCacheRead::Prefetch(0,0);
-      }
-
-   } // scope of the lock!
-
-   if (len > fCompBufferSize) {
-      delete [] fCompBuffer;
-      fCompBuffer = new char[len];
-      fCompBufferSize = len;
-   } else {
-      if (fCompBufferSize > len*4) {
-      delete [] fCompBuffer;
-      fCompBuffer = new char[len*2];
-      fCompBufferSize = len*2;
       }
    }
 
+   // Here we know that the async unzip of the wanted chunk
+   // was not done for some reason. We continue.
+   char *compBuffer = new char[len];
    {
       R__LOCKGUARD(fIOMutex);
-      // Here we know that the async unzip of the wanted chunk
-      // was not done for some reason. We continue.
 
       res = 0;
-      if (!ReadBufferExt(fCompBuffer, pos, len, loc)) {
-         //Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS %d %d", loc, fNseek);
+      Int_t loc = -1; // Set by ReadBufferExt, unrelated to unzipLoc.
+      if (!ReadBufferExt(compBuffer, pos, len, loc)) {
          fFile->Seek(pos);
-         res = fFile->ReadBuffer(fCompBuffer, len);
+         res = fFile->ReadBuffer(compBuffer, len);
       }
 
       if (res) res = -1;
@@ -903,9 +661,17 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
    } // scope of the lock!
 
    if (!res) {
-      res = UnzipBuffer(buf, fCompBuffer);
+      res = UnzipBuffer(buf, compBuffer, pos);
       *free = kTRUE;
    }
+   delete [] compBuffer;
+
+   // We took the block (or a task gave up on it): mark it as done so that
+   // the next request for it, e.g. when the basket is read again, does not
+   // wait for it.
+   if (unzipLoc >= 0 && fUnzipStatus) {
+      fUnzipStatus[unzipLoc] = kFinished;
+   }
 
    if (!fIsLearning) {
       fNMissed++;
@@ -944,8 +710,26 @@ void TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
 /// *dest is the inflated buffer (including the header)
 
 Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
+{
+   return UnzipBuffer(dest, src, -1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Same as UnzipBuffer(char **, char *) for the basket stored at position
+/// pos of the file; the position is used to find the compression
+/// dictionary of the basket's branch, if any.
+
+Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src, Long64_t pos)
 {
    Int_t  uzlen = 0;
+   Int_t  dictsize = 0;
+   const char *dict = 0;
+   if (pos >= 0 && !fDictBranches.empty()) {
+      // The map is only modified by FillBuffer, once the tasks are stopped.
+      std::map<Long64_t,TBranch*>::const_iterator it = fDictBranches.find(pos);
+      if (it != fDictBranches.end()) dict = it->second->GetCompressionDictionary(dictsize);
+   }
+
    Bool_t alloc = kFALSE;
 
    // Here we read the header of the buffer
@@ -1004,7 +788,7 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
             return uzlen;
          }
 
-         R__unzip(&nin, bufcur, &nbuf, objbuf, &nout);
+         R__unzipDict(&nin, bufcur, &nbuf, (UChar_t*)objbuf, &nout, (const UChar_t*)dict, dictsize);
 
          if (gDebug > 2)
             Info("UnzipBuffer", "R__unzip nin:%d, bufcur:%p, nbuf:%d, objbuf:%p, nout:%d",
@@ -1036,220 +820,96 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// This inflates all the buffers in the cache.. passing the data to a new
-/// buffer that will only wait there to be read...
-/// We can not inflate all the buffers in the cache so we will try to do
-/// it until the cache gets full... there is a member called fUnzipBufferSize which will
-/// tell us the max size we can allocate for this cache.
+/// This inflates the block index (in the sorted list of the blocks of the
+/// cache) into a new buffer that will only wait there to be read by
+/// GetUnzipBuffer. It is run by the unzipping tasks (see CreateTasks).
 ///
-/// note that we will  unzip in the order they were put into the cache not
-/// the order of the transference so it has to be read in that order or the
-/// pre-unzipping will be useless.
+/// If the reader already took the block, nothing is done. Since everything
+/// is so async, we cannot use a fixed buffer, we are forced to keep the
+/// individual chunks as separate blocks, whose summed size does not exceed
+/// the maximum allowed. The pointers are kept in the array fUnzipChunks.
 ///
-/// startindex is used as start index to check for blks to be unzipped
-///
-/// returns 0 in normal conditions or -1 if error, 1 if it would like to sleep
-///
-/// This func is supposed to compete among an indefinite number of threads to get a chunk to inflate
-/// in order to accommodate multiple unzippers
-/// Since everything is so async, we cannot use a fixed buffer, we are forced to keep
-/// the individual chunks as separate blocks, whose summed size does not exceed the maximum
-/// allowed. The pointers are kept globally in the array fUnzipChunks
+/// returns 0 in normal conditions
 
-Int_t TTreeCacheUnzip::UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff)
+Int_t TTreeCacheUnzip::UnzipCache(Int_t index)
 {
-   Int_t myCycle;
    const Int_t hlen=128;
    Int_t objlen=0, keylen=0;
    Int_t nbytes=0;
-   Int_t readbuf = 0;
-
-   Int_t idxtounzip = -1;
-   Long64_t rdoffs = 0;
-   Int_t rdlen = 0;
-   {
-      R__LOCKGUARD(fMutexList);
 
-      if (!IsActiveThread() || !fNseek || fIsLearning || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         return 1;
-      }
+   Byte_t expected = kUntouched;
+   if (!fUnzipStatus[index].compare_exchange_strong(expected, (Byte_t)kProgress)) {
+      return 0;
+   }
 
-      // To synchronize with the 'paging'
-      myCycle = fCycle;
-
-      // Try to look for a blk to unzip
-      idxtounzip = -1;
-      rdoffs = 0;
-      rdlen = 0;
-      if (fTotalUnzipBytes < fUnzipBufferSize) {
-
-         if (fBlocksToGo > 0) {
-            for (Int_t ii=0; ii < fNseek; ii++) {
-               Int_t reqi = (startindex+ii) % fNseek;
-               if (!fUnzipStatus[reqi] && (fSeekLen[reqi] > 256)   ) {
-                  // We found a chunk which is not unzipped nor pending
-                  fUnzipStatus[reqi] = 1; // Set it as pending
-                  idxtounzip = reqi;
-
-                  rdoffs = fSeek[idxtounzip];
-                  rdlen = fSeekLen[idxtounzip];
-                  break;
-               }
-            }
-            if (idxtounzip < 0) fBlocksToGo = 0;
-         }
-      }
+   Long64_t rdoffs = fSeekSort[index];
+   Int_t rdlen = fSeekSortLen[index];
 
-   } // lock scope
+   // The blocks were read in the cache buffer (see GetUnzipBuffer), we unzip
+   // directly from there. This way the tasks never access the file.
+   char *src = &fBuffer[fSeekPos[index]];
 
-   if (idxtounzip < 0) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Nothing to do... startindex:%d fTotalUnzipBytes:%lld fUnzipBufferSize:%lld fNseek:%d",
-              startindex, fTotalUnzipBytes, fUnzipBufferSize, fNseek );
-      return 1;
-   }
+   GetRecordHeader(src, hlen, nbytes, objlen, keylen);
 
-   // And here we have a new blk to unzip
-   startindex = idxtounzip+THREADCNT;
+   Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
 
-   if (!IsActiveThread() || !fNseek || fIsLearning ) {
+   // If the single unzipped chunk is really too big, leave it to the reader
+   // which will unzip it synchronously.
+   if (len > 4*fUnzipBufferSize) {
       if (gDebug > 0)
-         Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-              IsActiveThread(), fNseek, fIsLearning);
-      return 1;
+         Info("UnzipCache", "Block %d is too big, skipping.", index);
+      FinishUnzip(index);
+      return 0;
    }
 
-   Int_t loc = -1;
-
-   // Prepare a static tmp buf of adequate size
-   if(locbuffsz < rdlen) {
-      if (locbuff) delete [] locbuff;
-      locbuffsz = rdlen;
-      locbuff = new char[locbuffsz];
-      //memset(locbuff, 0, locbuffsz);
-   } else
-      if(locbuffsz > rdlen*3) {
-         if (locbuff) delete [] locbuff;
-         locbuffsz = rdlen*2;
-         locbuff = new char[locbuffsz];
-         //memset(locbuff, 0, locbuffsz);
-      }
-
-      if (gDebug > 0)
-      Info("UnzipCache", "Going to unzip block %d", idxtounzip);
-
-      readbuf = ReadBufferExt(locbuff, rdoffs, rdlen, loc);
-
-   {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle) || !fIsTransferred )  {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         fUnzipDoneCondition->Signal();
-
-         startindex = 0;
-         return 1;
-      }
-
-      if (readbuf <= 0) {
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         if (gDebug > 0)
-            Info("UnzipCache", "Block %d not done. rdoffs=%lld rdlen=%d readbuf=%d", idxtounzip, rdoffs, rdlen, readbuf);
-         return -1;
-      }
-
-      GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
-
-      Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
-
-      // If the single unzipped chunk is really too big, reset it to not processable
-      // I.e. mark it as done but set the pointer to 0
-      // This block will be unzipped synchronously in the main thread
-      if (len > 4*fUnzipBufferSize) {
-
-         //if (gDebug > 0)
-            Info("UnzipCache", "Block %d is too big, skipping.", idxtounzip);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         fUnzipDoneCondition->Signal();
-         return 0;
-      }
-
-   } // Scope of the lock
-
    // Unzip it into a new blk
    char *ptr = 0;
-   Int_t loclen = 0;
-
-   loclen = UnzipBuffer(&ptr, locbuff);
+   Int_t loclen = UnzipBuffer(&ptr, src, rdoffs);
 
    if ((loclen > 0) && (loclen == objlen+keylen)) {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle)  || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         delete [] ptr;
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         startindex = 0;
-         fUnzipDoneCondition->Signal();
-         return 1;
-      }
-
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = ptr;
-      fUnzipLen[idxtounzip] = loclen;
+      fUnzipChunks[index] = ptr;
+      fUnzipLen[index] = loclen;
       fTotalUnzipBytes += loclen;
-
-      fActiveBlks.push(idxtounzip);
+      fNUnzip++;
 
       if (gDebug > 0)
-         Info("UnzipCache", "reqi:%d, rdoffs:%lld, rdlen: %d, loclen:%d",
-              idxtounzip, rdoffs, rdlen, loclen);
-
-      fNUnzip++;
+         Info("UnzipCache", "index:%d, rdoffs:%lld, rdlen: %d, loclen:%d",
+              index, rdoffs, rdlen, loclen);
    }
    else {
-      R__LOCKGUARD(fMutexList);
-      Info("argh", "loclen:%d objlen:%d loc:%d readbuf:%d", loclen, objlen, loc, readbuf);
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = 0;
-      fUnzipLen[idxtounzip] = 0;
+      if (gDebug > 0)
+         Info("UnzipCache", "Block %d not done. loclen:%d objlen:%d", index, loclen, objlen);
+      delete [] ptr;
    }
 
-   fUnzipDoneCondition->Signal();
-
-   delete [] ptr;
+   // Publish the chunk to the reader.
+   FinishUnzip(index);
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Mark the block index as done by a task and wake up the reader if it
+/// waits for it in GetUnzipBuffer.
+
+void TTreeCacheUnzip::FinishUnzip(Int_t index)
+{
+   {
+      // Under the lock, so that the reader cannot miss the notification
+      // between its check of the status and its wait.
+      std::lock_guard<std::mutex> lock(fUnzipDoneMutex);
+      fUnzipStatus[index] = kFinished;
+   }
+   fUnzipDone.notify_all();
+}
+
 void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
    printf("Max allowed mem for pending buffers: %lld\n", fUnzipBufferSize);
-   printf("Number of blocks unzipped by threads: %d\n", fNUnzip);
-   printf("Number of hits: %d\n", fNFound);
-   printf("Number of stalls: %d\n", fNStalls);
-   printf("Number of misses: %d\n", fNMissed);
+   printf("Number of blocks unzipped by tasks: %d\n", (Int_t)fNUnzip);
+   printf("Number of hits: %d\n", (Int_t)fNFound);
+   printf("Number of stalls: %d\n", (Int_t)fNStalls);
+   printf("Number of misses: %d\n", (Int_t)fNMissed);
 
    TTreeCache::Print(option);
 }
@@ -34,6 +34,11 @@ Class implementing or helping  the various TTree cloning method
 
 #include <algorithm>
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/task_group.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Bool_t TTreeCloner::CompareSeek::operator()(UInt_t i1, UInt_t i2)
@@ -96,6 +101,11 @@ Bool_t TTreeCloner::CompareEntry::operator()(UInt_t i1, UInt_t i2)
 /// This means that on the file the baskets will be in the order
 /// in which they will be needed when reading the whole tree
 /// sequentially.
+///
+/// If 'method' also contains 'Recompress', the baskets of the branches
+/// whose compression settings differ from the ones of the output branch
+/// are uncompressed and compressed again with the output settings instead
+/// of being copied as is (see WriteBaskets).
 
 TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options) :
    fWarningMsg(),
@@ -115,10 +125,12 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fBasketIndex(new UInt_t[fMaxBaskets]),
    fPidOffset(0),
    fCloneMethod(TTreeCloner::kDefault),
-   fToStartEntries(0)
+   fToStartEntries(0),
+   fRecompress(kFALSE)
 {
    TString opt(method);
    opt.ToLower();
+   fRecompress = opt.Contains("recompress");
    if (opt.Contains("sortbasketsbybranch")) {
       //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByBranch");
       fCloneMethod = TTreeCloner::kSortBasketsByBranch;
@@ -221,6 +233,23 @@ UInt_t TTreeCloner::CollectBranches(TBranch *from, TBranch *to) {
    // Since this is called from the constructor, this can not be a virtual function
 
    UInt_t numBaskets = 0;
+
+   // The baskets are copied as is, so they must be decompressed with the
+   // same dictionary.
+   Int_t fromDictSize = 0, toDictSize = 0;
+   const char *fromDict = from->GetCompressionDictionary(fromDictSize);
+   const char *toDict = to->GetCompressionDictionary(toDictSize);
+   if (fromDictSize != toDictSize || (fromDictSize && memcmp(fromDict, toDict, fromDictSize) != 0)) {
+      fWarningMsg.Form("The export branch and the import branch do not have the same compression dictionary. (The branch name is %s.)",
+                       from->GetName());
+      if (!(fOptions & kNoWarnings)) {
+         Warning("TTreeCloner::CollectBranches", "%s", fWarningMsg.Data());
+      }
+      fNeedConversion = kTRUE;
+      fIsValid = kFALSE;
+      return 0;
+   }
+
    if (from->InheritsFrom(TBranchClones::Class())) {
       TBranchClones *fromclones = (TBranchClones*) from;
       TBranchClones *toclones = (TBranchClones*) to;
@@ -508,6 +537,7 @@ void TTreeCloner::CopyMemoryBaskets()
          basket = (TBasket*)basket->Clone();
          basket->SetBranch(to);
          to->AddBasket(*basket, kFALSE, fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()]);
+         CopyBasketRange(from, from->GetWriteBasket(), to, to->GetWriteBasket());
       } else {
          to->AddLastBasket(  fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()] );
       }
@@ -573,6 +603,22 @@ void TTreeCloner::CopyProcessIds()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the zone map of the basket 'index' of the branch 'from' to the basket
+/// 'where' of the branch 'to': the values are copied as is, so their range
+/// is still valid. TBranch::AddBasket leaves it unknown otherwise.
+
+void TTreeCloner::CopyBasketRange(TBranch *from, Int_t index, TBranch *to, Int_t where)
+{
+   Double_t min, max;
+   if (!to->fBasketMin || where < 0 || where >= to->fMaxBaskets) return;
+   if (!from->GetBasketRange(index, min, max)) return;
+   // Check that AddBasket did not insert the basket at another place.
+   if (to->fBasketEntry[where] != fToStartEntries + from->GetBasketEntry()[index]) return;
+   to->fBasketMin[where] = min;
+   to->fBasketMax[where] = max;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the entries and import the cluster range of the
 
@@ -616,39 +662,102 @@ void TTreeCloner::SortBaskets()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Transfer the basket from the input file to the output file
+///
+/// When recompressing, the baskets are loaded by batches of up to 64
+/// baskets (and 64MB) which, with implicit multi-threading, are
+/// recompressed by parallel tasks. They are then written in order, so the
+/// layout of the output file is the same as without recompression.
 
 void TTreeCloner::WriteBaskets()
 {
-   TBasket *basket = new TBasket();
-   for(UInt_t j=0; j<fMaxBaskets; ++j) {
-      TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
-      TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+   const UInt_t kBatchBaskets = fRecompress ? 64 : 1;
+   const Long64_t kBatchBytes = 64*1024*1024;
+
+   std::vector<TBasket*> baskets;
+   std::vector<Int_t> recompress;
+   for(UInt_t j0=0, j1=0; j0<fMaxBaskets; j0=j1) {
+      // Load the next batch of on-file baskets.
+      Long64_t batchBytes = 0;
+      for(j1=j0; j1<fMaxBaskets && j1-j0<kBatchBaskets && batchBytes<kBatchBytes; ++j1) {
+         UInt_t k = j1-j0;
+         if (k >= baskets.size()) {
+            baskets.push_back(new TBasket());
+            recompress.push_back(0);
+         }
+         recompress[k] = 0;
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j1] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j1] ] );
+
+         TFile *fromfile = from->GetFile(0);
 
-      TFile *tofile = to->GetFile(0);
-      TFile *fromfile = from->GetFile(0);
+         Int_t index = fBasketNum[ fBasketIndex[j1] ];
 
-      Int_t index = fBasketNum[ fBasketIndex[j] ];
+         Long64_t pos = from->GetBasketSeek(index);
+         if (pos!=0) {
+            if (from->GetBasketBytes()[index] == 0) {
+               from->GetBasketBytes()[index] = baskets[k]->ReadBasketBytes(pos, fromfile);
+            }
+            Int_t len = from->GetBasketBytes()[index];
 
-      Long64_t pos = from->GetBasketSeek(index);
-      if (pos!=0) {
-         if (from->GetBasketBytes()[index] == 0) {
-            from->GetBasketBytes()[index] = basket->ReadBasketBytes(pos, fromfile);
+            baskets[k]->LoadBasketBuffers(pos,len,fromfile,fFromTree);
+            batchBytes += len;
+            // The baskets of files older than 3.04/01 may look uncompressed when they are not.
+            recompress[k] = fRecompress && fromfile->GetVersion() > 30401 &&
+                            from->GetCompressionSettings() != to->GetCompressionSettings();
          }
-         Int_t len = from->GetBasketBytes()[index];
+      }
 
-         basket->LoadBasketBuffers(pos,len,fromfile,fFromTree);
-         basket->IncrementPidOffset(fPidOffset);
-         basket->CopyTo(tofile);
-         to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
-      } else {
-         TBasket *frombasket = from->GetBasket( index );
-         if (frombasket && frombasket->GetNevBuf()>0) {
-            TBasket *tobasket = (TBasket*)frombasket->Clone();
-            tobasket->SetBranch(to);
-            to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
-            to->FlushOneBasket(to->GetWriteBasket());
+      auto recompressBasket = [&](UInt_t k) {
+         TBranch *to = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j0+k] ] );
+         Int_t dictsize = 0;
+         const char *dict = to->GetCompressionDictionary(dictsize);
+         if (baskets[k]->RecompressBuffer(to->GetCompressionLevel(), to->GetCompressionAlgorithm(), dict, dictsize)) {
+            // The basket is left as is, it is still readable.
+            Warning("TTreeCloner::WriteBaskets", "could not recompress a basket of branch %s, copying it as is", to->GetName());
+         }
+      };
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && j1-j0 > 1) {
+         tbb::task_group g;
+         for(UInt_t k=0; k<j1-j0; ++k) {
+            if (recompress[k]) g.run([&recompressBasket, k]() { recompressBasket(k); });
+         }
+         g.wait();
+      } else
+#endif
+      {
+         for(UInt_t k=0; k<j1-j0; ++k) {
+            if (recompress[k]) recompressBasket(k);
+         }
+      }
+
+      // Write the batch in order.
+      for(UInt_t j=j0; j<j1; ++j) {
+         TBasket *basket = baskets[j-j0];
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+
+         TFile *tofile = to->GetFile(0);
+
+         Int_t index = fBasketNum[ fBasketIndex[j] ];
+
+         Long64_t pos = from->GetBasketSeek(index);
+         if (pos!=0) {
+            basket->IncrementPidOffset(fPidOffset);
+            basket->CopyTo(tofile);
+            to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+            CopyBasketRange(from, index, to, to->GetWriteBasket()-1);
+         } else {
+            TBasket *frombasket = from->GetBasket( index );
+            if (frombasket && frombasket->GetNevBuf()>0) {
+               TBasket *tobasket = (TBasket*)frombasket->Clone();
+               tobasket->SetBranch(to);
+               to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
+               CopyBasketRange(from, index, to, to->GetWriteBasket());
+               to->FlushOneBasket(to->GetWriteBasket());
+            }
          }
       }
    }
-   delete basket;
+   for(auto basket : baskets) delete basket;
 }
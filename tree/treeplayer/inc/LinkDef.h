@@ -21,10 +21,12 @@
 #pragma link C++ class TTreeIndex-;
 #pragma link C++ class TChainIndex+;
 #pragma link C++ class TChainIndex::TChainIndexEntry+;
+#pragma link C++ class TTreeBlockIndex-;
 #pragma link C++ class TTreeFormulaManager;
 #pragma link C++ class TTreeDrawArgsParser+;
 #pragma link C++ class TTreePerfStats+;
 #pragma link C++ class TTreeReader+;
+#pragma link C++ class TTreeProcessorMT;
 #pragma link C++ class TTreeTableInterface;
 
 #pragma link C++ namespace ROOT;
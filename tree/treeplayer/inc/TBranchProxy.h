@@ -201,6 +201,16 @@ namespace Detail {
 
       TVirtualCollectionProxy *GetCollection() { return fCollection; }
 
+      TBranch *GetBranch() {
+         // Return the branch read by this proxy in the current tree.
+         if (fDirector==0) return 0;
+         if (!IsInitialized() && !Setup()) return 0;
+         return fBranch;
+      }
+
+      Internal::TBranchProxyDirector *GetDirector() const { return fDirector; }
+      Long64_t GetReadEntry() const { return fDirector ? fDirector->GetReadEntry() : -1; }
+
       // protected:
       virtual  void *GetStart(UInt_t /*i*/=0) {
          // return the address of the start of the object being proxied. Assumes
@@ -0,0 +1,579 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TDataFrame
+#define ROOT_TDataFrame
+
+#ifndef ROOT_TTreeReader
+#include "TTreeReader.h"
+#endif
+#ifndef ROOT_TTreeReaderValue
+#include "TTreeReaderValue.h"
+#endif
+#ifndef ROOT_TFile
+#include "TFile.h"
+#endif
+#ifndef ROOT_TH1
+#include "TH1.h"
+#endif
+#ifndef ROOT_TList
+#include "TList.h"
+#endif
+#ifndef ROOT_TTree
+#include "TTree.h"
+#endif
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace ROOT {
+
+namespace Experimental {
+class TDataFrame;
+class TDataFrameInterface;
+template <typename T> class TResultProxy;
+}
+
+namespace Internal {
+namespace TDF {
+
+/// A compile time sequence of integers, used to expand the tuples of values.
+template <int...> struct TStaticSeq {};
+template <int N, int... S> struct TGenStaticSeq : TGenStaticSeq<N - 1, N - 1, S...> {};
+template <int... S> struct TGenStaticSeq<0, S...> { using Type_t = TStaticSeq<S...>; };
+
+/// A list of types.
+template <typename... Types> struct TTypeList {};
+
+/// The return type and the (decayed) argument types of a callable.
+template <typename F> struct TFunctionTraits : TFunctionTraits<decltype(&F::operator())> {};
+template <typename C, typename R, typename... Args> struct TFunctionTraits<R (C::*)(Args...) const> {
+   using Ret_t = typename std::decay<R>::type;
+   using Args_t = TTypeList<typename std::decay<Args>::type...>;
+};
+template <typename C, typename R, typename... Args> struct TFunctionTraits<R (C::*)(Args...)> {
+   using Ret_t = typename std::decay<R>::type;
+   using Args_t = TTypeList<typename std::decay<Args>::type...>;
+};
+template <typename R, typename... Args> struct TFunctionTraits<R (*)(Args...)> {
+   using Ret_t = typename std::decay<R>::type;
+   using Args_t = TTypeList<typename std::decay<Args>::type...>;
+};
+template <typename R, typename... Args> struct TFunctionTraits<R (Args...)> : TFunctionTraits<R (*)(Args...)> {};
+
+template <typename... Types> struct TNArgs;
+template <typename... Types> struct TNArgs<TTypeList<Types...>> { static const unsigned int fgValue = sizeof...(Types); };
+
+class TLoopManager;
+
+// The nodes of the computation graph keep a state per slot: the entries
+// of a slot are processed by one thread at a time. InitSlot is called for
+// each range of entries, with the TTreeReader of the range, and ClearSlot
+// at the end of the range, before the reader is deleted.
+
+/// A column added by TDataFrameInterface::Define, evaluated at most once
+/// per entry and slot.
+class TCustomColumnBase {
+public:
+   virtual ~TCustomColumnBase() {}
+   virtual void CreateSlots(unsigned int nSlots) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned int slot) = 0;
+   virtual void ClearSlot(unsigned int slot) = 0;
+   virtual void *GetValuePtr(unsigned int slot, Long64_t entry) = 0;
+   virtual const std::type_info &GetTypeId() const = 0;
+};
+
+/// A filter, added by TDataFrameInterface::Filter.
+class TFilterBase {
+public:
+   virtual ~TFilterBase() {}
+   virtual void CreateSlots(unsigned int nSlots) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned int slot) = 0;
+   virtual void ClearSlot(unsigned int slot) = 0;
+   virtual bool CheckFilters(unsigned int slot, Long64_t entry) = 0;
+};
+
+/// An action, producing a result from the entries passing the filters
+/// preceding it.
+class TActionBase {
+protected:
+   std::shared_ptr<TFilterBase> fPrev; ///< Last filter before the action, null if none
+public:
+   TActionBase(const std::shared_ptr<TFilterBase> &prev) : fPrev(prev) {}
+   virtual ~TActionBase() {}
+   virtual void CreateSlots(unsigned int nSlots) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned int slot) = 0;
+   virtual void ClearSlot(unsigned int slot) = 0;
+   virtual void Exec(unsigned int slot, Long64_t entry) = 0;
+   virtual void Finalize() = 0;
+   void Run(unsigned int slot, Long64_t entry)
+   {
+      if (!fPrev || fPrev->CheckFilters(slot, entry))
+         Exec(slot, entry);
+   }
+};
+
+/// Holds the tree, the nodes of the graph and runs the event loop, once
+/// for all the actions booked since the previous loop.
+class TLoopManager {
+private:
+   TTree                                          *fTree;           ///< Tree or chain to process
+   std::unique_ptr<TTree>                          fOwnedTree;      ///< Chain created from a file name, if any
+   std::vector<std::string>                        fDefaultColumns; ///< Columns used when none is given
+   std::vector<std::shared_ptr<TFilterBase>>       fFilters;        ///< All the filters of the graph
+   std::vector<std::pair<std::string, std::shared_ptr<TCustomColumnBase>>> fCustomColumns; ///< Columns added by Define
+   std::vector<std::shared_ptr<TActionBase>>       fActions;        ///< Actions waiting for the next event loop
+   std::vector<std::shared_ptr<bool>>              fReadiness;      ///< Set when the results of fActions are ready
+
+   void CreateSlots(unsigned int nSlots);
+   void InitSlot(TTreeReader &reader, unsigned int slot);
+   void ClearSlot(unsigned int slot);
+   void RunSequential();
+   bool RunMT();
+
+public:
+   TLoopManager(TTree *tree, const std::vector<std::string> &defaultColumns);
+   TLoopManager(const std::string &treeName, const std::string &fileNameGlob,
+                const std::vector<std::string> &defaultColumns);
+   TLoopManager(const TLoopManager &) = delete;
+   TLoopManager &operator=(const TLoopManager &) = delete;
+
+   TTree *GetTree() const { return fTree; }
+   const std::vector<std::string> &GetDefaultColumns() const { return fDefaultColumns; }
+   TCustomColumnBase *GetCustomColumn(const std::string &name) const;
+   bool HasColumn(const std::string &name) const;
+
+   void Book(const std::shared_ptr<TFilterBase> &filter) { fFilters.push_back(filter); }
+   void Book(const std::string &name, const std::shared_ptr<TCustomColumnBase> &column);
+   void Book(const std::shared_ptr<TActionBase> &action, const std::shared_ptr<bool> &readiness);
+   void Run(bool sequential = false);
+   void RunAlone(const std::shared_ptr<TActionBase> &action);
+};
+
+/// The value of a column for the current entry of a slot: a branch read
+/// through a TTreeReaderValue, or a column added by Define.
+template <typename T> class TColumnValue {
+private:
+   std::unique_ptr<TTreeReaderValue<T>> fReaderValue;
+   TCustomColumnBase *fCustomColumn = nullptr;
+   unsigned int fSlot = 0;
+
+public:
+   void Init(TTreeReader &reader, unsigned int slot, const std::string &name, const TLoopManager &lm)
+   {
+      fSlot = slot;
+      fCustomColumn = lm.GetCustomColumn(name);
+      if (!fCustomColumn) {
+         fReaderValue.reset(new TTreeReaderValue<T>(reader, name.c_str()));
+      } else if (fCustomColumn->GetTypeId() != typeid(T)) {
+         throw std::runtime_error("TDataFrame: the column " + name + " is read with the type " +
+                                  typeid(T).name() + " which is not the type it was defined with");
+      }
+   }
+   T &Get(Long64_t entry)
+   {
+      if (fCustomColumn)
+         return *static_cast<T *>(fCustomColumn->GetValuePtr(fSlot, entry));
+      return **fReaderValue;
+   }
+};
+
+/// Initialise the values of a tuple with the reader of the slot and the
+/// names of the columns.
+template <typename... Types, int... S>
+void InitColumnValues(std::tuple<TColumnValue<Types>...> &values, TTreeReader &reader, unsigned int slot,
+                      const std::vector<std::string> &columns, const TLoopManager &lm, TStaticSeq<S...>)
+{
+   int expander[] = {(std::get<S>(values).Init(reader, slot, columns[S], lm), 0)..., 0};
+   (void)expander;
+}
+
+template <typename F, typename ArgList = typename TFunctionTraits<F>::Args_t> class TCustomColumn;
+
+template <typename F, typename... Args>
+class TCustomColumn<F, TTypeList<Args...>> final : public TCustomColumnBase {
+   using Ret_t = typename TFunctionTraits<F>::Ret_t;
+   using Values_t = std::tuple<TColumnValue<Args>...>;
+   using Seq_t = typename TGenStaticSeq<sizeof...(Args)>::Type_t;
+
+   F fExpression;
+   const std::vector<std::string> fColumns;
+   const TLoopManager &fLoopManager;
+   std::vector<Values_t> fValues;
+   std::vector<std::pair<Long64_t, Ret_t>> fLastValues; ///< Entry and value last computed, per slot
+
+   template <int... S> Ret_t Eval(unsigned int slot, Long64_t entry, TStaticSeq<S...>)
+   {
+      return fExpression(std::get<S>(fValues[slot]).Get(entry)...);
+   }
+
+public:
+   TCustomColumn(F expression, const std::vector<std::string> &columns, const TLoopManager &lm)
+      : fExpression(expression), fColumns(columns), fLoopManager(lm) {}
+
+   void CreateSlots(unsigned int nSlots) override
+   {
+      fValues.clear();
+      fValues.resize(nSlots);
+      fLastValues.assign(nSlots, std::pair<Long64_t, Ret_t>(-1, Ret_t()));
+   }
+   void InitSlot(TTreeReader &reader, unsigned int slot) override
+   {
+      InitColumnValues(fValues[slot], reader, slot, fColumns, fLoopManager, Seq_t());
+      fLastValues[slot].first = -1;
+   }
+   void ClearSlot(unsigned int slot) override { fValues[slot] = Values_t(); }
+   void *GetValuePtr(unsigned int slot, Long64_t entry) override
+   {
+      std::pair<Long64_t, Ret_t> &last = fLastValues[slot];
+      if (last.first != entry) {
+         last.second = Eval(slot, entry, Seq_t());
+         last.first = entry;
+      }
+      return &last.second;
+   }
+   const std::type_info &GetTypeId() const override { return typeid(Ret_t); }
+};
+
+template <typename F, typename ArgList = typename TFunctionTraits<F>::Args_t> class TFilter;
+
+template <typename F, typename... Args>
+class TFilter<F, TTypeList<Args...>> final : public TFilterBase {
+   using Values_t = std::tuple<TColumnValue<Args>...>;
+   using Seq_t = typename TGenStaticSeq<sizeof...(Args)>::Type_t;
+
+   F fFilter;
+   const std::vector<std::string> fColumns;
+   std::shared_ptr<TFilterBase> fPrev; ///< Previous filter of the chain, null if none
+   const TLoopManager &fLoopManager;
+   std::vector<Values_t> fValues;
+   std::vector<std::pair<Long64_t, int>> fLastResults; ///< Entry and result last computed, per slot
+
+   template <int... S> bool Eval(unsigned int slot, Long64_t entry, TStaticSeq<S...>)
+   {
+      return fFilter(std::get<S>(fValues[slot]).Get(entry)...);
+   }
+
+public:
+   TFilter(F filter, const std::vector<std::string> &columns, const std::shared_ptr<TFilterBase> &prev,
+           const TLoopManager &lm)
+      : fFilter(filter), fColumns(columns), fPrev(prev), fLoopManager(lm) {}
+
+   void CreateSlots(unsigned int nSlots) override
+   {
+      fValues.clear();
+      fValues.resize(nSlots);
+      fLastResults.assign(nSlots, std::pair<Long64_t, int>(-1, 0));
+   }
+   void InitSlot(TTreeReader &reader, unsigned int slot) override
+   {
+      InitColumnValues(fValues[slot], reader, slot, fColumns, fLoopManager, Seq_t());
+      fLastResults[slot].first = -1;
+   }
+   void ClearSlot(unsigned int slot) override { fValues[slot] = Values_t(); }
+   bool CheckFilters(unsigned int slot, Long64_t entry) override
+   {
+      std::pair<Long64_t, int> &last = fLastResults[slot];
+      if (last.first != entry) {
+         // The filters are evaluated in order, the previous ones first.
+         last.second = (!fPrev || fPrev->CheckFilters(slot, entry)) && Eval(slot, entry, Seq_t());
+         last.first = entry;
+      }
+      return last.second;
+   }
+};
+
+/// Count the entries passing the filters.
+class TCountAction final : public TActionBase {
+   std::shared_ptr<ULong64_t> fResult;
+   std::vector<ULong64_t> fCounts; ///< Count per slot
+public:
+   TCountAction(const std::shared_ptr<ULong64_t> &result, const std::shared_ptr<TFilterBase> &prev)
+      : TActionBase(prev), fResult(result) {}
+   void CreateSlots(unsigned int nSlots) override { fCounts.assign(nSlots, 0); }
+   void InitSlot(TTreeReader &, unsigned int) override {}
+   void ClearSlot(unsigned int) override {}
+   void Exec(unsigned int slot, Long64_t) override { ++fCounts[slot]; }
+   void Finalize() override
+   {
+      *fResult = 0;
+      for (auto count : fCounts)
+         *fResult += count;
+   }
+};
+
+/// Fill a one dimensional histogram with the values of a column. Each slot
+/// fills its own copy of the histogram, the copies are merged at the end.
+template <typename T> class THisto1DAction final : public TActionBase {
+   std::shared_ptr<TH1D> fResult;
+   const std::vector<std::string> fColumns;
+   const TLoopManager &fLoopManager;
+   std::vector<std::tuple<TColumnValue<T>>> fValues;
+   std::vector<std::unique_ptr<TH1D>> fHistos; ///< Histogram per slot
+
+public:
+   THisto1DAction(const std::shared_ptr<TH1D> &result, const std::string &column,
+                  const std::shared_ptr<TFilterBase> &prev, const TLoopManager &lm)
+      : TActionBase(prev), fResult(result), fColumns(1, column), fLoopManager(lm) {}
+
+   void CreateSlots(unsigned int nSlots) override
+   {
+      fValues.clear();
+      fValues.resize(nSlots);
+      fHistos.clear();
+      for (unsigned int i = 0; i < nSlots; ++i) {
+         TH1D *h = new TH1D(*fResult);
+         h->SetDirectory(nullptr);
+         h->Reset();
+         fHistos.emplace_back(h);
+      }
+   }
+   void InitSlot(TTreeReader &reader, unsigned int slot) override
+   {
+      InitColumnValues(fValues[slot], reader, slot, fColumns, fLoopManager, TStaticSeq<0>());
+   }
+   void ClearSlot(unsigned int slot) override { fValues[slot] = std::tuple<TColumnValue<T>>(); }
+   void Exec(unsigned int slot, Long64_t entry) override
+   {
+      fHistos[slot]->Fill(std::get<0>(fValues[slot]).Get(entry));
+   }
+   void Finalize() override
+   {
+      TList list;
+      for (auto &h : fHistos)
+         list.Add(h.get());
+      fResult->Merge(&list);
+      fHistos.clear();
+   }
+};
+
+/// Write the values of columns in a new tree. Only run sequentially.
+template <typename... Types> class TSnapshotAction final : public TActionBase {
+   using Values_t = std::tuple<TColumnValue<Types>...>;
+   using Seq_t = typename TGenStaticSeq<sizeof...(Types)>::Type_t;
+
+   TTree *fOutputTree;
+   const std::vector<std::string> fColumns;
+   const TLoopManager &fLoopManager;
+   Values_t fValues;
+   std::tuple<Types...> fBranchValues; ///< Values at the address of the branches of fOutputTree
+
+   template <int... S> void Copy(Long64_t entry, TStaticSeq<S...>)
+   {
+      int expander[] = {(std::get<S>(fBranchValues) = std::get<S>(fValues).Get(entry), 0)..., 0};
+      (void)expander;
+   }
+   template <int... S> void MakeBranches(TStaticSeq<S...>)
+   {
+      int expander[] = {(fOutputTree->Branch(fColumns[S].c_str(), &std::get<S>(fBranchValues)), 0)..., 0};
+      (void)expander;
+   }
+
+public:
+   TSnapshotAction(TTree *outputTree, const std::vector<std::string> &columns, const std::shared_ptr<TFilterBase> &prev,
+                   const TLoopManager &lm)
+      : TActionBase(prev), fOutputTree(outputTree), fColumns(columns), fLoopManager(lm)
+   {
+      MakeBranches(Seq_t());
+   }
+   void CreateSlots(unsigned int nSlots) override
+   {
+      if (nSlots != 1)
+         throw std::runtime_error("TDataFrame: Snapshot cannot run in parallel");
+   }
+   void InitSlot(TTreeReader &reader, unsigned int slot) override
+   {
+      InitColumnValues(fValues, reader, slot, fColumns, fLoopManager, Seq_t());
+   }
+   void ClearSlot(unsigned int) override { fValues = Values_t(); }
+   void Exec(unsigned int, Long64_t entry) override
+   {
+      Copy(entry, Seq_t());
+      fOutputTree->Fill();
+   }
+   void Finalize() override {}
+};
+
+} // namespace TDF
+} // namespace Internal
+
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The result of an action of a TDataFrame. The event loop runs, for all
+/// the actions booked so far, the first time the result is accessed.
+template <typename T> class TResultProxy {
+   std::shared_ptr<Internal::TDF::TLoopManager> fLoopManager; ///< Runs the event loop
+   std::shared_ptr<bool>                        fReadiness;   ///< Set when the result is ready
+   std::shared_ptr<T>                           fObj;         ///< The result
+
+   void TriggerRun() const
+   {
+      if (!*fReadiness)
+         fLoopManager->Run();
+   }
+
+public:
+   TResultProxy(const std::shared_ptr<Internal::TDF::TLoopManager> &lm, const std::shared_ptr<bool> &readiness,
+                const std::shared_ptr<T> &obj)
+      : fLoopManager(lm), fReadiness(readiness), fObj(obj) {}
+
+   /// Return whether the result has been computed.
+   bool IsReady() const { return *fReadiness; }
+   /// Return the result, running the event loop if needed.
+   T &GetValue() const { TriggerRun(); return *fObj; }
+   T &operator*() const { return GetValue(); }
+   T *operator->() const { TriggerRun(); return fObj.get(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// A node of the computation graph of a TDataFrame: the whole dataset or
+/// the entries passing a chain of filters. See TDataFrame.
+class TDataFrameInterface {
+protected:
+   std::shared_ptr<Internal::TDF::TLoopManager> fLoopManager; //! Holds the graph and runs the event loop
+   std::shared_ptr<Internal::TDF::TFilterBase>  fNode;        //! Last filter of the chain, null for all the entries
+
+   TDataFrameInterface(const std::shared_ptr<Internal::TDF::TLoopManager> &lm,
+                       const std::shared_ptr<Internal::TDF::TFilterBase> &node)
+      : fLoopManager(lm), fNode(node) {}
+
+   std::vector<std::string> GetColumns(const std::vector<std::string> &columns, unsigned int n,
+                                       const char *where) const;
+
+public:
+   template <typename F>
+   TDataFrameInterface Filter(F f, const std::vector<std::string> &columns = {});
+   template <typename F>
+   TDataFrameInterface Define(const std::string &name, F expression, const std::vector<std::string> &columns = {});
+   TResultProxy<ULong64_t> Count();
+   template <typename T>
+   TResultProxy<TH1D> Histo1D(const TH1D &model, const std::string &column = "");
+   template <typename T>
+   TResultProxy<TH1D> Histo1D(const std::string &column = "");
+   template <typename... Types>
+   TDataFrame Snapshot(const std::string &treeName, const std::string &fileName, const std::vector<std::string> &columns);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The entry point of the functional interface to the analysis of a TTree,
+/// see the class documentation in TDataFrame.cxx.
+class TDataFrame : public TDataFrameInterface {
+public:
+   TDataFrame(const std::string &treeName, const std::string &fileNameGlob,
+              const std::vector<std::string> &defaultColumns = {});
+   TDataFrame(const std::string &treeName, TDirectory *dir, const std::vector<std::string> &defaultColumns = {});
+   TDataFrame(TTree &tree, const std::vector<std::string> &defaultColumns = {});
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Book a filter: only the entries for which f returns true are seen by the
+/// nodes attached to the returned one. The arguments of f are the values of
+/// columns (the default columns if none is given); their types are the
+/// ones of the arguments of f.
+
+template <typename F>
+TDataFrameInterface TDataFrameInterface::Filter(F f, const std::vector<std::string> &columns)
+{
+   using Args_t = typename Internal::TDF::TFunctionTraits<F>::Args_t;
+   const unsigned int nArgs = Internal::TDF::TNArgs<Args_t>::fgValue;
+   std::shared_ptr<Internal::TDF::TFilterBase> filter(
+      new Internal::TDF::TFilter<F>(f, GetColumns(columns, nArgs, "Filter"), fNode, *fLoopManager));
+   fLoopManager->Book(filter);
+   return TDataFrameInterface(fLoopManager, filter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the column name, whose value is computed by expression from the
+/// values of columns, at most once per entry. The column can be used by all
+/// the nodes of the TDataFrame.
+
+template <typename F>
+TDataFrameInterface TDataFrameInterface::Define(const std::string &name, F expression,
+                                                const std::vector<std::string> &columns)
+{
+   if (fLoopManager->HasColumn(name))
+      throw std::runtime_error("TDataFrame: cannot define the column " + name + ", it already exists");
+   using Args_t = typename Internal::TDF::TFunctionTraits<F>::Args_t;
+   const unsigned int nArgs = Internal::TDF::TNArgs<Args_t>::fgValue;
+   std::shared_ptr<Internal::TDF::TCustomColumnBase> column(
+      new Internal::TDF::TCustomColumn<F>(expression, GetColumns(columns, nArgs, "Define"), *fLoopManager));
+   fLoopManager->Book(name, column);
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Book the filling of a histogram, copy of model, with the values of the
+/// column of type T (the first default column if none is given). The
+/// contents of model are not copied: the result holds only the values of
+/// the column, and model is never modified.
+
+template <typename T>
+TResultProxy<TH1D> TDataFrameInterface::Histo1D(const TH1D &model, const std::string &column)
+{
+   const std::vector<std::string> columns = GetColumns(column.empty() ? std::vector<std::string>() :
+                                                       std::vector<std::string>(1, column), 1, "Histo1D");
+   std::shared_ptr<TH1D> h(new TH1D(model));
+   h->SetDirectory(nullptr);
+   h->Reset();
+   std::shared_ptr<bool> readiness(new bool(false));
+   std::shared_ptr<Internal::TDF::TActionBase> action(
+      new Internal::TDF::THisto1DAction<T>(h, columns[0], fNode, *fLoopManager));
+   fLoopManager->Book(action, readiness);
+   return TResultProxy<TH1D>(fLoopManager, readiness, h);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Same as above, with a histogram of 128 bins whose limits are computed
+/// from the first values (see TH1::SetBuffer).
+
+template <typename T>
+TResultProxy<TH1D> TDataFrameInterface::Histo1D(const std::string &column)
+{
+   return Histo1D<T>(TH1D("", "", 128, 0., 0.), column);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the columns, of types Types, of the entries passing the filters in
+/// the tree treeName of the new file fileName and return a TDataFrame
+/// reading it. Unlike the other actions, this runs immediately an event
+/// loop, with a single thread, for the snapshot only: the other actions
+/// booked are run later, by the access to one of their results.
+
+template <typename... Types>
+TDataFrame TDataFrameInterface::Snapshot(const std::string &treeName, const std::string &fileName,
+                                         const std::vector<std::string> &columns)
+{
+   if (columns.size() != sizeof...(Types))
+      throw std::runtime_error("TDataFrame: Snapshot needs a type for each column");
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "RECREATE"));
+   if (!file || file->IsZombie())
+      throw std::runtime_error("TDataFrame: Snapshot cannot create the file " + fileName);
+   TTree *tree = new TTree(treeName.c_str(), treeName.c_str());
+   std::shared_ptr<Internal::TDF::TActionBase> action(
+      new Internal::TDF::TSnapshotAction<Types...>(tree, columns, fNode, *fLoopManager));
+   fLoopManager->RunAlone(action);
+   tree->Write();
+   file->Close();
+   return TDataFrame(treeName, fileName, columns);
+}
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
@@ -62,6 +62,7 @@ protected:
    Bool_t         fCleanElist;     //  true if original Tree elist must be saved
    Bool_t         fObjEval;        //  true if fVar1 returns an object (or pointer to).
    Long64_t       fCurrentSubEntry; // Current subentry when fSelectMultiple is true. Used to fill TEntryListArray
+   Int_t          fBlockStatus;    //! 1 if ProcessFillBlock can evaluate the formulas by block, 0 if not, -1 if not known yet
 
 protected:
    virtual void      ClearFormula();
@@ -110,6 +111,7 @@ public:
    virtual Bool_t    Notify();
    virtual Bool_t    Process(Long64_t /*entry*/) { return kFALSE; }
    virtual void      ProcessFill(Long64_t entry);
+   virtual Long64_t  ProcessFillBlock(Long64_t entry, Long64_t nentries);
    virtual void      ProcessFillMultiple(Long64_t entry);
    virtual void      ProcessFillObject(Long64_t entry);
    virtual void      SetEstimate(Long64_t n);
@@ -0,0 +1,108 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeBlockIndex
+#define ROOT_TTreeBlockIndex
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeBlockIndex                                                      //
+//                                                                      //
+// A Tree Index with majorname and minorname, stored in compressed      //
+// blocks of sorted values.                                             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROOT_TVirtualIndex
+#include "TVirtualIndex.h"
+#endif
+#ifndef ROOT_TTreeFormula
+#include "TTreeFormula.h"
+#endif
+
+#include <mutex>
+#include <vector>
+
+class TFile;
+
+class TTreeBlockIndex : public TVirtualIndex {
+
+protected:
+   TString                fMajorName;           // Index major name
+   TString                fMinorName;           // Index minor name
+   Long64_t               fN;                   // Number of entries in the blocks
+   Int_t                  fBlockSize;           // Number of entries per block
+   Int_t                  fCompress;            // Compression settings of the blocks
+   std::vector<Long64_t>  fFirstMajor;          // Major value of the first entry of each block
+   std::vector<Long64_t>  fFirstMinor;          // Minor value of the first entry of each block
+   std::vector<Long64_t>  fBlockOffset;         // Position in fBlockFile of the key of each block, 0 if not written
+   std::vector<Int_t>     fBlockBytes;          // Size of the key of each block
+   TFile                 *fBlockFile;           //! File holding the keys of the blocks
+   std::vector<Long64_t>  fStaleOffset;         //! Keys in fBlockFile of the blocks replaced since the last write
+   std::vector<Int_t>     fStaleBytes;          //! Size of these keys
+   std::vector<std::vector<char> > fBlocks;     //! Blocks not written in fBlockFile: uncompressed size, then the values compressed
+   std::vector<Long64_t>  fPendingMajor;        //! Major values appended with delaySort, not in the blocks yet
+   std::vector<Long64_t>  fPendingMinor;        //! Minor values appended with delaySort
+   std::vector<Long64_t>  fPendingEntry;        //! Entry numbers appended with delaySort
+   std::vector<Long64_t>  fPendingRuns;         //! Start in fPending* of each sorted run appended
+   TTreeFormula          *fMajorFormula;        //! Pointer to major TreeFormula
+   TTreeFormula          *fMinorFormula;        //! Pointer to minor TreeFormula
+   TTreeFormula          *fMajorFormulaParent;  //! Pointer to major TreeFormula in Parent tree (if any)
+   TTreeFormula          *fMinorFormulaParent;  //! Pointer to minor TreeFormula in Parent tree (if any)
+   mutable Long64_t       fCurrentBlock;        //! Block whose values are in fCurrent*
+   mutable std::vector<Long64_t> fCurrentMajor; //! Major values of the current block
+   mutable std::vector<Long64_t> fCurrentMinor; //! Minor values of the current block
+   mutable std::vector<Long64_t> fCurrentEntry; //! Entry numbers of the current block
+   mutable std::mutex     fCurrentMutex;        //! Protects fCurrent* in the lookups
+
+   void                   Fill(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry, const Long64_t *order);
+   Long64_t               FindValues(Long64_t major, Long64_t minor) const;
+   const char            *GetBlockBytes(Long64_t block, std::vector<char> &storage, Int_t &nbytes) const;
+   Bool_t                 LoadBlock(Long64_t block) const;
+   void                   LoadValues(std::vector<Long64_t> &major, std::vector<Long64_t> &minor, std::vector<Long64_t> &entry) const;
+   void                   MergePending();
+   Bool_t                 WriteBlocks(TFile *file);
+
+private:
+   TTreeBlockIndex(const TTreeBlockIndex&);            // Not implemented.
+   TTreeBlockIndex &operator=(const TTreeBlockIndex&); // Not implemented.
+
+public:
+   TTreeBlockIndex();
+   TTreeBlockIndex(const TTree *T, const char *majorname, const char *minorname, Int_t blocksize = 4096);
+   virtual               ~TTreeBlockIndex();
+   virtual void           Append(const TVirtualIndex *,Bool_t delaySort = kFALSE);
+   Int_t                  GetBlockSize()    const {return fBlockSize;}
+   Long64_t               GetCompressedBytes() const;
+   virtual Long64_t       GetEntryNumberFriend(const TTree *parent);
+   virtual Long64_t       GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const;
+   virtual Long64_t       GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const;
+   Long64_t               GetEntryNumbersWithIndexRange(Long64_t majorLow, Long64_t minorLow, Long64_t majorHigh, Long64_t minorHigh, std::vector<Long64_t> &entries) const;
+   Long64_t               GetEntryNumbersWithMajorRange(Long64_t majorLow, Long64_t majorHigh, std::vector<Long64_t> &entries) const;
+   const char            *GetMajorName()    const {return fMajorName.Data();}
+   const char            *GetMinorName()    const {return fMinorName.Data();}
+   virtual Long64_t       GetN()            const {return fN + (Long64_t)fPendingMajor.size();}
+   Long64_t               GetNblocks()      const {return (Long64_t)fFirstMajor.size();}
+   virtual TTreeFormula  *GetMajorFormula();
+   virtual TTreeFormula  *GetMinorFormula();
+   virtual TTreeFormula  *GetMajorFormulaParent(const TTree *parent);
+   virtual TTreeFormula  *GetMinorFormulaParent(const TTree *parent);
+   virtual void           Print(Option_t *option="") const;
+   virtual void           UpdateFormulaLeaves(const TTree *parent);
+   virtual void           SetTree(const TTree *T);
+
+   ClassDef(TTreeBlockIndex,1);  //A Tree Index with majorname and minorname, stored in compressed blocks
+};
+
+#endif
+
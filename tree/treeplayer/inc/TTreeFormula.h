@@ -80,6 +80,16 @@ protected:
       kMin, kMax
 
    };
+   enum EJitStatus {
+      kJitUnknown, // fJitFunc must be made for the current leaves
+      kJitNone,    // the expression cannot be compiled, or TTreeFormula.JIT is not set
+      kJitReady    // fJitFunc evaluates the expression
+   };
+   enum EBlockStatus {
+      kBlockUnknown, // CanEvalBlock must check the formula
+      kBlockNone,    // the formula must be evaluated entry by entry with EvalInstance
+      kBlockReady    // EvalBlock can evaluate the formula
+   };
    enum {
       kAlias           = 200,
       kAliasString     = 201,
@@ -126,6 +136,17 @@ protected:
 
    LongDouble_t*        fConstLD;   // local version of fConsts able to store bigger numbers
 
+   void                     *fJitFunc;        //! Compiled version of the expression (see TTreeFormula.JIT)
+   std::vector<void*>        fJitArgs;        //! Address of the value of each leaf, passed to fJitFunc
+   Int_t                     fJitStatus;      //! Status of fJitFunc, see EJitStatus
+   Int_t                     fBlockStatus;    //! Whether EvalBlock can evaluate the formula, see EBlockStatus
+   Int_t                     fBlockDepth;     //! Maximum number of operands on the stack of EvalBlock
+   std::vector<Double_t>     fBlockValues;    //! Leaf columns and operand stack of EvalBlock
+   TBuffer                  *fBlockBuffer;    //! Buffer used to read the leaves in bulk
+   std::vector<Double_t>     fBlockRanges;    //! Ranges of the leaves and operand stack of EvalBlockRange
+   TTree                    *fZoneMapTree;    //! Tree for which fHasZoneMaps was computed
+   Bool_t                    fHasZoneMaps;    //! Whether a branch of the leaves of fZoneMapTree has zone maps
+
    TTreeFormula(const char *name, const char *formula, TTree *tree, const std::vector<std::string>& aliases);
    void Init(const char *name, const char *formula);
    Bool_t      BranchHasMethod(TLeaf* leaf, TBranch* branch, const char* method,const char* params, Long64_t readentry) const;
@@ -143,6 +164,11 @@ protected:
    virtual Double_t  GetValueFromMethod(Int_t i, TLeaf *leaf) const;
    virtual void*     GetValuePointerFromMethod(Int_t i, TLeaf *leaf) const;
    Int_t             GetRealInstance(Int_t instance, Int_t codeindex);
+   Bool_t            HasOnlyBasicLeaves() const;
+   static Int_t      BlockOperArity(Int_t action);
+   static void       BlockRangeOper(Int_t action, Double_t &amin, Double_t &amax, Double_t bmin, Double_t bmax);
+   static void       EvalBlockOper(Int_t action, Double_t *x, const Double_t *y, Int_t n);
+   Bool_t            MakeJitFunction();
 
    void              LoadBranches();
    Bool_t            LoadCurrentDim();
@@ -171,6 +197,9 @@ public:
 
    virtual Int_t       DefinedVariable(TString &variable, Int_t &action);
    virtual TClass*     EvalClass() const;
+   Bool_t              CanEvalBlock();
+   virtual Int_t       EvalBlock(Long64_t entry, Int_t nentries, Double_t *values);
+   virtual Int_t       EvalBlockRange(Long64_t entry, Int_t nentries, Double_t &min, Double_t &max);
 
    template<typename T> T EvalInstance(Int_t i=0, const char *stringStack[]=0);
    virtual Double_t       EvalInstance(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<Double_t>(i, stringStack); }
@@ -28,7 +28,12 @@
 #include "TString.h"
 #endif
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
 
+class TBranch;
 class TBrowser;
 class TFile;
 class TTree;
@@ -62,6 +67,25 @@ protected:
    TStopwatch   *fWatch;         //TStopwatch pointer
    TGaxis       *fRealTimeAxis;  //pointer to TGaxis object showing real-time
    TText        *fHostInfoText;  //Graphics Text object with the fHostInfo data
+   std::vector<TString>  fBranchNames;        //Names of the branches read
+   std::vector<Int_t>    fBranchBaskets;      //Number of baskets read per branch
+   std::vector<Int_t>    fBranchCacheMisses;  //Number of baskets per branch read from the file instead of the TTreeCache
+   std::vector<Long64_t> fBranchBytes;        //Number of zipped bytes read per branch
+   std::vector<Long64_t> fBranchUnzipBytes;   //Number of unzipped bytes per branch
+   std::vector<Double_t> fBranchUnzipTime;    //Time spent uncompressing the baskets of each branch
+   std::vector<Double_t> fBranchStreamerTime; //Time spent deserializing the entries of each branch
+   struct TBranchSlot;                         // Counters of a branch, updated without locking
+   std::vector<TBranchSlot*> fBranchSlots;     //!Counters not yet added to the per branch vectors, same index
+   std::map<const TBranch*,TBranchSlot*> fBranchIndex; //!Counters of the branches of fBranchTree
+   TTree                *fBranchTree;         //!Tree of the branches in fBranchIndex
+   Int_t                 fBranchTreeNumber;   //!Number in the chain of fBranchTree
+   std::atomic<ULong64_t> fBranchGeneration;  //!Changes when fBranchIndex is cleared, see GetBranchSlot
+   mutable std::mutex    fBranchMutex;        //!Protects fBranchSlots, fBranchIndex and fBranchTree
+
+   TBranchSlot     *FindBranchSlot(TBranch *branch);
+   TBranchSlot     *GetBranchSlot(TBranch *branch);
+   void             MergeBranchStats();
+   void             PrintBranchStats(std::ostream &out, Bool_t json) const;
 
 public:
    TTreePerfStats();
@@ -89,6 +113,7 @@ public:
    TStopwatch      *GetStopwatch() const {return fWatch;}
    virtual Int_t    GetTreeCacheSize() const {return fTreeCacheSize;}
    virtual Double_t GetUnzipTime() const {return fUnzipTime; }
+   Int_t            GetNbranches() const {return (Int_t)fBranchNames.size();}
    virtual void     Paint(Option_t *chopt="");
    virtual void     Print(Option_t *option="") const;
 
@@ -99,9 +124,13 @@ public:
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BasketReadEvent(TBranch *branch, Int_t len, Bool_t cacheMiss);
+   virtual void     BasketUnzipEvent(TBranch *branch, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BranchStreamerEvent(TBranch *branch, Double_t start);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
+   void             SaveBranchStats(const char *filename) const;
    virtual void     SavePrimitive(std::ostream &out, Option_t *option = "");
    virtual void     SetBytesRead(Long64_t nbytes) {fBytesRead = nbytes;}
    virtual void     SetBytesReadExtra(Long64_t nbytes) {fBytesReadExtra = nbytes;}
@@ -121,7 +150,7 @@ public:
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,1)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,2)  // TTree I/O performance measurement
 };
 
 #endif
@@ -59,6 +59,9 @@ protected:
    TList         *fInput;           //! input list to the selector
    TList         *fFormulaList;     //! Pointer to a list of coordinated list TTreeFormula (used by Scan and Query)
    TSelector     *fSelectorUpdate;  //! Set to the selector address when it's entry list needs to be updated by the UpdateFormulaLeaves function
+   Bool_t         fDrawHeadOnly;    //! If true, Process stops once the first buffer of values of a TSelectorDraw is filled, without terminating it (parallel DrawSelect)
+   Long64_t       fDrawHeadEnd;     //! First entry not processed by Process if it stopped because of fDrawHeadOnly, -1 otherwise
+   Bool_t         fDrawContinue;    //! If true, Process continues the loop of the TSelectorDraw stopped by fDrawHeadOnly, without calling Begin
 
 protected:
    const   char  *GetNameByIndex(TString &varexp, Int_t *index,Int_t colindex);
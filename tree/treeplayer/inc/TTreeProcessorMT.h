@@ -0,0 +1,113 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeProcessorMT
+#define ROOT_TTreeProcessorMT
+
+#ifndef ROOT_TTreeReader
+#include "TTreeReader.h"
+#endif
+
+#include <functional> //std::function, std::reference_wrapper
+#include <string>
+#include <type_traits> //std::result_of
+#include <vector>
+
+class TObject;
+class TTree;
+
+class TTreeProcessorMT {
+public:
+   /// A range of entries of a tree, made of whole clusters.
+   struct TTreeRange {
+      std::string fFileName; ///< Name of the file containing the tree
+      std::string fTreeName; ///< Name (path) of the tree in the file
+      Long64_t    fFirst;    ///< First entry of the range
+      Long64_t    fLast;     ///< Last entry of the range (excluded)
+   };
+
+   TTreeProcessorMT() : fClustersPerTask(1) {}
+   ~TTreeProcessorMT() {}
+
+   TTreeProcessorMT(const TTreeProcessorMT &) = delete;
+   TTreeProcessorMT &operator=(const TTreeProcessorMT &) = delete;
+
+   // ProcTree
+   // procFunc must take a TTreeReader& and return a pointer to TObject or inheriting classes (enforced at compile-time)
+   template<class F> auto ProcTree(const std::vector<std::string>& fileNames, F procFunc, const std::string& treeName, ULong64_t nToProcess = 0) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type;
+   template<class F> auto ProcTree(const std::string& fileName, F procFunc, const std::string& treeName, ULong64_t nToProcess = 0) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type;
+   template<class F> auto ProcTree(TTree& tree, F procFunc, ULong64_t nToProcess = 0) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type;
+
+   UInt_t GetClustersPerTask() const { return fClustersPerTask; }
+   void   SetClustersPerTask(UInt_t n) { fClustersPerTask = n ? n : 1; }
+
+   std::vector<TTreeRange> MakeRanges(const std::vector<std::string>& fileNames, const std::string& treeName, ULong64_t nToProcess) const;
+   std::vector<TTreeRange> MakeRanges(TTree& tree, ULong64_t nToProcess) const;
+
+private:
+   using ProcFunc_t = std::function<TObject*(TTreeReader&)>;
+
+   TObject *Process(const std::vector<TTreeRange>& ranges, const ProcFunc_t& func) const;
+   TObject *Process(TTree& tree, ULong64_t nToProcess, const ProcFunc_t& func) const;
+
+   UInt_t fClustersPerTask; ///< Number of clusters processed by each task
+};
+
+/************ TEMPLATE METHODS IMPLEMENTATION ******************/
+
+//////////////////////////////////////////////////////////////////////////
+/// Process the tree treeName of the files fileNames in parallel.
+/// The trees are split along their cluster boundaries and each task calls
+/// procFunc with its own TTreeReader, set to the entries of its range, on
+/// its own copy of the tree (with its own TTreeCache). The objects returned
+/// by procFunc are merged, first within each thread then between threads,
+/// and the result is returned. At most nToProcess entries are processed
+/// (0 means all).
+///
+/// procFunc is called concurrently by several threads: it must not modify
+/// shared state without synchronisation. The tasks run in the implicit
+/// multi-threading pool (see ROOT::EnableImplicitMT); if it is not
+/// enabled, the ranges are processed sequentially.
+template<class F>
+auto TTreeProcessorMT::ProcTree(const std::vector<std::string>& fileNames, F procFunc, const std::string& treeName, ULong64_t nToProcess) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type
+{
+   using retType = typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type;
+   static_assert(std::is_constructible<TObject*, retType>::value, "procFunc must return a pointer to a class inheriting from TObject, and must take a reference to TTreeReader as the only argument");
+
+   ProcFunc_t func = [&procFunc](TTreeReader &reader) -> TObject* { return procFunc(std::ref(reader)); };
+   return static_cast<retType>(Process(MakeRanges(fileNames, treeName, nToProcess), func));
+}
+
+
+template<class F>
+auto TTreeProcessorMT::ProcTree(const std::string& fileName, F procFunc, const std::string& treeName, ULong64_t nToProcess) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type
+{
+   std::vector<std::string> singleFileName(1, fileName);
+   return ProcTree(singleFileName, procFunc, treeName, nToProcess);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+/// Process a TTree or a TChain in parallel, see the version taking a list
+/// of files. Each task reads its own copy of the tree from its file, so
+/// the friends and the entry list of tree are not taken into account.
+/// A tree which is not in a file is processed sequentially.
+template<class F>
+auto TTreeProcessorMT::ProcTree(TTree& tree, F procFunc, ULong64_t nToProcess) -> typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type
+{
+   using retType = typename std::result_of<F(std::reference_wrapper<TTreeReader>)>::type;
+   static_assert(std::is_constructible<TObject*, retType>::value, "procFunc must return a pointer to a class inheriting from TObject, and must take a reference to TTreeReader as the only argument");
+
+   ProcFunc_t func = [&procFunc](TTreeReader &reader) -> TObject* { return procFunc(std::ref(reader)); };
+   return static_cast<retType>(Process(tree, nToProcess, func));
+}
+
+#endif
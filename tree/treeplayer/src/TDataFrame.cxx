@@ -0,0 +1,376 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Experimental::TDataFrame
+\ingroup treeplayer
+
+A functional interface to the analysis of a TTree or a TChain.
+
+Instead of a TSelector or a loop on a TTreeReader, the analysis is
+described by a graph of filters, new columns and actions booked on a
+TDataFrame. The event loop is run once for all the actions booked, only
+when one of their results is accessed, and only the branches used by the
+graph are read:
+~~~{.cpp}
+using namespace ROOT::Experimental;
+TDataFrame d("ntuple", "hsimple.root", {"px"});
+auto positive = d.Filter([](Float_t px) { return px > 0; });
+auto withR = positive.Define("r", [](Float_t px, Float_t py) { return sqrt(px * px + py * py); }, {"px", "py"});
+auto n = positive.Count();                     // booked, not computed
+auto hr = withR.Histo1D<Float_t>("r");         // booked, not computed
+hr->Draw();                                    // one event loop computes both results
+std::cout << *n << " entries with px > 0" << std::endl;
+~~~
+The nodes are:
+ - Filter(f, columns): the entries for which f returns true. The filters
+   can be chained, and are evaluated in order, at most once per entry.
+ - Define(name, f, columns): a new column, computed at most once per entry.
+ - Count(), Histo1D<T>([model,] column): actions, returning a
+   TResultProxy to their result.
+ - Snapshot<Types...>(treeName, fileName, columns): write the columns of
+   the entries passing the filters in a new tree; this runs immediately an
+   event loop for the snapshot only, and returns a TDataFrame on the new
+   tree. The other actions booked are not run by it.
+
+The arguments of the functions are the values of the columns given, or of
+the default columns of the TDataFrame; their types are deduced from the
+signature of the functions. The branches are read with TTreeReaderValue.
+
+If the implicit multi-threading is enabled (see ROOT::EnableImplicitMT)
+and the tree is in files, the event loop processes the clusters of the
+trees in parallel, as TTreeProcessorMT: the functions given to Filter and
+Define must then be thread safe. The number of threads used is the size of
+the implicit multi-threading pool (see ROOT::GetImplicitMTPoolSize). Each
+thread fills its own copy of the histograms, which are merged at the end.
+*/
+
+#include "TDataFrame.h"
+#include "TChain.h"
+#include "TDirectory.h"
+#include "TError.h"
+#include "TROOT.h"
+
+#ifdef R__USE_IMT
+#include "TTreeProcessorMT.h"
+#include "tbb/task_group.h"
+#include <algorithm>
+#include <atomic>
+#endif
+
+namespace ROOT {
+namespace Internal {
+namespace TDF {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process tree, which must outlive the loop manager.
+
+TLoopManager::TLoopManager(TTree *tree, const std::vector<std::string> &defaultColumns)
+   : fTree(tree), fDefaultColumns(defaultColumns)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the trees treeName of the files matching fileNameGlob, see
+/// TChain::Add.
+
+TLoopManager::TLoopManager(const std::string &treeName, const std::string &fileNameGlob,
+                           const std::vector<std::string> &defaultColumns)
+   : fTree(nullptr), fDefaultColumns(defaultColumns)
+{
+   TChain *chain = new TChain(treeName.c_str());
+   chain->Add(fileNameGlob.c_str());
+   fOwnedTree.reset(chain);
+   fTree = chain;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the column added by Define with this name, null if none.
+
+TCustomColumnBase *TLoopManager::GetCustomColumn(const std::string &name) const
+{
+   for (const auto &column : fCustomColumns) {
+      if (column.first == name)
+         return column.second.get();
+   }
+   return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if name is a column added by Define or a branch of the tree.
+
+bool TLoopManager::HasColumn(const std::string &name) const
+{
+   return GetCustomColumn(name) || (fTree && fTree->GetBranch(name.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the column name.
+
+void TLoopManager::Book(const std::string &name, const std::shared_ptr<TCustomColumnBase> &column)
+{
+   fCustomColumns.push_back(std::make_pair(name, column));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add an action to the next event loop, readiness is set when it is done.
+
+void TLoopManager::Book(const std::shared_ptr<TActionBase> &action, const std::shared_ptr<bool> &readiness)
+{
+   fActions.push_back(action);
+   fReadiness.push_back(readiness);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the nodes for nSlots slots.
+
+void TLoopManager::CreateSlots(unsigned int nSlots)
+{
+   for (auto &column : fCustomColumns)
+      column.second->CreateSlots(nSlots);
+   for (auto &filter : fFilters)
+      filter->CreateSlots(nSlots);
+   for (auto &action : fActions)
+      action->CreateSlots(nSlots);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the readers of the columns of the slot for a new range of entries.
+
+void TLoopManager::InitSlot(TTreeReader &reader, unsigned int slot)
+{
+   for (auto &column : fCustomColumns)
+      column.second->InitSlot(reader, slot);
+   for (auto &filter : fFilters)
+      filter->InitSlot(reader, slot);
+   for (auto &action : fActions)
+      action->InitSlot(reader, slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the readers of the columns of the slot, before their TTreeReader.
+
+void TLoopManager::ClearSlot(unsigned int slot)
+{
+   for (auto &column : fCustomColumns)
+      column.second->ClearSlot(slot);
+   for (auto &filter : fFilters)
+      filter->ClearSlot(slot);
+   for (auto &action : fActions)
+      action->ClearSlot(slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the event loop in this thread.
+
+void TLoopManager::RunSequential()
+{
+   CreateSlots(1);
+   TTreeReader reader(fTree);
+   InitSlot(reader, 0);
+   while (reader.Next()) {
+      const Long64_t entry = reader.GetCurrentEntry();
+      for (auto &action : fActions)
+         action->Run(0, entry);
+   }
+   ClearSlot(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the event loop with the tasks of the implicit multi-threading pool,
+/// each processing ranges of clusters with its own slot. Return false if
+/// the tree cannot be processed in parallel.
+
+bool TLoopManager::RunMT()
+{
+#ifdef R__USE_IMT
+   if (!ROOT::IsImplicitMTEnabled() || (!fTree->InheritsFrom(TChain::Class()) && !fTree->GetCurrentFile()))
+      return false;
+   const std::vector<TTreeProcessorMT::TTreeRange> ranges = TTreeProcessorMT().MakeRanges(*fTree, 0);
+   if (ranges.size() < 2)
+      return false;
+
+   // One task per slot, taking the next range to process until there is
+   // none left: a slot is never used by two threads at the same time.
+   const unsigned int nSlots = std::min<unsigned int>(ranges.size(), std::max(1u, ROOT::GetImplicitMTPoolSize()));
+   CreateSlots(nSlots);
+   std::atomic<unsigned int> nextRange(0);
+   auto processRanges = [&](unsigned int slot) {
+      // gDirectory is per thread: nothing created here goes to the
+      // directory of the caller.
+      TDirectory::TContext ctxt(nullptr);
+      std::unique_ptr<TFile> file;
+      std::string fileName;
+      TTree *tree = nullptr;
+      for (unsigned int i = nextRange++; i < ranges.size(); i = nextRange++) {
+         const TTreeProcessorMT::TTreeRange &range = ranges[i];
+         if (!file || range.fFileName != fileName) {
+            tree = nullptr;
+            fileName = range.fFileName;
+            file.reset(TFile::Open(fileName.c_str()));
+            if (!file || file->IsZombie()) {
+               Error("TDataFrame", "cannot open file %s", fileName.c_str());
+               file.reset();
+               continue;
+            }
+            file->GetObject(range.fTreeName.c_str(), tree);
+            if (!tree) {
+               Error("TDataFrame", "cannot find tree %s in file %s", range.fTreeName.c_str(), fileName.c_str());
+               continue;
+            }
+            // The parallelism is across the ranges.
+            tree->SetImplicitMT(kFALSE);
+            tree->SetCacheSize();
+         }
+         if (!tree)
+            continue;
+         tree->SetCacheEntryRange(range.fFirst, range.fLast);
+         TTreeReader reader(tree);
+         // Set the first entry to fFirst-1 so that the first call to TTreeReader::Next() reads fFirst.
+         if (reader.SetEntriesRange(range.fFirst - 1, range.fLast) != TTreeReader::kEntryValid) {
+            Error("TDataFrame", "could not set the TTreeReader to the range %lld-%lld of %s", range.fFirst,
+                  range.fLast, fileName.c_str());
+            continue;
+         }
+         InitSlot(reader, slot);
+         while (reader.Next()) {
+            const Long64_t entry = reader.GetCurrentEntry();
+            for (auto &action : fActions)
+               action->Run(slot, entry);
+         }
+         ClearSlot(slot);
+      }
+   };
+
+   tbb::task_group g;
+   for (unsigned int slot = 0; slot < nSlots; ++slot)
+      g.run([&processRanges, slot]() { processRanges(slot); });
+   g.wait();
+   return true;
+#else
+   return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the event loop for all the actions booked since the previous one,
+/// in parallel if the implicit multi-threading is enabled and sequential
+/// is false, and make their results ready.
+
+void TLoopManager::Run(bool sequential)
+{
+   if (fActions.empty())
+      return;
+   if (!fTree) {
+      Error("TDataFrame", "there is no tree to process");
+   } else if (sequential || !RunMT()) {
+      RunSequential();
+   }
+   for (auto &action : fActions)
+      action->Finalize();
+   for (auto &readiness : fReadiness)
+      *readiness = true;
+   fActions.clear();
+   fReadiness.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run, sequentially, an event loop for action only. The actions booked
+/// since the previous event loop stay booked for the next one.
+
+void TLoopManager::RunAlone(const std::shared_ptr<TActionBase> &action)
+{
+   std::vector<std::shared_ptr<TActionBase>> actions;
+   std::vector<std::shared_ptr<bool>> readiness;
+   std::swap(actions, fActions);
+   std::swap(readiness, fReadiness);
+   fActions.push_back(action);
+   fReadiness.push_back(std::make_shared<bool>(false));
+   try {
+      Run(true);
+   } catch (...) {
+      fActions = std::move(actions);
+      fReadiness = std::move(readiness);
+      throw;
+   }
+   fActions = std::move(actions);
+   fReadiness = std::move(readiness);
+}
+
+} // namespace TDF
+} // namespace Internal
+
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return columns, or the first n default columns if columns is empty.
+
+std::vector<std::string> TDataFrameInterface::GetColumns(const std::vector<std::string> &columns, unsigned int n,
+                                                         const char *where) const
+{
+   if (columns.empty() && n > 0) {
+      const std::vector<std::string> &defaultColumns = fLoopManager->GetDefaultColumns();
+      if (defaultColumns.size() < n)
+         throw std::runtime_error(std::string("TDataFrame::") + where + ": not enough default columns");
+      return std::vector<std::string>(defaultColumns.begin(), defaultColumns.begin() + n);
+   }
+   if (columns.size() != n)
+      throw std::runtime_error(std::string("TDataFrame::") + where + ": the number of columns does not match");
+   return columns;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Book the counting of the entries passing the filters.
+
+TResultProxy<ULong64_t> TDataFrameInterface::Count()
+{
+   std::shared_ptr<ULong64_t> count(new ULong64_t(0));
+   std::shared_ptr<bool> readiness(new bool(false));
+   std::shared_ptr<Internal::TDF::TActionBase> action(new Internal::TDF::TCountAction(count, fNode));
+   fLoopManager->Book(action, readiness);
+   return TResultProxy<ULong64_t>(fLoopManager, readiness, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Analyse the trees treeName of the files matching fileNameGlob (see
+/// TChain::Add). The default columns are used by the functions and actions
+/// for which no column is given.
+
+TDataFrame::TDataFrame(const std::string &treeName, const std::string &fileNameGlob,
+                       const std::vector<std::string> &defaultColumns)
+   : TDataFrameInterface(std::make_shared<Internal::TDF::TLoopManager>(treeName, fileNameGlob, defaultColumns),
+                         nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Analyse the tree treeName of the directory dir.
+
+TDataFrame::TDataFrame(const std::string &treeName, TDirectory *dir, const std::vector<std::string> &defaultColumns)
+   : TDataFrameInterface(nullptr, nullptr)
+{
+   TTree *tree = nullptr;
+   if (dir)
+      dir->GetObject(treeName.c_str(), tree);
+   if (!tree)
+      throw std::runtime_error("TDataFrame: cannot find the tree " + treeName);
+   fLoopManager = std::make_shared<Internal::TDF::TLoopManager>(tree, defaultColumns);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Analyse tree, which must outlive the TDataFrame and its results.
+
+TDataFrame::TDataFrame(TTree &tree, const std::vector<std::string> &defaultColumns)
+   : TDataFrameInterface(std::make_shared<Internal::TDF::TLoopManager>(&tree, defaultColumns), nullptr)
+{
+}
+
+} // namespace Experimental
+} // namespace ROOT
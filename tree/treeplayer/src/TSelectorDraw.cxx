@@ -77,6 +77,7 @@ TSelectorDraw::TSelectorDraw()
    fWeight         = 1;
    fCurrentSubEntry = -1;
    fTreeElistArray  = 0;
+   fBlockStatus     = -1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,6 +111,7 @@ void TSelectorDraw::Begin(TTree *tree)
    fTree = tree;
    fDimension = 0;
    fAction = 0;
+   fBlockStatus = -1;
 
    TObject *obj = fInput->FindObject("varexp");
    const char *varexp0   = obj ? obj->GetTitle() : "";
@@ -1135,6 +1137,8 @@ Bool_t TSelectorDraw::Notify()
       }
    }
    if (fSelect) fSelect->UpdateFormulaLeaves();
+   // The leaves of the new tree may not be readable by block.
+   fBlockStatus = -1;
    return kTRUE;
 }
 
@@ -1172,6 +1176,86 @@ void TSelectorDraw::ProcessFill(Long64_t entry)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Called in the entry loop instead of ProcessFill to process a block of at
+/// most nentries consecutive entries starting at the local entry entry of
+/// the current tree. The selection and the variables are evaluated for the
+/// whole block with TTreeFormula::EvalBlock, then the selected entries are
+/// appended to the buffers of values and weights. Return the number of
+/// entries processed, or 0 if the block mode cannot be used (for example
+/// for formulas with arrays or objects): then ProcessFill must be called
+/// for each entry.
+///
+/// When the zone maps of the branches prove that the selection is false
+/// for the whole block (see TTreeFormula::EvalBlockRange), the block is
+/// skipped without reading its baskets.
+
+Long64_t TSelectorDraw::ProcessFillBlock(Long64_t entry, Long64_t nentries)
+{
+   if (fObjEval || fMultiplicity || fForceRead) return 0;
+   if (fSelect) {
+      Double_t selMin = 0, selMax = 0;
+      Int_t nskip = fSelect->EvalBlockRange(entry, (Int_t)TMath::Min(nentries, (Long64_t)kMaxInt), selMin, selMax);
+      if (nskip > 0 && selMin == 0 && selMax == 0) return nskip;
+   }
+
+   // Find once whether all the formulas can be evaluated by block: if one
+   // cannot, evaluating the others would be wasted for each entry.
+   if (fBlockStatus < 0) {
+      fBlockStatus = (fAction != 5 && fDimension > 0 && fVal && fW) ? 1 : 0;
+      if (fSelect && !fSelect->CanEvalBlock()) fBlockStatus = 0;
+      for (Int_t i = 0; i < fDimension && fBlockStatus; ++i) {
+         if (fVar[i] && !fVar[i]->CanEvalBlock()) fBlockStatus = 0;
+      }
+   }
+   if (!fBlockStatus) return 0;
+
+   // Do not overflow the buffers.
+   Long64_t capacity = fTree->GetEstimate() - fNfill;
+   Int_t n = (Int_t)TMath::Min(TMath::Min(nentries, capacity), (Long64_t)kMaxInt);
+   if (n <= 0) return 0;
+
+   // The formulas may stop at different basket boundaries, the block is
+   // the shortest of them. If a leaf cannot be read in bulk after all, the
+   // block mode is not tried again for this tree.
+   Double_t *w = fW + fNfill;
+   if (fSelect) {
+      n = fSelect->EvalBlock(entry, n, w);
+      if (n <= 0) {
+         fBlockStatus = 0;
+         return 0;
+      }
+   }
+   for (Int_t i = 0; i < fDimension; ++i) {
+      if (!fVar[i]) continue;
+      Int_t nvar = fVar[i]->EvalBlock(entry, n, fVal[i] + fNfill);
+      if (nvar <= 0) {
+         fBlockStatus = 0;
+         return 0;
+      }
+      n = nvar;
+   }
+
+   // Keep the selected entries; like ProcessFill, the entries with a null
+   // weight are only dropped by the selection.
+   Int_t nfill = fNfill;
+   for (Int_t k = 0; k < n; ++k) {
+      Double_t weight = fSelect ? fWeight * w[k] : fWeight;
+      if (fSelect && !weight) continue;
+      fW[nfill] = weight;
+      for (Int_t i = 0; i < fDimension; ++i) {
+         if (fVar[i]) fVal[i][nfill] = fVal[i][fNfill + k];
+      }
+      ++nfill;
+   }
+   fNfill = nfill;
+   if (fNfill >= fTree->GetEstimate()) {
+      TakeAction();
+      fNfill = 0;
+   }
+   return n;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Called in the entry loop for all entries accepted by Select.
 /// Complex case with multiplicity.
@@ -0,0 +1,932 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTreeBlockIndex
+\ingroup treeplayer
+
+A Tree Index with majorname and minorname, stored in compressed blocks.
+
+It provides the same lookups as TTreeIndex (see TTreeIndex::TTreeIndex for
+the meaning of majorname and minorname, and for the use with friend trees)
+for a fraction of its size, in memory and in the file, and adds range
+queries.
+
+The pairs (major,minor) are sorted and cut in blocks of a fixed number of
+entries (4096 by default). In each block the values are delta encoded as
+variable length integers: the major values are increasing, the minor values
+are increasing for a given major value and the entry numbers of a sorted
+run/event index are usually close to each other, so that most entries take
+a few bytes. Each block is then compressed with the algorithm and level of
+the file of the tree. Only the first pair of each block is kept
+uncompressed: a lookup finds its block with a binary search on these, and
+unpacks that block only. The last block unpacked is kept, so that close
+lookups and range queries do not unpack it again.
+
+When the index is written with its tree, each block is written in its own
+key, not listed in the directory, as the baskets are; only the first pairs
+and the positions of the blocks are written with the tree header. The
+blocks of an index read from a file are read when a lookup needs them. If
+the index is not written in a file (for example sent in a TMessage), the
+blocks are streamed with the index. When the blocks of an index read from a
+writable file are replaced (by Append), the keys of the old blocks are
+deleted from the file when the new ones are written there, so the index must
+be written again with its tree.
+
+The lookups can be done by several threads at once: the last block unpacked
+is protected by a mutex. Building and appending are not thread safe.
+
+When the implicit multi-threading is enabled (see ROOT::EnableImplicitMT),
+the values are sorted and the blocks compressed in parallel tasks.
+
+As with TTreeIndex, the indices appended with delaySort are not used by the
+lookups until Append(0,kFALSE) is called: all the indices appended are then
+merged at once.
+
+The index is built on a TChain as on a TTree, as a single index of the
+entry numbers of the chain: unlike TChainIndex it does not need the index of
+each tree of the chain.
+~~~{.cpp}
+   TTreeBlockIndex *index = new TTreeBlockIndex(tree, "Run", "Event");
+   tree->SetTreeIndex(index);
+   tree->GetEntryWithIndex(1234, 56789);
+   std::vector<Long64_t> entries;
+   index->GetEntryNumbersWithMajorRange(1200, 1299, entries); // all the events of runs 1200 to 1299
+~~~
+*/
+
+#include "TTreeBlockIndex.h"
+#include "TTree.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TBuffer.h"
+#include "Bytes.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "RZip.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_sort.h"
+#include "tbb/task_group.h"
+#endif
+
+ClassImp(TTreeBlockIndex)
+
+namespace {
+   /// Order the positions of the (major,minor) pairs, then of the entry numbers.
+   struct TBlockIndexComparator {
+      const Long64_t *fMajor;
+      const Long64_t *fMinor;
+      const Long64_t *fEntry;
+
+      Long64_t Entry(Long64_t i) const { return fEntry ? fEntry[i] : i; }
+      bool operator()(Long64_t i1, Long64_t i2) const {
+         if (fMajor[i1] != fMajor[i2]) return fMajor[i1] < fMajor[i2];
+         if (fMinor[i1] != fMinor[i2]) return fMinor[i1] < fMinor[i2];
+         return Entry(i1) < Entry(i2);
+      }
+   };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append v as a variable length integer, 7 bits per byte.
+
+static void R__PutVarint(std::vector<char> &buf, ULong64_t v)
+{
+   while (v >= 0x80) {
+      buf.push_back((char)(v | 0x80));
+      v >>= 7;
+   }
+   buf.push_back((char)v);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read a variable length integer from p, not beyond end.
+
+static ULong64_t R__GetVarint(const unsigned char *&p, const unsigned char *end)
+{
+   ULong64_t v = 0;
+   Int_t shift = 0;
+   while (p < end && (*p & 0x80) && shift < 63) {
+      v |= ULong64_t(*p++ & 0x7f) << shift;
+      shift += 7;
+   }
+   if (p < end) v |= ULong64_t(*p++) << shift;
+   return v;
+}
+
+static inline ULong64_t R__ZigZag(Long64_t v) { return (ULong64_t(v) << 1) ^ ULong64_t(v >> 63); }
+static inline Long64_t R__UnZigZag(ULong64_t v) { return Long64_t(v >> 1) ^ -Long64_t(v & 1); }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Encode the n pairs and entry numbers at the positions order[0..n-1] and
+/// compress them with the settings compress, after their uncompressed size.
+/// The block is stored uncompressed if compressing it does not save space.
+
+static void R__EncodeBlock(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry,
+                            const Long64_t *order, Int_t compress, std::vector<char> &out)
+{
+   std::vector<char> raw;
+   raw.reserve(n*4);
+   Long64_t prevMajor = major[order[0]];
+   Long64_t prevMinor = minor[order[0]];
+   Long64_t prevEntry = 0;
+   for (Long64_t i = 0; i < n; ++i) {
+      Long64_t k = order[i];
+      Long64_t e = entry ? entry[k] : k;
+      ULong64_t dmajor = ULong64_t(major[k]) - ULong64_t(prevMajor);
+      R__PutVarint(raw, dmajor);
+      if (dmajor == 0) R__PutVarint(raw, ULong64_t(minor[k]) - ULong64_t(prevMinor));
+      else             R__PutVarint(raw, R__ZigZag(minor[k]));
+      R__PutVarint(raw, R__ZigZag(e - prevEntry));
+      prevMajor = major[k];
+      prevMinor = minor[k];
+      prevEntry = e;
+   }
+
+   Int_t rawbytes = (Int_t)raw.size();
+   Int_t cxlevel = compress % 100;
+   Int_t cxAlgorithm = compress / 100;
+   out.resize(sizeof(Int_t) + rawbytes);
+   char *buffer = out.data();
+   tobuf(buffer, rawbytes);
+   if (cxlevel > 0 && rawbytes > 256) {
+      Int_t srcsize = rawbytes, tgtsize = rawbytes, nout = 0;
+      R__zipMultipleAlgorithm(cxlevel, &srcsize, raw.data(), &tgtsize, buffer, &nout, cxAlgorithm);
+      if (nout > 0 && nout < rawbytes) {
+         out.resize(sizeof(Int_t) + nout);
+         return;
+      }
+   }
+   memcpy(buffer, raw.data(), rawbytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor for TTreeBlockIndex
+
+TTreeBlockIndex::TTreeBlockIndex(): TVirtualIndex()
+{
+   fTree               = 0;
+   fN                  = 0;
+   fBlockSize          = 4096;
+   fCompress           = 1;
+   fBlockFile          = 0;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+   fCurrentBlock       = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normal constructor for TTreeBlockIndex
+///
+/// Build an index table using the leaves of Tree T with major & minor names,
+/// as TTreeIndex::TTreeIndex does, cut in blocks of blocksize entries
+/// (between 16 and 65536). The blocks are compressed with the compression
+/// settings of the file of the tree.
+///
+/// The index is not used by the tree until it is given to TTree::SetTreeIndex.
+
+TTreeBlockIndex::TTreeBlockIndex(const TTree *T, const char *majorname, const char *minorname, Int_t blocksize)
+           : TVirtualIndex()
+{
+   fTree               = (TTree*)T;
+   fN                  = 0;
+   fBlockSize          = TMath::Max(16, TMath::Min(blocksize, 65536));
+   fCompress           = 1;
+   fBlockFile          = 0;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+   fCurrentBlock       = -1;
+   fMajorName          = majorname;
+   fMinorName          = minorname;
+   if (!T) return;
+   if (T->GetCurrentFile()) fCompress = T->GetCurrentFile()->GetCompressionSettings();
+   Long64_t n = T->GetEntries();
+   if (n <= 0) {
+      MakeZombie();
+      Error("TTreeBlockIndex","Cannot build a TTreeBlockIndex with a Tree having no entries");
+      return;
+   }
+
+   GetMajorFormula();
+   GetMinorFormula();
+   if (!fMajorFormula || !fMinorFormula
+       || (fMajorFormula->GetNdim() != 1) || (fMinorFormula->GetNdim() != 1)) {
+      MakeZombie();
+      Error("TTreeBlockIndex","Cannot build the index with major=%s, minor=%s",fMajorName.Data(), fMinorName.Data());
+      return;
+   }
+
+   std::vector<Long64_t> major(n);
+   std::vector<Long64_t> minor(n);
+   Long64_t oldEntry = fTree->GetReadEntry();
+   Int_t current = -1;
+   for (Long64_t i = 0; i < n; ++i) {
+      Long64_t centry = fTree->LoadTree(i);
+      if (centry < 0) {
+         n = i;
+         break;
+      }
+      if (fTree->GetTreeNumber() != current) {
+         current = fTree->GetTreeNumber();
+         fMajorFormula->UpdateFormulaLeaves();
+         fMinorFormula->UpdateFormulaLeaves();
+      }
+      major[i] = (Long64_t) fMajorFormula->EvalInstance<LongDouble_t>();
+      minor[i] = (Long64_t) fMinorFormula->EvalInstance<LongDouble_t>();
+   }
+   fTree->LoadTree(oldEntry);
+
+   std::vector<Long64_t> order(n);
+   for (Long64_t i = 0; i < n; ++i) order[i] = i;
+   TBlockIndexComparator cmp = {major.data(), minor.data(), 0};
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_sort(order.begin(), order.end(), cmp);
+   } else
+#endif
+   {
+      std::sort(order.begin(), order.end(), cmp);
+   }
+
+   Fill(n, major.data(), minor.data(), 0, order.data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TTreeBlockIndex::~TTreeBlockIndex()
+{
+   if (fTree && fTree->GetTreeIndex() == this) fTree->SetTreeIndex(0);
+   delete fMajorFormula;        fMajorFormula  = 0;
+   delete fMinorFormula;        fMinorFormula  = 0;
+   delete fMajorFormulaParent;  fMajorFormulaParent = 0;
+   delete fMinorFormulaParent;  fMinorFormulaParent = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append 'add' to this index.  Entry 0 in add will become entry n+1 in this.
+/// If delaySort is true, the values of add are kept aside, and not used by
+/// the lookups, until Append(0,kFALSE) is called: all the indices appended
+/// are then merged with this one at once.
+
+void TTreeBlockIndex::Append(const TVirtualIndex *add, Bool_t delaySort)
+{
+   if (add && add->GetN()) {
+      const TTreeBlockIndex *ti_add = dynamic_cast<const TTreeBlockIndex*>(add);
+      if (ti_add == 0) {
+         Error("Append","Can only Append a TTreeBlockIndex to a TTreeBlockIndex but got a %s",
+               add->IsA()->GetName());
+         return;
+      }
+
+      // The blocks of add, then its own pending runs, are sorted runs to
+      // be merged with the blocks of this.
+      Long64_t oldn = GetN();
+      std::vector<Long64_t> addMajor, addMinor, addEntry;
+      ti_add->LoadValues(addMajor, addMinor, addEntry);
+      Long64_t start = (Long64_t)fPendingMajor.size();
+      if (!addMajor.empty()) fPendingRuns.push_back(start);
+      fPendingMajor.insert(fPendingMajor.end(), addMajor.begin(), addMajor.end());
+      fPendingMinor.insert(fPendingMinor.end(), addMinor.begin(), addMinor.end());
+      for (size_t i = 0; i < addEntry.size(); ++i) fPendingEntry.push_back(addEntry[i] + oldn);
+
+      start = (Long64_t)fPendingMajor.size();
+      for (size_t r = 0; r < ti_add->fPendingRuns.size(); ++r)
+         fPendingRuns.push_back(start + ti_add->fPendingRuns[r]);
+      fPendingMajor.insert(fPendingMajor.end(), ti_add->fPendingMajor.begin(), ti_add->fPendingMajor.end());
+      fPendingMinor.insert(fPendingMinor.end(), ti_add->fPendingMinor.begin(), ti_add->fPendingMinor.end());
+      for (size_t i = 0; i < ti_add->fPendingEntry.size(); ++i)
+         fPendingEntry.push_back(ti_add->fPendingEntry[i] + oldn);
+   }
+
+   if (!delaySort) MergePending();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the runs appended with delaySort with the blocks, and store the
+/// result in new blocks.
+
+void TTreeBlockIndex::MergePending()
+{
+   if (fPendingMajor.empty()) return;
+
+   std::vector<Long64_t> major, minor, entry;
+   LoadValues(major, minor, entry);
+   std::vector<Long64_t> starts;
+   if (!major.empty()) starts.push_back(0);
+   Long64_t base = (Long64_t)major.size();
+   for (size_t r = 0; r < fPendingRuns.size(); ++r) starts.push_back(base + fPendingRuns[r]);
+   major.insert(major.end(), fPendingMajor.begin(), fPendingMajor.end());
+   minor.insert(minor.end(), fPendingMinor.begin(), fPendingMinor.end());
+   entry.insert(entry.end(), fPendingEntry.begin(), fPendingEntry.end());
+   std::vector<Long64_t>().swap(fPendingMajor);
+   std::vector<Long64_t>().swap(fPendingMinor);
+   std::vector<Long64_t>().swap(fPendingEntry);
+   std::vector<Long64_t>().swap(fPendingRuns);
+
+   // Merge the sorted runs two by two, until there is only one.
+   Long64_t n = (Long64_t)major.size();
+   std::vector<Long64_t> order(n);
+   for (Long64_t i = 0; i < n; ++i) order[i] = i;
+   TBlockIndexComparator cmp = {major.data(), minor.data(), entry.data()};
+   starts.push_back(n);
+   while (starts.size() > 2) {
+      std::vector<Long64_t> merged;
+      for (size_t r = 0; r + 1 < starts.size(); r += 2) {
+         merged.push_back(starts[r]);
+         if (r + 2 < starts.size())
+            std::inplace_merge(order.begin() + starts[r], order.begin() + starts[r+1], order.begin() + starts[r+2], cmp);
+      }
+      merged.push_back(n);
+      starts.swap(merged);
+   }
+
+   Fill(n, major.data(), minor.data(), entry.data(), order.data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the n pairs and entry numbers at the positions order[0..n-1], which
+/// are sorted. If entry is null, the entry numbers are the positions.
+
+void TTreeBlockIndex::Fill(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry,
+                           const Long64_t *order)
+{
+   fN = n;
+   fCurrentBlock = -1;
+   Long64_t nblocks = (n + fBlockSize - 1) / fBlockSize;
+   fFirstMajor.resize(nblocks);
+   fFirstMinor.resize(nblocks);
+   // The new blocks replace the ones written, if any: their keys are deleted
+   // when the new blocks are written in the same file, see WriteBlocks.
+   if (fBlockFile) {
+      for (size_t b = 0; b < fBlockOffset.size(); ++b) {
+         if (!fBlockOffset[b]) continue;
+         fStaleOffset.push_back(fBlockOffset[b]);
+         fStaleBytes.push_back(fBlockBytes[b]);
+      }
+   }
+   fBlockOffset.assign(nblocks, 0);
+   fBlockBytes.assign(nblocks, 0);
+   fBlocks.clear();
+   fBlocks.resize(nblocks);
+
+   auto encode = [&](Long64_t first, Long64_t last) {
+      for (Long64_t b = first; b < last; ++b) {
+         Long64_t begin = b * fBlockSize;
+         Long64_t len = TMath::Min((Long64_t)fBlockSize, n - begin);
+         fFirstMajor[b] = major[order[begin]];
+         fFirstMinor[b] = minor[order[begin]];
+         R__EncodeBlock(len, major, minor, entry, order + begin, fCompress, fBlocks[b]);
+      }
+   };
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && nblocks > 1) {
+      const Long64_t blocksPerTask = 16;
+      tbb::task_group g;
+      for (Long64_t b = 0; b < nblocks; b += blocksPerTask) {
+         g.run([&, b]() { encode(b, TMath::Min(b + blocksPerTask, nblocks)); });
+      }
+      g.wait();
+   } else
+#endif
+   {
+      encode(0, nblocks);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the bytes of the block, as stored by R__EncodeBlock, and set
+/// nbytes to their number. They are read from fBlockFile in storage if the
+/// block is not in memory. Return 0 if the block cannot be read.
+
+const char *TTreeBlockIndex::GetBlockBytes(Long64_t block, std::vector<char> &storage, Int_t &nbytes) const
+{
+   if (!fBlocks[block].empty()) {
+      nbytes = (Int_t)fBlocks[block].size();
+      return fBlocks[block].data();
+   }
+   if (!fBlockFile || !fBlockOffset[block]) {
+      Error("GetBlockBytes", "The block %lld of the index is not available", block);
+      return 0;
+   }
+   TKey *key = new TKey(fBlockOffset[block], fBlockBytes[block], fBlockFile);
+   if (!key->ReadFile()) {
+      Error("GetBlockBytes", "Cannot read the block %lld of the index", block);
+      delete key;
+      return 0;
+   }
+   char *buffer = key->GetBuffer();
+   key->ReadKeyBuffer(buffer);
+   nbytes = key->GetObjlen();
+   storage.assign(buffer, buffer + nbytes);
+   delete key;
+   return storage.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Unpack the values of the block in fCurrentMajor, fCurrentMinor and
+/// fCurrentEntry, if they are not already there. fCurrentMutex must be
+/// held. Return kFALSE if the block cannot be uncompressed.
+
+Bool_t TTreeBlockIndex::LoadBlock(Long64_t block) const
+{
+   if (block == fCurrentBlock) return kTRUE;
+   fCurrentBlock = -1;
+
+   Long64_t len = TMath::Min((Long64_t)fBlockSize, fN - block * fBlockSize);
+   std::vector<char> storage;
+   Int_t nbytes = 0;
+   char *buffer = const_cast<char*>(GetBlockBytes(block, storage, nbytes));
+   if (!buffer || nbytes < (Int_t)sizeof(Int_t)) return kFALSE;
+   Int_t rawbytes;
+   frombuf(buffer, &rawbytes);
+   nbytes -= sizeof(Int_t);
+   const unsigned char *src = (const unsigned char*)buffer;
+   std::vector<unsigned char> raw;
+   if (nbytes != rawbytes) {
+      raw.resize(rawbytes);
+      Int_t srcsize = nbytes, tgtsize = rawbytes, nout = 0;
+      R__unzip(&srcsize, const_cast<unsigned char*>(src), &tgtsize, raw.data(), &nout);
+      if (nout != rawbytes) {
+         Error("LoadBlock", "Cannot uncompress the block %lld of the index", block);
+         return kFALSE;
+      }
+      src = raw.data();
+   }
+
+   const unsigned char *end = src + rawbytes;
+   fCurrentMajor.resize(len);
+   fCurrentMinor.resize(len);
+   fCurrentEntry.resize(len);
+   Long64_t prevMajor = fFirstMajor[block];
+   Long64_t prevMinor = fFirstMinor[block];
+   Long64_t prevEntry = 0;
+   for (Long64_t i = 0; i < len; ++i) {
+      ULong64_t dmajor = R__GetVarint(src, end);
+      prevMajor = Long64_t(ULong64_t(prevMajor) + dmajor);
+      if (dmajor == 0) prevMinor = Long64_t(ULong64_t(prevMinor) + R__GetVarint(src, end));
+      else             prevMinor = R__UnZigZag(R__GetVarint(src, end));
+      prevEntry += R__UnZigZag(R__GetVarint(src, end));
+      fCurrentMajor[i] = prevMajor;
+      fCurrentMinor[i] = prevMinor;
+      fCurrentEntry[i] = prevEntry;
+   }
+   fCurrentBlock = block;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Unpack all the values of the index, in sorted order.
+
+void TTreeBlockIndex::LoadValues(std::vector<Long64_t> &major, std::vector<Long64_t> &minor,
+                                 std::vector<Long64_t> &entry) const
+{
+   std::lock_guard<std::mutex> lock(fCurrentMutex);
+   major.reserve(fN);
+   minor.reserve(fN);
+   entry.reserve(fN);
+   for (Long64_t b = 0; b < GetNblocks(); ++b) {
+      if (!LoadBlock(b)) return;
+      major.insert(major.end(), fCurrentMajor.begin(), fCurrentMajor.end());
+      minor.insert(minor.end(), fCurrentMinor.begin(), fCurrentMinor.end());
+      entry.insert(entry.end(), fCurrentEntry.begin(), fCurrentEntry.end());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes of the blocks, in memory for the ones not
+/// written, in the file (with their key headers) for the others.
+
+Long64_t TTreeBlockIndex::GetCompressedBytes() const
+{
+   Long64_t nbytes = 0;
+   for (Long64_t b = 0; b < GetNblocks(); ++b)
+      nbytes += fBlocks[b].empty() ? fBlockBytes[b] : (Long64_t)fBlocks[b].size();
+   return nbytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the entry number in this (friend) Tree corresponding to entry in
+/// the master Tree 'parent', see TTreeIndex::GetEntryNumberFriend.
+
+Long64_t TTreeBlockIndex::GetEntryNumberFriend(const TTree *parent)
+{
+   if (!parent) return -3;
+   GetMajorFormulaParent(parent);
+   GetMinorFormulaParent(parent);
+   if (!fMajorFormulaParent || !fMinorFormulaParent) return -1;
+   if (!fMajorFormulaParent->GetNdim() || !fMinorFormulaParent->GetNdim()) {
+      // The Tree Index in the friend has a pair majorname,minorname
+      // not available in the parent Tree T.
+      // if the friend Tree has less entries than the parent, this is an error
+      Long64_t pentry = parent->GetReadEntry();
+      if (pentry >= fTree->GetEntries()) return -2;
+      // otherwise we ignore the Tree Index and return the entry number
+      // in the parent Tree.
+      return pentry;
+   }
+
+   // majorname, minorname exist in the parent Tree
+   // we find the current values pair majorv,minorv in the parent Tree
+   Double_t majord = fMajorFormulaParent->EvalInstance();
+   Double_t minord = fMinorFormulaParent->EvalInstance();
+   Long64_t majorv = (Long64_t)majord;
+   Long64_t minorv = (Long64_t)minord;
+   // we check if this pair exist in the index.
+   // if yes, we return the corresponding entry number
+   // if not the function returns -1
+   return fTree->GetEntryNumberWithIndex(majorv,minorv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find the position of the first pair not lower than major|minor, as
+/// std::lower_bound does. Only the block holding it is unpacked.
+/// This is the position in the sorted index, not the entry number !
+/// fCurrentMutex must be held.
+
+Long64_t TTreeBlockIndex::FindValues(Long64_t major, Long64_t minor) const
+{
+   // Last block starting with a pair lower than major|minor.
+   Long64_t pos = 0, count = GetNblocks();
+   while (count > 0) {
+      Long64_t step = count / 2;
+      Long64_t mid = pos + step;
+      if (fFirstMajor[mid] < major || (fFirstMajor[mid] == major && fFirstMinor[mid] < minor)) {
+         pos = mid + 1;
+         count -= step + 1;
+      } else
+         count = step;
+   }
+   if (pos == 0) return 0;
+   Long64_t block = pos - 1;
+   if (!LoadBlock(block)) return fN;
+
+   Long64_t first = 0;
+   count = (Long64_t)fCurrentMajor.size();
+   while (count > 0) {
+      Long64_t step = count / 2;
+      Long64_t mid = first + step;
+      if (fCurrentMajor[mid] < major || (fCurrentMajor[mid] == major && fCurrentMinor[mid] < minor)) {
+         first = mid + 1;
+         count -= step + 1;
+      } else
+         count = step;
+   }
+   return block * fBlockSize + first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return entry number corresponding to major and minor number, or the one
+/// of the pair immediately lower if there is none (-1 if the pair is lower
+/// than the first entry in the index), see TTreeIndex::GetEntryNumberWithBestIndex.
+///
+/// See also GetEntryNumberWithIndex
+
+Long64_t TTreeBlockIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const
+{
+   if (fN == 0) return -1;
+
+   std::lock_guard<std::mutex> lock(fCurrentMutex);
+   Long64_t pos = FindValues(major, minor);
+   if (pos < fN && LoadBlock(pos / fBlockSize)) {
+      Long64_t i = pos % fBlockSize;
+      if (fCurrentMajor[i] == major && fCurrentMinor[i] == minor)
+         return fCurrentEntry[i];
+   }
+   if (--pos < 0 || !LoadBlock(pos / fBlockSize))
+      return -1;
+   return fCurrentEntry[pos % fBlockSize];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return entry number corresponding to major and minor number, or -1 if
+/// there is none.
+/// Note that this function returns only the entry number, not the data
+/// To read the data corresponding to an entry number, use TTree::GetEntryWithIndex
+///
+/// See also GetEntryNumberWithBestIndex
+
+Long64_t TTreeBlockIndex::GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const
+{
+   if (fN == 0) return -1;
+
+   std::lock_guard<std::mutex> lock(fCurrentMutex);
+   Long64_t pos = FindValues(major, minor);
+   if (pos >= fN || !LoadBlock(pos / fBlockSize)) return -1;
+   Long64_t i = pos % fBlockSize;
+   if (fCurrentMajor[i] == major && fCurrentMinor[i] == minor)
+      return fCurrentEntry[i];
+   return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append to entries the entry numbers of the pairs major|minor between
+/// majorLow|minorLow and majorHigh|minorHigh included, in the order of the
+/// pairs. Only the blocks holding these pairs are unpacked.
+/// Return the number of entry numbers appended.
+
+Long64_t TTreeBlockIndex::GetEntryNumbersWithIndexRange(Long64_t majorLow, Long64_t minorLow,
+                                                        Long64_t majorHigh, Long64_t minorHigh,
+                                                        std::vector<Long64_t> &entries) const
+{
+   std::lock_guard<std::mutex> lock(fCurrentMutex);
+   Long64_t nfound = 0;
+   for (Long64_t pos = FindValues(majorLow, minorLow); pos < fN; ++pos) {
+      if (!LoadBlock(pos / fBlockSize)) break;
+      Long64_t i = pos % fBlockSize;
+      if (fCurrentMajor[i] > majorHigh || (fCurrentMajor[i] == majorHigh && fCurrentMinor[i] > minorHigh))
+         break;
+      entries.push_back(fCurrentEntry[i]);
+      ++nfound;
+   }
+   return nfound;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append to entries the entry numbers of all the pairs whose major value is
+/// between majorLow and majorHigh included, see GetEntryNumbersWithIndexRange.
+
+Long64_t TTreeBlockIndex::GetEntryNumbersWithMajorRange(Long64_t majorLow, Long64_t majorHigh,
+                                                        std::vector<Long64_t> &entries) const
+{
+   return GetEntryNumbersWithIndexRange(majorLow, LLONG_MIN, majorHigh, LLONG_MAX, entries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the majorname.
+
+TTreeFormula *TTreeBlockIndex::GetMajorFormula()
+{
+   if (!fMajorFormula) {
+      fMajorFormula = new TTreeFormula("Major",fMajorName.Data(),fTree);
+      fMajorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMajorFormula;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the minorname.
+
+TTreeFormula *TTreeBlockIndex::GetMinorFormula()
+{
+   if (!fMinorFormula) {
+      fMinorFormula = new TTreeFormula("Minor",fMinorName.Data(),fTree);
+      fMinorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMinorFormula;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the majorname in parent tree.
+
+TTreeFormula *TTreeBlockIndex::GetMajorFormulaParent(const TTree *parent)
+{
+   if (!fMajorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMajorFormulaParent = new TTreeFormula("MajorP",fMajorName.Data(),const_cast<TTree*>(parent));
+      fMajorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMajorFormulaParent->GetTree() != parent) {
+      fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMajorFormulaParent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the minorname in parent tree.
+
+TTreeFormula *TTreeBlockIndex::GetMinorFormulaParent(const TTree *parent)
+{
+   if (!fMinorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMinorFormulaParent = new TTreeFormula("MinorP",fMinorName.Data(),const_cast<TTree*>(parent));
+      fMinorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMinorFormulaParent->GetTree() != parent) {
+      fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMinorFormulaParent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the size of the index and the table with : serial number,
+/// majorname, minorname (and entry number with option "all").
+/// -  if option = "10" print only the first 10 entries
+/// -  if option = "100" print only the first 100 entries
+/// -  if option = "1000" print only the first 1000 entries
+/// -  otherwise all the entries are printed
+
+void TTreeBlockIndex::Print(Option_t * option) const
+{
+   TString opt = option;
+   Bool_t printEntry = kFALSE;
+   Long64_t n = fN;
+   if (opt.Contains("10"))   n = 10;
+   if (opt.Contains("100"))  n = 100;
+   if (opt.Contains("1000")) n = 1000;
+   if (opt.Contains("all")) {
+      printEntry = kTRUE;
+   }
+   n = TMath::Min(n, fN);
+
+   Printf("\n*****************************************************************");
+   Printf("*    Index of Tree: %s/%s",fTree ? fTree->GetName() : "",fTree ? fTree->GetTitle() : "");
+   Printf("*    %lld entries in %lld blocks of %d entries, %lld bytes",fN,GetNblocks(),fBlockSize,GetCompressedBytes());
+   Printf("*****************************************************************");
+   if (printEntry) {
+      Printf("%8s : %16s : %16s : %16s","serial",fMajorName.Data(),fMinorName.Data(),"entry number");
+   } else {
+      Printf("%8s : %16s : %16s","serial",fMajorName.Data(),fMinorName.Data());
+   }
+   Printf("*****************************************************************");
+   std::lock_guard<std::mutex> lock(fCurrentMutex);
+   for (Long64_t i=0;i<n;i++) {
+      if (!LoadBlock(i / fBlockSize)) break;
+      Long64_t k = i % fBlockSize;
+      if (printEntry) {
+         Printf("%8lld :         %8lld :         %8lld :         %8lld",
+                i, fCurrentMajor[k], fCurrentMinor[k], fCurrentEntry[k]);
+      } else {
+         Printf("%8lld :         %8lld :         %8lld",
+                i, fCurrentMajor[k], fCurrentMinor[k]);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write each block not yet in file in its own key, not added to the list
+/// of keys of the directory, and release the memory of the blocks.
+/// The keys of the blocks replaced since the last write in file are deleted
+/// first. Return kFALSE if a block cannot be written; the blocks are then
+/// kept as they were.
+
+Bool_t TTreeBlockIndex::WriteBlocks(TFile *file)
+{
+   if (file == fBlockFile) {
+      for (size_t i = 0; i < fStaleOffset.size(); ++i)
+         file->MakeFree(fStaleOffset[i], fStaleOffset[i] + fStaleBytes[i] - 1);
+   }
+   // The keys in another file still belong to the index written there.
+   fStaleOffset.clear();
+   fStaleBytes.clear();
+
+   Long64_t nblocks = GetNblocks();
+   std::vector<Long64_t> offset(fBlockOffset);
+   std::vector<Int_t> nbytes(fBlockBytes);
+   std::vector<char> storage;
+   const char *name = fTree ? fTree->GetName() : GetName();
+   for (Long64_t b = 0; b < nblocks; ++b) {
+      if (file == fBlockFile && fBlockOffset[b]) continue;
+      Int_t len = 0;
+      const char *bytes = GetBlockBytes(b, storage, len);
+      if (!bytes) return kFALSE;
+      TKey *key = new TKey(name, "TTreeBlockIndex block", IsA(), len, file);
+      if (!key->GetSeekKey()) {
+         delete key;
+         return kFALSE;
+      }
+      memcpy(key->GetBuffer(), bytes, len);
+      offset[b] = key->GetSeekKey();
+      nbytes[b] = key->GetNbytes();
+      key->WriteFile();
+      delete key;
+   }
+   fBlockOffset.swap(offset);
+   fBlockBytes.swap(nbytes);
+   fBlockFile = file;
+   fBlocks.clear();
+   fBlocks.resize(nblocks);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class TTreeBlockIndex.
+/// When the buffer belongs to a writable file, the blocks are written in
+/// their own keys (see WriteBlocks) and only their positions are streamed,
+/// otherwise the blocks are streamed. The indices appended with delaySort
+/// are merged first.
+
+void TTreeBlockIndex::Streamer(TBuffer &R__b)
+{
+   UInt_t R__s, R__c;
+   if (R__b.IsReading()) {
+      Version_t R__v = R__b.ReadVersion(&R__s, &R__c); if (R__v) { }
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b >> fN;
+      R__b >> fBlockSize;
+      R__b >> fCompress;
+      Int_t nblocks;
+      R__b >> nblocks;
+      fFirstMajor.resize(nblocks);
+      fFirstMinor.resize(nblocks);
+      R__b.ReadFastArray(fFirstMajor.data(), nblocks);
+      R__b.ReadFastArray(fFirstMinor.data(), nblocks);
+      fBlockOffset.assign(nblocks, 0);
+      fBlockBytes.assign(nblocks, 0);
+      fBlocks.clear();
+      fBlocks.resize(nblocks);
+      Bool_t inKeys;
+      R__b >> inKeys;
+      if (inKeys) {
+         R__b.ReadFastArray(fBlockOffset.data(), nblocks);
+         R__b.ReadFastArray(fBlockBytes.data(), nblocks);
+         fBlockFile = dynamic_cast<TFile*>(R__b.GetParent());
+      } else {
+         for (Int_t b = 0; b < nblocks; ++b) {
+            Int_t len;
+            R__b >> len;
+            fBlocks[b].resize(len);
+            R__b.ReadFastArray(fBlocks[b].data(), len);
+         }
+         fBlockFile = 0;
+      }
+      fPendingMajor.clear();
+      fPendingMinor.clear();
+      fPendingEntry.clear();
+      fPendingRuns.clear();
+      fStaleOffset.clear();
+      fStaleBytes.clear();
+      fCurrentBlock = -1;
+      R__b.CheckByteCount(R__s, R__c, TTreeBlockIndex::IsA());
+   } else {
+      MergePending();
+      TFile *file = dynamic_cast<TFile*>(R__b.GetParent());
+      Bool_t inKeys = file && file->IsWritable() && WriteBlocks(file);
+      Int_t nblocks = (Int_t)GetNblocks();
+      R__c = R__b.WriteVersion(TTreeBlockIndex::IsA(), kTRUE);
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b << fN;
+      R__b << fBlockSize;
+      R__b << fCompress;
+      R__b << nblocks;
+      R__b.WriteFastArray(fFirstMajor.data(), nblocks);
+      R__b.WriteFastArray(fFirstMinor.data(), nblocks);
+      R__b << inKeys;
+      if (inKeys) {
+         R__b.WriteFastArray(fBlockOffset.data(), nblocks);
+         R__b.WriteFastArray(fBlockBytes.data(), nblocks);
+      } else {
+         std::vector<char> storage;
+         for (Int_t b = 0; b < nblocks; ++b) {
+            Int_t len = 0;
+            const char *bytes = GetBlockBytes(b, storage, len);
+            if (!bytes) len = 0;
+            R__b << len;
+            R__b.WriteFastArray(bytes, len);
+         }
+      }
+      R__b.SetByteCount(R__c, kTRUE);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Called by TChain::LoadTree when the parent chain changes it's tree.
+
+void TTreeBlockIndex::UpdateFormulaLeaves(const TTree *parent)
+{
+   if (fMajorFormula)       { fMajorFormula->UpdateFormulaLeaves();}
+   if (fMinorFormula)       { fMinorFormula->UpdateFormulaLeaves();}
+   if (fMajorFormulaParent) {
+      if (parent) fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   if (fMinorFormulaParent) {
+      if (parent) fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// this function is called by TChain::LoadTree and TTreePlayer::UpdateFormulaLeaves
+/// when a new Tree is loaded.
+
+void TTreeBlockIndex::SetTree(const TTree *T)
+{
+   fTree = (TTree*)T;
+}
@@ -14,10 +14,17 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TBranchObject.h"
+#include "TBufferFile.h"
 #include "TFunction.h"
 #include "TClonesArray.h"
 #include "TLeafB.h"
 #include "TLeafC.h"
+#include "TLeafD.h"
+#include "TLeafF.h"
+#include "TLeafI.h"
+#include "TLeafL.h"
+#include "TLeafO.h"
+#include "TLeafS.h"
 #include "TLeafObject.h"
 #include "TDataMember.h"
 #include "TMethodCall.h"
@@ -45,6 +52,8 @@
 #include "TFormLeafInfoReference.h"
 
 #include "TEntryList.h"
+#include "TEnv.h"
+#include "TVirtualMutex.h"
 
 #include <ctype.h>
 #include <stdio.h>
@@ -52,6 +61,8 @@
 #include <stdlib.h>
 #include <typeinfo>
 #include <algorithm>
+#include <map>
+#include <type_traits>
 
 const Int_t kMaxLen     = 1024;
 
@@ -91,6 +102,25 @@ The following method are available from the TFormLeafInfo interface:
  -  IsString()
  -  ReadValue(char *where, Int_t instance = 0) : Internal function to interpret the location 'where'
  -  Update() : react to the possible loading of a shared library.
+
+If `TTreeFormula.JIT` is set in the ROOT resources (see TEnv), the formulas
+made of numerical operations on leaves of a basic type are translated into
+C++ and compiled by the interpreter the first time they are evaluated, for
+example "x<y && sqrt(z)>3.2". Their evaluation then reads the leaves
+directly from their buffer. The compiled functions are shared by the
+formulas with the same expression on leaves of the same types, for example
+by the successive trees of a TChain.
+~~~{.cpp}
+     gEnv->SetValue("TTreeFormula.JIT", 1);
+~~~
+
+The same formulas, when each of their leaves is alone in its branch, can
+also be evaluated for a block of consecutive entries with EvalBlock: the
+leaves are read a basket at a time and the operations are applied to
+whole columns of values. TTree::Draw uses it to fill the histograms.
+When the branches have zone maps (see TBranch::SetZoneMaps),
+EvalBlockRange computes from them the range of the formula over a basket,
+and TTree::Draw skips the baskets where the selection is always false.
 */
 
 ClassImp(TTreeFormula)
@@ -137,6 +167,13 @@ TTreeFormula::TTreeFormula(): ROOT::v5::TFormula(), fQuickLoad(kFALSE), fNeedLoa
    fManager      = 0;
    fMultiplicity = 0;
    fConstLD      = 0;
+   fJitFunc      = 0;
+   fJitStatus    = kJitUnknown;
+   fBlockStatus  = kBlockUnknown;
+   fBlockDepth   = 0;
+   fBlockBuffer  = 0;
+   fZoneMapTree  = 0;
+   fHasZoneMaps  = kFALSE;
 
    Int_t j,k;
    for (j=0; j<kMAXCODES; j++) {
@@ -187,6 +224,13 @@ void TTreeFormula::Init(const char*name, const char* expression)
    fAxis         = 0;
    fHasCast      = 0;
    fConstLD      = 0;
+   fJitFunc      = 0;
+   fJitStatus    = kJitUnknown;
+   fBlockStatus  = kBlockUnknown;
+   fBlockDepth   = 0;
+   fBlockBuffer  = 0;
+   fZoneMapTree  = 0;
+   fHasZoneMaps  = kFALSE;
    Int_t i,j,k;
    fManager      = new TTreeFormulaManager;
    fManager->Add(this);
@@ -337,6 +381,7 @@ TTreeFormula::~TTreeFormula()
    fDataMembers.Delete();
    fMethods.Delete();
    fAliases.Delete();
+   delete fBlockBuffer;
    if (fLookupType) delete [] fLookupType;
    for (int j=0; j<fNcodes; j++) {
       for (int k = 0; k<fNdimensions[j]; k++) {
@@ -3906,6 +3951,596 @@ template<> inline LongDouble_t TTreeFormula::GetConstant(Int_t k) {
 }
 template<> inline Long64_t TTreeFormula::GetConstant(Int_t k) { return (Long64_t)GetConstant<LongDouble_t>(k); }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the formula has a single instance and all its codes are
+/// scalar leaves of a basic type (TLeafB, TLeafS, TLeafI, TLeafL, TLeafF,
+/// TLeafD or TLeafO), the only case handled by MakeJitFunction and
+/// EvalBlock.
+
+Bool_t TTreeFormula::HasOnlyBasicLeaves() const
+{
+   if (fMultiplicity != 0 || fNcodes <= 0 || TestBit(kMissingLeaf)) return kFALSE;
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);
+      if (!leaf || fLookupType[code] != kDirect || fCodes[code] < 0 || fNdimensions[code] != 0) return kFALSE;
+      if (leaf->GetLeafCount() || leaf->GetLenStatic() != 1) return kFALSE;
+      TClass *cl = leaf->IsA();
+      if (cl != TLeafB::Class() && cl != TLeafS::Class() && cl != TLeafI::Class() && cl != TLeafL::Class() &&
+          cl != TLeafF::Class() && cl != TLeafD::Class() && cl != TLeafO::Class()) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Declare to the interpreter a function returning the value of the C++
+/// expression expr, where v[i] is the address of the value of the leaf of
+/// code i, and return its address (0 if it cannot be compiled).
+/// The functions are cached by expression: since the expression contains
+/// the types of the leaves, the formulas of trees with the same layout,
+/// such as the trees of a TChain, share the same function.
+
+static void *R__JitCompile(const std::string &expr)
+{
+   // The semantic of the operations which are not plain C++ operators, see
+   // TTreeFormula::EvalInstance.
+   static const char *prelude =
+      "#include \"TMath.h\"\n"
+      "namespace TTreeFormulaJit {\n"
+      "inline Double_t Div(Double_t a, Double_t b) { return b == 0 ? 0 : a / b; }\n"
+      "inline Double_t Mod(Double_t a, Double_t b) { return Double_t(Long64_t(a) % Long64_t(b)); }\n"
+      "inline Double_t Tan(Double_t x) { return TMath::Cos(x) == 0 ? 0 : TMath::Tan(x); }\n"
+      "inline Double_t ACos(Double_t x) { return TMath::Abs(x) > 1 ? 0 : TMath::ACos(x); }\n"
+      "inline Double_t ASin(Double_t x) { return TMath::Abs(x) > 1 ? 0 : TMath::ASin(x); }\n"
+      "inline Double_t TanH(Double_t x) { return TMath::CosH(x) == 0 ? 0 : TMath::TanH(x); }\n"
+      "inline Double_t ACosH(Double_t x) { return x < 1 ? 0 : TMath::ACosH(x); }\n"
+      "inline Double_t ATanH(Double_t x) { return TMath::Abs(x) > 1 ? 0 : TMath::ATanH(x); }\n"
+      "inline Double_t Sq(Double_t x) { return x * x; }\n"
+      "inline Double_t Sqrt(Double_t x) { return TMath::Sqrt(TMath::Abs(x)); }\n"
+      "inline Double_t Min(Double_t a, Double_t b) { return b < a ? b : a; }\n"
+      "inline Double_t Max(Double_t a, Double_t b) { return a < b ? b : a; }\n"
+      "inline Double_t Log(Double_t x) { return x > 0 ? TMath::Log(x) : 0; }\n"
+      "inline Double_t Log10(Double_t x) { return x > 0 ? TMath::Log10(x) : 0; }\n"
+      "inline Double_t Exp(Double_t x) { return x < -700 ? 0 : TMath::Exp(x > 700 ? 700 : x); }\n"
+      "inline Double_t Sign(Double_t x) { return x < 0 ? -1 : 1; }\n"
+      "inline Double_t Int(Double_t x) { return Double_t(Long64_t(x)); }\n"
+      "}\n";
+   static Bool_t preludeDeclared = kFALSE;
+   static std::map<std::string, void*> functions;
+
+   R__LOCKGUARD2(gInterpreterMutex);
+   auto cached = functions.find(expr);
+   if (cached != functions.end())
+      return cached->second;
+
+   void *func = 0;
+   if (!preludeDeclared)
+      preludeDeclared = gInterpreter->Declare(prelude);
+   if (preludeDeclared) {
+      TString name = TString::Format("TTreeFormulaJit::Eval%lu", (ULong_t)functions.size());
+      TString code = TString::Format("namespace TTreeFormulaJit {\nDouble_t Eval%lu(void **v) { return %s; }\n}\n",
+                                     (ULong_t)functions.size(), expr.c_str());
+      if (gInterpreter->Declare(code))
+         func = (void*)gInterpreter->Calc(TString::Format("(long)&%s", name.Data()));
+   }
+   // Also remember the failures, not to try again for each tree.
+   functions[expr] = func;
+   return func;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// If TTreeFormula.JIT is set in the ROOT resources (gEnv), translate the
+/// operations of the formula into a C++ expression and compile it with the
+/// interpreter, so that EvalInstance calls a function reading the values of
+/// the leaves directly from their buffer instead of interpreting the
+/// operations one by one.
+///
+/// This is only done for formulas with a single instance made of
+/// numerical operations on leaves of a basic type, constants and the
+/// mathematical functions of TFormula. Return true if the function is
+/// ready.
+
+Bool_t TTreeFormula::MakeJitFunction()
+{
+   fJitStatus = kJitNone;
+   fJitFunc = 0;
+   if (!gEnv->GetValue("TTreeFormula.JIT", 0) || !gInterpreter) return kFALSE;
+   if (fNoper < 2 || !HasOnlyBasicLeaves()) return kFALSE;
+
+   // The leaves are read directly from their value buffer.
+   std::vector<std::string> leafValues(fNcodes);
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);
+      leafValues[code] = TString::Format("Double_t(*(const %s*)v[%d])", leaf->GetTypeName(), code).Data();
+   }
+
+   // Translate the reverse polish notation of the operations into C++.
+   std::vector<std::string> stack;
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      const Int_t param = oper & kTFOperMask;
+      const char *func = 0;   // unary function
+      const char *func2 = 0;  // binary function
+      const char *op2 = 0;    // binary operator
+      const char *cmp = 0;    // comparison or logical operator, giving 0 or 1
+      const char *bitop = 0;  // bitwise operator
+      switch (action) {
+         case kEnd:        i = fNoper; continue;
+         case kConstant: {
+            Double_t value = fConst[param];
+            if (!TMath::Finite(value)) return kFALSE;
+            stack.push_back(TString::Format("Double_t(%.17g)", value).Data());
+            continue;
+         }
+         case kDefinedVariable:
+            if (param >= fNcodes) return kFALSE;
+            stack.push_back(leafValues[param]);
+            continue;
+         case kpi:         stack.push_back("TMath::Pi()"); continue;
+         case kBoolOptimize: continue; // the C++ operators do the same
+         case kAdd:        op2 = "+"; break;
+         case kSubstract:  op2 = "-"; break;
+         case kMultiply:   op2 = "*"; break;
+         case kDivide:     func2 = "Div"; break;
+         case kModulo:     func2 = "Mod"; break;
+         case kcos:        func = "TMath::Cos"; break;
+         case ksin:        func = "TMath::Sin"; break;
+         case ktan:        func = "Tan"; break;
+         case kacos:       func = "ACos"; break;
+         case kasin:       func = "ASin"; break;
+         case katan:       func = "TMath::ATan"; break;
+         case kcosh:       func = "TMath::CosH"; break;
+         case ksinh:       func = "TMath::SinH"; break;
+         case ktanh:       func = "TanH"; break;
+         case kacosh:      func = "ACosH"; break;
+         case kasinh:      func = "TMath::ASinH"; break;
+         case katanh:      func = "ATanH"; break;
+         case katan2:      func2 = "TMath::ATan2"; break;
+         case kfmod:       func2 = "fmod"; break;
+         case kpow:        func2 = "TMath::Power"; break;
+         case ksq:         func = "Sq"; break;
+         case ksqrt:       func = "Sqrt"; break;
+         case kmin:        func2 = "Min"; break;
+         case kmax:        func2 = "Max"; break;
+         case klog:        func = "Log"; break;
+         case kexp:        func = "Exp"; break;
+         case klog10:      func = "Log10"; break;
+         case kabs:        func = "TMath::Abs"; break;
+         case ksign:       func = "Sign"; break;
+         case kint:        func = "Int"; break;
+         case kSignInv:    func = "-"; break;
+         case kAnd:        cmp = "&&"; break;
+         case kOr:         cmp = "||"; break;
+         case kEqual:      cmp = "=="; break;
+         case kNotEqual:   cmp = "!="; break;
+         case kLess:       cmp = "<"; break;
+         case kGreater:    cmp = ">"; break;
+         case kLessThan:   cmp = "<="; break;
+         case kGreaterThan:cmp = ">="; break;
+         case kNot:        func = "!"; break;
+         case kBitAnd:     bitop = "&"; break;
+         case kBitOr:      bitop = "|"; break;
+         case kLeftShift:  bitop = "<<"; break;
+         case kRightShift: bitop = ">>"; break;
+         default:          return kFALSE; // strings, jumps, aliases, function calls, ...
+      }
+      if (func) {
+         if (stack.empty()) return kFALSE;
+         std::string &a = stack.back();
+         if (action == kNot)
+            a = "(" + a + " != 0 ? 0. : 1.)";
+         else
+            a = std::string(func) + "(" + a + ")";
+         continue;
+      }
+      if (stack.size() < 2) return kFALSE;
+      std::string b = stack.back();
+      stack.pop_back();
+      std::string &a = stack.back();
+      if (op2) {
+         a = "(" + a + " " + op2 + " " + b + ")";
+      } else if (func2) {
+         a = std::string(func2) + "(" + a + ", " + b + ")";
+      } else if (action == kAnd || action == kOr) {
+         a = "(" + a + " != 0 " + cmp + " " + b + " != 0 ? 1. : 0.)";
+      } else if (cmp) {
+         a = "(" + a + " " + cmp + " " + b + " ? 1. : 0.)";
+      } else {
+         a = "Double_t(ULong64_t(" + a + ") " + bitop + " ULong64_t(" + b + "))";
+      }
+   }
+   if (stack.size() != 1) return kFALSE;
+
+   fJitFunc = R__JitCompile(stack.back());
+   if (!fJitFunc) return kFALSE;
+   fJitArgs.assign(fNcodes, (void*)0);
+   fJitStatus = kJitReady;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first entry after the basket of branch containing entry.
+
+static Long64_t R__BasketEnd(TBranch *branch, Long64_t entry)
+{
+   Int_t nbaskets = branch->GetWriteBasket();
+   Long64_t *basketEntry = branch->GetBasketEntry();
+   Int_t basket = TMath::BinarySearch(nbaskets + 1, basketEntry, entry);
+   if (basket < 0) return -1;
+   if (basket < nbaskets) return basketEntry[basket + 1];
+   return branch->GetEntries();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Convert the n values of type T at src to Double_t.
+
+template <typename T> static void R__ToDouble(const char *src, Double_t *dest, Int_t n)
+{
+   const T *values = reinterpret_cast<const T*>(src);
+   for (Int_t k = 0; k < n; ++k) dest[k] = values[k];
+}
+
+// The numerical operations evaluated both by EvalInstance, one value at a
+// time, and by EvalBlock, on columns of values: OP(action, expression) for
+// each of them, the expression computing the result from the operand a, or
+// the operands a and b.
+#define TT_UNARY_OPERS(OP) \
+   OP(kcos,     TMath::Cos(a)) \
+   OP(ksin,     TMath::Sin(a)) \
+   OP(ktan,     (TMath::Cos(a) == 0) ? 0 : TMath::Tan(a)) /* tangente indeterminee */ \
+   OP(kacos,    (TMath::Abs(a) > 1) ? 0 : TMath::ACos(a)) /* indetermination */ \
+   OP(kasin,    (TMath::Abs(a) > 1) ? 0 : TMath::ASin(a)) /* indetermination */ \
+   OP(katan,    TMath::ATan(a)) \
+   OP(kcosh,    TMath::CosH(a)) \
+   OP(ksinh,    TMath::SinH(a)) \
+   OP(ktanh,    (TMath::CosH(a) == 0) ? 0 : TMath::TanH(a)) /* tangente indeterminee */ \
+   OP(kacosh,   (a < 1) ? 0 : TMath::ACosH(a)) /* indetermination */ \
+   OP(kasinh,   TMath::ASinH(a)) \
+   OP(katanh,   (TMath::Abs(a) > 1) ? 0 : TMath::ATanH(a)) /* indetermination */ \
+   OP(ksq,      a * a) \
+   OP(ksqrt,    TMath::Sqrt(TMath::Abs(a))) \
+   OP(klog,     (a > 0) ? TMath::Log(a) : 0) /* indetermination */ \
+   OP(kexp,     (Double_t(a) < -700) ? 0 : TMath::Exp(std::min(Double_t(a), 700.))) \
+   OP(klog10,   (a > 0) ? TMath::Log10(a) : 0) /* indetermination */ \
+   OP(kabs,     TMath::Abs(a)) \
+   OP(ksign,    (a < 0) ? -1 : 1) \
+   OP(kint,     Long64_t(a)) \
+   OP(kSignInv, -1 * a) \
+   OP(kNot,     (a != 0) ? 0 : 1)
+
+#define TT_BINARY_OPERS(OP) \
+   OP(kAdd,         a + b) \
+   OP(kSubstract,   a - b) \
+   OP(kMultiply,    a * b) \
+   OP(kDivide,      (b == 0) ? 0 : a / b) /* division by 0 */ \
+   OP(kModulo,      Long64_t(a) % Long64_t(b)) \
+   OP(katan2,       TMath::ATan2(a, b)) \
+   OP(kfmod,        fmod_local(a, b)) \
+   OP(kpow,         TMath::Power(a, b)) \
+   OP(kmin,         std::min(a, b)) \
+   OP(kmax,         std::max(a, b)) \
+   OP(kAnd,         (a != 0 && b != 0) ? 1 : 0) \
+   OP(kOr,          (a != 0 || b != 0) ? 1 : 0) \
+   OP(kEqual,       (a == b) ? 1 : 0) \
+   OP(kNotEqual,    (a != b) ? 1 : 0) \
+   OP(kLess,        (a <  b) ? 1 : 0) \
+   OP(kGreater,     (a >  b) ? 1 : 0) \
+   OP(kLessThan,    (a <= b) ? 1 : 0) \
+   OP(kGreaterThan, (a >= b) ? 1 : 0) \
+   OP(kBitAnd,      ULong64_t(a) &  ULong64_t(b)) \
+   OP(kBitOr,       ULong64_t(a) |  ULong64_t(b)) \
+   OP(kLeftShift,   ULong64_t(a) << ULong64_t(b)) \
+   OP(kRightShift,  ULong64_t(a) >> ULong64_t(b))
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of operands of the operation action of EvalBlock, or
+/// 0 if the operation cannot be evaluated by block.
+
+Int_t TTreeFormula::BlockOperArity(Int_t action)
+{
+#define TT_ARITY_UNARY(action, expr)  case action: return 1;
+#define TT_ARITY_BINARY(action, expr) case action: return 2;
+   switch (action) {
+      TT_UNARY_OPERS(TT_ARITY_UNARY)
+      TT_BINARY_OPERS(TT_ARITY_BINARY)
+   }
+#undef TT_ARITY_UNARY
+#undef TT_ARITY_BINARY
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the operation action to the columns of n values x (and y for the
+/// binary operations), storing the result in x, with the semantic of
+/// TTreeFormula::EvalInstance.
+
+void TTreeFormula::EvalBlockOper(Int_t action, Double_t *x, const Double_t *y, Int_t n)
+{
+#define TT_BLOCK_UNARY(action, expr) \
+   case action: for (Int_t k = 0; k < n; ++k) { const Double_t a = x[k]; x[k] = expr; } return;
+#define TT_BLOCK_BINARY(action, expr) \
+   case action: for (Int_t k = 0; k < n; ++k) { const Double_t a = x[k], b = y[k]; x[k] = expr; } return;
+   switch (action) {
+      TT_UNARY_OPERS(TT_BLOCK_UNARY)
+      TT_BINARY_OPERS(TT_BLOCK_BINARY)
+   }
+#undef TT_BLOCK_UNARY
+#undef TT_BLOCK_BINARY
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the formula can be evaluated by block, see EvalBlock.
+
+Bool_t TTreeFormula::CanEvalBlock()
+{
+   if (fBlockStatus == kBlockUnknown) {
+      fBlockStatus = kBlockNone;
+      fBlockDepth = 0;
+      if (fAxis || !HasOnlyBasicLeaves()) return kFALSE;
+      for (Int_t code = 0; code < fNcodes; ++code) {
+         TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);
+         if (leaf->GetBranch()->GetNleaves() != 1) return kFALSE;
+      }
+      // Check the operations and compute the depth of the operand stack.
+      Int_t depth = 0;
+      for (Int_t i = 0; i < fNoper; ++i) {
+         const Int_t oper = GetOper()[i];
+         const Int_t action = oper >> kTFOperShift;
+         if (action == kEnd) break;
+         if (action == kBoolOptimize) continue;
+         if (action == kConstant || action == kpi || action == kDefinedVariable) {
+            if (action == kDefinedVariable && (oper & kTFOperMask) >= fNcodes) return kFALSE;
+            fBlockDepth = std::max(fBlockDepth, ++depth);
+            continue;
+         }
+         const Int_t arity = BlockOperArity(action);
+         if (arity == 0 || depth < arity) return kFALSE;
+         depth -= arity - 1;
+      }
+      if (depth != 1) return kFALSE;
+      fBlockStatus = kBlockReady;
+   }
+   return fBlockStatus == kBlockReady;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula for a block of consecutive entries of the current
+/// tree, starting at the local entry entry, and store the results in
+/// values. At most nentries entries are evaluated, and the block ends with
+/// the first basket of the leaves which ends. Return the number of entries
+/// evaluated, or -1 if the formula cannot be evaluated by block: then
+/// EvalInstance must be used for each entry.
+///
+/// The leaves are read in bulk with TBranch::GetBulkEntries, then each
+/// operation is applied to whole columns of values, in loops which the
+/// compiler can vectorize. This is possible for the formulas with a single
+/// instance made of numerical operations on scalar leaves of a basic type,
+/// each leaf being the only one of its branch. EvalBlock does not load the
+/// branches nor change their current entry.
+
+Int_t TTreeFormula::EvalBlock(Long64_t entry, Int_t nentries, Double_t *values)
+{
+   if (!CanEvalBlock() || nentries <= 0) return -1;
+
+   // The block ends with the first basket which ends.
+   Int_t n = nentries;
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TBranch *branch = ((TLeaf*)fLeaves.UncheckedAt(code))->GetBranch();
+      // The entries of a friend tree may not be aligned.
+      if (branch->GetTree() != fTree->GetTree()) return -1;
+      Long64_t end = R__BasketEnd(branch, entry);
+      if (end <= entry) return -1;
+      if (end - entry < n) n = Int_t(end - entry);
+   }
+
+   // Read the columns of the leaves.
+   if (!fBlockBuffer) fBlockBuffer = new TBufferFile(TBuffer::kRead, 10000);
+   fBlockValues.resize((size_t)(fNcodes + fBlockDepth) * n);
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);
+      if (leaf->GetBranch()->GetBulkEntries(entry, *fBlockBuffer) < n) {
+         // For example the entries of a basket have a variable size.
+         fBlockStatus = kBlockNone;
+         return -1;
+      }
+      const char *src = fBlockBuffer->Buffer();
+      Double_t *column = &fBlockValues[(size_t)code * n];
+      TClass *cl = leaf->IsA();
+      Bool_t isUnsigned = leaf->IsUnsigned();
+      if (cl == TLeafD::Class())      R__ToDouble<Double_t>(src, column, n);
+      else if (cl == TLeafF::Class()) R__ToDouble<Float_t>(src, column, n);
+      else if (cl == TLeafI::Class()) isUnsigned ? R__ToDouble<UInt_t>(src, column, n) : R__ToDouble<Int_t>(src, column, n);
+      else if (cl == TLeafL::Class()) isUnsigned ? R__ToDouble<ULong64_t>(src, column, n) : R__ToDouble<Long64_t>(src, column, n);
+      else if (cl == TLeafS::Class()) isUnsigned ? R__ToDouble<UShort_t>(src, column, n) : R__ToDouble<Short_t>(src, column, n);
+      else if (cl == TLeafB::Class()) isUnsigned ? R__ToDouble<UChar_t>(src, column, n) : R__ToDouble<Char_t>(src, column, n);
+      else                            R__ToDouble<Bool_t>(src, column, n);
+   }
+
+   // Evaluate the operations on the columns.
+   Double_t *stack = &fBlockValues[(size_t)fNcodes * n];
+   Int_t pos = 0;
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      if (action == kEnd) break;
+      Double_t *top = stack + (size_t)pos * n;
+      switch (action) {
+         case kBoolOptimize:
+            continue;
+         case kConstant:
+            std::fill(top, top + n, fConst[oper & kTFOperMask]);
+            ++pos;
+            continue;
+         case kpi:
+            std::fill(top, top + n, TMath::Pi());
+            ++pos;
+            continue;
+         case kDefinedVariable: {
+            const Double_t *column = &fBlockValues[(size_t)(oper & kTFOperMask) * n];
+            std::copy(column, column + n, top);
+            ++pos;
+            continue;
+         }
+      }
+      if (BlockOperArity(action) == 1) {
+         EvalBlockOper(action, top - n, 0, n);
+      } else {
+         EvalBlockOper(action, top - 2 * n, top - n, n);
+         --pos;
+      }
+   }
+   std::copy(stack, stack + n, values);
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the operation action to the ranges [amin,amax] and [bmin,bmax]
+/// (for the binary operations), storing in [amin,amax] a range containing
+/// all the possible results. The result of a comparison or a logical
+/// operation is [0,0] or [1,1] when it is certain, [0,1] otherwise; the
+/// range is infinite when nothing is known.
+
+void TTreeFormula::BlockRangeOper(Int_t action, Double_t &amin, Double_t &amax, Double_t bmin, Double_t bmax)
+{
+   const Double_t inf = TMath::Infinity();
+   // Whether the values of a range are all zero, or all different from zero.
+   const Bool_t aFalse = (amin == 0 && amax == 0);
+   const Bool_t bFalse = (bmin == 0 && bmax == 0);
+   const Bool_t aTrue = (amin > 0 || amax < 0);
+   const Bool_t bTrue = (bmin > 0 || bmax < 0);
+   Int_t certain = -1; // Result of a comparison: 0 or 1 if it is certain.
+   switch (action) {
+      case kAdd:       amin += bmin; amax += bmax; break;
+      case kSubstract: { Double_t lo = amin - bmax; amax -= bmin; amin = lo; break; }
+      case kMultiply: {
+         const Double_t p[4] = { amin * bmin, amin * bmax, amax * bmin, amax * bmax };
+         amin = *std::min_element(p, p + 4);
+         amax = *std::max_element(p, p + 4);
+         break;
+      }
+      case kSignInv:   { Double_t lo = -amax; amax = -amin; amin = lo; break; }
+      case kabs:
+         if (amax <= 0) { Double_t lo = -amax; amax = -amin; amin = lo; }
+         else if (amin < 0) { amax = std::max(-amin, amax); amin = 0; }
+         break;
+      case kmin:       amin = std::min(amin, bmin); amax = std::min(amax, bmax); break;
+      case kmax:       amin = std::max(amin, bmin); amax = std::max(amax, bmax); break;
+      case kLess:        certain = (amax <  bmin) ? 1 : (amin >= bmax) ? 0 : -1; break;
+      case kGreater:     certain = (amin >  bmax) ? 1 : (amax <= bmin) ? 0 : -1; break;
+      case kLessThan:    certain = (amax <= bmin) ? 1 : (amin >  bmax) ? 0 : -1; break;
+      case kGreaterThan: certain = (amin >= bmax) ? 1 : (amax <  bmin) ? 0 : -1; break;
+      case kEqual:
+         certain = (amin == amax && bmin == bmax && amin == bmin) ? 1 : (amax < bmin || bmax < amin) ? 0 : -1;
+         break;
+      case kNotEqual:
+         certain = (amin == amax && bmin == bmax && amin == bmin) ? 0 : (amax < bmin || bmax < amin) ? 1 : -1;
+         break;
+      case kAnd:       certain = (aFalse || bFalse) ? 0 : (aTrue && bTrue) ? 1 : -1; break;
+      case kOr:        certain = (aTrue || bTrue) ? 1 : (aFalse && bFalse) ? 0 : -1; break;
+      case kNot:       certain = aFalse ? 1 : aTrue ? 0 : -1; break;
+      default:         amin = -inf; amax = inf; return;
+   }
+   if ((action >= kAnd && action <= kGreaterThan) || action == kNot) {
+      amin = (certain == 1) ? 1 : 0;
+      amax = (certain == 0) ? 0 : 1;
+   } else if (amin != amin || amax != amax) {
+      // For example inf - inf.
+      amin = -inf;
+      amax = inf;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute in min and max a range containing the values of the formula for
+/// a block of consecutive entries of the current tree, starting at the
+/// local entry entry, from the zone maps of the branches of its leaves (see
+/// TBranch::SetZoneMaps). The block has at most nentries entries and ends
+/// with the first basket of the leaves which ends. Return the number of
+/// entries of the block, or -1 if the formula cannot be evaluated by block
+/// (see EvalBlock) or none of its leaves has zone maps.
+///
+/// A selection whose range is [0,0] is false for all the entries of the
+/// block, which can then be skipped without reading the baskets. The
+/// range is computed from the operations with an interval arithmetic: it
+/// is exact for the comparisons of leaves with constants combined with
+/// the logical operators, and may be infinite for the other operations.
+
+Int_t TTreeFormula::EvalBlockRange(Long64_t entry, Int_t nentries, Double_t &min, Double_t &max)
+{
+   if (!CanEvalBlock() || nentries <= 0) return -1;
+
+   // Most trees have no zone maps, find it out once per tree.
+   if (fZoneMapTree != fTree->GetTree()) {
+      fZoneMapTree = fTree->GetTree();
+      fHasZoneMaps = kFALSE;
+      for (Int_t code = 0; code < fNcodes && !fHasZoneMaps; ++code) {
+         TBranch *branch = ((TLeaf*)fLeaves.UncheckedAt(code))->GetBranch();
+         fHasZoneMaps = branch->HasZoneMaps();
+      }
+   }
+   if (!fHasZoneMaps) return -1;
+
+   // The range of each leaf in its current basket.
+   const Double_t inf = TMath::Infinity();
+   const Int_t size = fNcodes + fBlockDepth;
+   fBlockRanges.assign(2 * size, inf);
+   Double_t *lo = fBlockRanges.data();
+   Double_t *hi = lo + size;
+   for (Int_t i = 0; i < size; ++i) lo[i] = -inf;
+   Bool_t known = kFALSE;
+   Int_t n = nentries;
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TBranch *branch = ((TLeaf*)fLeaves.UncheckedAt(code))->GetBranch();
+      if (branch->GetTree() != fTree->GetTree()) return -1;
+      Long64_t end = R__BasketEnd(branch, entry);
+      if (end <= entry) return -1;
+      if (end - entry < n) n = Int_t(end - entry);
+      if (!branch->HasZoneMaps()) continue;
+      Int_t basket = TMath::BinarySearch(branch->GetWriteBasket() + 1, branch->GetBasketEntry(), entry);
+      if (branch->GetBasketRange(basket, lo[code], hi[code]) && lo[code] <= hi[code]) {
+         known = kTRUE;
+      } else {
+         lo[code] = -inf;
+         hi[code] = inf;
+      }
+   }
+   if (!known) return -1;
+
+   // Apply the operations to the ranges.
+   Int_t pos = fNcodes;
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      if (action == kEnd) break;
+      switch (action) {
+         case kBoolOptimize:
+            continue;
+         case kConstant:
+            lo[pos] = hi[pos] = fConst[oper & kTFOperMask];
+            ++pos;
+            continue;
+         case kpi:
+            lo[pos] = hi[pos] = TMath::Pi();
+            ++pos;
+            continue;
+         case kDefinedVariable:
+            lo[pos] = lo[oper & kTFOperMask];
+            hi[pos] = hi[oper & kTFOperMask];
+            ++pos;
+            continue;
+      }
+      if (BlockOperArity(action) == 1) {
+         BlockRangeOper(action, lo[pos - 1], hi[pos - 1], 0, 0);
+      } else {
+         BlockRangeOper(action, lo[pos - 2], hi[pos - 2], lo[pos - 1], hi[pos - 1]);
+         --pos;
+      }
+   }
+   min = lo[fNcodes];
+   max = hi[fNcodes];
+   return n;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Evaluate this treeformula.
 
@@ -3969,6 +4604,22 @@ T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
       }
    }
 
+   if (std::is_same<T, Double_t>::value && instance == 0 && fJitStatus != kJitNone && !fAxis) {
+      if (fJitStatus == kJitUnknown) MakeJitFunction();
+      if (fJitStatus == kJitReady) {
+         // All the branches are read: the compiled expression cannot skip
+         // the loading of the right side of the boolean operators.
+         fNeedLoading = kFALSE;
+         fDidBooleanOptimization = kFALSE;
+         for (Int_t code = 0; code < fNcodes; ++code) {
+            TBranch *branch = (TBranch*)fBranches.UncheckedAt(code);
+            if (branch) R__LoadBranch(branch, branch->GetTree()->GetReadEntry(), fQuickLoad);
+            fJitArgs[code] = ((TLeaf*)fLeaves.UncheckedAt(code))->GetValuePointer();
+         }
+         return (T)((Double_t (*)(void**))fJitFunc)(fJitArgs.data());
+      }
+   }
+
    T tab[kMAXFOUND];
    const Int_t kMAXSTRINGFOUND = 10;
    const char *stringStackLocal[kMAXSTRINGFOUND];
@@ -3993,97 +4644,28 @@ T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
          switch(newaction) {
 
             case kEnd        : return tab[0];
-            case kAdd        : pos--; tab[pos-1] += tab[pos]; continue;
-            case kSubstract  : pos--; tab[pos-1] -= tab[pos]; continue;
-            case kMultiply   : pos--; tab[pos-1] *= tab[pos]; continue;
-            case kDivide     : pos--; if (tab[pos] == 0) tab[pos-1] = 0; //  division by 0
-                                      else               tab[pos-1] /= tab[pos];
-                                      continue;
-            case kModulo     : {pos--;
-                                Long64_t int1((Long64_t)tab[pos-1]);
-                                Long64_t int2((Long64_t)tab[pos]);
-                                tab[pos-1] = T(int1 % int2);
-                                continue;}
-
-            case kcos  : tab[pos-1] = TMath::Cos(tab[pos-1]); continue;
-            case ksin  : tab[pos-1] = TMath::Sin(tab[pos-1]); continue;
-            case ktan  : if (TMath::Cos(tab[pos-1]) == 0) {tab[pos-1] = 0;} // { tangente indeterminee }
-                         else tab[pos-1] = TMath::Tan(tab[pos-1]);
-                         continue;
-            case kacos : if (TMath::Abs(tab[pos-1]) > 1) {tab[pos-1] = 0;} //  indetermination
-                         else tab[pos-1] = TMath::ACos(tab[pos-1]);
-                         continue;
-            case kasin : if (TMath::Abs(tab[pos-1]) > 1) {tab[pos-1] = 0;} //  indetermination
-                         else tab[pos-1] = TMath::ASin(tab[pos-1]);
-                         continue;
-            case katan : tab[pos-1] = TMath::ATan(tab[pos-1]); continue;
-            case kcosh : tab[pos-1] = TMath::CosH(tab[pos-1]); continue;
-            case ksinh : tab[pos-1] = TMath::SinH(tab[pos-1]); continue;
-            case ktanh : if (TMath::CosH(tab[pos-1]) == 0) {tab[pos-1] = 0;} // { tangente indeterminee }
-                         else tab[pos-1] = TMath::TanH(tab[pos-1]);
-                         continue;
-            case kacosh: if (tab[pos-1] < 1) {tab[pos-1] = 0;} //  indetermination
-                         else tab[pos-1] = TMath::ACosH(tab[pos-1]);
-                         continue;
-            case kasinh: tab[pos-1] = TMath::ASinH(tab[pos-1]); continue;
-            case katanh: if (TMath::Abs(tab[pos-1]) > 1) {tab[pos-1] = 0;} // indetermination
-                     else tab[pos-1] = TMath::ATanH(tab[pos-1]); continue;
-            case katan2: pos--; tab[pos-1] = TMath::ATan2(tab[pos-1],tab[pos]); continue;
-
-            case kfmod : pos--; tab[pos-1] = fmod_local(tab[pos-1],tab[pos]); continue;
-            case kpow  : pos--; tab[pos-1] = TMath::Power(tab[pos-1],tab[pos]); continue;
-            case ksq   : tab[pos-1] = tab[pos-1]*tab[pos-1]; continue;
-            case ksqrt : tab[pos-1] = TMath::Sqrt(TMath::Abs(tab[pos-1])); continue;
+
+#define TT_EVAL_UNARY(action, expr) \
+            case action: { const T a = tab[pos-1]; tab[pos-1] = expr; continue; }
+#define TT_EVAL_BINARY(action, expr) \
+            case action: { pos--; const T a = tab[pos-1]; const T b = tab[pos]; tab[pos-1] = expr; continue; }
+            TT_UNARY_OPERS(TT_EVAL_UNARY)
+            TT_BINARY_OPERS(TT_EVAL_BINARY)
+#undef TT_EVAL_UNARY
+#undef TT_EVAL_BINARY
 
             case kstrstr : pos2 -= 2; pos++;if (strstr(stringStack[pos2],stringStack[pos2+1])) tab[pos-1]=1;
                                         else tab[pos-1]=0; continue;
 
-            case kmin : pos--; tab[pos-1] = std::min(tab[pos-1],tab[pos]); continue;
-            case kmax : pos--; tab[pos-1] = std::max(tab[pos-1],tab[pos]); continue;
-
-            case klog  : if (tab[pos-1] > 0) tab[pos-1] = TMath::Log(tab[pos-1]);
-                         else {tab[pos-1] = 0;} //{indetermination }
-                          continue;
-            case kexp  : { Double_t dexp = tab[pos-1];
-                           if (dexp < -700) {tab[pos-1] = 0; continue;}
-                           if (dexp >  700) {tab[pos-1] = TMath::Exp(700); continue;}
-                           tab[pos-1] = TMath::Exp(dexp); continue;
-                         }
-            case klog10: if (tab[pos-1] > 0) tab[pos-1] = TMath::Log10(tab[pos-1]);
-                         else {tab[pos-1] = 0;} //{indetermination }
-                         continue;
-
             case kpi   : pos++; tab[pos-1] = TMath::ACos(-1); continue;
 
-            case kabs  : tab[pos-1] = TMath::Abs(tab[pos-1]); continue;
-            case ksign : if (tab[pos-1] < 0) tab[pos-1] = -1; else tab[pos-1] = 1; continue;
-            case kint  : tab[pos-1] = T(Long64_t(tab[pos-1])); continue;
-            case kSignInv: tab[pos-1] = -1 * tab[pos-1]; continue;
             case krndm : pos++; tab[pos-1] = gRandom->Rndm(1); continue;
 
-            case kAnd  : pos--; if (tab[pos-1]!=0 && tab[pos]!=0) tab[pos-1]=1;
-                                else tab[pos-1]=0; continue;
-            case kOr   : pos--; if (tab[pos-1]!=0 || tab[pos]!=0) tab[pos-1]=1;
-                                else tab[pos-1]=0; continue;
-
-            case kEqual      : pos--; tab[pos-1] = (tab[pos-1] == tab[pos]) ? 1 : 0; continue;
-            case kNotEqual   : pos--; tab[pos-1] = (tab[pos-1] != tab[pos]) ? 1 : 0; continue;
-            case kLess       : pos--; tab[pos-1] = (tab[pos-1] <  tab[pos]) ? 1 : 0; continue;
-            case kGreater    : pos--; tab[pos-1] = (tab[pos-1] >  tab[pos]) ? 1 : 0; continue;
-            case kLessThan   : pos--; tab[pos-1] = (tab[pos-1] <= tab[pos]) ? 1 : 0; continue;
-            case kGreaterThan: pos--; tab[pos-1] = (tab[pos-1] >= tab[pos]) ? 1 : 0; continue;
-            case kNot        :        tab[pos-1] = (tab[pos-1] !=        0) ? 0 : 1; continue;
-
             case kStringEqual : pos2 -= 2; pos++; if (!strcmp(stringStack[pos2+1],stringStack[pos2])) tab[pos-1]=1;
                                                   else tab[pos-1]=0; continue;
             case kStringNotEqual: pos2 -= 2; pos++;if (strcmp(stringStack[pos2+1],stringStack[pos2])) tab[pos-1]=1;
                                                    else tab[pos-1]=0; continue;
 
-            case kBitAnd    : pos--; tab[pos-1]= ((ULong64_t) tab[pos-1]) & ((ULong64_t) tab[pos]); continue;
-            case kBitOr     : pos--; tab[pos-1]= ((ULong64_t) tab[pos-1]) | ((ULong64_t) tab[pos]); continue;
-            case kLeftShift : pos--; tab[pos-1]= ((ULong64_t) tab[pos-1]) <<((ULong64_t) tab[pos]); continue;
-            case kRightShift: pos--; tab[pos-1]= ((ULong64_t) tab[pos-1]) >>((ULong64_t) tab[pos]); continue;
-
             case kJump   : i = (oper & kTFOperMask); continue;
             case kJumpIf : {
                pos--;
@@ -5009,6 +5591,10 @@ void TTreeFormula::UpdateFormulaLeaves()
 {
    Int_t nleaves = fLeafNames.GetEntriesFast();
    ResetBit( kMissingLeaf );
+   // The types of the leaves may differ in the new tree.
+   fJitStatus = kJitUnknown;
+   fBlockStatus = kBlockUnknown;
+   fZoneMapTree = 0;
    for (Int_t i=0;i<nleaves;i++) {
       if (!fTree) break;
       if (!fLeafNames[i]) continue;
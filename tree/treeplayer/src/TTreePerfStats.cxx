@@ -77,9 +77,39 @@ ReadTotal +ReadTotal*Readextra/100. Same for ReadSize.
 A consequence of NOTE1, the Disk I/O speed corresponds to the effective
 number of bytes returned to the application per second.
 The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
+
+ ### Statistics per branch
+The following counters are also collected for each branch read, and are
+added up by branch name over the trees of a TChain:
+ -  Baskets   = Number of baskets read
+ -  Misses    = Number of baskets read from the file because they were not
+                in the TTreeCache
+ -  ReadMB    = Number of zipped MBytes read
+ -  UnzipMB   = Number of unzipped MBytes
+ -  Unzip     = Time spent uncompressing the baskets, in seconds
+ -  Streamer  = Time spent deserializing the entries, in seconds
+They are printed, the most expensive branches first, with
+~~~{.cpp}
+   root > ioperf->Print("branches");
+~~~
+and can be exported as a text table or, if the file name ends with
+.json, as JSON:
+~~~{.cpp}
+   root > ioperf->SaveBranchStats("branches.json");
+~~~
+The baskets unzipped in advance by TTreeCacheUnzip are counted, but not
+their unzip time. Without a TTreeCache, or while the TTreeCache is
+learning, every basket read from the file is counted as a miss; the
+baskets used in place in a memory mapped file are not.
+
+The counters are updated with relaxed atomic operations in a slot per
+branch, found through a small cache per thread: the lock is only taken the
+first time a thread reads a branch. The slots are added to the statistics
+per branch by Finish.
 */
 
 #include "TTreePerfStats.h"
+#include "TBranch.h"
 #include "TROOT.h"
 #include "TSystem.h"
 #include "Riostream.h"
@@ -93,11 +123,35 @@ The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
 #include "TStopwatch.h"
 #include "TGaxis.h"
 #include "TTimeStamp.h"
+#include "ThreadLocalStorage.h"
 #include "TDatime.h"
 #include "TMath.h"
 
+#include <algorithm>
+#include <fstream>
+
 ClassImp(TTreePerfStats)
 
+// Counters of a branch, updated concurrently by the threads reading it.
+// The times are in nanoseconds.
+struct TTreePerfStats::TBranchSlot {
+   std::atomic<Int_t>    fBaskets;
+   std::atomic<Int_t>    fCacheMisses;
+   std::atomic<Long64_t> fBytes;
+   std::atomic<Long64_t> fUnzipBytes;
+   std::atomic<Long64_t> fUnzipTime;
+   std::atomic<Long64_t> fStreamerTime;
+
+   TBranchSlot() : fBaskets(0), fCacheMisses(0), fBytes(0), fUnzipBytes(0), fUnzipTime(0), fStreamerTime(0) {}
+};
+
+namespace {
+   // Source of the TTreePerfStats::fBranchGeneration, unique over all the
+   // objects so that an object allocated at the address of a deleted one
+   // does not match the cache entries of the latter.
+   std::atomic<ULong64_t> gBranchGeneration(0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// default constructor (used when reading an object only)
 
@@ -125,6 +179,9 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fCompress      = 0;
    fRealTimeAxis  = 0;
    fHostInfoText  = 0;
+   fBranchTree    = 0;
+   fBranchTreeNumber = -1;
+   fBranchGeneration = ++gBranchGeneration;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +228,9 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    TDatime dt;
    fHostInfo += TString::Format(" %s",dt.AsString());
    fHostInfoText   = 0;
+   fBranchTree     = 0;
+   fBranchTreeNumber = -1;
+   fBranchGeneration = ++gBranchGeneration;
 
    gPerfStats = this;
 }
@@ -188,6 +248,7 @@ TTreePerfStats::~TTreePerfStats()
    delete fWatch;
    delete fRealTimeAxis;
    delete fHostInfoText;
+   for (size_t i = 0; i < fBranchSlots.size(); ++i) delete fBranchSlots[i];
 
    if (gPerfStats == this) {
       gPerfStats = 0;
@@ -311,13 +372,159 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the counters of branch, adding them if needed, or 0 if it is not
+/// a branch of the monitored tree. Must be called with fBranchMutex locked.
+
+TTreePerfStats::TBranchSlot *TTreePerfStats::FindBranchSlot(TBranch *branch)
+{
+   TTree *tree = branch->GetTree();
+   if (!fTree || (tree != fTree && tree != fTree->GetTree())) return 0;
+   Int_t treeNumber = fTree->GetTreeNumber();
+   if (tree != fBranchTree || treeNumber != fBranchTreeNumber) {
+      // The branches of the previous tree of a chain may have been deleted,
+      // and their addresses reused. Invalidate the caches of the threads.
+      fBranchIndex.clear();
+      fBranchTree = tree;
+      fBranchTreeNumber = treeNumber;
+      fBranchGeneration = ++gBranchGeneration;
+   }
+   std::map<const TBranch*,TBranchSlot*>::const_iterator it = fBranchIndex.find(branch);
+   if (it != fBranchIndex.end()) return it->second;
+
+   // The statistics are kept by full branch name, to add up over the trees
+   // of a chain without mixing the sub-branches of the same name.
+   TString name = branch->GetFullName();
+   Int_t index = -1;
+   Int_t nbranches = fBranchNames.size();
+   for (Int_t i = 0; i < nbranches; ++i) {
+      if (fBranchNames[i] == name) {
+         index = i;
+         break;
+      }
+   }
+   if (index < 0) {
+      index = nbranches;
+      fBranchNames.push_back(name);
+      fBranchBaskets.push_back(0);
+      fBranchCacheMisses.push_back(0);
+      fBranchBytes.push_back(0);
+      fBranchUnzipBytes.push_back(0);
+      fBranchUnzipTime.push_back(0);
+      fBranchStreamerTime.push_back(0);
+   }
+   while ((Int_t)fBranchSlots.size() <= index) fBranchSlots.push_back(new TBranchSlot);
+   fBranchIndex[branch] = fBranchSlots[index];
+   return fBranchSlots[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the counters of branch, or 0 if it is not a branch of the
+/// monitored tree. The counters of the last branches seen are cached per
+/// thread, fBranchMutex is only locked the first time a thread sees a
+/// branch or after the monitored tree changed.
+
+TTreePerfStats::TBranchSlot *TTreePerfStats::GetBranchSlot(TBranch *branch)
+{
+   struct TCacheEntry {
+      const TTreePerfStats *fPerfStats;
+      ULong64_t             fGeneration;
+      Int_t                 fTreeNumber;
+      const TBranch        *fBranch;
+      TBranchSlot          *fSlot;
+   };
+   const Int_t kCacheSize = 64;
+   TTHREAD_TLS_ARRAY(TCacheEntry, kCacheSize, cache);
+
+   if (!fTree) return 0;
+   // A new tree of a chain may reuse the addresses of the branches of the
+   // previous one: its number is checked before fBranchIndex is cleared.
+   Int_t treeNumber = fTree->GetTreeNumber();
+   ULong64_t generation = fBranchGeneration.load(std::memory_order_acquire);
+   TCacheEntry &entry = cache[(reinterpret_cast<ULong_t>(branch) / sizeof(void*)) % kCacheSize];
+   if (entry.fBranch == branch && entry.fGeneration == generation &&
+       entry.fTreeNumber == treeNumber && entry.fPerfStats == this)
+      return entry.fSlot;
+
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   entry.fSlot = FindBranchSlot(branch);
+   entry.fBranch = branch;
+   entry.fGeneration = fBranchGeneration.load(std::memory_order_relaxed);
+   entry.fTreeNumber = treeNumber;
+   entry.fPerfStats = this;
+   return entry.fSlot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the counters of the branches to the statistics per branch, and reset
+/// them.
+
+void TTreePerfStats::MergeBranchStats()
+{
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   for (size_t i = 0; i < fBranchSlots.size(); ++i) {
+      TBranchSlot &slot = *fBranchSlots[i];
+      fBranchBaskets[i]      += slot.fBaskets.exchange(0, std::memory_order_relaxed);
+      fBranchCacheMisses[i]  += slot.fCacheMisses.exchange(0, std::memory_order_relaxed);
+      fBranchBytes[i]        += slot.fBytes.exchange(0, std::memory_order_relaxed);
+      fBranchUnzipBytes[i]   += slot.fUnzipBytes.exchange(0, std::memory_order_relaxed);
+      fBranchUnzipTime[i]    += 1e-9*slot.fUnzipTime.exchange(0, std::memory_order_relaxed);
+      fBranchStreamerTime[i] += 1e-9*slot.fStreamerTime.exchange(0, std::memory_order_relaxed);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the reading of a basket of branch.
+/// -  len is the number of bytes of the basket on file
+/// -  cacheMiss is true if the basket was read from the file because it
+///    was not in the TTreeCache, or because there is no TTreeCache
+
+void TTreePerfStats::BasketReadEvent(TBranch *branch, Int_t len, Bool_t cacheMiss)
+{
+   TBranchSlot *slot = GetBranchSlot(branch);
+   if (!slot) return;
+   slot->fBaskets.fetch_add(1, std::memory_order_relaxed);
+   slot->fBytes.fetch_add(len, std::memory_order_relaxed);
+   if (cacheMiss) slot->fCacheMisses.fetch_add(1, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the unzipping of a basket of branch.
+/// -  start is the TVirtualPerfStats::GetSteadyTime() before unzip
+/// -  complen is the length of the compressed buffer
+/// -  objlen is the length of the de-compressed buffer
+
+void TTreePerfStats::BasketUnzipEvent(TBranch *branch, Double_t start, Int_t /* complen */, Int_t objlen)
+{
+   TBranchSlot *slot = GetBranchSlot(branch);
+   if (!slot) return;
+   Double_t dtime = GetSteadyTime() - start;
+   slot->fUnzipBytes.fetch_add(objlen, std::memory_order_relaxed);
+   slot->fUnzipTime.fetch_add(Long64_t(1e9*dtime), std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the deserialization of an entry of branch.
+/// -  start is the TVirtualPerfStats::GetSteadyTime() before reading the leaves
+
+void TTreePerfStats::BranchStreamerEvent(TBranch *branch, Double_t start)
+{
+   Double_t dtime = GetSteadyTime() - start;
+   TBranchSlot *slot = GetBranchSlot(branch);
+   if (!slot) return;
+   slot->fStreamerTime.fetch_add(Long64_t(1e9*dtime), std::memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
-/// the function is automatically called by Draw and Print
+/// the function is automatically called by Draw and Print.
+/// The counters of the branches are added to the statistics per branch at
+/// each call.
 
 void TTreePerfStats::Finish()
 {
+   MergeBranchStats();
    if (fRealNorm)   return;  //has already been called
    if (!fFile)      return;
    if (!fTree)      return;
@@ -457,6 +664,82 @@ void TTreePerfStats::Print(Option_t * option) const
       printf("ReadStrCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/(fCpuTime-fUnzipTime));
       printf("ReadZipCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fUnzipTime);
    }
+   if (opts.Contains("branch")) {
+      std::cout << std::endl;
+      PrintBranchStats(std::cout, kFALSE);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write a string in JSON, with the quotes and backslashes escaped.
+
+static void R__WriteJSONString(std::ostream &out, const char *str)
+{
+   out << '"';
+   for (const char *c = str; *c; ++c) {
+      if (*c == '"' || *c == '\\') out << '\\';
+      out << *c;
+   }
+   out << '"';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the statistics per branch to out, the branches with the largest
+/// unzip and streamer time first, as a table or as JSON.
+
+void TTreePerfStats::PrintBranchStats(std::ostream &out, Bool_t json) const
+{
+   Int_t nbranches = fBranchNames.size();
+   std::vector<Int_t> order(nbranches);
+   for (Int_t i = 0; i < nbranches; ++i) order[i] = i;
+   std::stable_sort(order.begin(), order.end(), [this](Int_t a, Int_t b) {
+      return fBranchUnzipTime[a] + fBranchStreamerTime[a] > fBranchUnzipTime[b] + fBranchStreamerTime[b];
+   });
+
+   if (json) {
+      out << "{\n  \"name\": ";
+      R__WriteJSONString(out, fName.Data());
+      out << ",\n  \"branches\": [";
+      for (Int_t k = 0; k < nbranches; ++k) {
+         Int_t i = order[k];
+         out << (k ? ",\n" : "\n") << "    {\"name\": ";
+         R__WriteJSONString(out, fBranchNames[i].Data());
+         out << ", \"baskets\": " << fBranchBaskets[i]
+             << ", \"cacheMisses\": " << fBranchCacheMisses[i]
+             << ", \"bytesRead\": " << fBranchBytes[i]
+             << ", \"bytesUnzipped\": " << fBranchUnzipBytes[i]
+             << ", \"unzipTime\": " << fBranchUnzipTime[i]
+             << ", \"streamerTime\": " << fBranchStreamerTime[i] << "}";
+      }
+      out << "\n  ]\n}\n";
+      return;
+   }
+
+   out << TString::Format("%-40s %8s %8s %10s %10s %10s %10s\n",
+                          "Branch", "Baskets", "Misses", "ReadMB", "UnzipMB", "Unzip(s)", "Strm(s)");
+   for (Int_t k = 0; k < nbranches; ++k) {
+      Int_t i = order[k];
+      out << TString::Format("%-40s %8d %8d %10.3f %10.3f %10.3f %10.3f\n",
+                             fBranchNames[i].Data(), fBranchBaskets[i], fBranchCacheMisses[i],
+                             1e-6*fBranchBytes[i], 1e-6*fBranchUnzipBytes[i],
+                             fBranchUnzipTime[i], fBranchStreamerTime[i]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save the statistics per branch in the file filename: as JSON if its
+/// name ends with .json, as a text table otherwise.
+
+void TTreePerfStats::SaveBranchStats(const char *filename) const
+{
+   std::ofstream out(filename);
+   if (!out) {
+      Error("SaveBranchStats", "cannot open file %s", filename);
+      return;
+   }
+   TTreePerfStats *ps = (TTreePerfStats*)this;
+   ps->MergeBranchStats();
+   PrintBranchStats(out, TString(filename).EndsWith(".json"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,6 +83,17 @@ extra libraries (Histogram, display, etc).
 #include "Fit/UnBinData.h"
 #include "Math/MinimizerOptions.h"
 
+#ifdef R__USE_IMT
+#include "TTreeProcessorMT.h"
+#include "tbb/task_group.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#endif
+
 
 
 R__EXTERN Foption_t Foption;
@@ -108,6 +119,9 @@ TTreePlayer::TTreePlayer()
    fSelectorFromFile = 0;
    fSelectorClass    = 0;
    fSelectorUpdate   = 0;
+   fDrawHeadOnly     = kFALSE;
+   fDrawHeadEnd      = -1;
+   fDrawContinue     = kFALSE;
    fInput            = new TList();
    fInput->Add(new TNamed("varexp",""));
    fInput->Add(new TNamed("selection",""));
@@ -324,6 +338,334 @@ Long64_t TTreePlayer::DrawScript(const char* wrapperPrefix,
    return result;
 }
 
+#ifdef R__USE_IMT
+
+namespace {
+   /// The state of a task of a parallel TTree::Draw: the tree opened in its
+   /// own file, the selector with the formulas compiled for that tree, and
+   /// the histogram it fills.
+   struct TDrawTaskState {
+      std::unique_ptr<TFile>         fFile;
+      std::string                    fFileName;
+      std::string                    fTreeName;
+      TTree                         *fTree = nullptr;
+      std::unique_ptr<TSelectorDraw> fSelector;
+      TList                          fInput;
+      TH1                           *fHistogram = nullptr;
+      Long64_t                       fSelectedRows = 0;
+
+      ~TDrawTaskState() { fInput.Delete(); }
+   };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the position of the last ">>" of varexp, which introduces the
+/// name of the histogram or list to fill (see TSelectorDraw::Begin).
+
+static Ssiz_t R__FindHistogramName(const TString &varexp)
+{
+   for (Ssiz_t k = varexp.Length() - 1; k > 0; --k) {
+      if (varexp[k] == '>' && varexp[k-1] == '>')
+         return k - 1;
+   }
+   return kNPOS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if the entries of TTree::Draw, starting at firstentry, can
+/// be split between the calling thread and parallel tasks. The ranges (made
+/// of whole clusters) of all the entries up to firstentry+nentries are then
+/// stored in ranges.
+///
+/// The entries processed first, on the calling thread, fix the limits of the
+/// histogram (see TTreePlayer::Process), the tasks then fill clones of it.
+/// This is only done for histograms (not for graphs, event lists or parallel
+/// coordinates) and if the tasks can read the same entries as the tree: no
+/// entry list and no friends, and the tree must be a TChain or be read from
+/// a file which is not being written.
+
+static Bool_t R__SplitDrawEntries(TTree *tree, TSelectorDraw *selector, const char *varexp0,
+                                  const char *selection, const TString &opt, Long64_t nentries, Long64_t firstentry,
+                                  std::vector<TTreeProcessorMT::TTreeRange> &ranges)
+{
+   if (!ROOT::IsImplicitMTEnabled() || !tree->GetImplicitMT() || nentries <= 0)
+      return kFALSE;
+   if (tree->GetEntryList() || tree->GetEventList() || tree->GetUpdate())
+      return kFALSE;
+   if (tree->GetListOfFriends() && tree->GetListOfFriends()->GetEntries())
+      return kFALSE;
+   Bool_t isChain = tree->InheritsFrom(TChain::Class());
+   if (isChain) {
+      // The tasks read the trees of the chain, with their own weights.
+      if (tree->TestBit(TChain::kGlobalWeight)) return kFALSE;
+      // Entry$ and Entries$ would be relative to the tree of a task.
+      if (strstr(varexp0, "Entr") || (selection && strstr(selection, "Entr"))) return kFALSE;
+   } else if (!tree->GetCurrentFile() || tree->GetCurrentFile()->IsWritable()) {
+      return kFALSE;
+   }
+
+   // Only histograms with new contents, see TSelectorDraw::Begin.
+   TString varexp = varexp0;
+   Ssiz_t hpos = R__FindHistogramName(varexp);
+   if (hpos != kNPOS) {
+      if (hpos == 0) return kFALSE;
+      TString hname = varexp(hpos + 2, varexp.Length());
+      if (TString(hname.Strip(TString::kLeading)).BeginsWith("+")) return kFALSE;
+      varexp.Remove(hpos);
+   }
+   if (opt.Contains("entrylist") || opt.Contains("para") || opt.Contains("candle") || opt.Contains("gl5d"))
+      return kFALSE;
+   std::vector<TString> names;
+   UInt_t ndim = selector->SplitNames(varexp, names);
+   if (ndim == 2 && !opt.Contains("prof")) {
+      Bool_t graph = kFALSE;
+      if (opt.Length() == 0 || opt.Contains("same")) graph = kTRUE;
+      if (opt.Contains("p")     || opt.Contains("*")    || opt.Contains("l"))    graph = kTRUE;
+      if (opt.Contains("surf")  || opt.Contains("lego") || opt.Contains("cont")) graph = kFALSE;
+      if (opt.Contains("col")   || opt.Contains("hist") || opt.Contains("scat")) graph = kFALSE;
+      if (opt.Contains("box"))                                                   graph = kFALSE;
+      if (graph) return kFALSE;
+   } else if (ndim == 3 && !opt.Contains("prof")) {
+      Int_t noscat = opt.Length();
+      if (opt.Contains("same")) noscat -= 4;
+      if (opt.Contains("col") || !noscat) return kFALSE;
+   } else if (ndim < 1 || ndim > 3) {
+      return kFALSE;
+   }
+
+   TTreeProcessorMT processor;
+   ranges = processor.MakeRanges(*tree, firstentry + nentries);
+
+   // The ranges of a chain restart at 0 with each tree.
+   Long64_t offset = 0;
+   Long64_t end = 0;
+   for (size_t i = 0; i < ranges.size(); ++i) {
+      if (i && ranges[i].fFirst == 0)
+         offset = end;
+      end = offset + ranges[i].fLast;
+   }
+   // Some files could not be read, or the tree is not the one on file.
+   if (end != firstentry + nentries || ranges.size() < 2) {
+      ranges.clear();
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove from ranges, as made by R__SplitDrawEntries, the entries before
+/// headEnd which were processed on the calling thread. The range holding
+/// headEnd is shortened to start there.
+
+static void R__SkipDrawEntries(std::vector<TTreeProcessorMT::TTreeRange> &ranges, Long64_t headEnd)
+{
+   std::vector<TTreeProcessorMT::TTreeRange> tail;
+   Long64_t offset = 0;
+   Long64_t end = 0;
+   for (size_t i = 0; i < ranges.size(); ++i) {
+      if (i && ranges[i].fFirst == 0)
+         offset = end;
+      end = offset + ranges[i].fLast;
+      if (end <= headEnd)
+         continue;
+      tail.push_back(ranges[i]);
+      if (offset + ranges[i].fFirst < headEnd)
+         tail.back().fFirst = headEnd - offset;
+   }
+   ranges.swap(tail);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the state of a task to process range: open the tree of the
+/// range if the state has another one, and compile the formulas of a new
+/// selector for it, filling a clone of hist.
+
+static Bool_t R__InitDrawTask(TDrawTaskState &state, const TTreeProcessorMT::TTreeRange &range, TTree *tree,
+                              const TString &varexp, const char *selection, const TString &option,
+                              TH1 *hist, Int_t action, std::mutex &initMutex)
+{
+   if (state.fFile && range.fFileName == state.fFileName && range.fTreeName == state.fTreeName)
+      return state.fSelector != nullptr;
+
+   // Flush the previous selector and detach the histogram from its file.
+   if (state.fSelector) {
+      state.fSelector->Terminate();
+      state.fSelectedRows += state.fSelector->GetSelectedRows();
+      state.fTree->SetNotify(0);
+      state.fSelector.reset();
+   }
+   if (state.fHistogram)
+      state.fHistogram->SetDirectory(nullptr);
+   state.fTree = nullptr;
+   state.fFileName = range.fFileName;
+   state.fTreeName = range.fTreeName;
+   state.fFile.reset(TFile::Open(range.fFileName.c_str()));
+   if (!state.fFile || state.fFile->IsZombie()) {
+      Error("DrawSelect", "cannot open file %s", range.fFileName.c_str());
+      return kFALSE;
+   }
+   state.fFile->GetObject(range.fTreeName.c_str(), state.fTree);
+   if (!state.fTree) {
+      Error("DrawSelect", "cannot find tree %s in file %s", range.fTreeName.c_str(), range.fFileName.c_str());
+      return kFALSE;
+   }
+   // The parallelism is across the ranges.
+   state.fTree->SetImplicitMT(kFALSE);
+   state.fTree->SetCacheSize();
+   if (!tree->InheritsFrom(TChain::Class()))
+      state.fTree->SetWeight(tree->GetWeight());
+   if (tree->GetListOfAliases()) {
+      TIter next(tree->GetListOfAliases());
+      while (TObject *alias = next())
+         state.fTree->SetAlias(alias->GetName(), alias->GetTitle());
+   }
+
+   // The selector finds the histogram to fill in the current directory.
+   gDirectory = state.fFile.get();
+   std::lock_guard<std::mutex> lock(initMutex);
+   if (!state.fHistogram) {
+      state.fHistogram = (TH1*)hist->Clone("htempmt");
+      state.fHistogram->Reset();
+   }
+   state.fHistogram->SetDirectory(state.fFile.get());
+   if (state.fInput.IsEmpty()) {
+      state.fInput.Add(new TNamed("varexp", (varexp + ">>+htempmt").Data()));
+      state.fInput.Add(new TNamed("selection", selection));
+   }
+   state.fSelector.reset(new TSelectorDraw());
+   state.fSelector->SetInputList(&state.fInput);
+   state.fTree->SetNotify(state.fSelector.get());
+   state.fSelector->SetOption(option);
+   state.fSelector->Begin(state.fTree);
+   state.fSelector->SlaveBegin(state.fTree);
+   state.fSelector->Notify();
+   gDirectory = nullptr;
+   if (state.fSelector->GetAbort() != TSelector::kContinue || state.fSelector->GetAction() != action ||
+       state.fSelector->GetObject() != state.fHistogram) {
+      Error("DrawSelect", "cannot draw the entries of tree %s in file %s", range.fTreeName.c_str(),
+            range.fFileName.c_str());
+      state.fTree->SetNotify(0);
+      state.fSelector.reset();
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the ranges of tail with parallel tasks, each filling its own
+/// clone of the histogram of selector, with its own formulas, and merge the
+/// clones into it. Return the number of selected rows, or -1 if the
+/// histogram of selector cannot be filled this way or if a task could not
+/// process its range; the histogram is then left untouched.
+
+static Long64_t R__DrawSelectMT(TTree *tree, TSelectorDraw *selector, const char *varexp0, const char *selection,
+                                const TString &opt, const std::vector<TTreeProcessorMT::TTreeRange> &tail)
+{
+   TH1 *hist = dynamic_cast<TH1*>(selector->GetObject());
+   Int_t action = selector->GetAction();
+   if (!hist || (action != 1 && action != 2 && action != 3 && action != 4 && action != 23))
+      return -1;
+   if (selector->GetVar1()->EvalClass())
+      return -1;
+
+   TString varexp = varexp0;
+   Ssiz_t hpos = R__FindHistogramName(varexp);
+   if (hpos != kNPOS)
+      varexp.Remove(hpos);
+   TString option = opt;
+   option.ReplaceAll("same", "");
+   option += " goff";
+
+   std::vector<std::unique_ptr<TDrawTaskState>> states;
+   std::vector<TDrawTaskState*> freeStates;
+   std::mutex statesMutex;
+   std::mutex initMutex;
+   std::atomic<Bool_t> failed(kFALSE);
+   auto processRange = [&](const TTreeProcessorMT::TTreeRange &range) {
+      if (gROOT->IsInterrupted())
+         return;
+      TDrawTaskState *state = nullptr;
+      {
+         // Prefer a state which has the tree of the range already opened.
+         std::lock_guard<std::mutex> lock(statesMutex);
+         for (auto it = freeStates.begin(); it != freeStates.end(); ++it) {
+            if ((*it)->fFile && range.fFileName == (*it)->fFileName && range.fTreeName == (*it)->fTreeName) {
+               state = *it;
+               freeStates.erase(it);
+               break;
+            }
+         }
+         if (!state && !freeStates.empty()) {
+            state = freeStates.back();
+            freeStates.pop_back();
+         }
+         if (!state) {
+            states.emplace_back(new TDrawTaskState);
+            state = states.back().get();
+         }
+      }
+      {
+         // gDirectory is per thread: nothing created here goes to the
+         // directory of the caller.
+         TDirectory::TContext ctxt(nullptr);
+         if (R__InitDrawTask(*state, range, tree, varexp, selection, option, hist, action, initMutex)) {
+            TSelectorDraw *sel = state->fSelector.get();
+            state->fTree->SetCacheEntryRange(range.fFirst, range.fLast);
+            for (Long64_t entry = range.fFirst; entry < range.fLast; ++entry) {
+               if (gROOT->IsInterrupted()) break;
+               if (state->fTree->LoadTree(entry) < 0) break;
+               Long64_t nblock = sel->ProcessFillBlock(entry, range.fLast - entry);
+               if (nblock > 0) {
+                  entry += nblock - 1;
+                  continue;
+               }
+               if (sel->ProcessCut(entry))
+                  sel->ProcessFill(entry);
+            }
+         } else {
+            failed = kTRUE;
+         }
+      }
+      std::lock_guard<std::mutex> lock(statesMutex);
+      freeStates.push_back(state);
+   };
+
+   tbb::task_group g;
+   for (const auto &range : tail)
+      g.run([&processRange, &range]() { processRange(range); });
+   g.wait();
+
+   Long64_t nrows = 0;
+   TList clones;
+   for (auto &state : states) {
+      if (state->fSelector) {
+         state->fSelector->Terminate();
+         state->fSelectedRows += state->fSelector->GetSelectedRows();
+         state->fTree->SetNotify(0);
+         state->fSelector.reset();
+      }
+      nrows += state->fSelectedRows;
+      if (state->fHistogram) {
+         state->fHistogram->SetDirectory(nullptr);
+         clones.Add(state->fHistogram);
+      }
+      state->fTree = nullptr;
+      state->fFile.reset();
+   }
+   if (failed) {
+      // The entries of the failed tasks are missing from the clones.
+      clones.Delete();
+      return -1;
+   }
+   if (!clones.IsEmpty()) {
+      hist->Merge(&clones);
+      clones.Delete();
+   }
+   return nrows;
+}
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Draw expression varexp for specified entries that matches the selection.
 /// Returns -1 in case of error or number of selected events in case of succss.
@@ -410,7 +752,45 @@ Long64_t TTreePlayer::DrawSelect(const char *varexp0, const char *selection, Opt
    if (nentries > fTree->GetMaxEntryLoop()) nentries = fTree->GetMaxEntryLoop();
 
    // invoke the selector
+#ifdef R__USE_IMT
+   // With implicit multi-threading, the entries are processed here until
+   // the limits of the histogram are set, as they would be sequentially,
+   // and the following ones by parallel tasks. The selector is terminated,
+   // and the histogram drawn, once all the entries are in it.
+   std::vector<TTreeProcessorMT::TTreeRange> tail;
+   Long64_t nrows;
+   if (R__SplitDrawEntries(fTree, fSelector, varexp0, selection, opt,
+                           GetEntriesToProcess(firstentry, nentries), firstentry, tail)) {
+      fDrawHeadOnly = kTRUE;
+      fDrawHeadEnd  = -1;
+      nrows = Process(fSelector,option,nentries,firstentry);
+      fDrawHeadOnly = kFALSE;
+      if (fDrawHeadEnd >= 0 && nrows >= 0) {
+         // Process stopped without terminating the selector.
+         R__SkipDrawEntries(tail, fDrawHeadEnd);
+         Long64_t nrowsMT = R__DrawSelectMT(fTree, fSelector, varexp0, selection, opt, tail);
+         Long64_t last = firstentry + GetEntriesToProcess(firstentry, nentries);
+         fDrawContinue = kTRUE;
+         if (nrowsMT < 0) {
+            // Unexpected kind of drawing, or some entries could not be read
+            // by the tasks: go on sequentially from where we stopped.
+            nrows = Process(fSelector,option,last - fDrawHeadEnd,fDrawHeadEnd);
+         } else {
+            // The entries of the tasks are merged in the histogram already.
+            nrows = Process(fSelector,option,0,last);
+            if (nrows >= 0) {
+               nrows += nrowsMT;
+               fSelector->SetStatus(nrows);
+            }
+         }
+         fDrawContinue = kFALSE;
+      }
+   } else {
+      nrows = Process(fSelector,option,nentries,firstentry);
+   }
+#else
    Long64_t nrows = Process(fSelector,option,nentries,firstentry);
+#endif
    fSelectedRows = nrows;
    fDimension = fSelector->GetDimension();
 
@@ -2223,16 +2603,22 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
 
    fTree->SetNotify(selector);
 
-   selector->SetOption(option);
+   // The loop of a parallel DrawSelect continues with the selector, already
+   // initialized, where its first part stopped (see fDrawHeadOnly).
+   if (!fDrawContinue) {
+      selector->SetOption(option);
 
-   selector->Begin(fTree);       //<===call user initialization function
-   selector->SlaveBegin(fTree);  //<===call user initialization function
-   if (selector->Version() >= 2)
-      selector->Init(fTree);
-   selector->Notify();
+      selector->Begin(fTree);       //<===call user initialization function
+      selector->SlaveBegin(fTree);  //<===call user initialization function
+      if (selector->Version() >= 2)
+         selector->Init(fTree);
+      selector->Notify();
 
-   if (gMonitoringWriter)
-      gMonitoringWriter->SendProcessingStatus("STARTED",kTRUE);
+      if (gMonitoringWriter)
+         gMonitoringWriter->SendProcessingStatus("STARTED",kTRUE);
+   } else {
+      selector->Notify();
+   }
 
    Bool_t process = (selector->GetAbort() != TSelector::kAbortProcess &&
                     (selector->Version() != 0 || selector->GetStatus() != -1)) ? kTRUE : kFALSE;
@@ -2265,6 +2651,10 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
       Long64_t entry, entryNumber, localEntry;
 
       Bool_t useCutFill = selector->Version() == 0;
+      // Without entry list, TSelectorDraw can evaluate blocks of consecutive entries.
+      TSelectorDraw *drawSelector = 0;
+      if (useCutFill && !fTree->GetEntryList() && selector->IsA() == TSelectorDraw::Class())
+         drawSelector = (TSelectorDraw*)selector;
 
       // force the first monitoring info
       if (gMonitoringWriter)
@@ -2283,7 +2673,15 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
          if (gROOT->IsInterrupted()) break;
          localEntry = fTree->LoadTree(entryNumber);
          if (localEntry < 0) break;
-         if(useCutFill) {
+         // Process the entries up to the end of the current baskets at once,
+         // or skip them if the zone maps show that none is selected.
+         Long64_t nblock = 0;
+         if (drawSelector)
+            nblock = drawSelector->ProcessFillBlock(localEntry, firstentry+nentries-entry);
+         if (nblock > 0) {
+            entry += nblock - 1;
+            localEntry += nblock - 1;
+         } else if(useCutFill) {
             if (selector->ProcessCut(localEntry))
                selector->ProcessFill(localEntry); //<==call user analysis function
          } else {
@@ -2292,6 +2690,13 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
          if (gMonitoringWriter)
             gMonitoringWriter->SendProcessingProgress((entry-firstentry),TFile::GetFileBytesRead()-readbytesatstart,kTRUE);
          if (selector->GetAbort() == TSelector::kAbortProcess) break;
+         // The limits of the histogram are set once the first buffer of
+         // values is filled, DrawSelect has the following entries processed
+         // by parallel tasks.
+         if (fDrawHeadOnly && drawSelector && drawSelector->GetSelectedRows() > 0) {
+            fDrawHeadEnd = entry + 1;
+            break;
+         }
          if (selector->GetAbort() == TSelector::kAbortFile) {
             // Skip to the next file.
             entry += fTree->GetTree()->GetEntries() - localEntry;
@@ -2313,6 +2718,12 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
    process = (selector->GetAbort() != TSelector::kAbortProcess &&
              (selector->Version() != 0 || selector->GetStatus() != -1)) ? kTRUE : kFALSE;
    Long64_t res = (process) ? 0 : -1;
+   if (process && fDrawHeadOnly && fDrawHeadEnd >= 0) {
+      // DrawSelect processes the other entries, then terminates the selector.
+      fTree->SetNotify(0);
+      fSelectorUpdate = 0;
+      return res;
+   }
    if (process) {
       selector->SlaveTerminate();   //<==call user termination function
       selector->Terminate();        //<==call user termination function
@@ -0,0 +1,355 @@
+// @(#)root/treeplayer:$Id$
+// Author: agent   18/10/2026
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTreeProcessorMT
+\ingroup treeplayer
+
+A thread based processor of TTrees and TChains.
+
+It splits the trees along their cluster boundaries (see
+TTree::GetClusterIterator) into ranges processed by concurrent tasks of the
+implicit multi-threading pool. Each task calls the user function with a
+TTreeReader set to the entries of its range, on a copy of the tree read
+from its file by that task, so that each task has its own baskets and its
+own TTreeCache. The objects returned by the user function are merged, with
+their Merge method, first within each thread and then at the end.
+
+The interface is the one of TProcPool::ProcTree, without fork and
+inter-process communication:
+~~~{.cpp}
+ROOT::EnableImplicitMT();
+TTreeProcessorMT processor;
+auto fillHisto = [](TTreeReader &reader) {
+   TTreeReaderValue<Float_t> px(reader, "px");
+   auto h = new TH1F("hpx", "px", 100, -4, 4);
+   while (reader.Next())
+      h->Fill(*px);
+   return h;
+};
+TH1F *hpx = processor.ProcTree(fileNames, fillHisto, "ntuple");
+~~~
+*/
+
+#include "TTreeProcessorMT.h"
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TClass.h"
+#include "TDirectory.h"
+#include "TEntryList.h"
+#include "TError.h"
+#include "TEventList.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <memory>
+#include <mutex>
+
+#ifdef R__USE_IMT
+#include "tbb/task_group.h"
+#endif
+
+namespace {
+   /// What a task needs to process a range: the tree, opened in its own file,
+   /// and the merged result of the ranges already processed.
+   struct TTaskState {
+      std::unique_ptr<TFile> fFile;
+      std::string            fFileName;
+      std::string            fTreeName;
+      TTree                 *fTree = nullptr;
+      TObject               *fResult = nullptr;
+   };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the first TTree of the file.
+
+static std::string R__FindTreeName(TFile &file)
+{
+   TIter next(file.GetListOfKeys());
+   while (TKey *key = (TKey*)next()) {
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (cl && cl->InheritsFrom(TTree::Class()))
+         return key->GetName();
+   }
+   return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add to ranges the ranges of fClustersPerTask clusters of the tree treeName
+/// of the file fileName, for at most nToProcess entries in total (0 means
+/// no limit), nEntries being the number of entries in the previous ranges.
+/// Return false if the limit of entries is reached.
+
+static Bool_t R__AddRanges(std::vector<TTreeProcessorMT::TTreeRange> &ranges, const std::string &fileName,
+                           const std::string &treeName, UInt_t clustersPerTask, ULong64_t nToProcess,
+                           ULong64_t &nEntries)
+{
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+   if (!file || file->IsZombie()) {
+      Error("TTreeProcessorMT::MakeRanges", "cannot open file %s", fileName.c_str());
+      return kTRUE;
+   }
+   std::string name = treeName.empty() ? R__FindTreeName(*file) : treeName;
+   TTree *tree = nullptr;
+   if (!name.empty())
+      file->GetObject(name.c_str(), tree);
+   if (!tree) {
+      if (name.empty())
+         Error("TTreeProcessorMT::MakeRanges", "cannot find a tree in file %s", fileName.c_str());
+      else
+         Error("TTreeProcessorMT::MakeRanges", "cannot find tree %s in file %s", name.c_str(), fileName.c_str());
+      return kTRUE;
+   }
+
+   Long64_t entries = tree->GetEntries();
+   TTree::TClusterIterator clusters = tree->GetClusterIterator(0);
+   Long64_t first = 0;
+   UInt_t nclusters = 0;
+   while (clusters() < entries) {
+      Long64_t last = clusters.GetNextEntry();
+      if (++nclusters < clustersPerTask && last < entries)
+         continue;
+      nclusters = 0;
+      if (nToProcess && nEntries + (last - first) >= nToProcess) {
+         ranges.push_back({fileName, name, first, first + Long64_t(nToProcess - nEntries)});
+         nEntries = nToProcess;
+         return kFALSE;
+      }
+      ranges.push_back({fileName, name, first, last});
+      nEntries += last - first;
+      first = last;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Objects attached to a directory are deleted with it: detach the result
+/// from the file of the task (currently needed for TH1, TTree, TEventList
+/// and TEntryList).
+
+static void R__DetachResult(TObject *res)
+{
+   if (TH1 *h = dynamic_cast<TH1*>(res)) {
+      h->SetDirectory(nullptr);
+   } else if (TTree *t = dynamic_cast<TTree*>(res)) {
+      t->SetDirectory(nullptr);
+   } else if (TEntryList *el = dynamic_cast<TEntryList*>(res)) {
+      el->SetDirectory(nullptr);
+   } else if (TEventList *evl = dynamic_cast<TEventList*>(res)) {
+      evl->SetDirectory(nullptr);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the objects of objs into the first one, with its Merge method, and
+/// delete them. Return the first object.
+
+static TObject *R__MergeResults(std::vector<TObject*> &objs)
+{
+   if (objs.empty())
+      return nullptr;
+   TObject *obj = objs[0];
+   if (objs.size() == 1)
+      return obj;
+
+   ROOT::MergeFunc_t merge = obj->IsA()->GetMerge();
+   if (!merge) {
+      Error("TTreeProcessorMT::ProcTree", "could not find a merge method for %s, returning a partial result",
+            obj->ClassName());
+      return obj;
+   }
+   TList mergelist;
+   for (size_t i = 1; i < objs.size(); ++i)
+      mergelist.Add(objs[i]);
+   merge(obj, &mergelist, nullptr);
+   mergelist.Delete();
+   return obj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process one range with the tree of the state, opening it if needed, and
+/// merge the result into the one of the state.
+
+static void R__ProcessRange(TTaskState &state, const TTreeProcessorMT::TTreeRange &range,
+                            const std::function<TObject*(TTreeReader&)> &func)
+{
+   // gDirectory is per thread. Keep it null while func runs, so that the
+   // objects it creates are not attached to the file of the task.
+   TDirectory::TContext ctxt(nullptr);
+
+   if (!state.fFile || range.fFileName != state.fFileName || range.fTreeName != state.fTreeName) {
+      state.fTree = nullptr;
+      state.fFileName = range.fFileName;
+      state.fFile.reset(TFile::Open(range.fFileName.c_str()));
+      if (!state.fFile || state.fFile->IsZombie()) {
+         Error("TTreeProcessorMT::ProcTree", "cannot open file %s", range.fFileName.c_str());
+         state.fFile.reset();
+         return;
+      }
+      state.fTreeName = range.fTreeName;
+      state.fFile->GetObject(range.fTreeName.c_str(), state.fTree);
+      if (!state.fTree) {
+         Error("TTreeProcessorMT::ProcTree", "cannot find tree %s in file %s", range.fTreeName.c_str(), range.fFileName.c_str());
+         return;
+      }
+      // The parallelism is across the ranges.
+      state.fTree->SetImplicitMT(kFALSE);
+      state.fTree->SetCacheSize();
+      gDirectory = nullptr;
+   }
+   if (!state.fTree)
+      return;
+   state.fTree->SetCacheEntryRange(range.fFirst, range.fLast);
+
+   TTreeReader reader(state.fTree);
+   // Set the first entry to fFirst-1 so that the first call to TTreeReader::Next() reads fFirst.
+   if (reader.SetEntriesRange(range.fFirst - 1, range.fLast) != TTreeReader::kEntryValid) {
+      Error("TTreeProcessorMT::ProcTree", "could not set the TTreeReader to the range %lld-%lld of %s",
+            range.fFirst, range.fLast, range.fFileName.c_str());
+      return;
+   }
+   TObject *res = func(reader);
+   if (!res)
+      return;
+   R__DetachResult(res);
+   if (!state.fResult) {
+      state.fResult = res;
+   } else {
+      std::vector<TObject*> objs{state.fResult, res};
+      state.fResult = R__MergeResults(objs);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split the tree treeName of the files into ranges of GetClustersPerTask()
+/// clusters, for at most nToProcess entries (0 means all). If treeName is
+/// empty, the first tree of each file is used.
+
+std::vector<TTreeProcessorMT::TTreeRange> TTreeProcessorMT::MakeRanges(const std::vector<std::string>& fileNames, const std::string& treeName, ULong64_t nToProcess) const
+{
+   std::vector<TTreeRange> ranges;
+   ULong64_t nEntries = 0;
+   for (const auto &fileName : fileNames) {
+      if (!R__AddRanges(ranges, fileName, treeName, fClustersPerTask, nToProcess, nEntries))
+         break;
+   }
+   return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split a TTree or the trees of a TChain into ranges of GetClustersPerTask()
+/// clusters, for at most nToProcess entries (0 means all). The tree must be
+/// in a file.
+
+std::vector<TTreeProcessorMT::TTreeRange> TTreeProcessorMT::MakeRanges(TTree& tree, ULong64_t nToProcess) const
+{
+   std::vector<TTreeRange> ranges;
+   ULong64_t nEntries = 0;
+   if (tree.InheritsFrom(TChain::Class())) {
+      TIter next(static_cast<TChain&>(tree).GetListOfFiles());
+      while (TChainElement *element = (TChainElement*)next()) {
+         if (!R__AddRanges(ranges, element->GetTitle(), element->GetName(), fClustersPerTask, nToProcess, nEntries))
+            break;
+      }
+   } else if (tree.GetCurrentFile()) {
+      // The name of the tree is its path in the file.
+      TString path = tree.GetDirectory()->GetPath();
+      path.Remove(0, path.Index(":/") + 2);
+      if (!path.IsNull())
+         path += "/";
+      path += tree.GetName();
+      R__AddRanges(ranges, tree.GetCurrentFile()->GetName(), path.Data(), fClustersPerTask, nToProcess, nEntries);
+   }
+   return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the ranges with func and return the merged result.
+
+TObject *TTreeProcessorMT::Process(const std::vector<TTreeRange>& ranges, const ProcFunc_t& func) const
+{
+   // The states are reused by the following tasks, taking a free one rather
+   // than a thread local one keeps this correct if a task runs another one
+   // while it waits (e.g. inside a parallel unzipping).
+   std::vector<std::unique_ptr<TTaskState>> states;
+   std::vector<TTaskState*> freeStates;
+   std::mutex statesMutex;
+   auto processRange = [&](const TTreeRange &range) {
+      TTaskState *state = nullptr;
+      {
+         std::lock_guard<std::mutex> lock(statesMutex);
+         // Prefer a state which has the file of the range already opened.
+         for (auto it = freeStates.begin(); it != freeStates.end(); ++it) {
+            if ((*it)->fFile && range.fFileName == (*it)->fFileName) {
+               state = *it;
+               freeStates.erase(it);
+               break;
+            }
+         }
+         if (!state && !freeStates.empty()) {
+            state = freeStates.back();
+            freeStates.pop_back();
+         }
+         if (!state) {
+            states.emplace_back(new TTaskState);
+            state = states.back().get();
+         }
+      }
+      R__ProcessRange(*state, range, func);
+      std::lock_guard<std::mutex> lock(statesMutex);
+      freeStates.push_back(state);
+   };
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && ranges.size() > 1) {
+      tbb::task_group g;
+      for (const auto &range : ranges)
+         g.run([&processRange, &range]() { processRange(range); });
+      g.wait();
+   } else
+#endif
+   {
+      for (const auto &range : ranges)
+         processRange(range);
+   }
+
+   std::vector<TObject*> results;
+   for (auto &state : states) {
+      if (state->fResult)
+         results.push_back(state->fResult);
+      // Close the file before the results are merged.
+      state->fTree = nullptr;
+      state->fFile.reset();
+   }
+   return R__MergeResults(results);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process a TTree or a TChain with func and return the merged result.
+
+TObject *TTreeProcessorMT::Process(TTree& tree, ULong64_t nToProcess, const ProcFunc_t& func) const
+{
+   if (!tree.InheritsFrom(TChain::Class()) && !tree.GetCurrentFile()) {
+      // There is no file the tasks could read the tree from, process it here.
+      TTreeReader reader(&tree);
+      if (nToProcess)
+         reader.SetEntriesRange(-1, nToProcess);
+      TObject *res = func(reader);
+      R__DetachResult(res);
+      return res;
+   }
+   return Process(MakeRanges(tree, nToProcess), func);
+}
@@ -16,6 +16,7 @@
 #include "TBranchRef.h"
 #include "TBranchSTL.h"
 #include "TBranchProxyDirector.h"
+#include "TBufferFile.h"
 #include "TClassEdit.h"
 #include "TLeaf.h"
 #include "TROOT.h"
@@ -237,6 +238,56 @@ namespace {
       }
    };
 
+   // Reader for a data member of basic type of the elements of a split
+   // collection, e.g. fPx of a std::vector<MyStruct>: the values of the data
+   // member for the current entry are read from its basket as one contiguous
+   // column, without reading the collection nor constructing its elements.
+   // Falls back to TBasicTypeArrayReader when the branch does not allow it.
+   class TSTLMemberColumnReader : public TBasicTypeArrayReader {
+   private:
+      TBufferFile fColumn;       // Values of the data member for fColumnEntry
+      TTree      *fColumnTree;   // Tree from which fColumn was read (the current tree of a TChain)
+      Int_t       fColumnTreeNumber; // Number of fColumnTree in its TChain
+      TBranch    *fColumnBranch; // Branch from which fColumn was read
+      Long64_t    fColumnEntry;  // Entry from which fColumn was read
+      Int_t       fColumnSize;   // Number of values in fColumn, -1 if the branch cannot be read as a column
+      Int_t       fElementSize;  // Size of one value
+
+      Bool_t ReadColumn(ROOT::Detail::TBranchProxy *proxy) {
+         TBranch *branch = proxy->GetBranch();
+         Long64_t entry = proxy->GetReadEntry();
+         // The local entry and even the branch address may be the same in
+         // the next tree of a TChain.
+         TTree *tree = branch ? proxy->GetDirector()->GetTree() : 0;
+         Int_t treeNumber = tree ? tree->GetTreeNumber() : -1;
+         if (tree) tree = tree->GetTree();
+         if (tree != fColumnTree || treeNumber != fColumnTreeNumber || branch != fColumnBranch || entry != fColumnEntry) {
+            fColumnTree = tree;
+            fColumnTreeNumber = treeNumber;
+            fColumnBranch = branch;
+            fColumnEntry = entry;
+            fColumnSize = branch ? ((TBranchElement*)branch)->GetEntryColumn(entry, fColumn) : -1;
+         }
+         if (fColumnSize < 0) return kFALSE;
+         fReadStatus = TTreeReaderValueBase::kReadSuccess;
+         return kTRUE;
+      }
+
+   public:
+      TSTLMemberColumnReader(Int_t elementSize) : fColumn(TBuffer::kRead, 1024), fColumnTree(0), fColumnTreeNumber(-1), fColumnBranch(0), fColumnEntry(-1), fColumnSize(-1), fElementSize(elementSize) {}
+      ~TSTLMemberColumnReader() {}
+
+      virtual size_t GetSize(ROOT::Detail::TBranchProxy* proxy){
+         if (!ReadColumn(proxy)) return TBasicTypeArrayReader::GetSize(proxy);
+         return fColumnSize;
+      }
+
+      virtual void* At(ROOT::Detail::TBranchProxy* proxy, size_t idx){
+         if (!ReadColumn(proxy)) return TBasicTypeArrayReader::At(proxy, idx);
+         return fColumn.Buffer() + idx * fElementSize;
+      }
+   };
+
    class TBasicTypeClonesReader : public TClonesReader {
    private:
       Int_t offset;
@@ -494,7 +545,11 @@ void ROOT::Internal::TTreeReaderArrayBase::CreateProxy()
          }
          else if (element->IsA() == TStreamerBasicType::Class()){
             if (branchElement->GetType() == TBranchElement::kSTLMemberNode){
-               fImpl = new TBasicTypeArrayReader();
+               if (fDict == branchActualType && !element->GetArrayLength()) {
+                  fImpl = new TSTLMemberColumnReader(element->GetSize());
+               } else {
+                  fImpl = new TBasicTypeArrayReader();
+               }
             }
             else if (branchElement->GetType() == TBranchElement::kClonesMemberNode){
                fImpl = new TBasicTypeClonesReader(element->GetOffset());